@@ -0,0 +1,220 @@
+#include "AllocationTracker.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace
+{
+    // Everything here is constant-initialized, so allocations made during static initialization are counted too
+    struct ZoneSlot
+    {
+        std::atomic<const char*> zone{ nullptr };
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+    };
+
+    std::atomic<uint64_t> totalAllocations{ 0 };
+    std::atomic<uint64_t> totalBytes{ 0 };
+    std::array<ZoneSlot, AllocationTracker::MaxZones> zoneSlots;
+    ZoneSlot otherZones;
+
+    // Open addressing on the name pointer; zone names are literals, so one name is one pointer
+    ZoneSlot& SlotFor( const char* zone )
+    {
+        const auto hash = reinterpret_cast<uintptr_t>( zone ) >> 3;
+        for ( size_t probe = 0; probe < zoneSlots.size(); probe++ )
+        {
+            ZoneSlot& slot     = zoneSlots[( hash + probe ) % zoneSlots.size()];
+            const char* stored = slot.zone.load( std::memory_order_acquire );
+            if ( stored == zone )
+                return slot;
+            if ( stored == nullptr &&
+                 ( slot.zone.compare_exchange_strong( stored, zone, std::memory_order_acq_rel ) || stored == zone ) )
+                return slot;
+        }
+        return otherZones;
+    }
+
+    void* Allocate( const size_t size )
+    {
+        AllocationTracker::Record( size );
+        return std::malloc( size ? size : 1 );
+    }
+
+    void* AllocateAligned( const size_t size, const std::align_val_t alignment )
+    {
+        AllocationTracker::Record( size );
+        const auto align = static_cast<size_t>( alignment );
+#ifdef _MSC_VER
+        return _aligned_malloc( size ? size : 1, align );
+#else
+        return std::aligned_alloc( align, ( ( size ? size : 1 ) + align - 1 ) / align * align );
+#endif
+    }
+
+    void FreeAligned( void* pointer )
+    {
+#ifdef _MSC_VER
+        _aligned_free( pointer );
+#else
+        std::free( pointer );
+#endif
+    }
+} // namespace
+
+AllocationCounts AllocationTracker::Total()
+{
+    return { totalAllocations.load( std::memory_order_relaxed ), totalBytes.load( std::memory_order_relaxed ) };
+}
+
+void AllocationTracker::Sites( std::vector<AllocationSite>& sites )
+{
+    sites.clear();
+    const auto collect = [&sites]( const ZoneSlot& slot, const char* zone )
+    {
+        const uint64_t allocations = slot.allocations.load( std::memory_order_relaxed );
+        if ( zone && allocations > 0 )
+            sites.push_back( { zone, { allocations, slot.bytes.load( std::memory_order_relaxed ) } } );
+    };
+    for ( const ZoneSlot& slot : zoneSlots )
+        collect( slot, slot.zone.load( std::memory_order_acquire ) );
+    collect( otherZones, OtherZones );
+
+    std::sort( sites.begin(), sites.end(), []( const AllocationSite& a, const AllocationSite& b )
+               { return a.counts.allocations > b.counts.allocations; } );
+}
+
+void AllocationTracker::ResetSites()
+{
+    // Names stay, so a zone keeps its slot
+    for ( ZoneSlot& slot : zoneSlots )
+    {
+        slot.allocations.store( 0, std::memory_order_relaxed );
+        slot.bytes.store( 0, std::memory_order_relaxed );
+    }
+    otherZones.allocations.store( 0, std::memory_order_relaxed );
+    otherZones.bytes.store( 0, std::memory_order_relaxed );
+}
+
+void AllocationTracker::Record( const size_t bytes )
+{
+    totalAllocations.fetch_add( 1, std::memory_order_relaxed );
+    totalBytes.fetch_add( bytes, std::memory_order_relaxed );
+
+    const char* zone = Profiler::CurrentZone();
+    ZoneSlot& slot   = SlotFor( zone ? zone : OutsideZones );
+    slot.allocations.fetch_add( 1, std::memory_order_relaxed );
+    slot.bytes.fetch_add( bytes, std::memory_order_relaxed );
+}
+
+// Replacements for the global allocation functions; the remaining forms forward to these by the standard's rules
+void* operator new( const size_t size )
+{
+    if ( void* pointer = Allocate( size ) )
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[]( const size_t size )
+{
+    return operator new( size );
+}
+
+void* operator new( const size_t size, const std::nothrow_t& ) noexcept
+{
+    return Allocate( size );
+}
+
+void* operator new[]( const size_t size, const std::nothrow_t& ) noexcept
+{
+    return Allocate( size );
+}
+
+void* operator new( const size_t size, const std::align_val_t alignment )
+{
+    if ( void* pointer = AllocateAligned( size, alignment ) )
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[]( const size_t size, const std::align_val_t alignment )
+{
+    return operator new( size, alignment );
+}
+
+void* operator new( const size_t size, const std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+    return AllocateAligned( size, alignment );
+}
+
+void* operator new[]( const size_t size, const std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+    return AllocateAligned( size, alignment );
+}
+
+void operator delete( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer, size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, const std::nothrow_t& ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer, const std::nothrow_t& ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, std::align_val_t ) noexcept
+{
+    FreeAligned( pointer );
+}
+
+void operator delete[]( void* pointer, std::align_val_t ) noexcept
+{
+    FreeAligned( pointer );
+}
+
+void operator delete( void* pointer, size_t, std::align_val_t ) noexcept
+{
+    FreeAligned( pointer );
+}
+
+void operator delete[]( void* pointer, size_t, std::align_val_t ) noexcept
+{
+    FreeAligned( pointer );
+}
+
+void operator delete( void* pointer, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+    FreeAligned( pointer );
+}
+
+void operator delete[]( void* pointer, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+    FreeAligned( pointer );
+}
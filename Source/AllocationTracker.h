@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AllocationCounts
+{
+    uint64_t allocations = 0;
+    uint64_t bytes       = 0;
+};
+
+struct AllocationSite
+{
+    const char* zone = nullptr; // innermost PROFILE_ZONE, or OutsideZones
+    AllocationCounts counts;
+};
+
+// Counts every global operator new (AllocationTracker.cpp replaces them) and attributes it to the innermost profile
+// zone open on the allocating thread, so "who allocates in steady state" is answered by zone name. Counting is a few
+// relaxed atomics next to a malloc; it is always on.
+class AllocationTracker
+{
+  public:
+    static constexpr size_t MaxZones         = 128;
+    static constexpr const char* OutsideZones = "(outside zones)";
+    static constexpr const char* OtherZones   = "(zone table full)";
+
+    // Since process start, all threads
+    static AllocationCounts Total();
+
+    // Per zone since the last ResetSites(), most allocations first. Reuses the vector's capacity, so a HUD that
+    // lists sites every frame does not allocate itself.
+    static void Sites( std::vector<AllocationSite>& sites );
+
+    static void ResetSites();
+
+    // Called by the operator new replacements
+    static void Record( size_t bytes );
+};
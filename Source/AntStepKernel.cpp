@@ -0,0 +1,251 @@
+#include "AntStepKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float StopDistance    = 0.03f;
+    constexpr float ContactDistance = 0.005f; // how close an ant's centre comes to a rock edge
+
+    struct Float2
+    {
+        float x, y;
+    };
+
+    float Length( const Float2 v )
+    {
+        return std::sqrt( v.x * v.x + v.y * v.y );
+    }
+
+    Float2 Normalize( const Float2 v )
+    {
+        const float length = Length( v );
+        return { v.x / length, v.y / length };
+    }
+
+    float Saturate( const float v )
+    {
+        return std::clamp( v, 0.0f, 1.0f );
+    }
+
+    // Unit direction from a flow field slot at pos, bilinear between cell centres; zero where the field gives none
+    Float2 FlowDirection( const FlowFieldView& flow, const int slot, const Float2 pos )
+    {
+        const int size   = flow.gridSize;
+        const float cell = ObstacleGrid::WorldExtent / static_cast<float>( size );
+        const float gx   = std::clamp( ( pos.x - ObstacleGrid::WorldMin ) / cell - 0.5f, 0.0f, size - 1.0f );
+        const float gy   = std::clamp( ( pos.y - ObstacleGrid::WorldMin ) / cell - 0.5f, 0.0f, size - 1.0f );
+        const int x0     = std::min( static_cast<int>( gx ), size - 2 );
+        const int y0     = std::min( static_cast<int>( gy ), size - 2 );
+        const float fx   = gx - static_cast<float>( x0 );
+        const float fy   = gy - static_cast<float>( y0 );
+
+        const uint32_t* field = flow.directions + static_cast<size_t>( slot ) * size * size;
+        const auto at         = [field, size]( const int x, const int y )
+        {
+            const uint32_t packed = field[static_cast<size_t>( y ) * size + x];
+            return Float2{ static_cast<int16_t>( packed & 0xFFFF ) / 32767.0f,
+                           static_cast<int16_t>( packed >> 16 ) / 32767.0f };
+        };
+        const Float2 d00 = at( x0, y0 );
+        const Float2 d10 = at( x0 + 1, y0 );
+        const Float2 d01 = at( x0, y0 + 1 );
+        const Float2 d11 = at( x0 + 1, y0 + 1 );
+        const float bottomX = d00.x + ( d10.x - d00.x ) * fx;
+        const float bottomY = d00.y + ( d10.y - d00.y ) * fx;
+        const float topX    = d01.x + ( d11.x - d01.x ) * fx;
+        const float topY    = d01.y + ( d11.y - d01.y ) * fx;
+        return { bottomX + ( topX - bottomX ) * fy, bottomY + ( topY - bottomY ) * fy };
+    }
+
+    // Heading towards a target: down the slot's flow field while there is one and the target is more than two cells
+    // away, straight otherwise
+    Float2 Heading( const Float2 pos, const Float2 toTarget, const float distance, const int slot,
+                    const SimulationConstants& constants, const FlowFieldView& flow )
+    {
+        const Float2 straight = { toTarget.x / distance, toTarget.y / distance };
+        if ( slot < 0 || constants.flowGridSize == 0 || flow.gridSize != constants.flowGridSize )
+            return straight;
+        if ( distance <= 2.0f * ObstacleGrid::WorldExtent / static_cast<float>( constants.flowGridSize ) )
+            return straight;
+        const Float2 flowDir = FlowDirection( flow, slot, pos );
+        const float length   = Length( flowDir );
+        return length > 0.1f ? Float2{ flowDir.x / length, flowDir.y / length } : straight;
+    }
+
+    // Pushes a position closer than ContactDistance to a rock back out along the distance gradient, from one bilinear
+    // sample of the field. The push is along the edge normal, so an ant walking into a rock keeps the part of its step
+    // along the edge and slides round.
+    Float2 Collide( const Float2 pos, const SimulationConstants& constants, const DistanceFieldView& field )
+    {
+        if ( constants.distanceGridSize == 0 || field.gridSize != constants.distanceGridSize )
+            return pos;
+
+        const int size    = field.gridSize;
+        const float scale = static_cast<float>( size ) / DistanceField::WorldExtent; // cells per world unit
+        const float gx    = std::clamp( ( pos.x - DistanceField::WorldMin ) * scale - 0.5f, 0.0f, size - 1.0f );
+        const float gy    = std::clamp( ( pos.y - DistanceField::WorldMin ) * scale - 0.5f, 0.0f, size - 1.0f );
+        const int x0      = std::min( static_cast<int>( gx ), size - 2 );
+        const int y0      = std::min( static_cast<int>( gy ), size - 2 );
+        const float fx    = gx - static_cast<float>( x0 );
+        const float fy    = gy - static_cast<float>( y0 );
+
+        const float* bottomRow  = field.distances + static_cast<size_t>( y0 ) * size + x0;
+        const float* topRow     = bottomRow + size;
+        const float bottomSlope = bottomRow[1] - bottomRow[0];
+        const float topSlope    = topRow[1] - topRow[0];
+        const float bottom      = bottomRow[0] + bottomSlope * fx;
+        const float top         = topRow[0] + topSlope * fx;
+        const float distance    = bottom + ( top - bottom ) * fy;
+        if ( distance >= ContactDistance )
+            return pos;
+
+        // Gradient of the same bilinear patch, per world unit. The field holds true distances, so it is close to unit
+        // length and serves as the edge normal as it is; an ant it leaves short of ContactDistance gets the rest on
+        // the next step.
+        const float push = ( ContactDistance - distance ) * scale;
+        return { pos.x + ( bottomSlope + ( topSlope - bottomSlope ) * fy ) * push, pos.y + ( top - bottom ) * push };
+    }
+
+    // Lane-offset steering along a heading, pushed away from the hazard; both legs of the shader share it
+    Float2 Steer( const Float2 pos, const Float2 baseDir, const float distance, const InstanceData& ant,
+                  const SimulationConstants& constants )
+    {
+        const Float2 side = { -baseDir.y, baseDir.x };
+        const float amp   = ant.laneOffset * Saturate( distance / 0.2f ); // fade near the target
+        Float2 steer      = Normalize( { baseDir.x + side.x * amp, baseDir.y + side.y * amp } );
+        if ( constants.hazardActive != 0 )
+        {
+            const Float2 toHazard = { pos.x - constants.hazardPosX, pos.y - constants.hazardPosY };
+            const float dh        = Length( toHazard );
+            if ( dh < constants.hazardRadius && dh > 1e-5f )
+            {
+                const float push = Saturate( 1.0f - dh / constants.hazardRadius ) * 1.5f;
+                steer            = Normalize( { steer.x + toHazard.x / dh * push, steer.y + toHazard.y / dh * push } );
+            }
+        }
+        return steer;
+    }
+} // namespace
+
+void AntStepKernel::Run( const InstanceData* in, InstanceData* out, const size_t count,
+                         const SimulationConstants& constants, uint32_t* foodHits, uint32_t* nestHits,
+                         const FlowFieldView& flow, const DistanceFieldView& distance )
+{
+    const Float2 nest = { constants.nestPosX, constants.nestPosY };
+    for ( size_t id = 0; id < count; id++ )
+    {
+        const InstanceData& ant = in[id];
+        InstanceData& next      = out[id];
+        next                    = ant; // goal, hold timer, source, color, lane and speed carry over by default
+
+        const Float2 pos = { ant.posX, ant.posY };
+        Float2 dir       = { 0.0f, 0.0f };
+        Float2 newPos    = pos;
+        int newState     = ant.movementState;
+
+        if ( ant.movementState == 0 )
+        {
+            if ( constants.activeFoodIndex < 0 )
+            {
+                // No active food: head back to the nest from the next step on
+                newState   = 1;
+                next.goalX = nest.x;
+                next.goalY = nest.y;
+            }
+            else
+            {
+                const Float2 goal   = { ant.goalX, ant.goalY };
+                const Float2 toGoal = { goal.x - pos.x, goal.y - pos.y };
+                const float d       = Length( toGoal );
+                if ( d > 1e-5f )
+                {
+                    const bool known = ant.sourceIndex >= 0 &&
+                                       static_cast<size_t>( ant.sourceIndex ) < flow.foodSlotCount;
+                    const int slot   = known ? flow.foodSlots[ant.sourceIndex] : -1;
+                    const float step = std::min( d, constants.speed * ant.speedScale * constants.deltaTime );
+                    dir = Steer( pos, Heading( pos, toGoal, d, slot, constants, flow ), d, ant, constants );
+                    newPos           = { pos.x + dir.x * step, pos.y + dir.y * step };
+                }
+
+                if ( Length( { newPos.x - goal.x, newPos.y - goal.y } ) <= StopDistance )
+                {
+                    newState   = 1;
+                    next.goalX = nest.x;
+                    next.goalY = nest.y;
+                    if ( ant.sourceIndex >= 0 )
+                        foodHits[ant.sourceIndex]++;
+                }
+            }
+        }
+        else
+        {
+            const Float2 toNest  = { nest.x - pos.x, nest.y - pos.y };
+            const float distNest = Length( toNest );
+            if ( distNest > 1e-5f )
+            {
+                const float step = std::min( distNest, constants.speed * ant.speedScale * constants.deltaTime );
+                dir              = Steer( pos, Heading( pos, toNest, distNest, 0, constants, flow ), distNest, ant,
+                                          constants );
+                newPos           = { pos.x + dir.x * step, pos.y + dir.y * step };
+            }
+
+            newState = 1;
+            if ( distNest <= StopDistance )
+            {
+                // Deposit once; waiting at the nest must not score every step
+                if ( ant.sourceIndex >= 0 )
+                {
+                    nestHits[ant.sourceIndex]++;
+                    next.sourceIndex = -1;
+                }
+                next.goalX = nest.x;
+                next.goalY = nest.y;
+                if ( constants.activeFoodIndex >= 0 )
+                {
+                    // The hold timer only runs down while there is a target
+                    next.holdTimer = ant.holdTimer - constants.deltaTime;
+                    if ( next.holdTimer <= 0.0f )
+                    {
+                        newState         = 0;
+                        next.goalX       = constants.targetPosX;
+                        next.goalY       = constants.targetPosY;
+                        next.sourceIndex = constants.activeFoodIndex;
+                        next.holdTimer   = 0.0f;
+                    }
+                }
+            }
+        }
+
+        // After the arrival checks: rocks keep well clear of the nest and the food nodes, so the push never decides one
+        newPos             = Collide( newPos, constants, distance );
+        next.posX          = newPos.x;
+        next.posY          = newPos.y;
+        next.directionX    = dir.x;
+        next.directionY    = dir.y;
+        next.movementState = newState;
+    }
+}
+
+uint64_t HitCounts::AccumulateFood( const uint32_t* counts, const size_t nodes, const int bins, uint64_t* totals )
+{
+    uint64_t added = 0;
+    for ( size_t i = 0; i < nodes; ++i )
+    {
+        uint32_t sum = 0;
+        for ( int b = 0; b < bins; b++ )
+            sum += counts[i * static_cast<size_t>( bins ) + b];
+        totals[i] += sum;
+        added += sum;
+    }
+    return added;
+}
+
+uint64_t HitCounts::SumNest( const uint32_t* counts, const size_t nodes, const int bins )
+{
+    uint64_t total = 0;
+    for ( size_t i = 0; i < nodes * static_cast<size_t>( bins ); ++i )
+        total += counts[i];
+    return total;
+}
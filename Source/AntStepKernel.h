@@ -0,0 +1,34 @@
+#pragma once
+
+#include "DistanceField.h"
+#include "FlowField.h"
+#include "InstanceData.h"
+#include "ShaderConstants.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU mirror of FlockComputeShader.hlsl: the same per-ant state machine, one call per dispatch. The benchmarks time
+// it at colony sizes the GPU runs, and it is the reference to check against when the kernel changes; keep the two in
+// step, like DensityLod::SplatWeight.
+class AntStepKernel
+{
+  public:
+    // Steps count ants from in to out. Hits are counted per food node index, as the shader's InterlockedAdds do.
+    // With flow fields (flow.gridSize matching constants.flowGridSize) ants steer around obstacles by them; with a
+    // distance field (likewise against constants.distanceGridSize) they collide with the rocks and slide along them.
+    static void Run( const InstanceData* in, InstanceData* out, size_t count, const SimulationConstants& constants,
+                     uint32_t* foodHits, uint32_t* nestHits, const FlowFieldView& flow = {},
+                     const DistanceFieldView& distance = {} );
+};
+
+// The hit counters read back from the GPU hold HitBins counters per food node; these fold them back together
+class HitCounts
+{
+  public:
+    // Adds each node's food hits to its running total; returns the hits added over all nodes
+    static uint64_t AccumulateFood( const uint32_t* counts, size_t nodes, int bins, uint64_t* totals );
+
+    // Nest arrivals over the first nodes nodes
+    static uint64_t SumNest( const uint32_t* counts, size_t nodes, int bins );
+};
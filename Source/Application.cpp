@@ -45,7 +45,7 @@ int Application::run( HINSTANCE hInstance, int nCmdShow )
     }
 
     timeEndPeriod( 1 );
-    return 0;
+    return static_cast<int>( msg.wParam ); // PostQuitMessage code, e.g. 3 from --assert-no-alloc
 }
 
 LRESULT CALLBACK Application::staticWindowProc( HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam )
@@ -77,8 +77,8 @@ LRESULT Application::windowProc( HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
         {
             game_ = std::make_unique<Game::AntGame>( renderer_ );
             renderer_.SetGame( game_.get() );
+            // Also initializes the game, as one task of the startup graph
             renderer_.Init( hwnd, blockWidth_, blockHeight_ );
-            game_->initialize();
         }
         catch ( const std::exception& ex )
         {
@@ -0,0 +1,102 @@
+#include "AssetBundle.h"
+
+#include "Hash.h"
+
+#include <cstring>
+
+bool AssetBundle::Open( const std::filesystem::path& path )
+{
+    Close();
+    if ( !file_.Open( path ) )
+        return false;
+
+    if ( file_.Size() < sizeof( BundleHeader ) )
+    {
+        Close();
+        return false;
+    }
+
+    BundleHeader header;
+    std::memcpy( &header, file_.Data(), sizeof( header ) );
+    const uint64_t tableEnd = sizeof( BundleHeader ) + static_cast<uint64_t>( header.entryCount ) * sizeof( BundleEntry ) +
+                              header.nameTableSize;
+    if ( std::memcmp( header.magic, "ANTB", 4 ) != 0 || header.version != BundleVersion || tableEnd > file_.Size() )
+    {
+        Close();
+        return false;
+    }
+
+    entries_    = reinterpret_cast<const BundleEntry*>( file_.Data() + sizeof( BundleHeader ) );
+    names_      = reinterpret_cast<const char*>( entries_ + header.entryCount );
+    entryCount_ = header.entryCount;
+
+    if ( !Validate() )
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetBundle::Close()
+{
+    file_.Close();
+    entries_    = nullptr;
+    names_      = nullptr;
+    entryCount_ = 0;
+}
+
+bool AssetBundle::Validate() const
+{
+    const auto* header = reinterpret_cast<const BundleHeader*>( file_.Data() );
+    for ( uint32_t i = 0; i < entryCount_; i++ )
+    {
+        const BundleEntry& entry = entries_[i];
+        if ( static_cast<uint64_t>( entry.nameOffset ) + entry.nameLength > header->nameTableSize )
+            return false;
+        if ( entry.offset > file_.Size() || entry.size > file_.Size() - entry.offset )
+            return false;
+        if ( i > 0 && NameAt( i - 1 ) >= NameAt( i ) )
+            return false; // lookups binary search, so names must be sorted and unique
+    }
+    return true;
+}
+
+std::string_view AssetBundle::NameAt( const uint32_t index ) const
+{
+    return { names_ + entries_[index].nameOffset, entries_[index].nameLength };
+}
+
+const BundleEntry& AssetBundle::EntryAt( const uint32_t index ) const
+{
+    return entries_[index];
+}
+
+AssetSpan AssetBundle::Find( const std::string_view name ) const
+{
+    uint32_t lo = 0;
+    uint32_t hi = entryCount_;
+    while ( lo < hi )
+    {
+        const uint32_t mid = lo + ( hi - lo ) / 2;
+        const int order    = NameAt( mid ).compare( name );
+        if ( order == 0 )
+            return { file_.Data() + entries_[mid].offset, static_cast<size_t>( entries_[mid].size ) };
+        if ( order < 0 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return {};
+}
+
+bool AssetBundle::Verify() const
+{
+    for ( uint32_t i = 0; i < entryCount_; i++ )
+    {
+        const BundleEntry& entry = entries_[i];
+        if ( HashBytes( file_.Data() + entry.offset, static_cast<size_t>( entry.size ) ) != entry.contentHash )
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+using AssetSpan = std::span<const unsigned char>;
+
+// On-disk layout, little endian:
+//   BundleHeader | BundleEntry[entryCount] sorted by name | name table | blobs, each 16-byte aligned
+struct BundleHeader
+{
+    char magic[4]; // "ANTB"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t nameTableSize;
+};
+
+struct BundleEntry
+{
+    uint64_t contentHash; // HashBytes of the blob
+    uint64_t offset;      // from the start of the file
+    uint64_t size;
+    uint32_t nameOffset; // into the name table
+    uint32_t nameLength;
+};
+
+static_assert( sizeof( BundleHeader ) == 16 );
+static_assert( sizeof( BundleEntry ) == 32 );
+
+constexpr uint32_t BundleVersion   = 1;
+constexpr uint64_t BundleAlignment = 16;
+
+// Read side of the packed asset bundle. The file is memory-mapped once and every asset is handed out as a span into
+// the mapping, so nothing is copied; spans stay valid until the bundle is closed.
+class AssetBundle
+{
+  public:
+    // False when the file is missing or fails validation; the bundle is left closed
+    bool Open( const std::filesystem::path& path );
+    void Close();
+
+    bool IsOpen() const
+    {
+        return file_.IsOpen();
+    }
+
+    // Empty span when the name is not in the bundle
+    AssetSpan Find( std::string_view name ) const;
+
+    // Re-hashes every blob against the stored content hash
+    bool Verify() const;
+
+    uint32_t EntryCount() const
+    {
+        return entryCount_;
+    }
+    std::string_view NameAt( uint32_t index ) const;
+    const BundleEntry& EntryAt( uint32_t index ) const;
+    size_t MappedBytes() const
+    {
+        return file_.Size();
+    }
+
+  private:
+    bool Validate() const;
+
+    MappedFile file_;
+    const BundleEntry* entries_ = nullptr;
+    const char* names_          = nullptr;
+    uint32_t entryCount_        = 0;
+};
@@ -0,0 +1,81 @@
+#include "AssetBundleWriter.h"
+
+#include "AssetBundle.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+void AssetBundleWriter::Add( std::string name, std::vector<unsigned char> bytes )
+{
+    items_.push_back( { std::move( name ), std::move( bytes ) } );
+}
+
+bool AssetBundleWriter::AddFile( std::string name, const std::filesystem::path& path )
+{
+    std::ifstream input( path, std::ios::binary );
+    if ( !input.is_open() )
+        return false;
+
+    std::vector<unsigned char> bytes( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>() );
+    Add( std::move( name ), std::move( bytes ) );
+    return true;
+}
+
+void AssetBundleWriter::Write( const std::filesystem::path& path ) const
+{
+    std::vector<const Item*> sorted;
+    for ( const Item& item : items_ )
+        sorted.push_back( &item );
+    std::sort( sorted.begin(), sorted.end(), []( const Item* a, const Item* b ) { return a->name < b->name; } );
+    for ( size_t i = 1; i < sorted.size(); i++ )
+    {
+        if ( sorted[i - 1]->name == sorted[i]->name )
+            throw std::runtime_error( "Duplicate asset name: " + sorted[i]->name );
+    }
+
+    std::string names;
+    for ( const Item* item : sorted )
+        names += item->name;
+
+    BundleHeader header{};
+    std::memcpy( header.magic, "ANTB", 4 );
+    header.version       = BundleVersion;
+    header.entryCount    = static_cast<uint32_t>( sorted.size() );
+    header.nameTableSize = static_cast<uint32_t>( names.size() );
+
+    const auto align = []( const uint64_t value ) { return ( value + BundleAlignment - 1 ) & ~( BundleAlignment - 1 ); };
+
+    std::vector<BundleEntry> entries( sorted.size() );
+    uint64_t offset     = align( sizeof( BundleHeader ) + sizeof( BundleEntry ) * entries.size() + names.size() );
+    uint32_t nameOffset = 0;
+    for ( size_t i = 0; i < sorted.size(); i++ )
+    {
+        const Item& item       = *sorted[i];
+        entries[i].contentHash = HashBytes( item.bytes.data(), item.bytes.size() );
+        entries[i].offset      = offset;
+        entries[i].size        = item.bytes.size();
+        entries[i].nameOffset  = nameOffset;
+        entries[i].nameLength  = static_cast<uint32_t>( item.name.size() );
+        nameOffset += entries[i].nameLength;
+        offset = align( offset + item.bytes.size() );
+    }
+
+    std::vector<unsigned char> file( static_cast<size_t>( offset ), 0 );
+    std::memcpy( file.data(), &header, sizeof( header ) );
+    std::memcpy( file.data() + sizeof( header ), entries.data(), sizeof( BundleEntry ) * entries.size() );
+    std::memcpy( file.data() + sizeof( header ) + sizeof( BundleEntry ) * entries.size(), names.data(), names.size() );
+    for ( size_t i = 0; i < sorted.size(); i++ )
+    {
+        if ( !sorted[i]->bytes.empty() )
+            std::memcpy( file.data() + entries[i].offset, sorted[i]->bytes.data(), sorted[i]->bytes.size() );
+    }
+
+    std::ofstream output( path, std::ios::binary | std::ios::trunc );
+    if ( !output.is_open() ||
+         !output.write( reinterpret_cast<const char*>( file.data() ), static_cast<std::streamsize>( file.size() ) ) )
+        throw std::runtime_error( "Failed to write asset bundle: " + path.string() );
+}
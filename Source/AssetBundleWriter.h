@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Build side of AssetBundle, used by the asset packer tool
+class AssetBundleWriter
+{
+  public:
+    void Add( std::string name, std::vector<unsigned char> bytes );
+
+    // Reads the file and adds it under name; false when it cannot be read
+    bool AddFile( std::string name, const std::filesystem::path& path );
+
+    // Throws std::runtime_error on duplicate names or when the file cannot be written
+    void Write( const std::filesystem::path& path ) const;
+
+  private:
+    struct Item
+    {
+        std::string name;
+        std::vector<unsigned char> bytes;
+    };
+
+    std::vector<Item> items_;
+};
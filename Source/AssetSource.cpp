@@ -0,0 +1,57 @@
+#include "AssetSource.h"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    double MillisecondsSince( const std::chrono::steady_clock::time_point start )
+    {
+        return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    }
+} // namespace
+
+bool AssetSource::OpenBundle( const std::filesystem::path& path )
+{
+    const auto start  = std::chrono::steady_clock::now();
+    stats_.bundleOpen = bundle_.Open( path );
+    stats_.openMs     = MillisecondsSince( start );
+    return stats_.bundleOpen;
+}
+
+AssetSpan AssetSource::Get( const std::string_view name )
+{
+    const std::lock_guard lock( mutex_ );
+    const auto start = std::chrono::steady_clock::now();
+
+    AssetSpan bytes = bundle_.Find( name );
+    if ( !bytes.empty() )
+    {
+        stats_.bundleHits++;
+        stats_.bundleBytes += bytes.size();
+        stats_.loadMs += MillisecondsSince( start );
+        return bytes;
+    }
+
+    auto it = loose_.find( name );
+    if ( it == loose_.end() )
+    {
+        std::ifstream input( std::filesystem::path( name ), std::ios::binary );
+        if ( !input.is_open() )
+            return {};
+
+        std::vector<unsigned char> data( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>() );
+        stats_.looseReads++;
+        stats_.looseBytes += data.size();
+        it = loose_.emplace( std::string( name ), std::move( data ) ).first;
+    }
+
+    stats_.loadMs += MillisecondsSince( start );
+    return it->second;
+}
+
+void AssetSource::ReleaseLoose()
+{
+    loose_.clear();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "AssetBundle.h"
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct AssetSourceStats
+{
+    bool bundleOpen    = false;
+    size_t bundleHits  = 0; // served as spans into the mapping
+    size_t bundleBytes = 0;
+    size_t looseReads  = 0; // fell back to a file next to the exe
+    size_t looseBytes  = 0;
+    double openMs      = 0.0;
+    double loadMs      = 0.0; // accumulated time spent inside Get()
+};
+
+// Resolves asset names against the packed bundle first and loose files second, so a build without the bundle (or
+// one run with --loose-assets) still starts. Bundle assets are zero-copy; loose ones are read once and kept until
+// ReleaseLoose().
+class AssetSource
+{
+  public:
+    // Returns false when the bundle is missing or invalid; lookups then go to loose files only
+    bool OpenBundle( const std::filesystem::path& path );
+
+    // Empty span when the asset is neither in the bundle nor on disk. Safe to call from the startup tasks in parallel.
+    AssetSpan Get( std::string_view name );
+
+    void ReleaseLoose();
+
+    const AssetSourceStats& Stats() const
+    {
+        return stats_;
+    }
+    const AssetBundle& Bundle() const
+    {
+        return bundle_;
+    }
+
+  private:
+    AssetBundle bundle_;
+    std::map<std::string, std::vector<unsigned char>, std::less<>> loose_;
+    AssetSourceStats stats_;
+    std::mutex mutex_; // guards loose_ and stats_
+};
@@ -0,0 +1,302 @@
+#include "ByteCoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    enum PlaneMode : uint8_t
+    {
+        ConstantPlane, // every byte the same; the byte follows
+        RawPlane,      // coding would not make it smaller
+        RansPlane,     // frequency table, stream size, rANS stream
+    };
+
+    // Byte-wise rANS with 32-bit states (as in Fabian Giesen's rans_byte.h), two of them interleaved: symbols are coded
+    // last to first so the decoder reads them first to last
+    constexpr uint32_t ProbBits  = 12;
+    constexpr uint32_t ProbScale = 1u << ProbBits;
+    constexpr uint32_t RansLow   = 1u << 23;
+
+    // Encoder side of one symbol. x / freq is a multiply by a fixed-point reciprocal and a shift (rans_byte.h's
+    // RansEncSymbol): the division was most of the encode time.
+    struct RansSymbol
+    {
+        RansSymbol() = default;
+
+        RansSymbol( const uint32_t start, const uint32_t freq )
+            : xMax( ( ( RansLow >> ProbBits ) << 8 ) * freq ), complement( ProbScale - freq )
+        {
+            if ( freq < 2 )
+            {
+                // x / 1 is x: the largest reciprocal gives x - 1, which the bias puts back
+                reciprocal = ~0u;
+                shift      = 0;
+                bias       = start + ProbScale - 1;
+                return;
+            }
+            uint32_t bits = 0;
+            while ( freq > ( 1u << bits ) )
+                bits++;
+            reciprocal = static_cast<uint32_t>( ( ( uint64_t( 1 ) << ( bits + 31 ) ) + freq - 1 ) / freq );
+            shift      = bits - 1;
+            bias       = start;
+        }
+
+        // ( x / freq ) * ProbScale + x % freq + start, without the divide
+        uint32_t Encode( const uint32_t x ) const
+        {
+            const auto quotient = static_cast<uint32_t>( ( uint64_t( x ) * reciprocal ) >> 32 ) >> shift;
+            return x + bias + quotient * complement;
+        }
+
+        uint32_t xMax       = 0; // renormalize while x is at or above this
+        uint32_t reciprocal = 0;
+        uint32_t bias       = 0;
+        uint32_t complement = 0;
+        uint32_t shift      = 0;
+    };
+
+    // Scales symbol counts to frequencies summing to ProbScale, keeping every present symbol at 1 or more
+    void NormalizeFrequencies( const std::array<uint32_t, 256>& counts, const size_t total,
+                               std::array<uint32_t, 256>& freq )
+    {
+        uint32_t sum   = 0;
+        size_t largest = 0;
+        for ( size_t s = 0; s < 256; s++ )
+        {
+            freq[s] = counts[s] == 0
+                          ? 0
+                          : std::max<uint32_t>( 1, static_cast<uint32_t>( uint64_t( counts[s] ) * ProbScale / total ) );
+            sum += freq[s];
+            if ( freq[s] > freq[largest] )
+                largest = s;
+        }
+        if ( sum < ProbScale )
+            freq[largest] += ProbScale - sum;
+        while ( sum > ProbScale )
+        {
+            // Rounding up the rare symbols overshot; take it back from whichever symbol is largest now
+            const auto most = std::max_element( freq.begin(), freq.end() );
+            ( *most )--;
+            sum--;
+        }
+    }
+} // namespace
+
+void ByteCoder::PutVarint( std::vector<uint8_t>& out, uint64_t value )
+{
+    while ( value >= 0x80 )
+    {
+        out.push_back( static_cast<uint8_t>( value | 0x80 ) );
+        value >>= 7;
+    }
+    out.push_back( static_cast<uint8_t>( value ) );
+}
+
+void ByteCoder::PutSigned( std::vector<uint8_t>& out, const int64_t value )
+{
+    PutVarint( out, ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+}
+
+void ByteCoder::PutFloat( std::vector<uint8_t>& out, const float value )
+{
+    uint8_t bytes[sizeof( value )];
+    std::memcpy( bytes, &value, sizeof( value ) );
+    out.insert( out.end(), bytes, bytes + sizeof( value ) );
+}
+
+void ByteCoder::EncodePlane( const std::span<const uint8_t> plane, std::vector<uint8_t>& out,
+                             std::vector<uint8_t>& scratch )
+{
+    // Four tables, so runs of one byte (most of a residual plane) do not wait on the previous increment
+    std::array<uint32_t, 256> counts{};
+    std::array<uint32_t, 256> partial[3]{};
+    size_t i = 0;
+    for ( ; i + 4 <= plane.size(); i += 4 )
+    {
+        counts[plane[i]]++;
+        partial[0][plane[i + 1]]++;
+        partial[1][plane[i + 2]]++;
+        partial[2][plane[i + 3]]++;
+    }
+    for ( ; i < plane.size(); i++ )
+        counts[plane[i]]++;
+    for ( size_t s = 0; s < 256; s++ )
+        counts[s] += partial[0][s] + partial[1][s] + partial[2][s];
+    const size_t distinct = static_cast<size_t>( std::count_if( counts.begin(), counts.end(),
+                                                                []( const uint32_t c ) { return c > 0; } ) );
+    if ( distinct <= 1 )
+    {
+        out.push_back( ConstantPlane );
+        out.push_back( plane.empty() ? 0 : plane[0] );
+        return;
+    }
+
+    std::array<uint32_t, 256> freq{};
+    NormalizeFrequencies( counts, plane.size(), freq );
+    std::array<RansSymbol, 256> symbols;
+    for ( uint32_t s = 0, start = 0; s < 256; start += freq[s], s++ )
+        symbols[s] = RansSymbol( start, freq[s] );
+
+    // No symbol costs more than ProbBits bits, so this bounds the stream
+    scratch.resize( plane.size() * ProbBits / 8 + 16 );
+    uint8_t* const end = scratch.data() + scratch.size();
+    uint8_t* ptr       = end;
+    uint32_t x[2]      = { RansLow, RansLow }; // even and odd symbols, so the two dependency chains overlap
+    for ( size_t i = plane.size(); i-- > 0; )
+    {
+        const RansSymbol& symbol = symbols[plane[i]];
+        uint32_t& state          = x[i & 1];
+        while ( state >= symbol.xMax )
+        {
+            *--ptr = static_cast<uint8_t>( state );
+            state >>= 8;
+        }
+        state = symbol.Encode( state );
+    }
+    for ( int n = 1; n >= 0; n-- )
+    {
+        ptr -= 4;
+        for ( int b = 0; b < 4; b++ )
+            ptr[b] = static_cast<uint8_t>( x[n] >> ( b * 8 ) );
+    }
+    const auto streamBytes = static_cast<size_t>( end - ptr );
+
+    const size_t mark = out.size();
+    out.push_back( RansPlane );
+    uint8_t present[32] = {};
+    for ( size_t s = 0; s < 256; s++ )
+    {
+        if ( freq[s] > 0 )
+            present[s / 8] |= static_cast<uint8_t>( 1u << ( s % 8 ) );
+    }
+    out.insert( out.end(), present, present + sizeof( present ) );
+    for ( size_t s = 0; s < 256; s++ )
+    {
+        if ( freq[s] > 0 )
+            PutVarint( out, freq[s] );
+    }
+    PutVarint( out, streamBytes );
+    if ( out.size() - mark + streamBytes >= plane.size() + 1 )
+    {
+        out.resize( mark );
+        out.push_back( RawPlane );
+        out.insert( out.end(), plane.begin(), plane.end() );
+        return;
+    }
+    out.insert( out.end(), ptr, end );
+}
+
+ByteReader::ByteReader( const std::span<const uint8_t> bytes, const char* what ) : bytes_( bytes ), what_( what )
+{
+}
+
+std::span<const uint8_t> ByteReader::Take( const size_t count )
+{
+    if ( count > bytes_.size() - at_ )
+        Fail( "is cut short" );
+    const std::span<const uint8_t> taken = bytes_.subspan( at_, count );
+    at_ += count;
+    return taken;
+}
+
+uint8_t ByteReader::Byte()
+{
+    return Take( 1 )[0];
+}
+
+uint64_t ByteReader::Varint()
+{
+    uint64_t value = 0;
+    for ( int shift = 0; shift < 64; shift += 7 )
+    {
+        const uint8_t b = Byte();
+        value |= static_cast<uint64_t>( b & 0x7F ) << shift;
+        if ( !( b & 0x80 ) )
+            return value;
+    }
+    Fail( "has a malformed varint" );
+}
+
+int64_t ByteReader::Signed()
+{
+    const uint64_t zigzag = Varint();
+    return static_cast<int64_t>( zigzag >> 1 ) ^ -static_cast<int64_t>( zigzag & 1 );
+}
+
+float ByteReader::Float()
+{
+    float value;
+    std::memcpy( &value, Take( sizeof( value ) ).data(), sizeof( value ) );
+    return value;
+}
+
+void ByteReader::Plane( const size_t count, std::vector<uint8_t>& plane )
+{
+    plane.resize( count );
+    const uint8_t mode = Byte();
+    if ( mode == ConstantPlane )
+    {
+        std::fill( plane.begin(), plane.end(), Byte() );
+        return;
+    }
+    if ( mode == RawPlane )
+    {
+        const std::span<const uint8_t> bytes = Take( count );
+        std::copy( bytes.begin(), bytes.end(), plane.begin() );
+        return;
+    }
+    if ( mode != RansPlane )
+        Fail( "has an unknown plane" );
+
+    const std::span<const uint8_t> present = Take( 32 );
+    std::array<uint32_t, 256> freq{};
+    std::array<uint32_t, 256> start{};
+    std::array<uint8_t, ProbScale> symbolAt;
+    uint32_t sum = 0;
+    for ( size_t s = 0; s < 256; s++ )
+    {
+        if ( !( present[s / 8] & ( 1u << ( s % 8 ) ) ) )
+            continue;
+        freq[s] = static_cast<uint32_t>( Varint() );
+        if ( freq[s] == 0 || freq[s] > ProbScale - sum )
+            Fail( "has a bad frequency table" );
+        start[s] = sum;
+        std::fill_n( symbolAt.begin() + sum, freq[s], static_cast<uint8_t>( s ) );
+        sum += freq[s];
+    }
+    if ( sum != ProbScale )
+        Fail( "has a bad frequency table" );
+
+    const std::span<const uint8_t> stream = Take( Varint() );
+    if ( stream.size() < 8 )
+        Fail( "is cut short" );
+    uint32_t x[2] = {};
+    for ( int b = 0; b < 8; b++ )
+        x[b / 4] |= static_cast<uint32_t>( stream[b] ) << ( b % 4 * 8 );
+    const uint8_t* ptr = stream.data() + 8;
+    const uint8_t* end = stream.data() + stream.size();
+    for ( size_t i = 0; i < count; i++ )
+    {
+        uint32_t& state     = x[i & 1];
+        const uint32_t slot = state & ( ProbScale - 1 );
+        const uint8_t s     = symbolAt[slot];
+        plane[i]            = s;
+        state               = freq[s] * ( state >> ProbBits ) + slot - start[s];
+        while ( state < RansLow )
+        {
+            if ( ptr == end )
+                Fail( "is cut short" );
+            state = ( state << 8 ) | *ptr++;
+        }
+    }
+}
+
+void ByteReader::Fail( const char* problem ) const
+{
+    throw std::runtime_error( std::string( what_ ) + " " + problem );
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// The byte-level pieces of the spectator frames and trajectory chunks: LEB128 varints (zigzag for signed values),
+// raw floats, and byte planes coded on their own with static rANS. A plane where every byte is the same costs two
+// bytes, and one that would not get smaller is stored as it is.
+class ByteCoder
+{
+  public:
+    static void PutVarint( std::vector<uint8_t>& out, uint64_t value );
+    static void PutSigned( std::vector<uint8_t>& out, int64_t value );
+    static void PutFloat( std::vector<uint8_t>& out, float value );
+
+    // Appends the coded plane to out. scratch holds the rANS stream while it is built; keep it between calls so
+    // coding does not allocate.
+    static void EncodePlane( std::span<const uint8_t> plane, std::vector<uint8_t>& out, std::vector<uint8_t>& scratch );
+};
+
+// Reads what ByteCoder wrote. Throws std::runtime_error, naming what it was reading (e.g. "Spectator frame"), when
+// the bytes run out or do not parse.
+class ByteReader
+{
+  public:
+    ByteReader( std::span<const uint8_t> bytes, const char* what );
+
+    std::span<const uint8_t> Take( size_t count );
+    uint8_t Byte();
+    uint64_t Varint();
+    int64_t Signed();
+    float Float();
+
+    // Decodes a plane of count bytes into plane
+    void Plane( size_t count, std::vector<uint8_t>& plane );
+
+    [[noreturn]] void Fail( const char* problem ) const;
+
+  private:
+    std::span<const uint8_t> bytes_;
+    size_t at_        = 0;
+    const char* what_ = "";
+};
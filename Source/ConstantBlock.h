@@ -0,0 +1,35 @@
+#pragma once
+
+#include "RenderDevice.h"
+
+#include <cstring>
+
+// CPU shadow of one constant buffer. Update() uploads only when the new contents differ from what the GPU already
+// has, so blocks that rarely change cost nothing per draw. Callers must value-initialize T so padding compares equal.
+template <class T> class ConstantBlock
+{
+  public:
+    bool Update( RenderDevice& device, ID3D11Buffer* buffer, const T& data )
+    {
+        if ( valid_ && std::memcmp( &shadow_, &data, sizeof( T ) ) == 0 )
+        {
+            device.CountSkippedUpload( sizeof( T ) );
+            return false;
+        }
+
+        shadow_ = data;
+        valid_  = true;
+        device.UpdateSubresource( buffer, &data, sizeof( T ) );
+        return true;
+    }
+
+    // Forget the shadow, e.g. after the buffer was recreated
+    void Invalidate()
+    {
+        valid_ = false;
+    }
+
+  private:
+    T shadow_{};
+    bool valid_ = false;
+};
@@ -0,0 +1,90 @@
+#include "D3D11RenderDevice.h"
+
+D3D11RenderDevice::D3D11RenderDevice( ID3D11DeviceContext* context ) : context_( context )
+{
+}
+
+void D3D11RenderDevice::DoUpdateSubresource( ID3D11Buffer* buffer, const void* data, const UINT byteOffset,
+                                             const UINT byteCount, const bool wholeResource )
+{
+    if ( wholeResource )
+    {
+        context_->UpdateSubresource( buffer, 0, nullptr, data, 0, 0 );
+        return;
+    }
+
+    D3D11_BOX box{};
+    box.left   = byteOffset;
+    box.right  = byteOffset + byteCount;
+    box.top    = 0;
+    box.bottom = 1;
+    box.front  = 0;
+    box.back   = 1;
+    context_->UpdateSubresource( buffer, 0, &box, data, 0, 0 );
+}
+
+void D3D11RenderDevice::DoCopyResource( ID3D11Buffer* destination, ID3D11Buffer* source, UINT /*byteCount*/ )
+{
+    context_->CopyResource( destination, source );
+}
+
+void* D3D11RenderDevice::DoMap( ID3D11Buffer* buffer, const MapMode mode, UINT /*byteCount*/ )
+{
+    D3D11_MAP mapType = D3D11_MAP_READ;
+    if ( mode == MapMode::WriteDiscard )
+        mapType = D3D11_MAP_WRITE_DISCARD;
+    else if ( mode == MapMode::WriteNoOverwrite )
+        mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    if ( FAILED( context_->Map( buffer, 0, mapType, 0, &mapped ) ) )
+        return nullptr;
+    return mapped.pData;
+}
+
+void D3D11RenderDevice::DoUnmap( ID3D11Buffer* buffer )
+{
+    context_->Unmap( buffer, 0 );
+}
+
+void D3D11RenderDevice::DoBegin( ID3D11Query* query )
+{
+    context_->Begin( query );
+}
+
+void D3D11RenderDevice::DoEnd( ID3D11Query* query )
+{
+    context_->End( query );
+}
+
+bool D3D11RenderDevice::DoGetData( ID3D11Query* query, void* data, const UINT byteCount )
+{
+    return context_->GetData( query, data, byteCount, D3D11_ASYNC_GETDATA_DONOTFLUSH ) == S_OK;
+}
+
+void D3D11RenderDevice::DoDispatch( const UINT groupsX, const UINT groupsY, const UINT groupsZ )
+{
+    context_->Dispatch( groupsX, groupsY, groupsZ );
+}
+
+void D3D11RenderDevice::DoIASetVertexBuffer( const UINT slot, ID3D11Buffer* buffer, const UINT stride )
+{
+    constexpr UINT offset = 0;
+    context_->IASetVertexBuffers( slot, 1, &buffer, &stride, &offset );
+}
+
+void D3D11RenderDevice::DoIASetIndexBuffer( ID3D11Buffer* buffer )
+{
+    context_->IASetIndexBuffer( buffer, DXGI_FORMAT_R32_UINT, 0 );
+}
+
+void D3D11RenderDevice::DoDrawIndexedInstanced( const UINT indexCount, const UINT instanceCount, const UINT startIndex,
+                                                const INT baseVertex, const UINT startInstance )
+{
+    context_->DrawIndexedInstanced( indexCount, instanceCount, startIndex, baseVertex, startInstance );
+}
+
+void D3D11RenderDevice::DoDraw( const UINT vertexCount, const UINT startVertex )
+{
+    context_->Draw( vertexCount, startVertex );
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "RenderDevice.h"
+
+#include <d3d11.h>
+
+// Forwards RenderDevice calls to the immediate context
+class D3D11RenderDevice : public RenderDevice
+{
+  public:
+    explicit D3D11RenderDevice( ID3D11DeviceContext* context );
+
+  protected:
+    void DoUpdateSubresource( ID3D11Buffer* buffer, const void* data, UINT byteOffset, UINT byteCount,
+                              bool wholeResource ) override;
+    void DoCopyResource( ID3D11Buffer* destination, ID3D11Buffer* source, UINT byteCount ) override;
+    void* DoMap( ID3D11Buffer* buffer, MapMode mode, UINT byteCount ) override;
+    void DoUnmap( ID3D11Buffer* buffer ) override;
+    void DoBegin( ID3D11Query* query ) override;
+    void DoEnd( ID3D11Query* query ) override;
+    bool DoGetData( ID3D11Query* query, void* data, UINT byteCount ) override;
+    void DoDispatch( UINT groupsX, UINT groupsY, UINT groupsZ ) override;
+    void DoIASetVertexBuffer( UINT slot, ID3D11Buffer* buffer, UINT stride ) override;
+    void DoIASetIndexBuffer( ID3D11Buffer* buffer ) override;
+    void DoDrawIndexedInstanced( UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex,
+                                 UINT startInstance ) override;
+    void DoDraw( UINT vertexCount, UINT startVertex ) override;
+
+  private:
+    ID3D11DeviceContext* context_ = nullptr;
+};
@@ -0,0 +1,63 @@
+#include "DensityLod.h"
+
+DensityLodPasses DensityLod::ChoosePasses( LodMode mode, int antCount, const DensityLodSettings& settings )
+{
+    if ( mode == LodMode::SplatOnly )
+        return { LodMode::SplatOnly, true, false, true };
+
+    // Small colonies never pay for the density pass
+    if ( mode == LodMode::AntsOnly || antCount < settings.minAnts )
+        return { LodMode::AntsOnly, false, true, false };
+
+    return { LodMode::Auto, true, true, true };
+}
+
+float DensityLod::SplatWeight( unsigned int cellCount, LodMode mode, const DensityLodSettings& settings )
+{
+    if ( mode == LodMode::AntsOnly )
+        return 0.0f;
+
+    const float antsPerPixel =
+        static_cast<float>( cellCount ) / static_cast<float>( settings.cellPixels * settings.cellPixels );
+    if ( mode == LodMode::SplatOnly )
+        return antsPerPixel > 0.0f ? 1.0f : 0.0f;
+
+    float range = settings.endAntsPerPixel - settings.startAntsPerPixel;
+    if ( range < 1e-5f )
+        range = 1e-5f;
+
+    const float t = ( antsPerPixel - settings.startAntsPerPixel ) / range;
+    return t < 0.0f ? 0.0f : ( t > 1.0f ? 1.0f : t );
+}
+
+int DensityLod::GridCells( unsigned int pixels, const DensityLodSettings& settings )
+{
+    const int cells = ( static_cast<int>( pixels ) + settings.cellPixels - 1 ) / settings.cellPixels;
+    return cells > 0 ? cells : 1;
+}
+
+const char* DensityLod::ModeName( LodMode mode )
+{
+    switch ( mode )
+    {
+    case LodMode::AntsOnly:
+        return "Ants only";
+    case LodMode::SplatOnly:
+        return "Splat only";
+    default:
+        return "Auto";
+    }
+}
+
+LodMode DensityLod::NextMode( LodMode mode )
+{
+    switch ( mode )
+    {
+    case LodMode::Auto:
+        return LodMode::AntsOnly;
+    case LodMode::AntsOnly:
+        return LodMode::SplatOnly;
+    default:
+        return LodMode::Auto;
+    }
+}
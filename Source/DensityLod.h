@@ -0,0 +1,40 @@
+#pragma once
+
+// Level of detail for large colonies: above a density threshold ants are binned into a coarse
+// screen-space grid and drawn as one splat instead of one quad each.
+enum class LodMode
+{
+    Auto,      // per-cell blend between quads and splat
+    AntsOnly,  // always one quad per ant
+    SplatOnly, // always the density splat
+};
+
+struct DensityLodSettings
+{
+    int minAnts             = 20000; // below this the density pass is skipped entirely
+    int cellPixels          = 4;     // density grid cell edge in screen pixels
+    float startAntsPerPixel = 0.5f;  // splat starts to fade in
+    float endAntsPerPixel   = 2.0f;  // per-ant quads fully replaced
+};
+
+struct DensityLodPasses
+{
+    LodMode mode; // effective mode handed to the shaders
+    bool density; // bin ants into the grid
+    bool ants;    // per-ant instanced quads
+    bool splat;   // fullscreen density splat
+};
+
+class DensityLod
+{
+  public:
+    static DensityLodPasses ChoosePasses( LodMode mode, int antCount, const DensityLodSettings& settings );
+
+    // CPU mirror of SplatWeight() in the flock and splat shaders
+    static float SplatWeight( unsigned int cellCount, LodMode mode, const DensityLodSettings& settings );
+
+    static int GridCells( unsigned int pixels, const DensityLodSettings& settings );
+
+    static const char* ModeName( LodMode mode );
+    static LodMode NextMode( LodMode mode );
+};
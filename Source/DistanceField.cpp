@@ -0,0 +1,118 @@
+#include "DistanceField.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr size_t RowsPerTask = 8;
+
+    bool SameRock( const Rock& a, const Rock& b )
+    {
+        return a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.halfSize == b.halfSize;
+    }
+
+    // Signed distance from (x, y) to the edge of the rock's square
+    float RockDistance( const Rock& rock, const float x, const float y )
+    {
+        const float qx      = std::abs( x - rock.pos.x ) - rock.halfSize;
+        const float qy      = std::abs( y - rock.pos.y ) - rock.halfSize;
+        const float ox      = std::max( qx, 0.0f );
+        const float oy      = std::max( qy, 0.0f );
+        const float outside = std::sqrt( ox * ox + oy * oy );
+        return outside + std::min( std::max( qx, qy ), 0.0f );
+    }
+} // namespace
+
+DistanceField::DistanceField( const int size )
+    : size_( std::max( 2, size ) ), distances_( static_cast<size_t>( size_ ) * size_, Band )
+{
+}
+
+size_t DistanceField::Bake( const std::span<const Rock> rocks )
+{
+    // Called every step: the same rocks in the same order cost one compare and no allocation
+    if ( std::equal( rocks.begin(), rocks.end(), rocks_.begin(), rocks_.end(), SameRock ) )
+        return 0;
+
+    // Rocks that came or went; moving a rock is one of each
+    changed_.clear();
+    kept_.assign( rocks_.size(), 0 );
+    for ( const Rock& rock : rocks )
+    {
+        size_t match = 0;
+        while ( match < rocks_.size() && ( kept_[match] || !SameRock( rocks_[match], rock ) ) )
+            match++;
+        if ( match < rocks_.size() )
+            kept_[match] = 1;
+        else
+            changed_.push_back( rock );
+    }
+    for ( size_t i = 0; i < rocks_.size(); i++ )
+        if ( !kept_[i] )
+            changed_.push_back( rocks_[i] );
+    if ( changed_.empty() )
+    {
+        rocks_.assign( rocks.begin(), rocks.end() ); // only the order changed
+        return 0;
+    }
+
+    // Each changed rock dirties the cells within Band of it: one span of columns per row
+    const float scale = static_cast<float>( size_ ) / WorldExtent;
+    const auto first  = [this, scale]( const float world )
+    { return std::clamp( static_cast<int>( std::floor( ( world - WorldMin ) * scale - 0.5f ) ), 0, size_ - 1 ); };
+    const auto last = [this, scale]( const float world )
+    { return std::clamp( static_cast<int>( std::ceil( ( world - WorldMin ) * scale - 0.5f ) ), 0, size_ - 1 ); };
+    rowFirst_.assign( static_cast<size_t>( size_ ), size_ );
+    rowLast_.assign( static_cast<size_t>( size_ ), -1 );
+    for ( const Rock& rock : changed_ )
+    {
+        const float reach = rock.halfSize + Band;
+        const int x0      = first( rock.pos.x - reach );
+        const int x1      = last( rock.pos.x + reach );
+        for ( int y = first( rock.pos.y - reach ); y <= last( rock.pos.y + reach ); y++ )
+        {
+            rowFirst_[y] = std::min( rowFirst_[y], x0 );
+            rowLast_[y]  = std::max( rowLast_[y], x1 );
+        }
+    }
+    dirtyRows_.clear();
+    size_t cells = 0;
+    for ( int y = 0; y < size_; y++ )
+        if ( rowLast_[y] >= rowFirst_[y] )
+        {
+            dirtyRows_.push_back( y );
+            cells += static_cast<size_t>( rowLast_[y] - rowFirst_[y] + 1 );
+        }
+
+    rocks_.assign( rocks.begin(), rocks.end() );
+    const float cell = WorldExtent / static_cast<float>( size_ );
+    ForEachParallel( ( dirtyRows_.size() + RowsPerTask - 1 ) / RowsPerTask,
+                     [this, cell]( const size_t task )
+                     {
+                         std::vector<const Rock*> near;
+                         const size_t end = std::min( dirtyRows_.size(), ( task + 1 ) * RowsPerTask );
+                         for ( size_t i = task * RowsPerTask; i < end; i++ )
+                         {
+                             const int y    = dirtyRows_[i];
+                             const float cy = WorldMin + ( static_cast<float>( y ) + 0.5f ) * cell;
+                             // Only rocks within Band of the row can bring a distance under Band
+                             near.clear();
+                             for ( const Rock& rock : rocks_ )
+                                 if ( std::abs( cy - rock.pos.y ) < rock.halfSize + Band )
+                                     near.push_back( &rock );
+
+                             float* row = distances_.data() + static_cast<size_t>( y ) * size_;
+                             for ( int x = rowFirst_[y]; x <= rowLast_[y]; x++ )
+                             {
+                                 const float cx = WorldMin + ( static_cast<float>( x ) + 0.5f ) * cell;
+                                 float distance = Band;
+                                 for ( const Rock* rock : near )
+                                     distance = std::min( distance, RockDistance( *rock, cx, cy ) );
+                                 row[x] = std::max( distance, -Band );
+                             }
+                         }
+                     } );
+    return cells;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Rock.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Signed distance from every cell centre of a grid over the world square [-1, 1] x [-1, 1] to the nearest rock edge,
+// negative inside a rock. Ants collide with the rocks through it: one bilinear sample gives the distance and its
+// gradient, the way out, whatever the number of rocks (see AntStepKernel and FlockComputeShader.hlsl).
+//
+// Distances are clamped to [-Band, Band]. A rock then only reaches the cells within Band of it, which is what lets
+// Bake() redo just the cells around the rocks that came or went since the last bake. Band is deeper than the largest
+// rock's half plus the kernel's 0.005 contact distance, so no cell inside a rock is clamped: a clamped cell has no
+// gradient, and an ant sampling it would get no push out.
+class DistanceField
+{
+  public:
+    static constexpr int DefaultSize   = 256;
+    static constexpr float WorldMin    = -1.0f;
+    static constexpr float WorldExtent = 2.0f;
+    static constexpr float Band        = 0.09375f; // 12 cells at the default size
+
+    explicit DistanceField( int size = DefaultSize );
+
+    int Size() const
+    {
+        return size_;
+    }
+
+    size_t Cells() const
+    {
+        return distances_.size();
+    }
+
+    // No rocks: every distance is Band and ants need not sample the field
+    bool Empty() const
+    {
+        return rocks_.empty();
+    }
+
+    // Brings the field in line with the rocks. Only the cells within Band of a rock that was added or removed are
+    // computed again, spread over worker threads a few rows at a time. Returns the cells computed, 0 when the rocks
+    // are the ones last baked.
+    size_t Bake( std::span<const Rock> rocks );
+
+    std::span<const float> Distances() const
+    {
+        return distances_;
+    }
+
+  private:
+    int size_;
+    std::vector<float> distances_;
+    std::vector<Rock> rocks_; // as last baked
+    std::vector<Rock> changed_;
+    std::vector<uint8_t> kept_;
+    std::vector<int> rowFirst_;
+    std::vector<int> rowLast_;
+    std::vector<int> dirtyRows_;
+};
+
+static_assert( DistanceField::Band >= MaxRockHalfSize + 0.005f, "rock interiors would be clamped flat" );
+
+// Read-only view of a field for the step kernel, laid out as the flock shader's buffer
+struct DistanceFieldView
+{
+    int gridSize           = 0; // 0: no rocks, no collisions
+    const float* distances = nullptr;
+};
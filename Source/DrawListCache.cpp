@@ -0,0 +1,140 @@
+#include "DrawListCache.h"
+
+#include "Hash.h"
+
+#include <algorithm>
+
+DrawListCache::DrawListCache( const unsigned int vertexStride, const unsigned int indexStride )
+    : vertexStride_( vertexStride ), indexStride_( indexStride )
+{
+}
+
+uint64_t DrawListCache::Hash( const DrawListSlice& list, const unsigned int vertexStride,
+                              const unsigned int indexStride )
+{
+    uint64_t hash = HashBytes( list.vertices, static_cast<size_t>( list.vertexCount ) * vertexStride );
+    hash          = HashBytes( list.indices, static_cast<size_t>( list.indexCount ) * indexStride, hash );
+    return hash;
+}
+
+void DrawListCache::Reset()
+{
+    resident_.clear();
+    vertexCapacity_ = 0;
+    indexCapacity_  = 0;
+    vertexHead_     = 0;
+    indexHead_      = 0;
+}
+
+void DrawListCache::Plan( const std::vector<DrawListSlice>& lists )
+{
+    stats_     = {};
+    recreate_  = false;
+    discard_   = false;
+    anyUpload_ = false;
+
+    current_.resize( lists.size() );
+    placements_.resize( lists.size() );
+    reuse_.assign( lists.size(), -1 );
+
+    unsigned int totalVertices = 0;
+    unsigned int totalIndices  = 0;
+    unsigned int newVertices   = 0;
+    unsigned int newIndices    = 0;
+
+    for ( size_t n = 0; n < lists.size(); n++ )
+    {
+        Entry& entry      = current_[n];
+        entry.hash        = Hash( lists[n], vertexStride_, indexStride_ );
+        entry.vertexCount = lists[n].vertexCount;
+        entry.indexCount  = lists[n].indexCount;
+        totalVertices += entry.vertexCount;
+        totalIndices += entry.indexCount;
+
+        // Lists rarely reorder, so try the same slot first, then scan
+        for ( size_t k = 0; k < resident_.size() && reuse_[n] < 0; k++ )
+        {
+            const size_t r       = ( n + k ) % resident_.size();
+            const Entry& cached  = resident_[r];
+            const bool sameShape = cached.vertexCount == entry.vertexCount && cached.indexCount == entry.indexCount;
+            if ( sameShape && cached.hash == entry.hash )
+                reuse_[n] = static_cast<int>( r );
+        }
+
+        if ( reuse_[n] < 0 )
+        {
+            newVertices += entry.vertexCount;
+            newIndices += entry.indexCount;
+        }
+    }
+
+    // A ring only as big as the live lists has no room left for the changed ones, so it would restart, and upload
+    // every list again, nearly every frame. Keep room for MinHeadroom live sets, and grow while restarts still drop
+    // lists that could have been reused, up to MaxHeadroom. Fresh buffers hold nothing, so everything is uploaded
+    // again after a grow.
+    const bool full     = vertexHead_ + newVertices > vertexCapacity_ || indexHead_ + newIndices > indexCapacity_;
+    const bool reusable = std::any_of( reuse_.begin(), reuse_.end(), []( const int r ) { return r >= 0; } );
+    const bool tooSmall = vertexCapacity_ < totalVertices * MinHeadroom || indexCapacity_ < totalIndices * MinHeadroom;
+    const bool crowded  = full && reusable && ( vertexCapacity_ < totalVertices * MaxHeadroom ||
+                                                indexCapacity_ < totalIndices * MaxHeadroom );
+    if ( tooSmall || crowded )
+    {
+        // A crowded ring doubles once; the loops below always double at least to MinHeadroom live sets
+        const unsigned int wantVertices = std::max( totalVertices * MinHeadroom, crowded ? vertexCapacity_ + 1 : 0u );
+        const unsigned int wantIndices  = std::max( totalIndices * MinHeadroom, crowded ? indexCapacity_ + 1 : 0u );
+        while ( vertexCapacity_ < wantVertices || vertexCapacity_ < MinVertexCapacity )
+            vertexCapacity_ = vertexCapacity_ ? vertexCapacity_ * 2 : MinVertexCapacity;
+        while ( indexCapacity_ < wantIndices || indexCapacity_ < MinIndexCapacity )
+            indexCapacity_ = indexCapacity_ ? indexCapacity_ * 2 : MinIndexCapacity;
+        recreate_ = true;
+        stats_.grows++;
+    }
+
+    // Ring full: restart at zero with a discard, which drops every resident list
+    if ( recreate_ || full )
+    {
+        discard_ = true;
+        stats_.discards++;
+        vertexHead_ = 0;
+        indexHead_  = 0;
+        resident_.clear();
+        reuse_.assign( lists.size(), -1 );
+    }
+
+    for ( size_t n = 0; n < lists.size(); n++ )
+    {
+        Entry& entry       = current_[n];
+        const size_t bytes = static_cast<size_t>( entry.vertexCount ) * vertexStride_ +
+                             static_cast<size_t>( entry.indexCount ) * indexStride_;
+        if ( bytes == 0 )
+        {
+            entry.placement = {};
+        }
+        else if ( reuse_[n] >= 0 )
+        {
+            entry.placement        = resident_[static_cast<size_t>( reuse_[n] )].placement;
+            entry.placement.upload = false;
+            stats_.skippedBytes += bytes;
+            stats_.listsSkipped++;
+        }
+        else
+        {
+            entry.placement.vertexOffset = vertexHead_;
+            entry.placement.indexOffset  = indexHead_;
+            entry.placement.upload       = true;
+            vertexHead_ += entry.vertexCount;
+            indexHead_ += entry.indexCount;
+            stats_.uploadBytes += bytes;
+            stats_.listsUploaded++;
+            anyUpload_ = true;
+        }
+        placements_[n] = entry.placement;
+    }
+
+    // Everything placed since the last discard stays reusable until the ring restarts
+    for ( const Entry& entry : current_ )
+    {
+        if ( entry.placement.upload )
+            resident_.push_back( entry );
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One ImGui command list's geometry as seen by the cache
+struct DrawListSlice
+{
+    const void* vertices     = nullptr;
+    unsigned int vertexCount = 0;
+    const void* indices      = nullptr;
+    unsigned int indexCount  = 0;
+};
+
+// Where a list's geometry lives in the dynamic buffers this frame; upload is false when last frame's copy is reused
+struct DrawListPlacement
+{
+    unsigned int vertexOffset = 0; // in vertices
+    unsigned int indexOffset  = 0; // in indices
+    bool upload               = false;
+};
+
+struct DrawListCacheStats
+{
+    size_t uploadBytes  = 0;
+    size_t skippedBytes = 0; // bytes of unchanged lists that were not re-uploaded
+    int listsUploaded   = 0;
+    int listsSkipped    = 0;
+    int discards        = 0; // ring wrapped (or grew) and was mapped with WRITE_DISCARD
+    int grows           = 0;
+};
+
+// Decides how UI geometry goes into a pair of dynamic vertex/index buffers used as a ring. Lists whose contents hash
+// the same as a list placed since the last discard keep their old placement. Changed lists are appended after the
+// ring head (map with NO_OVERWRITE, since nothing in flight is touched). The ring only restarts with WRITE_DISCARD when
+// it is full. Capacity grows geometrically and is kept at two live sets or more, so several frames of changes fit
+// between restarts; a restart that drops lists which could have been reused grows it further, up to four live sets.
+// Platform-neutral: the renderer does the actual mapping.
+class DrawListCache
+{
+  public:
+    DrawListCache( unsigned int vertexStride, unsigned int indexStride );
+
+    // Plans one frame; Placements() lines up with lists
+    void Plan( const std::vector<DrawListSlice>& lists );
+
+    const std::vector<DrawListPlacement>& Placements() const
+    {
+        return placements_;
+    }
+
+    // The buffers must be (re)created at these capacities before writing
+    bool NeedsRecreate() const
+    {
+        return recreate_;
+    }
+    unsigned int VertexCapacity() const
+    {
+        return vertexCapacity_;
+    }
+    unsigned int IndexCapacity() const
+    {
+        return indexCapacity_;
+    }
+
+    // This frame writes after a restart of the ring; map with WRITE_DISCARD instead of NO_OVERWRITE
+    bool Discard() const
+    {
+        return discard_;
+    }
+    bool AnyUpload() const
+    {
+        return anyUpload_;
+    }
+
+    const DrawListCacheStats& Stats() const
+    {
+        return stats_;
+    }
+
+    // Forget every placement, e.g. after the buffers were released
+    void Reset();
+
+    static uint64_t Hash( const DrawListSlice& list, unsigned int vertexStride, unsigned int indexStride );
+
+  private:
+    struct Entry
+    {
+        uint64_t hash            = 0;
+        unsigned int vertexCount = 0;
+        unsigned int indexCount  = 0;
+        DrawListPlacement placement;
+    };
+
+    static constexpr unsigned int MinVertexCapacity = 4096;
+    static constexpr unsigned int MinIndexCapacity  = 8192;
+    static constexpr unsigned int MinHeadroom       = 2; // capacity in live sets, at least
+    static constexpr unsigned int MaxHeadroom       = 4; // and at most, when grown for restarts dropping lists
+
+    unsigned int vertexStride_;
+    unsigned int indexStride_;
+    unsigned int vertexCapacity_ = 0;
+    unsigned int indexCapacity_  = 0;
+    unsigned int vertexHead_     = 0;
+    unsigned int indexHead_      = 0;
+
+    std::vector<Entry> resident_; // lists placed since the last discard, still valid in the buffers
+    std::vector<Entry> current_;  // scratch for this frame
+    std::vector<DrawListPlacement> placements_;
+    std::vector<int> reuse_; // index into resident_ or -1
+
+    bool recreate_  = false;
+    bool discard_   = false;
+    bool anyUpload_ = false;
+    DrawListCacheStats stats_{};
+};
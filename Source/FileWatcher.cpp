@@ -0,0 +1,127 @@
+#include "FileWatcher.h"
+
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::filesystem::path DirectoryOf( const std::filesystem::path& path )
+    {
+        return path.has_parent_path() ? path.parent_path() : std::filesystem::path( "." );
+    }
+} // namespace
+
+FileWatcher::~FileWatcher()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool FileWatcher::Watch( const std::filesystem::path& path )
+{
+    Close();
+
+    // The notification fires for any file in the directory; Changed() tells this one apart by its write time
+    HANDLE notification = FindFirstChangeNotificationW(
+        DirectoryOf( path ).c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME );
+    if ( notification == INVALID_HANDLE_VALUE )
+        return false;
+
+    std::error_code error;
+    path_         = path;
+    notification_ = notification;
+    lastWrite_    = std::filesystem::last_write_time( path, error );
+    return true;
+}
+
+void FileWatcher::Close()
+{
+    if ( notification_ )
+        FindCloseChangeNotification( notification_ );
+    notification_ = nullptr;
+}
+
+bool FileWatcher::IsWatching() const
+{
+    return notification_ != nullptr;
+}
+
+bool FileWatcher::Changed()
+{
+    if ( !notification_ || WaitForSingleObject( notification_, 0 ) != WAIT_OBJECT_0 )
+        return false;
+    FindNextChangeNotification( notification_ );
+
+    std::error_code error;
+    const auto written = std::filesystem::last_write_time( path_, error );
+    if ( error || written == lastWrite_ )
+        return false;
+    lastWrite_ = written;
+    return true;
+}
+
+#else
+
+bool FileWatcher::Watch( const std::filesystem::path& path )
+{
+    Close();
+
+    const int fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if ( fd < 0 )
+        return false;
+    // Closed after writing, or renamed into place
+    if ( inotify_add_watch( fd, DirectoryOf( path ).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0 )
+    {
+        ::close( fd );
+        return false;
+    }
+    path_ = path;
+    fd_   = fd;
+    return true;
+}
+
+void FileWatcher::Close()
+{
+    if ( fd_ >= 0 )
+        ::close( fd_ );
+    fd_ = -1;
+}
+
+bool FileWatcher::IsWatching() const
+{
+    return fd_ >= 0;
+}
+
+bool FileWatcher::Changed()
+{
+    if ( fd_ < 0 )
+        return false;
+
+    const std::string name = path_.filename().string();
+    bool changed           = false;
+    alignas( inotify_event ) char events[4096];
+    for ( ;; )
+    {
+        const ssize_t size = ::read( fd_, events, sizeof( events ) );
+        if ( size <= 0 )
+            break;
+        for ( ssize_t at = 0; at < size; )
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>( events + at );
+            if ( event->len > 0 && std::strcmp( event->name, name.c_str() ) == 0 )
+                changed = true;
+            at += static_cast<ssize_t>( sizeof( inotify_event ) + event->len );
+        }
+    }
+    return changed;
+}
+
+#endif
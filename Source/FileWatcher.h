@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+
+// Tells, without blocking, when one file has been written. inotify on the file's directory elsewhere, a directory
+// change notification on Windows; either way an editor that saves by writing a new file and renaming it over the old
+// one counts as a write.
+class FileWatcher
+{
+  public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher( const FileWatcher& )            = delete;
+    FileWatcher& operator=( const FileWatcher& ) = delete;
+
+    // Stops any earlier watch; false when the file's directory cannot be watched
+    bool Watch( const std::filesystem::path& path );
+    void Close();
+
+    bool IsWatching() const;
+
+    const std::filesystem::path& Path() const
+    {
+        return path_;
+    }
+
+    // True once for any number of writes since the last call. Cheap enough to poll every frame.
+    bool Changed();
+
+  private:
+    std::filesystem::path path_;
+#ifdef _WIN32
+    void* notification_ = nullptr;
+    std::filesystem::file_time_type lastWrite_{};
+#else
+    int fd_ = -1;
+#endif
+};
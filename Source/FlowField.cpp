@@ -0,0 +1,412 @@
+#include "FlowField.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr float Infinity = std::numeric_limits<float>::infinity();
+    constexpr float Sqrt2    = 1.41421356f;
+
+    constexpr int NeighbourX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    constexpr int NeighbourY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+    enum Mark : uint8_t
+    {
+        Unknown = 0,
+        Valid,
+        Invalid,
+        Directed, // direction already refreshed by this repair
+    };
+
+    float CellCost( const ObstacleGrid& grid, const size_t cell )
+    {
+        return grid.Blocked( cell ) ? FlowField::WallCost : 1.0f;
+    }
+
+    // Cost of the step from (x, y) by (dx, dy); the same both ways, so distances to the target are distances from it
+    float StepCost( const ObstacleGrid& grid, const int x, const int y, const int dx, const int dy )
+    {
+        const int size = grid.Size();
+        const auto at  = [size]( const int cx, const int cy ) { return static_cast<size_t>( cy ) * size + cx; };
+        const float from = CellCost( grid, at( x, y ) );
+        const float to   = CellCost( grid, at( x + dx, y + dy ) );
+        if ( dx == 0 || dy == 0 )
+            return 0.5f * ( from + to );
+        // Past a corner: as dear as the dearest of the four cells it touches
+        const float side = std::max( CellCost( grid, at( x + dx, y ) ), CellCost( grid, at( x, y + dy ) ) );
+        return Sqrt2 * std::max( std::max( from, to ), side );
+    }
+} // namespace
+
+ObstacleGrid::ObstacleGrid( const int size )
+    : size_( std::max( 2, size ) ), cells_( static_cast<size_t>( size_ ) * size_ )
+{
+}
+
+size_t ObstacleGrid::CellAt( const float x, const float y ) const
+{
+    const float scale = static_cast<float>( size_ ) / WorldExtent;
+    const int cx      = std::clamp( static_cast<int>( std::floor( ( x - WorldMin ) * scale ) ), 0, size_ - 1 );
+    const int cy      = std::clamp( static_cast<int>( std::floor( ( y - WorldMin ) * scale ) ), 0, size_ - 1 );
+    return static_cast<size_t>( cy ) * size_ + cx;
+}
+
+void ObstacleGrid::Block( const Rock& rock )
+{
+    // Cells whose centre, at (i + 0.5) cells from WorldMin, lies within the square
+    const float scale = static_cast<float>( size_ ) / WorldExtent;
+    const auto first  = [this, scale]( const float v )
+    { return std::clamp( static_cast<int>( std::ceil( ( v - WorldMin ) * scale - 0.5f ) ), 0, size_ ); };
+    const auto last = [this, scale]( const float v )
+    { return std::clamp( static_cast<int>( std::floor( ( v - WorldMin ) * scale - 0.5f ) ), -1, size_ - 1 ); };
+
+    const int x0 = first( rock.pos.x - rock.halfSize );
+    const int x1 = last( rock.pos.x + rock.halfSize );
+    const int y0 = first( rock.pos.y - rock.halfSize );
+    const int y1 = last( rock.pos.y + rock.halfSize );
+    for ( int y = y0; y <= y1; y++ )
+    {
+        for ( int x = x0; x <= x1; x++ )
+        {
+            uint8_t& cell = cells_[static_cast<size_t>( y ) * size_ + x];
+            blocked_ += cell == 0 ? 1 : 0;
+            cell = 1;
+        }
+    }
+}
+
+void ObstacleGrid::Clear()
+{
+    std::fill( cells_.begin(), cells_.end(), uint8_t{ 0 } );
+    blocked_ = 0;
+}
+
+uint32_t FlowField::PackDirection( const float x, const float y )
+{
+    const auto snorm = []( const float v )
+    { return static_cast<uint16_t>( static_cast<int16_t>( std::lround( std::clamp( v, -1.0f, 1.0f ) * 32767.0f ) ) ); };
+    return static_cast<uint32_t>( snorm( x ) ) | static_cast<uint32_t>( snorm( y ) ) << 16;
+}
+
+void FlowField::Build( const ObstacleGrid& grid, const float targetX, const float targetY )
+{
+    size_   = grid.Size();
+    target_ = grid.CellAt( targetX, targetY );
+    distance_.assign( grid.Cells(), Infinity );
+    parent_.assign( grid.Cells(), static_cast<uint32_t>( target_ ) );
+    directions_.assign( grid.Cells(), 0 );
+
+    distance_[target_] = 0.0f;
+    heap_.clear();
+    heap_.push_back( { 0.0f, static_cast<uint32_t>( target_ ) } );
+    Search( grid );
+
+    for ( size_t cell = 0; cell < grid.Cells(); cell++ )
+        UpdateDirections( grid, cell );
+}
+
+size_t FlowField::Repair( const ObstacleGrid& grid, const std::span<const uint32_t> changed )
+{
+    const size_t cells = grid.Cells();
+    mark_.assign( cells, Unknown );
+
+    // A flipped cell changes the cost of every step that touches it, and every such step ends within one cell of it
+    for ( const uint32_t cell : changed )
+    {
+        const int x = static_cast<int>( cell % size_ );
+        const int y = static_cast<int>( cell / size_ );
+        for ( int ny = std::max( 0, y - 1 ); ny <= std::min( size_ - 1, y + 1 ); ny++ )
+        {
+            for ( int nx = std::max( 0, x - 1 ); nx <= std::min( size_ - 1, x + 1 ); nx++ )
+                mark_[static_cast<size_t>( ny ) * size_ + nx] = Invalid;
+        }
+    }
+    mark_[target_] = Valid;
+
+    // A route that runs through a cell near a flip is no longer known to be shortest; one walk up each route marks it
+    for ( size_t cell = 0; cell < cells; cell++ )
+    {
+        chain_.clear();
+        size_t at = cell;
+        while ( mark_[at] == Unknown )
+        {
+            chain_.push_back( static_cast<uint32_t>( at ) );
+            at = parent_[at];
+        }
+        for ( const uint32_t link : chain_ )
+            mark_[link] = mark_[at];
+    }
+
+    // Start the search over from the edge of what is still known
+    for ( size_t cell = 0; cell < cells; cell++ )
+    {
+        if ( mark_[cell] == Invalid )
+            distance_[cell] = Infinity;
+    }
+    heap_.clear();
+    for ( size_t cell = 0; cell < cells; cell++ )
+    {
+        if ( mark_[cell] != Invalid )
+            continue;
+        const int x = static_cast<int>( cell % size_ );
+        const int y = static_cast<int>( cell / size_ );
+        for ( int n = 0; n < 8; n++ )
+        {
+            const int nx = x + NeighbourX[n];
+            const int ny = y + NeighbourY[n];
+            if ( nx < 0 || ny < 0 || nx >= size_ || ny >= size_ )
+                continue;
+            const size_t neighbour = static_cast<size_t>( ny ) * size_ + nx;
+            if ( mark_[neighbour] != Valid )
+                continue;
+            const float distance = distance_[neighbour] + StepCost( grid, x, y, NeighbourX[n], NeighbourY[n] );
+            if ( distance < distance_[cell] )
+            {
+                distance_[cell] = distance;
+                parent_[cell]   = static_cast<uint32_t>( neighbour );
+            }
+        }
+        if ( distance_[cell] < Infinity )
+            heap_.push_back( { distance_[cell], static_cast<uint32_t>( cell ) } );
+    }
+    std::make_heap( heap_.begin(), heap_.end() );
+    Search( grid );
+
+    // Directions read the distances and step costs around a cell
+    for ( const uint32_t cell : reached_ )
+    {
+        const int x = static_cast<int>( cell % size_ );
+        const int y = static_cast<int>( cell / size_ );
+        for ( int ny = std::max( 0, y - 1 ); ny <= std::min( size_ - 1, y + 1 ); ny++ )
+        {
+            for ( int nx = std::max( 0, x - 1 ); nx <= std::min( size_ - 1, x + 1 ); nx++ )
+            {
+                const size_t neighbour = static_cast<size_t>( ny ) * size_ + nx;
+                if ( mark_[neighbour] == Directed )
+                    continue;
+                mark_[neighbour] = Directed;
+                UpdateDirections( grid, neighbour );
+            }
+        }
+    }
+    return reached_.size();
+}
+
+void FlowField::Search( const ObstacleGrid& grid )
+{
+    reached_.clear();
+    while ( !heap_.empty() )
+    {
+        std::pop_heap( heap_.begin(), heap_.end() );
+        const Entry entry = heap_.back();
+        heap_.pop_back();
+        if ( entry.distance > distance_[entry.cell] )
+            continue; // queued again since with a shorter route
+        reached_.push_back( entry.cell );
+
+        const int x = static_cast<int>( entry.cell % size_ );
+        const int y = static_cast<int>( entry.cell / size_ );
+        for ( int n = 0; n < 8; n++ )
+        {
+            const int nx = x + NeighbourX[n];
+            const int ny = y + NeighbourY[n];
+            if ( nx < 0 || ny < 0 || nx >= size_ || ny >= size_ )
+                continue;
+            const size_t neighbour = static_cast<size_t>( ny ) * size_ + nx;
+            const float distance   = entry.distance + StepCost( grid, x, y, NeighbourX[n], NeighbourY[n] );
+            if ( distance < distance_[neighbour] )
+            {
+                distance_[neighbour] = distance;
+                parent_[neighbour]   = entry.cell;
+                heap_.push_back( { distance, static_cast<uint32_t>( neighbour ) } );
+                std::push_heap( heap_.begin(), heap_.end() );
+            }
+        }
+    }
+}
+
+void FlowField::UpdateDirections( const ObstacleGrid& grid, const size_t cell )
+{
+    if ( cell == target_ )
+    {
+        directions_[cell] = 0;
+        return;
+    }
+
+    // Every downhill step, weighted by how steeply it descends, rather than only the steepest: the 8 grid directions
+    // blend into the true heading. Out in the open a step that would cross or clip a wall never counts.
+    const int x       = static_cast<int>( cell % size_ );
+    const int y       = static_cast<int>( cell / size_ );
+    const bool inRock = grid.Blocked( cell );
+    float gx          = 0.0f;
+    float gy          = 0.0f;
+    for ( int n = 0; n < 8; n++ )
+    {
+        const int nx = x + NeighbourX[n];
+        const int ny = y + NeighbourY[n];
+        if ( nx < 0 || ny < 0 || nx >= size_ || ny >= size_ )
+            continue;
+        const float drop = distance_[cell] - distance_[static_cast<size_t>( ny ) * size_ + nx];
+        if ( drop <= 0.0f )
+            continue;
+        const float length = ( NeighbourX[n] != 0 && NeighbourY[n] != 0 ) ? Sqrt2 : 1.0f;
+        if ( !inRock && StepCost( grid, x, y, NeighbourX[n], NeighbourY[n] ) > length )
+            continue;
+        const float slope = drop / length;
+        gx += slope * static_cast<float>( NeighbourX[n] ) / length;
+        gy += slope * static_cast<float>( NeighbourY[n] ) / length;
+    }
+
+    float length = std::sqrt( gx * gx + gy * gy );
+    if ( length < 1e-6f )
+    {
+        // Only the next cell of the route is downhill through a wall: follow the route
+        const size_t next = parent_[cell];
+        gx                = static_cast<float>( static_cast<int>( next % size_ ) - x );
+        gy                = static_cast<float>( static_cast<int>( next / size_ ) - y );
+        length            = std::sqrt( gx * gx + gy * gy );
+    }
+    directions_[cell] = length > 0.0f ? PackDirection( gx / length, gy / length ) : 0;
+}
+
+size_t FlowFields::Acquire( const ObstacleGrid& grid, const Vector2D& target, std::vector<size_t>& pending )
+{
+    const size_t cell = grid.CellAt( target.x, target.y );
+    for ( size_t i = 0; i < cache_.size(); i++ )
+    {
+        if ( cache_[i].cell == cell )
+        {
+            cache_[i].live = true;
+            return i;
+        }
+    }
+    Cached& added = cache_.emplace_back();
+    added.cell    = cell;
+    added.target  = target;
+    added.live    = true;
+    pending.push_back( cache_.size() - 1 );
+    return cache_.size() - 1;
+}
+
+bool FlowFields::Update( const ObstacleGrid& grid, const Vector2D& nest, const std::span<const FoodNode> food )
+{
+    if ( grid.Empty() )
+    {
+        const bool had = gridSize_ != 0;
+        gridSize_      = 0;
+        cache_.clear();
+        slots_.clear();
+        slotCells_.clear();
+        known_.clear();
+        directions_.clear();
+        foodSlots_.assign( food.size(), -1 );
+        return had;
+    }
+
+    bool changed = false;
+    if ( grid.Size() != gridSize_ )
+    {
+        gridSize_ = grid.Size();
+        cache_.clear();
+        known_.assign( grid.Data().begin(), grid.Data().end() );
+        changed = true;
+    }
+    else if ( !std::equal( known_.begin(), known_.end(), grid.Data().begin() ) )
+    {
+        changed_.clear();
+        for ( size_t cell = 0; cell < known_.size(); cell++ )
+        {
+            if ( known_[cell] != grid.Data()[cell] )
+                changed_.push_back( static_cast<uint32_t>( cell ) );
+        }
+        known_.assign( grid.Data().begin(), grid.Data().end() );
+
+        // Idle fields would need the same repair for a node that may never come back
+        std::erase_if( cache_, []( const Cached& cached ) { return !cached.live; } );
+        std::vector<size_t> repaired( cache_.size() );
+        ForEachParallel( cache_.size(),
+                         [this, &grid, &repaired]( const size_t i )
+                         { repaired[i] = cache_[i].field.Repair( grid, changed_ ); } );
+        for ( const size_t cells : repaired )
+            repairedCells_ += cells;
+        changed = true;
+    }
+
+    // Past the idle allowance, the fields idle the longest go first
+    size_t idle = 0;
+    for ( const Cached& cached : cache_ )
+        idle += cached.live ? 0 : 1;
+    for ( auto it = cache_.begin(); it != cache_.end() && idle > IdleFields; )
+    {
+        if ( !it->live )
+        {
+            it = cache_.erase( it );
+            idle--;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for ( Cached& cached : cache_ )
+        cached.live = false;
+    pending_.clear();
+    slots_.clear();
+    lastCells_.swap( slotCells_ );
+    slotCells_.clear();
+    lastFoodSlots_.swap( foodSlots_ );
+    foodSlots_.assign( food.size(), -1 );
+
+    const auto slotOf = [this]( const size_t index )
+    {
+        const auto found = std::find( slots_.begin(), slots_.end(), index );
+        if ( found != slots_.end() )
+            return static_cast<int32_t>( found - slots_.begin() );
+        slots_.push_back( index );
+        slotCells_.push_back( cache_[index].cell );
+        return static_cast<int32_t>( slots_.size() - 1 );
+    };
+    slotOf( Acquire( grid, nest, pending_ ) ); // slot 0
+    for ( size_t i = 0; i < food.size(); i++ )
+    {
+        if ( food[i].isActive )
+            foodSlots_[i] = slotOf( Acquire( grid, food[i].pos, pending_ ) );
+    }
+
+    ForEachParallel( pending_.size(),
+                     [this, &grid]( const size_t i )
+                     {
+                         Cached& cached = cache_[pending_[i]];
+                         cached.field.Build( grid, cached.target.x, cached.target.y );
+                     } );
+    builds_ += pending_.size();
+
+    changed = changed || !pending_.empty() || slotCells_ != lastCells_ || foodSlots_ != lastFoodSlots_;
+    if ( changed )
+    {
+        const size_t cells = grid.Cells();
+        directions_.resize( slots_.size() * cells );
+        for ( size_t slot = 0; slot < slots_.size(); slot++ )
+        {
+            const auto field = cache_[slots_[slot]].field.Directions();
+            std::copy( field.begin(), field.end(), directions_.begin() + static_cast<ptrdiff_t>( slot * cells ) );
+        }
+    }
+    return changed;
+}
+
+FlowFieldView FlowFields::View() const
+{
+    FlowFieldView view;
+    if ( gridSize_ == 0 )
+        return view;
+    view.gridSize      = gridSize_;
+    view.directions    = directions_.data();
+    view.foodSlots     = foodSlots_.data();
+    view.foodSlotCount = foodSlots_.size();
+    return view;
+}
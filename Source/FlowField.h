@@ -0,0 +1,211 @@
+#pragma once
+
+#include "FoodNode.h"
+#include "Rock.h"
+#include "Vector2D.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Static obstacles over the world square [-1, 1] x [-1, 1], one byte per cell, row-major from the bottom-left
+class ObstacleGrid
+{
+  public:
+    static constexpr int DefaultSize   = 128;
+    static constexpr float WorldMin    = -1.0f;
+    static constexpr float WorldExtent = 2.0f;
+
+    explicit ObstacleGrid( int size = DefaultSize );
+
+    int Size() const
+    {
+        return size_;
+    }
+
+    float CellSize() const
+    {
+        return WorldExtent / static_cast<float>( size_ );
+    }
+
+    size_t Cells() const
+    {
+        return cells_.size();
+    }
+
+    bool Blocked( const size_t cell ) const
+    {
+        return cells_[cell] != 0;
+    }
+
+    // No cell is blocked: ants can steer straight at their targets
+    bool Empty() const
+    {
+        return blocked_ == 0;
+    }
+
+    // The cell a world point falls in, clamped to the grid
+    size_t CellAt( float x, float y ) const;
+
+    // Blocks every cell whose centre lies inside the rock
+    void Block( const Rock& rock );
+    void Clear();
+
+    std::span<const uint8_t> Data() const
+    {
+        return cells_;
+    }
+
+  private:
+    int size_;
+    std::vector<uint8_t> cells_;
+    size_t blocked_ = 0;
+};
+
+// Shortest distances from every cell of an ObstacleGrid to one target cell, and the way downhill from each cell, for
+// ants to steer by instead of heading straight at the target. Built once with Dijkstra over the 8-connected grid, so
+// its cost is per cell, not per ant; after the grid changes, Repair() searches again only the cells whose shortest
+// route ran through a changed cell.
+//
+// Blocked cells are not left out of the search but cost WallCost per cell to cross. Every cell gets a finite distance
+// that way: an ant caught inside a rock is led out the short way, and a target that is walled in is still reached,
+// through the thinnest wall. A diagonal step past a blocked corner costs as much as crossing it, so routes do not
+// clip corners.
+class FlowField
+{
+  public:
+    static constexpr float WallCost = 1000.0f; // per cell, against 1 for a free one
+
+    // Full search from the cell the target falls in
+    void Build( const ObstacleGrid& grid, float targetX, float targetY );
+
+    // Brings the field up to date after the listed cells of grid flipped. Returns the cells searched again.
+    size_t Repair( const ObstacleGrid& grid, std::span<const uint32_t> changed );
+
+    size_t TargetCell() const
+    {
+        return target_;
+    }
+
+    // Route length from the cell to the target, in cells (crossed walls count WallCost each)
+    float Distance( const size_t cell ) const
+    {
+        return distance_[cell];
+    }
+
+    // Unit steering direction per cell as two snorm16 (x in the low half); zero at the target. The layout the flock
+    // shader samples.
+    std::span<const uint32_t> Directions() const
+    {
+        return directions_;
+    }
+
+    static uint32_t PackDirection( float x, float y );
+
+  private:
+    struct Entry
+    {
+        float distance;
+        uint32_t cell;
+
+        bool operator<( const Entry& other ) const
+        {
+            return distance > other.distance; // min-heap under std::push_heap
+        }
+    };
+
+    void Search( const ObstacleGrid& grid );
+    void UpdateDirections( const ObstacleGrid& grid, size_t cell );
+
+    int size_      = 0;
+    size_t target_ = 0;
+    std::vector<float> distance_;
+    std::vector<uint32_t> parent_; // next cell on the shortest route; the target is its own parent
+    std::vector<uint32_t> directions_;
+
+    // Search scratch, kept between calls so repairs do not allocate
+    std::vector<Entry> heap_;
+    std::vector<uint32_t> reached_; // cells whose distance the last search set
+    std::vector<uint8_t> mark_;
+    std::vector<uint32_t> chain_;
+};
+
+// Read-only view of a set of fields for the step kernel, laid out as the flock shader's buffers
+struct FlowFieldView
+{
+    int gridSize               = 0;       // 0: no obstacles, ants steer straight at their targets
+    const uint32_t* directions = nullptr; // slot-major, gridSize * gridSize per slot; slot 0 leads to the nest
+    const int32_t* foodSlots   = nullptr; // slot per food node index, -1 for none
+    size_t foodSlotCount       = 0;
+};
+
+// The fields a colony steers by: one to the nest and one per food node. Fields are keyed by their target cell, so
+// nodes that share a cell share a field, and a field no node asks for any more stays cached (up to IdleFields of
+// them) in case its node comes back. Fields are built on worker threads, one field per thread; when the grid changes,
+// live fields are repaired in place and idle ones dropped.
+class FlowFields
+{
+  public:
+    static constexpr size_t IdleFields = 16;
+
+    // Brings the fields in line with the grid and the targets. While the grid is empty there are no fields at all.
+    // Returns true when View() changed: a field was built or repaired, or slots moved.
+    bool Update( const ObstacleGrid& grid, const Vector2D& nest, std::span<const FoodNode> food );
+
+    FlowFieldView View() const;
+
+    // Slot per food node index, as passed to the last Update()
+    std::span<const int32_t> FoodSlots() const
+    {
+        return foodSlots_;
+    }
+
+    // Directions of every slot, back to back
+    std::span<const uint32_t> Directions() const
+    {
+        return directions_;
+    }
+
+    size_t Slots() const
+    {
+        return slots_.size();
+    }
+
+    // Fields built from scratch and cells searched again by repairs, over the whole run
+    uint64_t Builds() const
+    {
+        return builds_;
+    }
+
+    uint64_t RepairedCells() const
+    {
+        return repairedCells_;
+    }
+
+  private:
+    struct Cached
+    {
+        size_t cell = 0;
+        Vector2D target{};
+        FlowField field;
+        bool live = false;
+    };
+
+    // Cache index of the field for the target's cell, marked live; a new entry is queued on pending to be built
+    size_t Acquire( const ObstacleGrid& grid, const Vector2D& target, std::vector<size_t>& pending );
+
+    int gridSize_ = 0;
+    std::vector<uint8_t> known_; // the grid the fields were last brought up to
+    std::vector<Cached> cache_;
+    std::vector<size_t> slots_;     // cache index per slot
+    std::vector<size_t> slotCells_; // target cell per slot, to tell when slots moved
+    std::vector<size_t> lastCells_;
+    std::vector<int32_t> foodSlots_;
+    std::vector<int32_t> lastFoodSlots_;
+    std::vector<size_t> pending_;
+    std::vector<uint32_t> directions_;
+    std::vector<uint32_t> changed_;
+    uint64_t builds_        = 0;
+    uint64_t repairedCells_ = 0;
+};
@@ -0,0 +1,88 @@
+#include "FontData.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    bool KerningLess( const FontKerning& a, const FontKerning& b )
+    {
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    }
+} // namespace
+
+std::vector<unsigned char> FontData::Serialize( FontDescription description )
+{
+    std::sort( description.glyphs.begin(), description.glyphs.end(),
+               []( const FontGlyph& a, const FontGlyph& b ) { return a.codepoint < b.codepoint; } );
+    std::sort( description.kernings.begin(), description.kernings.end(), KerningLess );
+
+    FontFileHeader header{};
+    std::memcpy( header.magic, "ANTF", 4 );
+    header.version      = FontFileVersion;
+    header.lineHeight   = description.lineHeight;
+    header.base         = description.base;
+    header.scaleW       = description.scaleW;
+    header.scaleH       = description.scaleH;
+    header.glyphCount   = static_cast<uint32_t>( description.glyphs.size() );
+    header.kerningCount = static_cast<uint32_t>( description.kernings.size() );
+
+    const size_t glyphBytes   = sizeof( FontGlyph ) * description.glyphs.size();
+    const size_t kerningBytes = sizeof( FontKerning ) * description.kernings.size();
+    std::vector<unsigned char> bytes( sizeof( header ) + glyphBytes + kerningBytes );
+    std::memcpy( bytes.data(), &header, sizeof( header ) );
+    if ( glyphBytes > 0 )
+        std::memcpy( bytes.data() + sizeof( header ), description.glyphs.data(), glyphBytes );
+    if ( kerningBytes > 0 )
+        std::memcpy( bytes.data() + sizeof( header ) + glyphBytes, description.kernings.data(), kerningBytes );
+    return bytes;
+}
+
+bool FontData::Load( const std::span<const unsigned char> bytes )
+{
+    *this = FontData();
+    if ( bytes.size() < sizeof( FontFileHeader ) )
+        return false;
+
+    FontFileHeader header;
+    std::memcpy( &header, bytes.data(), sizeof( header ) );
+    const uint64_t required = sizeof( FontFileHeader ) + static_cast<uint64_t>( header.glyphCount ) * sizeof( FontGlyph ) +
+                              static_cast<uint64_t>( header.kerningCount ) * sizeof( FontKerning );
+    if ( std::memcmp( header.magic, "ANTF", 4 ) != 0 || header.version != FontFileVersion || required > bytes.size() ||
+         header.lineHeight == 0 || header.scaleW == 0 || header.scaleH == 0 )
+        return false;
+
+    const auto* glyphs   = reinterpret_cast<const FontGlyph*>( bytes.data() + sizeof( FontFileHeader ) );
+    const auto* kernings = reinterpret_cast<const FontKerning*>( glyphs + header.glyphCount );
+
+    header_   = header;
+    glyphs_   = { glyphs, header.glyphCount };
+    kernings_ = { kernings, header.kerningCount };
+
+    for ( uint32_t i = 0; i < header.glyphCount && i < UINT16_MAX; i++ )
+    {
+        if ( glyphs[i].codepoint < DirectCount )
+            direct_[glyphs[i].codepoint] = static_cast<uint16_t>( i + 1 );
+    }
+    return true;
+}
+
+const FontGlyph* FontData::Find( const uint32_t codepoint ) const
+{
+    if ( codepoint < DirectCount )
+        return direct_[codepoint] != 0 ? &glyphs_[direct_[codepoint] - 1] : nullptr;
+
+    const auto it = std::lower_bound( glyphs_.begin(), glyphs_.end(), codepoint,
+                                      []( const FontGlyph& glyph, uint32_t value ) { return glyph.codepoint < value; } );
+    return it != glyphs_.end() && it->codepoint == codepoint ? &*it : nullptr;
+}
+
+int FontData::Kerning( const uint32_t first, const uint32_t second ) const
+{
+    if ( kernings_.empty() )
+        return 0;
+
+    const FontKerning key{ first, second, 0 };
+    const auto it = std::lower_bound( kernings_.begin(), kernings_.end(), key, KerningLess );
+    return it != kernings_.end() && it->first == first && it->second == second ? it->amount : 0;
+}
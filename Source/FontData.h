@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Binary glyph table converted offline from a BMFont XML file (Tools/FontConverter.cpp). Laid out so a loaded file
+// (or bundle span) is used in place:
+//   FontFileHeader | FontGlyph[glyphCount] sorted by codepoint | FontKerning[kerningCount] sorted by pair
+struct FontFileHeader
+{
+    char magic[4]; // "ANTF"
+    uint32_t version;
+    uint16_t lineHeight; // BMFont <common> metrics, in atlas pixels
+    uint16_t base;
+    uint16_t scaleW; // atlas size
+    uint16_t scaleH;
+    uint32_t glyphCount;
+    uint32_t kerningCount;
+};
+
+struct FontGlyph
+{
+    uint32_t codepoint;
+    uint16_t x; // atlas rect
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    int16_t xOffset; // from the pen position to the rect's top-left
+    int16_t yOffset;
+    int16_t xAdvance;
+    uint16_t page;
+};
+
+struct FontKerning
+{
+    uint32_t first;
+    uint32_t second;
+    int32_t amount;
+};
+
+static_assert( sizeof( FontFileHeader ) == 24 );
+static_assert( sizeof( FontGlyph ) == 20 );
+static_assert( sizeof( FontKerning ) == 12 );
+
+constexpr uint32_t FontFileVersion = 1;
+
+// Everything the converter reads out of the XML; glyphs and kernings in any order
+struct FontDescription
+{
+    uint16_t lineHeight = 0;
+    uint16_t base       = 0;
+    uint16_t scaleW     = 0;
+    uint16_t scaleH     = 0;
+    std::vector<FontGlyph> glyphs;
+    std::vector<FontKerning> kernings;
+};
+
+class FontData
+{
+  public:
+    static std::vector<unsigned char> Serialize( FontDescription description );
+
+    // Points into bytes without copying, so they must outlive this object. False when the data is malformed.
+    bool Load( std::span<const unsigned char> bytes );
+
+    // nullptr when the font has no glyph for the codepoint
+    const FontGlyph* Find( uint32_t codepoint ) const;
+
+    // Extra advance between a pair, 0 when the pair is not kerned
+    int Kerning( uint32_t first, uint32_t second ) const;
+
+    const FontFileHeader& Header() const
+    {
+        return header_;
+    }
+    std::span<const FontGlyph> Glyphs() const
+    {
+        return glyphs_;
+    }
+    bool IsLoaded() const
+    {
+        return !glyphs_.empty();
+    }
+
+  private:
+    static constexpr uint32_t DirectCount = 128; // ASCII resolves without a search
+
+    FontFileHeader header_{};
+    std::span<const FontGlyph> glyphs_;
+    std::span<const FontKerning> kernings_;
+    uint16_t direct_[DirectCount]{}; // glyph index + 1, 0 when missing
+};
@@ -0,0 +1,157 @@
+#include "FrameHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+    constexpr double PrintedPercentiles[] = { 50.0, 90.0, 95.0, 99.0, 99.9, 99.99 };
+} // namespace
+
+FrameHistogram::FrameHistogram() : counts_( BucketCount, 0 )
+{
+}
+
+int FrameHistogram::IndexOf( const uint64_t micros )
+{
+    if ( micros < SubBuckets )
+        return static_cast<int>( micros );
+
+    // Shift that brings the value into [HalfBuckets, SubBuckets)
+    const int shift = static_cast<int>( std::bit_width( micros ) ) - SubBucketBits;
+    if ( shift > MaxShift )
+        return BucketCount - 1;
+    return SubBuckets + ( shift - 1 ) * HalfBuckets + static_cast<int>( ( micros >> shift ) - HalfBuckets );
+}
+
+uint64_t FrameHistogram::LowestOf( const int index )
+{
+    if ( index < SubBuckets )
+        return static_cast<uint64_t>( index );
+
+    const int shift    = ( index - SubBuckets ) / HalfBuckets + 1;
+    const uint64_t sub = static_cast<uint64_t>( ( index - SubBuckets ) % HalfBuckets + HalfBuckets );
+    return sub << shift;
+}
+
+uint64_t FrameHistogram::HighestOf( const int index )
+{
+    if ( index < SubBuckets )
+        return static_cast<uint64_t>( index );
+
+    const int shift = ( index - SubBuckets ) / HalfBuckets + 1;
+    return LowestOf( index ) + ( uint64_t{ 1 } << shift ) - 1;
+}
+
+void FrameHistogram::Record( const double ms )
+{
+    const uint64_t micros = ms > 0.0 ? static_cast<uint64_t>( std::llround( ms * 1000.0 ) ) : 0;
+    counts_[IndexOf( micros )]++;
+    count_++;
+    maxMicros_ = std::max( maxMicros_, micros );
+    sumMs_ += ms;
+}
+
+void FrameHistogram::Reset()
+{
+    std::fill( counts_.begin(), counts_.end(), 0 );
+    count_     = 0;
+    maxMicros_ = 0;
+    sumMs_     = 0.0;
+}
+
+double FrameHistogram::Percentile( const double percentile ) const
+{
+    if ( count_ == 0 )
+        return 0.0;
+
+    // Rank of the value at the percentile, at least the first one
+    const double clamped = std::clamp( percentile, 0.0, 100.0 );
+    const auto rank      = std::max<uint64_t>( 1, static_cast<uint64_t>( std::ceil( clamped / 100.0 * count_ ) ) );
+
+    uint64_t seen = 0;
+    for ( int i = 0; i < BucketCount; i++ )
+    {
+        seen += counts_[i];
+        if ( seen >= rank )
+            return static_cast<double>( std::min( HighestOf( i ), maxMicros_ ) ) / 1000.0;
+    }
+    return Max();
+}
+
+double FrameHistogram::Max() const
+{
+    return static_cast<double>( maxMicros_ ) / 1000.0;
+}
+
+double FrameHistogram::Mean() const
+{
+    return count_ > 0 ? sumMs_ / static_cast<double>( count_ ) : 0.0;
+}
+
+void FrameHistogram::WriteBuckets( std::ostream& out, const std::string_view name ) const
+{
+    for ( int i = 0; i < BucketCount; i++ )
+    {
+        if ( counts_[i] > 0 )
+            out << name << ',' << LowestOf( i ) << ',' << HighestOf( i ) << ',' << counts_[i] << '\n';
+    }
+}
+
+void FrameTimings::Record( const FramePhase phase, const double ms )
+{
+    histograms_[static_cast<size_t>( phase )].Record( ms );
+}
+
+void FrameTimings::Reset()
+{
+    for ( FrameHistogram& histogram : histograms_ )
+        histogram.Reset();
+}
+
+const char* FrameTimings::Name( const FramePhase phase )
+{
+    switch ( phase )
+    {
+    case FramePhase::Frame:
+        return "frame";
+    case FramePhase::Simulation:
+        return "simulation";
+    case FramePhase::Readback:
+        return "readback";
+    case FramePhase::UiBuild:
+        return "ui_build";
+    case FramePhase::Present:
+        return "present";
+    default:
+        return "unknown";
+    }
+}
+
+bool FrameTimings::WriteFile( const char* path ) const
+{
+    std::ofstream out( path, std::ios::trunc );
+    if ( !out )
+        return false;
+
+    out << "# phase,count,mean_ms,max_ms";
+    for ( const double percentile : PrintedPercentiles )
+        out << ",p" << percentile;
+    out << '\n';
+    for ( size_t i = 0; i < histograms_.size(); i++ )
+    {
+        const FrameHistogram& histogram = histograms_[i];
+        out << "# " << Name( static_cast<FramePhase>( i ) ) << ',' << histogram.Count() << ',' << histogram.Mean()
+            << ',' << histogram.Max();
+        for ( const double percentile : PrintedPercentiles )
+            out << ',' << histogram.Percentile( percentile );
+        out << '\n';
+    }
+
+    out << "phase,low_us,high_us,count\n";
+    for ( size_t i = 0; i < histograms_.size(); i++ )
+        histograms_[i].WriteBuckets( out, Name( static_cast<FramePhase>( i ) ) );
+    return static_cast<bool>( out );
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Durations in whole microseconds on an HdrHistogram-style log-linear scale: exact below SubBuckets, then every
+// power of two is split into SubBuckets / 2 linear buckets, so a reported value is within 1/128 (0.8%) of what was
+// recorded. Recording is an index computation and an increment; nothing is ever dropped or averaged away.
+class FrameHistogram
+{
+  public:
+    static constexpr int SubBucketBits = 8;
+    static constexpr int SubBuckets    = 1 << SubBucketBits;
+    static constexpr int HalfBuckets   = SubBuckets / 2;
+    static constexpr int MaxShift      = 24; // values up to 2^32 us (about 71 minutes); larger ones are clamped
+    static constexpr int BucketCount   = SubBuckets + MaxShift * HalfBuckets;
+
+    FrameHistogram();
+
+    void Record( double ms );
+    void Reset();
+
+    uint64_t Count() const
+    {
+        return count_;
+    }
+
+    // Highest value equivalent to the bucket holding the given percentile (0..100), in milliseconds
+    double Percentile( double percentile ) const;
+    double Max() const;
+    double Mean() const;
+
+    // Non-empty buckets as "name,low_us,high_us,count" rows
+    void WriteBuckets( std::ostream& out, std::string_view name ) const;
+
+    static int IndexOf( uint64_t micros );
+    static uint64_t LowestOf( int index );
+    static uint64_t HighestOf( int index );
+
+  private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_     = 0;
+    uint64_t maxMicros_ = 0;
+    double sumMs_       = 0.0;
+};
+
+// The frame and the phases it is made of, one histogram each
+enum class FramePhase
+{
+    Frame,      // paint to paint
+    Simulation, // game step (on the simulation thread when pipelined)
+    Readback,   // hit-count readback copies and maps
+    UiBuild,    // ImGui frame, overlays and HUD
+    Present,    // ImGui submit and swap chain present
+    Count
+};
+
+class FrameTimings
+{
+  public:
+    void Record( FramePhase phase, double ms );
+    void Reset();
+
+    const FrameHistogram& Get( FramePhase phase ) const
+    {
+        return histograms_[static_cast<size_t>( phase )];
+    }
+
+    static const char* Name( FramePhase phase );
+
+    // Percentile summary followed by the raw buckets of every phase, so two runs can be diffed or re-plotted
+    bool WriteFile( const char* path ) const;
+
+  private:
+    std::array<FrameHistogram, static_cast<size_t>( FramePhase::Count )> histograms_;
+};
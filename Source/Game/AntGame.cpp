@@ -1,61 +1,240 @@
 #include "AntGame.h"
+#include "GameRules.h"
+#include "GameStateFile.h"
 
 #include "InstancedRendererEngine2D.h"
+#include "Metrics.h"
+#include "Profiler.h"
 #include "Utilities.h"
 #include "imgui.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cwchar>
 #include <fstream>
 #include <random>
+#include <sstream>
 
 using namespace Game;
 
-AntGame::AntGame( InstancedRendererEngine2D& renderer ) : renderer_( renderer )
+AntGame::AntGame( InstancedRendererEngine2D& renderer )
+    : renderer_( renderer ), pipeline_( [this]( const FrameInput& input, WorldSnapshot& out ) { step( input, out ); } )
 {
 }
 
-void AntGame::initialize()
+AntGame::~AntGame()
 {
-    renderer_.SetGame( this );
-    loadSettings();
+    pipeline_.Stop();
+}
 
-    // Prewarm instance storage with a reasonable capacity
-    state_.instances.clear();
-    state_.instances.reserve( 1024 );
-    const int initialCount = 1024;
-    for ( int i = 0; i < initialCount; ++i )
+void AntGame::initialize()
+{
+    FrameInput first;
     {
-        InstanceData instance{};
-        instance.posX       = state_.nestPos.x;
-        instance.posY       = state_.nestPos.y;
-        instance.goalX      = state_.nestPos.x;
-        instance.goalY      = state_.nestPos.y;
-        instance.laneOffset = 0.1f;
-        instance.speedScale = 1.0f;
-        instance.color = DirectX::XMFLOAT4( 1.0f, 1.0f, 1.0f, 1.0f );
-        instance.movementState = 0;
-        instance.sourceIndex   = -1;
-        instance.holdTimer     = 0.0f;
-        state_.instances.emplace_back( instance );
+        // Runs on a startup worker (the renderer's init task graph); the game is handed to the renderer first thing,
+        // so state_ is set up under the lock like any other entry point's
+        std::lock_guard<std::mutex> lock( mutex_ );
+        renderer_.SetGame( this );
+        loadSettings();
+        // From before the first step, with the settings just loaded, so a replay starts from the same state
+        if ( wcsstr( GetCommandLineW(), L"--record" ) )
+            recorder_.open( RecordFile, settingsText( state_ ) );
+
+        // Instance storage grows with the colony instead of being prewarmed; this is the starting size
+        state_.instances.clear();
+        ensureInstances( state_.initialAnts );
+        // A few overlapping bursts, so confetti does not allocate during play
+        state_.partyParticles.reserve( 512 );
+
+        view_ = renderer_.View();
+
+        resetGame();
+        startStage( 1 );
+        first.view = view_;
     }
 
-    renderer_.InitializeSimulationBuffers( state_.instances );
+    // The first snapshot is produced here, so the first frame already has the GPU buffers to create. The step takes
+    // the lock itself. --single-thread keeps the step inline in the paint handler, for debugging and for comparison.
+    // Scenario runs and replays step inline too, so the same run always steps on the same inputs.
+    const wchar_t* flags = GetCommandLineW();
+    const bool threaded  = !wcsstr( flags, L"--single-thread" ) && !wcsstr( flags, L"--scenario" ) &&
+                          !wcsstr( flags, L"--replay" );
+    pipeline_.Start( first, threaded );
+}
+
+const WorldSnapshot& AntGame::beginFrame( const FrameInput& input )
+{
+    return pipeline_.Advance( input );
+}
 
-    resetGame();
-    startStage( 1 );
+SimulationPipelineStats AntGame::pipelineStats() const
+{
+    return pipeline_.Stats();
 }
 
-void AntGame::update( double dt )
+void AntGame::step( const FrameInput& input, WorldSnapshot& out )
 {
+    PROFILE_ZONE( "AntGame::step" );
+    const auto start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock( mutex_ );
+    pollSettingsFile();
+    view_           = input.view;
+    const double dt = max( 0.0, input.time - simTime_ );
+    simTime_        = input.time;
+    recorder_.step( input, dt, foodHitsSeen_, nestHitsSeen_ );
+
     updateGameLogic( dt );
+    applyHits( input );
+    updateFlowFields();
+    updateDistanceField();
+
+    static Metric& pendingSpawns = Metrics::Gauge( "ants.pendingSpawns" );
+    static Metric& particles     = Metrics::Gauge( "party.particles" );
+    pendingSpawns.Set( static_cast<int64_t>( state_.pendingSpawns.size() ) );
+    particles.Set( static_cast<int64_t>( state_.partyParticles.size() ) );
+
+    publish( out );
+    out.stepMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+}
+
+void AntGame::applyHits( const FrameInput& input )
+{
+    PROFILE_ZONE( "AntGame::applyHits" );
+    // Food taken from each node since the last step; totals are per node index, like the GPU hit bins
+    for ( size_t i = 0; i < state_.foodNodes.size() && i < input.foodHits.size(); ++i )
+    {
+        const uint64_t taken = input.foodHits[i] - foodHitsSeen_[i];
+        if ( taken > 0 )
+            state_.foodNodes[i].amount = max( 0.0f, state_.foodNodes[i].amount - static_cast<float>( taken ) );
+    }
+    foodHitsSeen_ = input.foodHits;
+
+    const uint64_t delivered = input.nestHits - nestHitsSeen_;
+    nestHitsSeen_            = input.nestHits;
+    if ( delivered == 0 )
+        return;
+
+    // Combo handling
+    if ( state_.sinceLastDeposit < 0.5 )
+        state_.combo = min( 5, state_.combo + 1 );
+    else
+        state_.combo = 1;
+    state_.sinceLastDeposit = 0.0;
+    const int add           = static_cast<int>( delivered ) * state_.combo;
+    state_.score += add;
+    state_.stageScore += add;
+}
+
+void AntGame::publish( WorldSnapshot& out )
+{
+    PROFILE_ZONE( "AntGame::publish" );
+    // Copy everything but the instance array, which the GPU owns between uploads
+    std::vector<InstanceData> instances = std::move( state_.instances );
+    out.state                           = state_;
+    state_.instances                    = std::move( instances );
+
+    out.sequence      = ++steps_;
+    out.instanceCount = static_cast<int>( state_.instances.size() );
+
+    out.uploads.recreate = uploads_.recreate;
+    out.uploads.full     = uploads_.full;
+    out.uploads.slots.swap( uploads_.slots );
+    if ( uploads_.recreate || uploads_.full )
+        out.uploads.instances = state_.instances;
+    else
+        out.uploads.instances.clear();
+
+    uploads_.recreate = false;
+    uploads_.full     = false;
+    uploads_.slots.clear();
+
+    out.flow.changed = flowChanged_;
+    if ( flowChanged_ )
+    {
+        const auto foodSlots = flowFields_.FoodSlots();
+        out.flow.gridSize    = flowFields_.View().gridSize;
+        out.flow.directions.assign( flowFields_.Directions().begin(), flowFields_.Directions().end() );
+        out.flow.foodSlots.assign( MaxFoodNodes, -1 );
+        std::copy_n( foodSlots.begin(), min( foodSlots.size(), static_cast<size_t>( MaxFoodNodes ) ),
+                     out.flow.foodSlots.begin() );
+        flowChanged_ = false;
+    }
+
+    out.distance.changed = distanceChanged_;
+    if ( distanceChanged_ )
+    {
+        out.distance.gridSize = distanceField_.Empty() ? 0 : distanceField_.Size();
+        if ( distanceField_.Empty() )
+            out.distance.distances.clear();
+        else
+            out.distance.distances.assign( distanceField_.Distances().begin(), distanceField_.Distances().end() );
+        distanceChanged_ = false;
+    }
+}
+
+void AntGame::uploadAll( const bool recreate )
+{
+    // Sent whole from the array as of the end of the step, which already holds any earlier slot writes
+    uploads_.recreate = uploads_.recreate || recreate;
+    uploads_.full     = true;
+    uploads_.slots.clear();
+}
+
+void AntGame::ensureInstances( const int count )
+{
+    const int size = static_cast<int>( state_.instances.size() );
+    if ( count <= size )
+        return;
+
+    // Geometric growth, so a colony spawning one ant at a time recreates the GPU buffers only log(n) times
+    InstanceData idle{};
+    idle.posX          = state_.nestPos.x;
+    idle.posY          = state_.nestPos.y;
+    idle.goalX         = state_.nestPos.x;
+    idle.goalY         = state_.nestPos.y;
+    idle.laneOffset    = 0.1f;
+    idle.speedScale    = 1.0f;
+    idle.color         = DirectX::XMFLOAT4( 1.0f, 1.0f, 1.0f, 1.0f );
+    idle.sourceIndex   = -1;
+    idle.holdTimer     = 9999.0f;
+    state_.instances.resize( max( count, max( MinInstanceCapacity, size * 2 ) ), idle );
+    uploadAll( true );
+}
+
+void AntGame::uploadSlot( const int slot )
+{
+    if ( uploads_.recreate || uploads_.full )
+        return;
+    uploads_.slots.emplace_back( slot, state_.instances[slot] );
 }
 
 void AntGame::handleEvent( UINT msg, WPARAM wParam, LPARAM lParam )
 {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    view_ = renderer_.View();
+
     switch ( msg )
     {
     case WM_KEYUP:
+        // Quick save and restore are for investigating a session, not part of it, so they are not recorded. The
+        // renderer saves on F5, as only it can read back the ants the compute pass has moved.
+        if ( wParam == VK_F5 || wParam == VK_F6 )
+        {
+            try
+            {
+                if ( wParam == VK_F6 )
+                    restore( QuickSaveFile );
+            }
+            catch ( const std::exception& ex )
+            {
+                OutputDebugStringA( ex.what() );
+                OutputDebugStringA( "\n" );
+            }
+            break;
+        }
+        recorder_.view( view_ );
+        recorder_.key( static_cast<uint32_t>( wParam ) );
         if ( wParam == 'R' )
         {
             resetGame();
@@ -71,15 +250,15 @@ void AntGame::handleEvent( UINT msg, WPARAM wParam, LPARAM lParam )
         }
         else if ( wParam == '1' || wParam == VK_NUMPAD1 )
         {
-            applyUpgrade( 1 );
+            upgrade( 1 );
         }
         else if ( wParam == '2' || wParam == VK_NUMPAD2 )
         {
-            applyUpgrade( 2 );
+            upgrade( 2 );
         }
         else if ( wParam == '3' || wParam == VK_NUMPAD3 )
         {
-            applyUpgrade( 3 );
+            upgrade( 3 );
         }
 
         // Konami Code tracking
@@ -94,7 +273,7 @@ void AntGame::handleEvent( UINT msg, WPARAM wParam, LPARAM lParam )
                 {
                     state_.konamiIndex = 0;
                     state_.partyMode   = !state_.partyMode;
-                    triggerConfettiBurst( renderer_.GetScreenWidth() / 2, renderer_.GetScreenHeight() / 2, 160 );
+                    triggerConfettiBurst( view_.width / 2, view_.height / 2, 160 );
                 }
             }
             else
@@ -122,6 +301,8 @@ void AntGame::handleEvent( UINT msg, WPARAM wParam, LPARAM lParam )
     {
         const int x = GET_X_LPARAM( lParam );
         const int y = GET_Y_LPARAM( lParam );
+        recorder_.view( view_ );
+        recorder_.click( x, y );
         if ( state_.partyMode )
         {
             triggerConfettiBurst( x, y, 90 );
@@ -155,7 +336,64 @@ void AntGame::toggleEndless( bool enabled )
     state_.endlessMode = enabled;
 }
 
-void AntGame::applyUpgrade( int option )
+void AntGame::applyUpgrade( const int option )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    recorder_.upgrade( option );
+    upgrade( option );
+}
+
+void AntGame::setDebugHudVisible( const bool visible )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    recorder_.debugHud( visible );
+    state_.showDebugHud = visible;
+}
+
+void AntGame::restartScenario( std::istream& settings, const int stage )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    applySettings( settings, state_ );
+    settings_ = settingsIn( state_ );
+    resetGame();
+    startStage( stage );
+}
+
+void AntGame::spawnHazard( const Vector2D& pos, const Vector2D& vel, const float radius, const double duration )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    state_.hazard         = Hazard{ pos, vel, radius, true };
+    state_.hazardTimeLeft = duration;
+}
+
+void AntGame::saveState( const std::filesystem::path& path, const std::span<const InstanceData> instances )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    saveGameState( path, state_, instances );
+}
+
+void AntGame::restoreState( const std::filesystem::path& path )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    restore( path );
+}
+
+void AntGame::reloadSettings( std::istream& settings )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    applyReloadedSettings( parseSettings( settings ) );
+}
+
+void AntGame::restore( const std::filesystem::path& path )
+{
+    loadGameState( path, state_ );
+    recorder_.close();
+    // The GPU hit totals run on across a restore, so foodHitsSeen_ and nestHitsSeen_ stay as they are
+    ensureInstances( max( state_.activeAnts, MinInstanceCapacity ) );
+    uploadAll( true );
+}
+
+void AntGame::upgrade( int option )
 {
     if ( state_.gameState != GameState::StageClear )
         return;
@@ -183,33 +421,7 @@ void AntGame::applyUpgrade( int option )
 
 int AntGame::findNearestFoodScreen( int x, int y, float maxPixelRadius ) const
 {
-    if ( state_.foodNodes.empty() )
-        return -1;
-
-    const auto mouse     = renderer_.ScreenToWorld( x, y );
-    const float maxDist2 = maxPixelRadius * maxPixelRadius;
-    int bestIndex        = -1;
-    float bestDist2      = maxDist2;
-
-    for ( size_t i = 0; i < state_.foodNodes.size(); ++i )
-    {
-        const auto& node = state_.foodNodes[i];
-        const float dx   = mouse.x - node.pos.x;
-        const float dy   = mouse.y - node.pos.y;
-        const float d2   = dx * dx + dy * dy;
-        if ( d2 < bestDist2 )
-        {
-            bestDist2 = d2;
-            bestIndex = static_cast<int>( i );
-        }
-    }
-
-    return bestIndex;
-}
-
-int AntGame::getActiveFoodIndex() const
-{
-    return state_.activeFoodIndex;
+    return Game::findNearestFood( state_, view_, x, y, maxPixelRadius );
 }
 
 void AntGame::setActiveFoodByIndex( int index )
@@ -222,78 +434,55 @@ void AntGame::setActiveFoodByIndex( int index )
 
 void AntGame::loadSettings()
 {
+    // A loose settings.ini (edited by hand) wins over the default packed into the asset bundle. While the game runs
+    // that file is watched and reloaded on change; scenario runs and replays must step the same way every time, so
+    // they leave it alone.
+    const wchar_t* flags     = GetCommandLineW();
+    const bool watch         = !wcsstr( flags, L"--scenario" ) && !wcsstr( flags, L"--replay" );
     const char* candidates[] = { "settings.ini", "../settings.ini", "../../settings.ini" };
     std::ifstream f;
     for ( const char* path : candidates )
     {
         f.open( path );
         if ( f.is_open() )
-            break;
-    }
-    if ( !f.is_open() )
-        return;
-
-    std::string line;
-    auto trim = []( std::string& s )
-    {
-        size_t a = s.find_first_not_of( " \t\r\n" );
-        size_t b = s.find_last_not_of( " \t\r\n" );
-        if ( a == std::string::npos )
-        {
-            s.clear();
-        }
-        else
         {
-            s = s.substr( a, b - a + 1 );
+            applySettings( f, state_ );
+            settings_ = settingsIn( state_ );
+            if ( watch && !settingsFile_.Watch( path ) )
+                OutputDebugStringA( "Cannot watch settings.ini; edits apply on the next start\n" );
+            return;
         }
-    };
+    }
 
-    while ( std::getline( f, line ) )
+    const AssetSpan packed = renderer_.Assets().Bundle().Find( "settings.ini" );
+    if ( !packed.empty() )
     {
-        if ( line.empty() || line[0] == '#' || line[0] == ';' ||
-             ( line.size() > 1 && line[0] == '/' && line[1] == '/' ) )
-            continue;
-        auto pos = line.find( '=' );
-        if ( pos == std::string::npos )
-            continue;
-        std::string key = line.substr( 0, pos );
-        std::string val = line.substr( pos + 1 );
-        trim( key );
-        trim( val );
-        try
-        {
-            if ( key == "initialAnts" )
-            {
-                state_.initialAnts = max( 0, std::stoi( val ) );
-            }
-            else if ( key == "antsPerSecond" )
-            {
-                state_.antsPerSecond = max( 0.0f, std::stof( val ) );
-            }
-            else if ( key == "spawnDelaySec" )
-            {
-                state_.spawnDelaySec = max( 0.0, std::stod( val ) );
-            }
-            else if ( key == "defaultFoodAmount" )
-            {
-                state_.defaultFoodAmount = max( 0.0f, std::stof( val ) );
-            }
-            else if ( key == "minFoodSpacing" )
-            {
-                state_.minFoodSpacing = max( 0.0f, std::stof( val ) );
-            }
-            else if ( key == "initialSpeed" )
-            {
-                state_.initialSpeed = max( 0.0f, std::stof( val ) );
-                state_.antSpeed     = state_.initialSpeed;
-            }
-        }
-        catch ( ... )
-        {
-        }
+        std::istringstream bundled( std::string( reinterpret_cast<const char*>( packed.data() ), packed.size() ) );
+        applySettings( bundled, state_ );
     }
+    settings_ = settingsIn( state_ );
+}
+
+void AntGame::pollSettingsFile()
+{
+    if ( !settingsFile_.Changed() )
+        return;
+    std::ifstream f( settingsFile_.Path() );
+    if ( f.is_open() )
+        applyReloadedSettings( parseSettings( f ) );
+}
+
+void AntGame::applyReloadedSettings( const GameSettings& next )
+{
+    static Metric& reloads = Metrics::Counter( "settings.reloads" );
 
-    state_.maxAnts = state_.initialAnts;
+    const std::string changed = applySettingsChanges( settings_, next, state_ );
+    settings_                 = next;
+    if ( changed.empty() )
+        return;
+    recorder_.settings( settingsText( next ) );
+    reloads.Add();
+    OutputDebugStringA( ( "settings.ini reloaded: " + changed + "\n" ).c_str() );
 }
 
 void AntGame::resetGame()
@@ -318,6 +507,7 @@ void AntGame::resetAnts()
 {
     double sendInterval = max( 0.02, 1.0 / max( 0.01, (double)state_.antsPerSecond ) );
 
+    ensureInstances( state_.activeAnts );
     for ( int i = 0; i < (int)state_.instances.size(); ++i )
     {
         InstanceData& it = state_.instances[i];
@@ -331,7 +521,7 @@ void AntGame::resetAnts()
         it.holdTimer     = ( i < state_.activeAnts ) ? (float)( sendInterval * i ) : 9999.0f;
     }
 
-    renderer_.UploadInstanceBuffer( state_.instances );
+    uploadAll( false );
     state_.legElapsed = 0.0;
     state_.travelTime = 0.0;
 }
@@ -352,6 +542,7 @@ void AntGame::startStage( int number )
 
     int count = min( 3 + state_.stage, 10 );
     spawnRandomFood( count );
+    placeRocks( state_ );
     state_.activeFoodIndex = -1;
     state_.mode            = AntMode::Idle;
 
@@ -379,6 +570,7 @@ void AntGame::restartGame()
 
 void AntGame::updateGameLogic( double dt )
 {
+    PROFILE_ZONE( "AntGame::updateGameLogic" );
     updateHazard( dt );
 
     if ( state_.gameState == GameState::GameOver )
@@ -408,9 +600,18 @@ void AntGame::updateGameLogic( double dt )
 
 void AntGame::updateHazard( double dt )
 {
+    PROFILE_ZONE( "AntGame::updateHazard" );
     if ( !state_.hazard.active )
         return;
 
+    state_.hazardTimeLeft -= dt;
+    if ( state_.hazardTimeLeft <= 0.0 )
+    {
+        state_.hazard.active   = false;
+        state_.hazardSinceLast = 0.0;
+        return;
+    }
+
     state_.hazard.pos.x += state_.hazard.vel.x * static_cast<float>( dt );
     state_.hazard.pos.y += state_.hazard.vel.y * static_cast<float>( dt );
 
@@ -438,63 +639,28 @@ void AntGame::updateHazard( double dt )
 
 void AntGame::updateEvents( double dt )
 {
+    PROFILE_ZONE( "AntGame::updateEvents" );
     state_.slowSinceLast += dt;
     state_.frenzySinceLast += dt;
 }
 
 void AntGame::updatePendingSpawns( double dt )
 {
-    if ( state_.mode == AntMode::ToFood && state_.activeFoodIndex >= 0 )
-    {
-        int capacity = state_.maxAnts - ( state_.activeAnts + static_cast<int>( state_.pendingSpawns.size() ) );
-        if ( capacity > 0 && state_.pendingSpawns.empty() )
-        {
-            double interval = max( 0.01, state_.spawnDelaySec );
-            state_.pendingSpawns.push_back( interval );
-        }
-    }
-
-    if ( state_.pendingSpawns.empty() )
+    PROFILE_ZONE( "AntGame::updatePendingSpawns" );
+    const int slot = releasePendingSpawn( state_, dt );
+    if ( slot < 0 )
         return;
+    static Metric& spawned = Metrics::Counter( "ants.spawned" );
+    spawned.Add();
 
-    for ( double& t : state_.pendingSpawns )
-        t -= dt;
-
-    if ( state_.pendingSpawns.front() > 0.0 || state_.activeAnts >= state_.maxAnts )
-        return;
-
-    state_.pendingSpawns.pop_front();
-    int slot = state_.activeAnts;
-    state_.activeAnts++;
-
-    InstanceData init = {};
-    init.posX         = state_.nestPos.x;
-    init.posY         = state_.nestPos.y;
-    init.directionX   = 0.0f;
-    init.directionY   = 0.0f;
-    init.goalX        = state_.nestPos.x;
-    init.goalY        = state_.nestPos.y;
-    init.laneOffset   = 0.03f;
-    init.speedScale   = 1.15f;
-    init.color = DirectX::XMFLOAT4( 1.0f, 1.0f, 1.0f, 1.0f );
-    init.movementState = 1;
-    init.sourceIndex   = -1;
-    init.holdTimer     = static_cast<float>( max( 0.01, state_.spawnDelaySec ) );
-
-    if ( slot >= static_cast<int>( state_.instances.size() ) )
-    {
-        state_.instances.push_back( init );
-        renderer_.ResizeInstanceStorage( state_.instances );
-    }
-    else
-    {
-        state_.instances[slot] = init;
-        renderer_.UploadInstanceSlot( slot, init );
-    }
+    ensureInstances( slot + 1 );
+    state_.instances[slot] = spawnedAnt( state_ );
+    uploadSlot( slot );
 }
 
 void AntGame::updateStageProgress()
 {
+    PROFILE_ZONE( "AntGame::updateStageProgress" );
     if ( state_.stageScore >= state_.stageTarget )
     {
         resetAnts();
@@ -513,6 +679,53 @@ void AntGame::updateStageProgress()
     }
 }
 
+void AntGame::updateFlowFields()
+{
+    PROFILE_ZONE( "AntGame::updateFlowFields" );
+    static Metric& builds        = Metrics::Counter( "flow.builds" );
+    static Metric& repairedCells = Metrics::Counter( "flow.repairedCells" );
+    static Metric& updateUs      = Metrics::Gauge( "flow.updateUs" );
+
+    const auto sameRock = []( const Rock& a, const Rock& b )
+    { return a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.halfSize == b.halfSize; };
+    if ( !std::equal( state_.rocks.begin(), state_.rocks.end(), gridRocks_.begin(), gridRocks_.end(), sameRock ) )
+    {
+        obstacles_.Clear();
+        for ( const Rock& rock : state_.rocks )
+            obstacles_.Block( rock );
+        gridRocks_ = state_.rocks;
+    }
+
+    // Cheap while nothing moved: one compare of the grid and a walk over the food nodes
+    const auto start              = std::chrono::steady_clock::now();
+    const uint64_t buildsBefore   = flowFields_.Builds();
+    const uint64_t repairedBefore = flowFields_.RepairedCells();
+    if ( !flowFields_.Update( obstacles_, state_.nestPos, state_.foodNodes ) )
+        return;
+    flowChanged_ = true;
+    builds.Add( static_cast<int64_t>( flowFields_.Builds() - buildsBefore ) );
+    repairedCells.Add( static_cast<int64_t>( flowFields_.RepairedCells() - repairedBefore ) );
+    updateUs.Set( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start )
+                      .count() );
+}
+
+void AntGame::updateDistanceField()
+{
+    PROFILE_ZONE( "AntGame::updateDistanceField" );
+    static Metric& bakedCells = Metrics::Counter( "sdf.bakedCells" );
+    static Metric& bakeUs     = Metrics::Gauge( "sdf.bakeUs" );
+
+    // Only the cells around rocks that came or went are baked again; a step with the same rocks costs one compare
+    const auto start   = std::chrono::steady_clock::now();
+    const size_t cells = distanceField_.Bake( state_.rocks );
+    if ( cells == 0 )
+        return;
+    distanceChanged_ = true;
+    bakedCells.Add( static_cast<int64_t>( cells ) );
+    bakeUs.Set( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start )
+                    .count() );
+}
+
 void AntGame::rebuildDepartureStagger()
 {
     double sendInterval = max( 0.02, 1.0 / max( 0.01, (double)state_.antsPerSecond ) );
@@ -524,7 +737,7 @@ void AntGame::rebuildDepartureStagger()
             it.holdTimer = static_cast<float>( sendInterval * i );
         }
     }
-    renderer_.UploadInstanceBuffer( state_.instances );
+    uploadAll( false );
 }
 
 void AntGame::spawnRandomFood( int count )
@@ -533,21 +746,21 @@ void AntGame::spawnRandomFood( int count )
     {
         float x = 0.5f;
         float y = 0.5f;
-        spawnFoodAtScreen( static_cast<int>( ( x * 0.5f + 0.5f ) * renderer_.GetScreenWidth() ),
-                           static_cast<int>( ( -y * 0.5f + 0.5f ) * renderer_.GetScreenHeight() ),
+        spawnFoodAtScreen( static_cast<int>( ( x * 0.5f + 0.5f ) * view_.width ),
+                           static_cast<int>( ( -y * 0.5f + 0.5f ) * view_.height ),
                            state_.defaultFoodAmount );
     }
 }
 
 void AntGame::spawnFoodAtScreen( int x, int y, float amount )
 {
-    Vector2D p = renderer_.ScreenToWorld( x, y );
+    Vector2D p = view_.ScreenToWorld( x, y );
     state_.foodNodes.emplace_back( FoodNode{ p, amount } );
 }
 
 void AntGame::setFlockTarget( int x, int y )
 {
-    state_.flockTarget         = renderer_.ScreenToWorld( x, y );
+    state_.flockTarget         = view_.ScreenToWorld( x, y );
     state_.previousFlockTarget = state_.flockTarget;
 }
 
@@ -558,7 +771,7 @@ void AntGame::setFood( int x, int y, float amount )
 
 void AntGame::setNest( int x, int y )
 {
-    state_.nestPos = renderer_.ScreenToWorld( x, y );
+    state_.nestPos = view_.ScreenToWorld( x, y );
     resetAnts();
 }
 
@@ -590,22 +803,6 @@ void AntGame::triggerConfettiBurst( int x, int y, int count )
 
 void AntGame::updateParty( double dt )
 {
-    if ( state_.partyParticles.empty() )
-        return;
-
-    for ( auto& p : state_.partyParticles )
-    {
-        p.life -= static_cast<float>( dt );
-        if ( p.life < 0.0f )
-            p.life = 0.0f;
-        float t = ( p.ttl > 0.0f ) ? ( 1.0f - p.life / p.ttl ) : 1.0f;
-        p.y += p.vy * static_cast<float>( dt );
-        p.x += p.vx * static_cast<float>( dt );
-        p.vy += 140.0f * static_cast<float>( dt );
-        p.rot += p.rotVel * static_cast<float>( dt );
-        int alpha = static_cast<int>( 255.0f * max( 0.0f, 1.0f - t ) );
-        p.color   = ( p.color & 0x00FFFFFF ) | ( alpha << 24 );
-    }
-
-    state_.partyParticles.erase( std::remove_if( state_.partyParticles.begin(), state_.partyParticles.end(), []( const PartyParticle& p ) { return p.life <= 0.0f; } ), state_.partyParticles.end() );
+    PROFILE_ZONE( "AntGame::updateParty" );
+    updatePartyParticles( state_.partyParticles, dt );
 }
@@ -1,44 +1,86 @@
 #pragma once
 
+#include "FileWatcher.h"
+#include "DistanceField.h"
+#include "FlowField.h"
+#include "GameRules.h"
 #include "GameWorldState.h"
+#include "InputRecording.h"
+#include "SimulationFrame.h"
+#include "SimulationPipeline.h"
+#include "ViewTransform.h"
 
 #include <Windows.h>
+#include <filesystem>
+#include <istream>
+#include <mutex>
+#include <span>
 
 class InstancedRendererEngine2D;
 
 namespace Game
 {
+    // Gameplay runs on the simulation thread (see SimulationPipeline), one frame ahead of the renderer, which only
+    // sees WorldSnapshots. state_ is guarded by mutex_: the step holds it, and so does every entry point called from
+    // the UI thread (input, upgrade buttons, HUD toggle).
     class AntGame
     {
       public:
         explicit AntGame( InstancedRendererEngine2D& renderer );
+        ~AntGame();
 
         void initialize();
-        void update( double dt );
+
+        // Render thread, once per frame: queue the next step and return the newest finished snapshot
+        const WorldSnapshot& beginFrame( const FrameInput& input );
+        SimulationPipelineStats pipelineStats() const;
 
         void handleEvent( UINT msg, WPARAM wParam, LPARAM lParam );
         void onResize( int width, int height );
 
-        void toggleEndless( bool enabled );
         void applyUpgrade( int option );
-        void advanceStage();
-        void restartGame();
+        void setDebugHudVisible( bool visible );
 
-        int findNearestFoodScreen( int x, int y, float maxPixelRadius ) const;
-        int getActiveFoodIndex() const;
-        void setActiveFoodByIndex( int index );
+        // Scenario runs (ScenarioRunner) script the rest through handleEvent, like a player would. These two cover
+        // what no input reaches: settings applied over the loaded ones and a restart at any stage, and a hazard.
+        void restartScenario( std::istream& settings, int stage );
+        void spawnHazard( const Vector2D& pos, const Vector2D& vel, float radius, double duration );
+
+        // Whole-state save and restore (see GameStateFile.h), also on F5/F6 with QuickSaveFile. instances is the
+        // stepped colony: read back from the GPU in the game, the CPU colony in headless runs. A restore closes a
+        // --record session, whose replay could not follow it. Both throw std::runtime_error.
+        void saveState( const std::filesystem::path& path, std::span<const InstanceData> instances = {} );
+        void restoreState( const std::filesystem::path& path );
 
-        GameWorldState& state()
-        {
-            return state_;
-        }
-        const GameWorldState& state() const
-        {
-            return state_;
-        }
+        // Applies the settings in settings that differ from the ones in effect to the running game, in place (see
+        // applySettingsChanges). The game does this itself when the settings.ini it loaded changes on disk; replays
+        // call it with the recorded text.
+        void reloadSettings( std::istream& settings );
+
+        static constexpr const char* QuickSaveFile = "quicksave.state";
 
       private:
+        static constexpr int MinInstanceCapacity = 64;
+        static constexpr const char* RecordFile  = "session.input"; // --record; replay with --replay <file>
+
+        void step( const FrameInput& input, WorldSnapshot& out );
+        void applyHits( const FrameInput& input );
+        void publish( WorldSnapshot& out );
+        void uploadAll( bool recreate );
+        void uploadSlot( int slot );
+        // Grows the instance array (and recreates the GPU buffers) only when count does not fit
+        void ensureInstances( int count );
+
+        void restore( const std::filesystem::path& path );
+        void toggleEndless( bool enabled );
+        void upgrade( int option );
+        void advanceStage();
+        void restartGame();
+        int findNearestFoodScreen( int x, int y, float maxPixelRadius ) const;
+        void setActiveFoodByIndex( int index );
         void loadSettings();
+        void pollSettingsFile();
+        void applyReloadedSettings( const GameSettings& next );
         void resetGame();
         void resetAnts();
         void startStage( int number );
@@ -47,6 +89,8 @@ namespace Game
         void updateEvents( double dt );
         void updatePendingSpawns( double dt );
         void updateStageProgress();
+        void updateFlowFields();
+        void updateDistanceField();
         void rebuildDepartureStagger();
         void spawnRandomFood( int count );
         void spawnFoodAtScreen( int x, int y, float amount );
@@ -58,5 +102,25 @@ namespace Game
 
         InstancedRendererEngine2D& renderer_;
         GameWorldState state_;
+
+        std::mutex mutex_;
+        ViewTransform view_;       // camera as of the last step or UI event
+        InstanceUploads uploads_;  // instance writes not yet handed to the renderer
+        double simTime_ = 0.0;     // FrameInput::time of the last step
+        uint64_t steps_ = 0;
+        std::array<uint64_t, MaxFoodNodes> foodHitsSeen_{};
+        uint64_t nestHitsSeen_ = 0;
+        InputRecorder recorder_; // open with --record
+        GameSettings settings_;  // as settings.ini last set them; hot reloads apply the difference
+        FileWatcher settingsFile_;
+        ObstacleGrid obstacles_;      // state_.rocks, rasterized
+        std::vector<Rock> gridRocks_; // the rocks obstacles_ was drawn from
+        FlowFields flowFields_;
+        bool flowChanged_ = false; // fields not handed to the renderer yet
+        DistanceField distanceField_;  // state_.rocks, baked
+        bool distanceChanged_ = false; // field not handed to the renderer yet
+
+        // Declared last so the worker is joined before the state it steps is destroyed
+        SimulationPipeline<FrameInput, WorldSnapshot> pipeline_;
     };
 } // namespace Game
@@ -0,0 +1,345 @@
+#include "GameRules.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace Game
+{
+    int findNearestFood( const GameWorldState& state, const ViewTransform& view, const int x, const int y,
+                         const float maxPixelRadius )
+    {
+        if ( state.foodNodes.empty() )
+            return -1;
+
+        const auto mouse     = view.ScreenToWorld( x, y );
+        const float maxDist2 = maxPixelRadius * maxPixelRadius;
+        int bestIndex        = -1;
+        float bestDist2      = maxDist2;
+
+        for ( size_t i = 0; i < state.foodNodes.size(); ++i )
+        {
+            const auto& node = state.foodNodes[i];
+            const float dx   = mouse.x - node.pos.x;
+            const float dy   = mouse.y - node.pos.y;
+            const float d2   = dx * dx + dy * dy;
+            if ( d2 < bestDist2 )
+            {
+                bestDist2 = d2;
+                bestIndex = static_cast<int>( i );
+            }
+        }
+
+        return bestIndex;
+    }
+
+    void applySettings( std::istream& in, GameWorldState& state )
+    {
+        std::string line;
+        auto trim = []( std::string& s )
+        {
+            size_t a = s.find_first_not_of( " \t\r\n" );
+            size_t b = s.find_last_not_of( " \t\r\n" );
+            if ( a == std::string::npos )
+            {
+                s.clear();
+            }
+            else
+            {
+                s = s.substr( a, b - a + 1 );
+            }
+        };
+
+        while ( std::getline( in, line ) )
+        {
+            if ( line.empty() || line[0] == '#' || line[0] == ';' ||
+                 ( line.size() > 1 && line[0] == '/' && line[1] == '/' ) )
+                continue;
+            auto pos = line.find( '=' );
+            if ( pos == std::string::npos )
+                continue;
+            std::string key = line.substr( 0, pos );
+            std::string val = line.substr( pos + 1 );
+            trim( key );
+            trim( val );
+            try
+            {
+                if ( key == "initialAnts" )
+                {
+                    state.initialAnts = std::max( 0, std::stoi( val ) );
+                }
+                else if ( key == "antsPerSecond" )
+                {
+                    state.antsPerSecond = std::max( 0.0f, std::stof( val ) );
+                }
+                else if ( key == "spawnDelaySec" )
+                {
+                    state.spawnDelaySec = std::max( 0.0, std::stod( val ) );
+                }
+                else if ( key == "defaultFoodAmount" )
+                {
+                    state.defaultFoodAmount = std::max( 0.0f, std::stof( val ) );
+                }
+                else if ( key == "minFoodSpacing" )
+                {
+                    state.minFoodSpacing = std::max( 0.0f, std::stof( val ) );
+                }
+                else if ( key == "initialSpeed" )
+                {
+                    state.initialSpeed = std::max( 0.0f, std::stof( val ) );
+                    state.antSpeed     = state.initialSpeed;
+                }
+                else if ( key == "rocks" )
+                {
+                    state.rockCount = std::max( 0, std::stoi( val ) );
+                }
+            }
+            catch ( ... )
+            {
+            }
+        }
+
+        state.maxAnts = state.initialAnts;
+    }
+
+    std::string settingsText( const GameWorldState& state )
+    {
+        return settingsText( settingsIn( state ) );
+    }
+
+    std::string settingsText( const GameSettings& settings )
+    {
+        // max_digits10, so floats and doubles read back exactly
+        std::ostringstream out;
+        out << std::setprecision( std::numeric_limits<double>::max_digits10 );
+        out << "initialAnts = " << settings.initialAnts << '\n'
+            << "antsPerSecond = " << settings.antsPerSecond << '\n'
+            << "spawnDelaySec = " << settings.spawnDelaySec << '\n'
+            << "defaultFoodAmount = " << settings.defaultFoodAmount << '\n'
+            << "minFoodSpacing = " << settings.minFoodSpacing << '\n'
+            << "initialSpeed = " << settings.initialSpeed << '\n'
+            << "rocks = " << settings.rocks << '\n';
+        return out.str();
+    }
+
+    GameSettings settingsIn( const GameWorldState& state )
+    {
+        GameSettings settings;
+        settings.initialAnts       = state.initialAnts;
+        settings.antsPerSecond     = state.antsPerSecond;
+        settings.spawnDelaySec     = state.spawnDelaySec;
+        settings.defaultFoodAmount = state.defaultFoodAmount;
+        settings.minFoodSpacing    = state.minFoodSpacing;
+        settings.initialSpeed      = state.initialSpeed;
+        settings.rocks             = state.rockCount;
+        return settings;
+    }
+
+    GameSettings parseSettings( std::istream& in )
+    {
+        GameWorldState parsed;
+        applySettings( in, parsed );
+        return settingsIn( parsed );
+    }
+
+    std::string applySettingsChanges( const GameSettings& before, const GameSettings& after, GameWorldState& state )
+    {
+        std::string changed;
+        const auto note = [&changed]( const char* key )
+        {
+            if ( !changed.empty() )
+                changed += ", ";
+            changed += key;
+        };
+
+        if ( after.initialAnts != before.initialAnts )
+        {
+            state.initialAnts = after.initialAnts;
+            state.maxAnts     = std::max( 0, state.maxAnts + after.initialAnts - before.initialAnts );
+            note( "initialAnts" );
+        }
+        if ( after.antsPerSecond != before.antsPerSecond )
+        {
+            state.antsPerSecond = after.antsPerSecond;
+            note( "antsPerSecond" );
+        }
+        if ( after.spawnDelaySec != before.spawnDelaySec )
+        {
+            // The spawn already counting down keeps its progress at the new pace
+            const double scale = std::max( 0.01, after.spawnDelaySec ) / std::max( 0.01, before.spawnDelaySec );
+            for ( double& t : state.pendingSpawns )
+                t *= scale;
+            state.spawnDelaySec = after.spawnDelaySec;
+            note( "spawnDelaySec" );
+        }
+        if ( after.defaultFoodAmount != before.defaultFoodAmount )
+        {
+            state.defaultFoodAmount = after.defaultFoodAmount;
+            note( "defaultFoodAmount" );
+        }
+        if ( after.minFoodSpacing != before.minFoodSpacing )
+        {
+            state.minFoodSpacing = after.minFoodSpacing;
+            note( "minFoodSpacing" );
+        }
+        if ( after.initialSpeed != before.initialSpeed )
+        {
+            state.antSpeed     = before.initialSpeed > 0.0f ? state.antSpeed * after.initialSpeed / before.initialSpeed
+                                                            : after.initialSpeed;
+            state.initialSpeed = after.initialSpeed;
+            note( "initialSpeed" );
+        }
+        if ( after.rocks != before.rocks )
+        {
+            state.rockCount = after.rocks;
+            placeRocks( state );
+            note( "rocks" );
+        }
+        return changed;
+    }
+
+    void updatePartyParticles( std::vector<PartyParticle>& particles, const double dt )
+    {
+        if ( particles.empty() )
+            return;
+
+        for ( auto& p : particles )
+        {
+            p.life -= static_cast<float>( dt );
+            if ( p.life < 0.0f )
+                p.life = 0.0f;
+            float t = ( p.ttl > 0.0f ) ? ( 1.0f - p.life / p.ttl ) : 1.0f;
+            p.y += p.vy * static_cast<float>( dt );
+            p.x += p.vx * static_cast<float>( dt );
+            p.vy += 140.0f * static_cast<float>( dt );
+            p.rot += p.rotVel * static_cast<float>( dt );
+            int alpha = static_cast<int>( 255.0f * std::max( 0.0f, 1.0f - t ) );
+            p.color   = ( p.color & 0x00FFFFFF ) | ( static_cast<uint32_t>( alpha ) << 24 );
+        }
+
+        particles.erase( std::remove_if( particles.begin(), particles.end(),
+                                         []( const PartyParticle& p ) { return p.life <= 0.0f; } ),
+                         particles.end() );
+    }
+
+    int releasePendingSpawn( GameWorldState& state, const double dt )
+    {
+        if ( state.mode == AntMode::ToFood && state.activeFoodIndex >= 0 )
+        {
+            int capacity = state.maxAnts - ( state.activeAnts + static_cast<int>( state.pendingSpawns.size() ) );
+            if ( capacity > 0 && state.pendingSpawns.empty() )
+            {
+                double interval = std::max( 0.01, state.spawnDelaySec );
+                state.pendingSpawns.push_back( interval );
+            }
+        }
+
+        if ( state.pendingSpawns.empty() )
+            return -1;
+
+        for ( double& t : state.pendingSpawns )
+            t -= dt;
+
+        if ( state.pendingSpawns.front() > 0.0 || state.activeAnts >= state.maxAnts )
+            return -1;
+
+        state.pendingSpawns.erase( state.pendingSpawns.begin() );
+        return state.activeAnts++;
+    }
+
+    void placeRocks( GameWorldState& state )
+    {
+        constexpr float Clearance = 0.06f; // kept free around the nest and each node
+        constexpr int Attempts    = 16;
+        constexpr float MinHalf   = 0.03f;
+        constexpr float HalfRange = 0.05f;
+        static_assert( MinHalf + HalfRange <= MaxRockHalfSize );
+
+        // Raw engine output only: the standard distributions differ between standard libraries
+        std::mt19937 rng( 0x5eed0000u + static_cast<uint32_t>( state.stage ) );
+        const auto unit = [&rng] { return static_cast<float>( rng() >> 8 ) * ( 1.0f / 16777216.0f ); };
+        const auto clear = [&state]( const Vector2D& pos, const float half )
+        {
+            const auto covers = [&pos, half]( const Vector2D& p )
+            { return std::abs( p.x - pos.x ) < half + Clearance && std::abs( p.y - pos.y ) < half + Clearance; };
+            if ( covers( state.nestPos ) )
+                return false;
+            return std::none_of( state.foodNodes.begin(), state.foodNodes.end(),
+                                 [&covers]( const FoodNode& node ) { return covers( node.pos ); } );
+        };
+
+        state.rocks.clear();
+        for ( int i = 0; i < state.rockCount; i++ )
+        {
+            for ( int attempt = 0; attempt < Attempts; attempt++ )
+            {
+                const float half = MinHalf + HalfRange * unit();
+                Vector2D pos;
+                if ( i % 3 != 2 && !state.foodNodes.empty() )
+                {
+                    // Part way along the nest-to-node line, shifted a little to either side
+                    const Vector2D& node = state.foodNodes[static_cast<size_t>( i ) % state.foodNodes.size()].pos;
+                    const float t        = 0.35f + 0.3f * unit();
+                    const float shift    = ( unit() - 0.5f ) * 0.1f;
+                    const float dx       = node.x - state.nestPos.x;
+                    const float dy       = node.y - state.nestPos.y;
+                    const float length   = std::max( 1e-5f, std::sqrt( dx * dx + dy * dy ) );
+                    pos                  = { state.nestPos.x + dx * t - dy / length * shift,
+                                             state.nestPos.y + dy * t + dx / length * shift };
+                }
+                else
+                {
+                    pos = { unit() * 1.7f - 0.85f, unit() * 1.7f - 0.85f };
+                }
+                if ( clear( pos, half ) )
+                {
+                    state.rocks.push_back( Rock{ pos, half } );
+                    break;
+                }
+            }
+        }
+    }
+
+    InstanceData spawnedAnt( const GameWorldState& state )
+    {
+        InstanceData init  = {};
+        init.posX          = state.nestPos.x;
+        init.posY          = state.nestPos.y;
+        init.directionX    = 0.0f;
+        init.directionY    = 0.0f;
+        init.goalX         = state.nestPos.x;
+        init.goalY         = state.nestPos.y;
+        init.laneOffset    = 0.03f;
+        init.speedScale    = 1.15f;
+        init.color         = DirectX::XMFLOAT4( 1.0f, 1.0f, 1.0f, 1.0f );
+        init.movementState = 1;
+        init.sourceIndex   = -1;
+        init.holdTimer     = static_cast<float>( std::max( 0.01, state.spawnDelaySec ) );
+        return init;
+    }
+
+    SimulationConstants simulationConstants( const GameWorldState& state, const float deltaTime )
+    {
+        SimulationConstants simulation = {};
+        // Freeze the colony outside of play so stage clear / game over screens don't keep scoring
+        simulation.deltaTime       = ( state.gameState == GameState::Playing ) ? deltaTime : 0.0f;
+        simulation.speed           = state.antSpeed;
+        simulation.activeFoodIndex = state.activeFoodIndex;
+        simulation.nestPosX        = state.nestPos.x;
+        simulation.nestPosY        = state.nestPos.y;
+        if ( state.activeFoodIndex >= 0 && state.activeFoodIndex < static_cast<int>( state.foodNodes.size() ) )
+        {
+            simulation.targetPosX = state.foodNodes[state.activeFoodIndex].pos.x;
+            simulation.targetPosY = state.foodNodes[state.activeFoodIndex].pos.y;
+        }
+        simulation.hazardPosX   = state.hazard.pos.x;
+        simulation.hazardPosY   = state.hazard.pos.y;
+        simulation.hazardRadius = state.hazard.radius;
+        simulation.hazardActive = state.hazard.active ? 1 : 0;
+        return simulation;
+    }
+} // namespace Game
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GameWorldState.h"
+#include "InstanceData.h"
+#include "ShaderConstants.h"
+#include "ViewTransform.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+// Gameplay rules that only need the world state. They live apart from AntGame (Win32 input, renderer, threads) so
+// they build on any platform; the microbenchmarks link them directly.
+namespace Game
+{
+    // Food node nearest to a screen point, or -1 when none is within maxPixelRadius
+    int findNearestFood( const GameWorldState& state, const ViewTransform& view, int x, int y, float maxPixelRadius );
+
+    // key=value lines as in settings.ini; comments, unknown keys and unparsable values are skipped
+    void applySettings( std::istream& in, GameWorldState& state );
+
+    // The values settings.ini sets, apart from the world they were applied to
+    struct GameSettings
+    {
+        int initialAnts         = 0;
+        float antsPerSecond     = 0.0f;
+        double spawnDelaySec    = 0.0;
+        float defaultFoodAmount = 0.0f;
+        float minFoodSpacing    = 0.0f;
+        float initialSpeed      = 0.0f;
+        int rocks               = 0;
+
+        bool operator==( const GameSettings& ) const = default;
+    };
+
+    // What state holds for each key. Stages and upgrades change antsPerSecond and antSpeed, so take this right after
+    // applySettings.
+    GameSettings settingsIn( const GameWorldState& state );
+
+    // Parses key=value lines as applySettings does; keys the text leaves out keep GameWorldState's defaults
+    GameSettings parseSettings( std::istream& in );
+
+    // The settings applySettings reads, as key=value lines it reads back to the same state
+    std::string settingsText( const GameWorldState& state );
+    std::string settingsText( const GameSettings& settings );
+
+    // Hot reload: applies the keys that differ between before and after to a running game, in place; no ant is reset
+    // or uploaded. spawnDelaySec paces spawns from the one counting down, which is rescaled. initialSpeed scales
+    // antSpeed, so upgrades bought on top keep their share. antsPerSecond spaces departures from the next stagger
+    // (until the next stage sets its own), the food keys apply to food placed from now on, and initialAnts moves
+    // maxAnts by as much and sizes the next stage. rocks places the stage's rocks again, which keeps the ones both
+    // counts have. Returns the keys that changed, comma-separated, or "".
+    std::string applySettingsChanges( const GameSettings& before, const GameSettings& after, GameWorldState& state );
+
+    // Ages, moves and fades confetti, and drops particles whose life ran out
+    void updatePartyParticles( std::vector<PartyParticle>& particles, double dt );
+
+    // Queues and counts down spawns; returns the slot of the ant released this step (activeAnts already counts it),
+    // or -1
+    int releasePendingSpawn( GameWorldState& state, double dt );
+
+    // Places rockCount rocks for the stage. A stage always gets the same rocks, and a larger count only adds to them.
+    // Two in three sit across the way from the nest to a food node, the rest anywhere; none covers the nest or a node.
+    void placeRocks( GameWorldState& state );
+
+    // A new ant at the nest, waiting spawnDelaySec before it leaves
+    InstanceData spawnedAnt( const GameWorldState& state );
+
+    // Flock step constants for one pass of deltaTime; the colony is frozen outside of play
+    SimulationConstants simulationConstants( const GameWorldState& state, float deltaTime );
+} // namespace Game
@@ -0,0 +1,235 @@
+#include "GameStateFile.h"
+
+#include "MappedFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    constexpr char Magic[4]           = { 'A', 'N', 'T', 'S' };
+    constexpr uint64_t BlockAlignment = 64;
+
+    struct GameStateHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t scalarBytes; // the layout the file was written with; checked on load along with the element sizes
+        uint32_t foodNodeBytes;
+        uint32_t particleBytes;
+        uint32_t instanceBytes;
+        uint32_t rockBytes;
+        uint64_t foodNodes;
+        uint64_t pendingSpawns;
+        uint64_t rocks;
+        uint64_t particles;
+        uint64_t instances;
+    };
+
+    static_assert( std::is_trivially_copyable_v<FoodNode> && std::is_trivially_copyable_v<Rock> &&
+                   std::is_trivially_copyable_v<PartyParticle> && std::is_trivially_copyable_v<InstanceData> );
+
+    // Every GameWorldState member that is not an array, in declaration order. Hazard goes field by field so its
+    // padding never reaches the file.
+    template <class State, class Field>
+    void forEachScalar( State& s, Field&& field )
+    {
+        field( s.flockTarget );
+        field( s.previousFlockTarget );
+        field( s.flockTransitionTime );
+        field( s.flockFrozenTime );
+        field( s.nestPos );
+        field( s.activeFoodIndex );
+        field( s.minFoodSpacing );
+        field( s.defaultFoodAmount );
+        field( s.depositingFoodIndex );
+        field( s.maxAnts );
+        field( s.activeAnts );
+        field( s.spawnAccumulator );
+        field( s.antsPerSecond );
+        field( s.score );
+        field( s.antSpeed );
+        field( s.initialSpeed );
+        field( s.followDistance );
+        field( s.legElapsed );
+        field( s.travelTime );
+        field( s.scoreCarryAccum );
+        field( s.mode );
+        field( s.initialAnts );
+        field( s.spawnDelaySec );
+        field( s.enableSugar );
+        field( s.enableHazard );
+        field( s.rockCount );
+        field( s.gameState );
+        field( s.stage );
+        field( s.stageTimeLeft );
+        field( s.stageTarget );
+        field( s.stageScore );
+        field( s.combo );
+        field( s.sinceLastDeposit );
+        field( s.endlessMode );
+        field( s.upgradePending );
+        field( s.slowActive );
+        field( s.slowTimeLeft );
+        field( s.slowCooldown );
+        field( s.slowSinceLast );
+        field( s.hazard.pos );
+        field( s.hazard.vel );
+        field( s.hazard.radius );
+        field( s.hazard.active );
+        field( s.hazardTimeLeft );
+        field( s.hazardDuration );
+        field( s.hazardSinceLast );
+        field( s.hazardCooldown );
+        field( s.partyMode );
+        field( s.stageClearBurstDone );
+        field( s.konamiIndex );
+        field( s.frenzyActive );
+        field( s.frenzyTimeLeft );
+        field( s.frenzyCooldown );
+        field( s.frenzySinceLast );
+        field( s.antsEnabled );
+        field( s.showDebugHud );
+        field( s.bonusSpawnSince );
+        field( s.bonusSpawnInterval );
+    }
+
+    uint32_t ScalarBytes()
+    {
+        Game::GameWorldState probe;
+        uint32_t bytes = 0;
+        forEachScalar( probe, [&bytes]( const auto& value ) { bytes += sizeof( value ); } );
+        return bytes;
+    }
+
+    uint64_t Align( const uint64_t value )
+    {
+        return ( value + BlockAlignment - 1 ) & ~( BlockAlignment - 1 );
+    }
+
+    // Where each block starts, from the counts in the header
+    struct Layout
+    {
+        uint64_t foodNodes;
+        uint64_t pendingSpawns;
+        uint64_t rocks;
+        uint64_t particles;
+        uint64_t instances;
+        uint64_t end;
+    };
+
+    Layout LayoutOf( const GameStateHeader& header )
+    {
+        Layout layout{};
+        layout.foodNodes     = Align( sizeof( GameStateHeader ) + header.scalarBytes );
+        layout.pendingSpawns = Align( layout.foodNodes + header.foodNodes * sizeof( FoodNode ) );
+        layout.rocks         = Align( layout.pendingSpawns + header.pendingSpawns * sizeof( double ) );
+        layout.particles     = Align( layout.rocks + header.rocks * sizeof( Rock ) );
+        layout.instances     = Align( layout.particles + header.particles * sizeof( PartyParticle ) );
+        layout.end           = layout.instances + header.instances * sizeof( InstanceData );
+        return layout;
+    }
+
+    template <class T>
+    void WriteBlock( std::ofstream& out, const uint64_t offset, const T* data, const size_t count )
+    {
+        static constexpr char Zeros[BlockAlignment] = {};
+        const auto at                               = static_cast<uint64_t>( out.tellp() );
+        out.write( Zeros, static_cast<std::streamsize>( offset - at ) );
+        if ( count > 0 )
+            out.write( reinterpret_cast<const char*>( data ), static_cast<std::streamsize>( count * sizeof( T ) ) );
+    }
+
+    template <class T>
+    void ReadBlock( const MappedFile& file, const uint64_t offset, const uint64_t count, std::vector<T>& out )
+    {
+        // Blocks are aligned within a page-aligned mapping, so they can be read in place
+        const T* first = reinterpret_cast<const T*>( file.Data() + offset );
+        out.assign( first, first + count );
+    }
+} // namespace
+
+namespace Game
+{
+    void saveGameState( const std::filesystem::path& path, const GameWorldState& state,
+                        const std::span<const InstanceData> instances )
+    {
+        const std::span<const InstanceData> ants = instances.empty() ? std::span( state.instances ) : instances;
+
+        GameStateHeader header{};
+        std::memcpy( header.magic, Magic, sizeof( Magic ) );
+        header.version       = GameStateVersion;
+        header.scalarBytes   = ScalarBytes();
+        header.foodNodeBytes = sizeof( FoodNode );
+        header.particleBytes = sizeof( PartyParticle );
+        header.instanceBytes = sizeof( InstanceData );
+        header.rockBytes     = sizeof( Rock );
+        header.foodNodes     = state.foodNodes.size();
+        header.pendingSpawns = state.pendingSpawns.size();
+        header.rocks         = state.rocks.size();
+        header.particles     = state.partyParticles.size();
+        header.instances     = ants.size();
+        const Layout layout  = LayoutOf( header );
+
+        std::vector<char> head( sizeof( header ) );
+        std::memcpy( head.data(), &header, sizeof( header ) );
+        forEachScalar( state,
+                       [&head]( const auto& value )
+                       {
+                           const auto* bytes = reinterpret_cast<const char*>( &value );
+                           head.insert( head.end(), bytes, bytes + sizeof( value ) );
+                       } );
+
+        std::ofstream out( path, std::ios::binary | std::ios::trunc );
+        if ( !out.write( head.data(), static_cast<std::streamsize>( head.size() ) ) )
+            throw std::runtime_error( "Failed to write game state: " + path.string() );
+        WriteBlock( out, layout.foodNodes, state.foodNodes.data(), state.foodNodes.size() );
+        WriteBlock( out, layout.pendingSpawns, state.pendingSpawns.data(), state.pendingSpawns.size() );
+        WriteBlock( out, layout.rocks, state.rocks.data(), state.rocks.size() );
+        WriteBlock( out, layout.particles, state.partyParticles.data(), state.partyParticles.size() );
+        WriteBlock( out, layout.instances, ants.data(), ants.size() );
+        if ( !out )
+            throw std::runtime_error( "Failed to write game state: " + path.string() );
+    }
+
+    void loadGameState( const std::filesystem::path& path, GameWorldState& state )
+    {
+        MappedFile file;
+        if ( !file.Open( path ) )
+            throw std::runtime_error( "Cannot open game state: " + path.string() );
+
+        GameStateHeader header{};
+        if ( file.Size() < sizeof( header ) )
+            throw std::runtime_error( "Not a game state file: " + path.string() );
+        std::memcpy( &header, file.Data(), sizeof( header ) );
+        if ( std::memcmp( header.magic, Magic, sizeof( Magic ) ) != 0 )
+            throw std::runtime_error( "Not a game state file: " + path.string() );
+        if ( header.version != GameStateVersion || header.scalarBytes != ScalarBytes() ||
+             header.foodNodeBytes != sizeof( FoodNode ) || header.particleBytes != sizeof( PartyParticle ) ||
+             header.instanceBytes != sizeof( InstanceData ) || header.rockBytes != sizeof( Rock ) )
+            throw std::runtime_error( "Game state of another version or layout: " + path.string() );
+
+        // Counts are bounded by the file size before any of them is multiplied into an offset
+        const uint64_t size = file.Size();
+        if ( header.foodNodes > size || header.pendingSpawns > size || header.rocks > size ||
+             header.particles > size || header.instances > size || LayoutOf( header ).end > size )
+            throw std::runtime_error( "Game state is cut short: " + path.string() );
+        const Layout layout = LayoutOf( header );
+
+        const unsigned char* scalars = file.Data() + sizeof( header );
+        forEachScalar( state,
+                       [&scalars]( auto& value )
+                       {
+                           std::memcpy( &value, scalars, sizeof( value ) );
+                           scalars += sizeof( value );
+                       } );
+        ReadBlock( file, layout.foodNodes, header.foodNodes, state.foodNodes );
+        ReadBlock( file, layout.pendingSpawns, header.pendingSpawns, state.pendingSpawns );
+        ReadBlock( file, layout.rocks, header.rocks, state.rocks );
+        ReadBlock( file, layout.particles, header.particles, state.partyParticles );
+        ReadBlock( file, layout.instances, header.instances, state.instances );
+    }
+} // namespace Game
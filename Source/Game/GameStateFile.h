@@ -0,0 +1,31 @@
+#pragma once
+
+#include "GameWorldState.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace Game
+{
+    // Bump when a GameWorldState field is added, removed or retyped; files of another version are refused
+    constexpr uint32_t GameStateVersion = 2;
+
+    // Binary save of a whole GameWorldState: a header with the layout it was written with, the scalar fields packed
+    // in declaration order, then each array as one 64-byte aligned block (food nodes, pending spawns, rocks,
+    // confetti, instances). Saving is one write per block; loading maps the file and copies each block in one go,
+    // reusing the capacity the vectors already have. A million ants is about 60 MB: under 100 ms to save and about
+    // 15 ms to load from the file cache (BM_GameStateSave/Load in bench_core).
+    //
+    // instances overrides state.instances when not empty. state.instances are the ants as last written from the CPU;
+    // the compute pass has moved them since, so callers pass the stepped array (the CPU colony in headless runs, the
+    // GPU buffer read back in the game).
+    //
+    // Throws std::runtime_error when the file cannot be written
+    void saveGameState( const std::filesystem::path& path, const GameWorldState& state,
+                        std::span<const InstanceData> instances = {} );
+
+    // Throws std::runtime_error when the file is missing, not a state file, of another version or layout, or cut
+    // short; state is left untouched then
+    void loadGameState( const std::filesystem::path& path, GameWorldState& state );
+} // namespace Game
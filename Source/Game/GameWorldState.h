@@ -5,9 +5,9 @@
 #include "Hazard.h"
 #include "InstanceData.h"
 #include "Objects/PartyParticle.h"
+#include "Rock.h"
 #include "Vector2D.h"
 
-#include <deque>
 #include <vector>
 
 namespace Game
@@ -40,13 +40,17 @@ namespace Game
         float scoreCarryAccum   = 0.0f;
         AntMode mode            = AntMode::Idle;
 
-        std::deque<double> pendingSpawns;
+        std::vector<double> pendingSpawns; // a vector keeps its capacity, a deque reallocates blocks as it cycles
+
+        // Static obstacles for the stage (placeRocks); ants route around them by flow field
+        std::vector<Rock> rocks;
 
         // Config
         int initialAnts      = 10;
         double spawnDelaySec = 0.1;
         bool enableSugar     = true;
         bool enableHazard    = true;
+        int rockCount        = 0; // rocks per stage
 
         // Stage system
         GameState gameState     = GameState::Playing;
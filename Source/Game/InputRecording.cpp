@@ -0,0 +1,297 @@
+#include "InputRecording.h"
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    constexpr char Magic[4] = { 'A', 'N', 'T', 'I' };
+
+    class Reader
+    {
+      public:
+        explicit Reader( const std::vector<uint8_t>& bytes ) : bytes_( bytes )
+        {
+        }
+
+        bool done() const
+        {
+            return at_ >= bytes_.size();
+        }
+
+        uint8_t byte()
+        {
+            if ( done() )
+                throw std::runtime_error( "Input recording is cut short" );
+            return bytes_[at_++];
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+            for ( int shift = 0; shift < 64; shift += 7 )
+            {
+                const uint8_t b = byte();
+                value |= static_cast<uint64_t>( b & 0x7F ) << shift;
+                if ( !( b & 0x80 ) )
+                    return value;
+            }
+            throw std::runtime_error( "Input recording has a malformed varint" );
+        }
+
+        int64_t signedVarint()
+        {
+            const uint64_t zigzag = varint();
+            return static_cast<int64_t>( zigzag >> 1 ) ^ -static_cast<int64_t>( zigzag & 1 );
+        }
+
+        float real()
+        {
+            uint32_t bits = 0;
+            for ( int i = 0; i < 4; i++ )
+                bits |= static_cast<uint32_t>( byte() ) << ( i * 8 );
+            float value;
+            std::memcpy( &value, &bits, sizeof( value ) );
+            return value;
+        }
+
+      private:
+        const std::vector<uint8_t>& bytes_;
+        size_t at_ = 0;
+    };
+
+    bool SameView( const ViewTransform& a, const ViewTransform& b )
+    {
+        return a.cameraPosition.x == b.cameraPosition.x && a.cameraPosition.y == b.cameraPosition.y &&
+               a.zoom == b.zoom && a.width == b.width && a.height == b.height;
+    }
+} // namespace
+
+namespace Game
+{
+    InputRecorder::~InputRecorder()
+    {
+        close();
+    }
+
+    bool InputRecorder::open( const std::filesystem::path& path, const std::string_view settings )
+    {
+        close();
+        out_.open( path, std::ios::binary | std::ios::trunc );
+        if ( !out_ )
+            return false;
+
+        buffer_.reserve( FlushBytes + 4096 );
+        buffer_.insert( buffer_.end(), std::begin( Magic ), std::end( Magic ) );
+        varint( InputRecordVersion );
+        varint( settings.size() );
+        buffer_.insert( buffer_.end(), settings.begin(), settings.end() );
+        written_ = 0;
+        hasView_ = false;
+        return true;
+    }
+
+    void InputRecorder::close()
+    {
+        if ( !out_.is_open() )
+            return;
+        out_.write( reinterpret_cast<const char*>( buffer_.data() ), static_cast<std::streamsize>( buffer_.size() ) );
+        buffer_.clear();
+        out_.close();
+    }
+
+    void InputRecorder::step( const FrameInput& input, const double deltaTime,
+                              const std::array<uint64_t, MaxFoodNodes>& hitsSeen, const uint64_t nestSeen )
+    {
+        if ( !isOpen() )
+            return;
+        view( input.view );
+
+        tag( InputRecordKind::Step );
+        varint( static_cast<uint64_t>( std::llround( deltaTime * 1e9 ) ) );
+        uint64_t nodes = 0;
+        for ( size_t i = 0; i < MaxFoodNodes; i++ )
+            nodes += input.foodHits[i] != hitsSeen[i] ? 1 : 0;
+        varint( nodes );
+        for ( size_t i = 0; i < MaxFoodNodes && nodes > 0; i++ )
+        {
+            if ( input.foodHits[i] == hitsSeen[i] )
+                continue;
+            varint( i );
+            varint( input.foodHits[i] - hitsSeen[i] );
+            nodes--;
+        }
+        varint( input.nestHits - nestSeen );
+        flushIfFull();
+    }
+
+    void InputRecorder::view( const ViewTransform& view )
+    {
+        if ( !isOpen() || ( hasView_ && SameView( view, lastView_ ) ) )
+            return;
+        lastView_ = view;
+        hasView_  = true;
+
+        tag( InputRecordKind::View );
+        real( view.cameraPosition.x );
+        real( view.cameraPosition.y );
+        real( view.zoom );
+        varint( static_cast<uint64_t>( view.width ) );
+        varint( static_cast<uint64_t>( view.height ) );
+    }
+
+    void InputRecorder::key( const uint32_t key )
+    {
+        if ( !isOpen() )
+            return;
+        tag( InputRecordKind::Key );
+        varint( key );
+    }
+
+    void InputRecorder::click( const int x, const int y )
+    {
+        if ( !isOpen() )
+            return;
+        tag( InputRecordKind::Click );
+        signedVarint( x );
+        signedVarint( y );
+    }
+
+    void InputRecorder::upgrade( const int option )
+    {
+        if ( !isOpen() )
+            return;
+        tag( InputRecordKind::Upgrade );
+        signedVarint( option );
+    }
+
+    void InputRecorder::debugHud( const bool visible )
+    {
+        if ( !isOpen() )
+            return;
+        tag( InputRecordKind::DebugHud );
+        varint( visible ? 1 : 0 );
+    }
+
+    void InputRecorder::settings( const std::string_view text )
+    {
+        if ( !isOpen() )
+            return;
+        tag( InputRecordKind::Settings );
+        varint( text.size() );
+        buffer_.insert( buffer_.end(), text.begin(), text.end() );
+        flushIfFull();
+    }
+
+    void InputRecorder::tag( const InputRecordKind kind )
+    {
+        buffer_.push_back( static_cast<uint8_t>( kind ) );
+    }
+
+    void InputRecorder::varint( uint64_t value )
+    {
+        while ( value >= 0x80 )
+        {
+            buffer_.push_back( static_cast<uint8_t>( value | 0x80 ) );
+            value >>= 7;
+        }
+        buffer_.push_back( static_cast<uint8_t>( value ) );
+    }
+
+    void InputRecorder::signedVarint( const int64_t value )
+    {
+        varint( ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+    }
+
+    void InputRecorder::real( const float value )
+    {
+        uint32_t bits;
+        std::memcpy( &bits, &value, sizeof( bits ) );
+        for ( int i = 0; i < 4; i++ )
+            buffer_.push_back( static_cast<uint8_t>( bits >> ( i * 8 ) ) );
+    }
+
+    void InputRecorder::flushIfFull()
+    {
+        // Records are only ever a few hundred bytes, so the reserve above FlushBytes is never exceeded
+        if ( buffer_.size() < FlushBytes )
+            return;
+        out_.write( reinterpret_cast<const char*>( buffer_.data() ), static_cast<std::streamsize>( buffer_.size() ) );
+        written_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    InputReplay::InputReplay( const std::filesystem::path& path )
+    {
+        std::ifstream in( path, std::ios::binary );
+        if ( !in )
+            throw std::runtime_error( "Cannot open input recording: " + path.string() );
+        const std::vector<uint8_t> bytes( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+
+        Reader reader( bytes );
+        for ( const char c : Magic )
+        {
+            if ( reader.byte() != static_cast<uint8_t>( c ) )
+                throw std::runtime_error( "Not an input recording: " + path.string() );
+        }
+        if ( reader.varint() != InputRecordVersion )
+            throw std::runtime_error( "Input recording of another version: " + path.string() );
+        const uint64_t settingsSize = reader.varint();
+        for ( uint64_t i = 0; i < settingsSize; i++ )
+            settings_.push_back( static_cast<char>( reader.byte() ) );
+
+        while ( !reader.done() )
+        {
+            InputRecord record;
+            record.kind = static_cast<InputRecordKind>( reader.byte() );
+            switch ( record.kind )
+            {
+            case InputRecordKind::Step:
+            {
+                record.deltaTime     = static_cast<double>( reader.varint() ) * 1e-9;
+                const uint64_t nodes = reader.varint();
+                for ( uint64_t i = 0; i < nodes; i++ )
+                {
+                    const auto node = static_cast<int>( reader.varint() );
+                    if ( node >= MaxFoodNodes )
+                        throw std::runtime_error( "Input recording has a food node out of range" );
+                    record.foodHits.emplace_back( node, reader.varint() );
+                }
+                record.nestHits = reader.varint();
+                steps_++;
+                break;
+            }
+            case InputRecordKind::View:
+                record.view.cameraPosition.x = reader.real();
+                record.view.cameraPosition.y = reader.real();
+                record.view.zoom             = reader.real();
+                record.view.width            = static_cast<int>( reader.varint() );
+                record.view.height           = static_cast<int>( reader.varint() );
+                break;
+            case InputRecordKind::Key:
+            case InputRecordKind::DebugHud:
+                record.value = static_cast<uint32_t>( reader.varint() );
+                break;
+            case InputRecordKind::Click:
+                record.x = static_cast<int>( reader.signedVarint() );
+                record.y = static_cast<int>( reader.signedVarint() );
+                break;
+            case InputRecordKind::Upgrade:
+                record.value = static_cast<uint32_t>( reader.signedVarint() );
+                break;
+            case InputRecordKind::Settings:
+            {
+                const uint64_t size = reader.varint();
+                for ( uint64_t i = 0; i < size; i++ )
+                    record.settings.push_back( static_cast<char>( reader.byte() ) );
+                break;
+            }
+            default:
+                throw std::runtime_error( "Input recording has an unknown record" );
+            }
+            records_.push_back( std::move( record ) );
+        }
+    }
+} // namespace Game
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "SimulationFrame.h"
+#include "ViewTransform.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Game
+{
+    constexpr uint32_t InputRecordVersion = 1;
+
+    // Everything that reaches the game from outside, in the order the game saw it. Events sit between the steps they
+    // fell between, so the tick is the number of Step records before them.
+    enum class InputRecordKind : uint8_t
+    {
+        Step,     // one simulation step: its time delta and the GPU hits it applied
+        View,     // camera or window size changed; clicks and food spawns map through it
+        Key,      // WM_KEYUP
+        Click,    // WM_LBUTTONUP
+        Upgrade,  // stage clear upgrade picked with the HUD buttons
+        DebugHud, // HUD closed from its own window
+        Settings, // settings.ini changed on disk and was reloaded
+    };
+
+    struct InputRecord
+    {
+        InputRecordKind kind = InputRecordKind::Step;
+        double deltaTime     = 0.0;                     // Step
+        std::vector<std::pair<int, uint64_t>> foodHits; // Step: hits per node index since the previous step
+        uint64_t nestHits = 0;                          // Step: deliveries since the previous step
+        ViewTransform view;                             // View
+        uint32_t value = 0;                             // Key: virtual key, Upgrade: option, DebugHud: visible
+        int x          = 0;                             // Click, in pixels of the last View
+        int y          = 0;
+        std::string settings; // Settings: the reloaded values as settingsText writes them
+    };
+
+    // Compact session log: a header with the settings in effect, then one tag byte per record followed by varints.
+    // A quiet step (no hits, same view) is seven bytes, about 25 KB a minute at 60 Hz. Writes go to a reserved
+    // buffer that is flushed in large blocks, so recording does not allocate during play. Not thread-safe; AntGame
+    // calls it under its lock.
+    class InputRecorder
+    {
+      public:
+        InputRecorder() = default;
+        InputRecorder( const InputRecorder& )            = delete;
+        InputRecorder& operator=( const InputRecorder& ) = delete;
+        ~InputRecorder();
+
+        bool open( const std::filesystem::path& path, std::string_view settings );
+        void close();
+        bool isOpen() const
+        {
+            return out_.is_open();
+        }
+
+        // hitsSeen/nestSeen are the totals the previous step applied; the record keeps only the difference
+        void step( const FrameInput& input, double deltaTime, const std::array<uint64_t, MaxFoodNodes>& hitsSeen,
+                   uint64_t nestSeen );
+        // Written only when it differs from the last recorded view
+        void view( const ViewTransform& view );
+        void key( uint32_t key );
+        void click( int x, int y );
+        void upgrade( int option );
+        void debugHud( bool visible );
+        void settings( std::string_view text );
+
+        uint64_t bytesWritten() const
+        {
+            return written_ + buffer_.size();
+        }
+
+      private:
+        static constexpr size_t FlushBytes = 60 * 1024;
+
+        void tag( InputRecordKind kind );
+        void varint( uint64_t value );
+        void signedVarint( int64_t value );
+        void real( float value );
+        void flushIfFull();
+
+        std::ofstream out_;
+        std::vector<uint8_t> buffer_;
+        uint64_t written_ = 0;
+        ViewTransform lastView_;
+        bool hasView_ = false;
+    };
+
+    // Reads a whole recording; throws std::runtime_error when the file is missing, of another version, or cut short
+    class InputReplay
+    {
+      public:
+        explicit InputReplay( const std::filesystem::path& path );
+
+        const std::string& settings() const
+        {
+            return settings_;
+        }
+        const std::vector<InputRecord>& records() const
+        {
+            return records_;
+        }
+        size_t steps() const
+        {
+            return steps_;
+        }
+
+      private:
+        std::string settings_;
+        std::vector<InputRecord> records_;
+        size_t steps_ = 0;
+    };
+} // namespace Game
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "GameWorldState.h"
+#include "ViewTransform.h"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Game
+{
+    // Food nodes the GPU counts hits for (HitBins per node in the hit buffers)
+    constexpr int MaxFoodNodes = 128;
+
+    // Counters per food node in the hit buffers (binning to reduce atomics contention); the readback folds them
+    constexpr int HitBins = 8;
+
+    // Render thread -> simulation thread, once per frame. Inputs coalesce when the simulation falls behind, so
+    // everything here is a running total or a latest value, never a per-frame delta.
+    struct FrameInput
+    {
+        double time = 0.0; // render clock; the step advances by the difference to the previous input
+        ViewTransform view;
+        std::array<uint64_t, MaxFoodNodes> foodHits{}; // ants that took food from each node, from the GPU readback
+        uint64_t nestHits = 0;                         // ants that delivered food
+    };
+
+    // Instance buffer writes the simulation asked for during one step, applied by the render thread in order:
+    // recreate or full upload first (from the instance array as of the end of the step), then single slots
+    struct InstanceUploads
+    {
+        bool recreate = false; // rebuild GPU storage (first upload, or the array outgrew it)
+        bool full     = false;
+        std::vector<InstanceData> instances;
+        std::vector<std::pair<int, InstanceData>> slots;
+
+        bool Any() const
+        {
+            return recreate || full || !slots.empty();
+        }
+    };
+
+    // Flow fields the colony steers by (see FlowFields), sent whole when a field or its slots changed in the step
+    struct FlowFieldUploads
+    {
+        bool changed = false;
+        int gridSize = 0;                 // cells per side; 0 when there are no obstacles and no fields
+        std::vector<uint32_t> directions; // slot-major, gridSize * gridSize per slot
+        std::vector<int32_t> foodSlots;   // MaxFoodNodes entries, -1 for a node without a field
+    };
+
+    // Rock distance field the colony collides with (see DistanceField), sent whole when a bake changed it
+    struct DistanceFieldUploads
+    {
+        bool changed = false;
+        int gridSize = 0;             // cells per side; 0 without rocks
+        std::vector<float> distances; // row-major from the bottom-left
+    };
+
+    // Simulation thread -> render thread. `state` is a copy of the world without the instance array, which lives on
+    // the GPU; `uploads` carries the instance writes made since the previous snapshot, `flow` and `distance` the flow
+    // fields and the rock distance field when they changed.
+    struct WorldSnapshot
+    {
+        uint64_t sequence = 0; // step number; uploads are applied once per sequence
+        GameWorldState state;
+        int instanceCount = 0;
+        double stepMs     = 0.0; // how long the step that produced this snapshot took
+        InstanceUploads uploads;
+        FlowFieldUploads flow;
+        DistanceFieldUploads distance;
+    };
+} // namespace Game
@@ -0,0 +1,178 @@
+#include "GlyphLayout.h"
+
+namespace
+{
+    constexpr uint32_t Replacement = 0xFFFD;
+} // namespace
+
+GlyphLayout::GlyphLayout( const FontData& font ) : font_( font )
+{
+    fallback_ = font.Find( '?' );
+
+    const FontGlyph* space = font.Find( ' ' );
+    spaceAdvance_          = space ? static_cast<float>( space->xAdvance ) : font.Header().lineHeight * 0.25f;
+}
+
+uint32_t GlyphLayout::DecodeUtf8( const std::string_view text, size_t& index )
+{
+    const auto lead = static_cast<unsigned char>( text[index] );
+    if ( lead < 0x80 )
+    {
+        index++;
+        return lead;
+    }
+
+    int length;
+    uint32_t codepoint;
+    uint32_t minimum;
+    if ( ( lead & 0xE0 ) == 0xC0 )
+    {
+        length    = 2;
+        codepoint = lead & 0x1F;
+        minimum   = 0x80;
+    }
+    else if ( ( lead & 0xF0 ) == 0xE0 )
+    {
+        length    = 3;
+        codepoint = lead & 0x0F;
+        minimum   = 0x800;
+    }
+    else if ( ( lead & 0xF8 ) == 0xF0 )
+    {
+        length    = 4;
+        codepoint = lead & 0x07;
+        minimum   = 0x10000;
+    }
+    else
+    {
+        index++;
+        return Replacement;
+    }
+
+    if ( index + length > text.size() )
+    {
+        index++;
+        return Replacement;
+    }
+    for ( int i = 1; i < length; i++ )
+    {
+        const auto next = static_cast<unsigned char>( text[index + i] );
+        if ( ( next & 0xC0 ) != 0x80 )
+        {
+            index++;
+            return Replacement;
+        }
+        codepoint = ( codepoint << 6 ) | ( next & 0x3F );
+    }
+
+    // Overlong encodings, surrogates and values past U+10FFFF are not characters
+    if ( codepoint < minimum || codepoint > 0x10FFFF || ( codepoint >= 0xD800 && codepoint <= 0xDFFF ) )
+    {
+        index++;
+        return Replacement;
+    }
+    index += length;
+    return codepoint;
+}
+
+template <typename EmitGlyph, typename EndLine>
+float GlyphLayout::Walk( const std::string_view utf8, const float scale, EmitGlyph&& emit, EndLine&& endLine ) const
+{
+    float widest     = 0.0f;
+    float penX       = 0.0f;
+    int line         = 0;
+    uint32_t prev    = 0;
+    size_t index     = 0;
+    const auto close = [&]()
+    {
+        endLine( line, penX );
+        widest = penX > widest ? penX : widest;
+    };
+
+    while ( index < utf8.size() )
+    {
+        const uint32_t codepoint = DecodeUtf8( utf8, index );
+        if ( codepoint == '\n' )
+        {
+            close();
+            penX = 0.0f;
+            prev = 0;
+            line++;
+            continue;
+        }
+
+        const FontGlyph* glyph = font_.Find( codepoint );
+        if ( !glyph )
+            glyph = fallback_;
+        if ( !glyph )
+        {
+            penX += spaceAdvance_ * scale;
+            prev = 0;
+            continue;
+        }
+
+        if ( prev != 0 )
+            penX += static_cast<float>( font_.Kerning( prev, glyph->codepoint ) ) * scale;
+        if ( glyph->width > 0 && glyph->height > 0 )
+            emit( *glyph, penX, line );
+        penX += static_cast<float>( glyph->xAdvance ) * scale;
+        prev = glyph->codepoint;
+    }
+    close();
+    return widest;
+}
+
+float GlyphLayout::Append( const std::string_view utf8, const Vector2D& anchor, const TextStyle& style,
+                           std::vector<GlyphInstance>& out ) const
+{
+    if ( !font_.IsLoaded() || utf8.empty() )
+        return 0.0f;
+
+    const FontFileHeader& header = font_.Header();
+    const float scale            = style.pixelHeight / header.lineHeight;
+    const float invW             = 1.0f / header.scaleW;
+    const float invH             = 1.0f / header.scaleH;
+    size_t lineStart             = out.size();
+
+    const auto emit = [&]( const FontGlyph& glyph, const float penX, const int line )
+    {
+        GlyphInstance& instance = out.emplace_back();
+        instance.anchorX        = anchor.x;
+        instance.anchorY        = anchor.y;
+        instance.offsetX        = style.offset.x + penX + glyph.xOffset * scale;
+        instance.offsetY        = style.offset.y + line * style.pixelHeight + glyph.yOffset * scale;
+        instance.sizeX          = glyph.width * scale;
+        instance.sizeY          = glyph.height * scale;
+        instance.u0             = glyph.x * invW;
+        instance.v0             = glyph.y * invH;
+        instance.u1             = ( glyph.x + glyph.width ) * invW;
+        instance.v1             = ( glyph.y + glyph.height ) * invH;
+        instance.color          = style.color;
+        instance.padding        = 0;
+    };
+
+    // Alignment is applied once a line's width is known, by shifting the glyphs it emitted
+    const auto endLine = [&]( int, const float width )
+    {
+        const float shift = style.align == TextAlign::Center ? width * 0.5f
+                            : style.align == TextAlign::Right ? width
+                                                               : 0.0f;
+        if ( shift != 0.0f )
+        {
+            for ( size_t i = lineStart; i < out.size(); i++ )
+                out[i].offsetX -= shift;
+        }
+        lineStart = out.size();
+    };
+
+    return Walk( utf8, scale, emit, endLine );
+}
+
+float GlyphLayout::Measure( const std::string_view utf8, const float pixelHeight ) const
+{
+    if ( !font_.IsLoaded() || utf8.empty() )
+        return 0.0f;
+
+    return Walk( utf8, pixelHeight / font_.Header().lineHeight, []( const FontGlyph&, float, int ) {},
+                 []( int, float ) {} );
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "FontData.h"
+#include "Vector2D.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Per-instance stream (slot 1) for TextVertexShader: one textured quad per glyph, 48 bytes
+struct GlyphInstance
+{
+    float anchorX; // world position the label is attached to
+    float anchorY;
+    float offsetX; // glyph top-left relative to the anchor, in screen pixels (y down)
+    float offsetY;
+    float sizeX; // screen pixels
+    float sizeY;
+    float u0; // atlas rect
+    float v0;
+    float u1;
+    float v1;
+    uint32_t color; // RGBA8, red in the low byte (IM_COL32 order)
+    uint32_t padding;
+};
+
+static_assert( sizeof( GlyphInstance ) == 48 );
+
+enum class TextAlign
+{
+    Left,   // anchor at the start of each line
+    Center, // anchor at the middle of each line
+    Right,  // anchor at the end of each line
+};
+
+struct TextStyle
+{
+    float pixelHeight = 16.0f;      // line height on screen; glyphs keep a constant screen size under camera zoom
+    uint32_t color    = 0xFFFFFFFF; // RGBA8, red in the low byte
+    TextAlign align   = TextAlign::Left;
+    Vector2D offset;                // screen pixels added to every glyph, so a label can sit beside its anchor
+};
+
+// Turns UTF-8 strings into glyph quads for one instanced draw. Stateless apart from the font, so any number of labels
+// can be appended into the same vector.
+class GlyphLayout
+{
+  public:
+    explicit GlyphLayout( const FontData& font );
+
+    // Appends one instance per visible glyph, first line's top at the anchor and '\n' starting a new line. Returns the
+    // widest line in pixels.
+    float Append( std::string_view utf8, const Vector2D& anchor, const TextStyle& style,
+                  std::vector<GlyphInstance>& out ) const;
+
+    // Width in pixels of the widest line, without emitting anything
+    float Measure( std::string_view utf8, float pixelHeight ) const;
+
+    // Decodes one codepoint at index and advances it. Malformed sequences give U+FFFD and skip one byte.
+    static uint32_t DecodeUtf8( std::string_view text, size_t& index );
+
+  private:
+    template <typename EmitGlyph, typename EndLine>
+    float Walk( std::string_view utf8, float scale, EmitGlyph&& emit, EndLine&& endLine ) const;
+
+    const FontData& font_;
+    const FontGlyph* fallback_; // '?' for codepoints the font lacks, if it has one
+    float spaceAdvance_;        // font pixels, for spaces and missing glyphs when there is no fallback
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+constexpr uint64_t HashSeed = 14695981039346656037ull;
+
+// FNV-1a over 8-byte words, tail bytewise. Not cryptographic; used to spot changed content cheaply.
+inline uint64_t HashBytes( const void* data, const size_t size, uint64_t hash = HashSeed )
+{
+    constexpr uint64_t prime = 1099511628211ull;
+
+    const auto* bytes = static_cast<const unsigned char*>( data );
+    size_t i          = 0;
+    for ( ; i + 8 <= size; i += 8 )
+    {
+        uint64_t word;
+        std::memcpy( &word, bytes + i, 8 );
+        hash = ( hash ^ word ) * prime;
+    }
+    for ( ; i < size; i++ )
+        hash = ( hash ^ bytes[i] ) * prime;
+    return hash;
+}
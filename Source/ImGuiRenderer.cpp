@@ -1,22 +1,26 @@
 #include "ImGuiRenderer.h"
+#include "Profiler.h"
 
-#include <d3dcompiler.h>
+#include <stdexcept>
 
 struct VSConstants
 {
     float mvp[4][4];
 };
 
-bool ImGuiRenderer::Init( HWND hwnd, ID3D11Device* device, ID3D11DeviceContext* context )
+bool ImGuiRenderer::Init( HWND hwnd, ID3D11Device* device, ID3D11DeviceContext* context, AssetSource& assets )
 {
     m_hwnd   = hwnd;
     m_device = device;
     m_ctx    = context;
     IMGUI_CHECKVERSION();
+    // ImGui's heap goes through operator new, so AllocationTracker sees its buffer regrowth
+    ImGui::SetAllocatorFunctions( []( const size_t size, void* ) { return ::operator new( size ); },
+                                  []( void* pointer, void* ) { ::operator delete( pointer ); } );
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
     UpdateFontTexture();
-    CreateDeviceObjects();
+    CreateDeviceObjects( assets );
     return true;
 }
 
@@ -43,60 +47,14 @@ void ImGuiRenderer::NewFrame( float displayWidth, float displayHeight, double de
 
 void ImGuiRenderer::Render()
 {
+    PROFILE_ZONE( "ImGuiRenderer::Render" );
     ImGui::Render();
     ImDrawData* drawData = ImGui::GetDrawData();
     if ( !drawData || drawData->CmdListsCount == 0 )
         return;
 
-    // Create/update buffers
-    int totalVtx = 0, totalIdx = 0;
-    for ( int n = 0; n < drawData->CmdListsCount; n++ )
-    {
-        totalVtx += drawData->CmdLists[n]->VtxBuffer.Size;
-        totalIdx += drawData->CmdLists[n]->IdxBuffer.Size;
-    }
-
-    if ( !m_vb || m_vbSize < totalVtx )
-    {
-        if ( m_vb )
-            m_vb->Release();
-        m_vbSize               = totalVtx + 5000;
-        D3D11_BUFFER_DESC desc = {};
-        desc.Usage             = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth         = m_vbSize * sizeof( ImDrawVert );
-        desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
-        desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
-        m_device->CreateBuffer( &desc, nullptr, &m_vb );
-    }
-    if ( !m_ib || m_ibSize < totalIdx )
-    {
-        if ( m_ib )
-            m_ib->Release();
-        m_ibSize               = totalIdx + 10000;
-        D3D11_BUFFER_DESC desc = {};
-        desc.Usage             = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth         = m_ibSize * sizeof( ImDrawIdx );
-        desc.BindFlags         = D3D11_BIND_INDEX_BUFFER;
-        desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
-        m_device->CreateBuffer( &desc, nullptr, &m_ib );
-    }
-
-    // Upload
-    D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
-    m_ctx->Map( m_vb, 0, D3D11_MAP_WRITE_DISCARD, 0, &vtx_resource );
-    m_ctx->Map( m_ib, 0, D3D11_MAP_WRITE_DISCARD, 0, &idx_resource );
-    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
-    ImDrawIdx* idx_dst  = (ImDrawIdx*)idx_resource.pData;
-    for ( int n = 0; n < drawData->CmdListsCount; n++ )
-    {
-        const ImDrawList* cmd_list = drawData->CmdLists[n];
-        memcpy( vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof( ImDrawVert ) );
-        memcpy( idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof( ImDrawIdx ) );
-        vtx_dst += cmd_list->VtxBuffer.Size;
-        idx_dst += cmd_list->IdxBuffer.Size;
-    }
-    m_ctx->Unmap( m_vb, 0 );
-    m_ctx->Unmap( m_ib, 0 );
+    if ( !UploadGeometry( drawData ) )
+        return;
 
     // Setup render state: alpha blend, scissor, texture, shaders
     UINT stride = sizeof( ImDrawVert );
@@ -126,12 +84,11 @@ void ImGuiRenderer::Render()
     m_ctx->UpdateSubresource( m_cb, 0, nullptr, &vsconst, 0, 0 );
     m_ctx->VSSetConstantBuffers( 0, 1, &m_cb );
 
-    // Render command lists
-    int vtx_offset = 0;
-    int idx_offset = 0;
+    // Render command lists, each from wherever the upload cache placed it
     for ( int n = 0; n < drawData->CmdListsCount; n++ )
     {
-        const ImDrawList* cmd_list = drawData->CmdLists[n];
+        const ImDrawList* cmd_list         = drawData->CmdLists[n];
+        const DrawListPlacement& placement = m_uploadCache.Placements()[n];
         for ( int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++ )
         {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
@@ -148,11 +105,10 @@ void ImGuiRenderer::Render()
                 if ( pcmd->GetTexID() != 0 )
                     tex = (ID3D11ShaderResourceView*)(intptr_t)pcmd->GetTexID();
                 m_ctx->PSSetShaderResources( 0, 1, &tex );
-                m_ctx->DrawIndexed( pcmd->ElemCount, idx_offset, vtx_offset );
+                m_ctx->DrawIndexed( pcmd->ElemCount, placement.indexOffset + pcmd->IdxOffset,
+                                    static_cast<INT>( placement.vertexOffset + pcmd->VtxOffset ) );
             }
-            idx_offset += pcmd->ElemCount;
         }
-        vtx_offset += cmd_list->VtxBuffer.Size;
     }
 
     // Restore a neutral D3D11 state so app rendering isn't constrained
@@ -168,6 +124,85 @@ void ImGuiRenderer::Render()
     m_ctx->PSSetShader( nullptr, nullptr, 0 );
 }
 
+bool ImGuiRenderer::UploadGeometry( const ImDrawData* drawData )
+{
+    m_slices.resize( drawData->CmdListsCount );
+    for ( int n = 0; n < drawData->CmdListsCount; n++ )
+    {
+        const ImDrawList* cmd_list = drawData->CmdLists[n];
+        m_slices[n]                = { cmd_list->VtxBuffer.Data, static_cast<unsigned int>( cmd_list->VtxBuffer.Size ),
+                                       cmd_list->IdxBuffer.Data, static_cast<unsigned int>( cmd_list->IdxBuffer.Size ) };
+    }
+
+    m_uploadCache.Plan( m_slices );
+    if ( m_uploadCache.NeedsRecreate() )
+        CreateGeometryBuffers();
+    if ( !m_uploadCache.AnyUpload() )
+        return true;
+
+    // Appends never touch ranges the GPU may still read; only a ring restart discards
+    const D3D11_MAP mapType = m_uploadCache.Discard() ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+    D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
+    if ( FAILED( m_ctx->Map( m_vb, 0, mapType, 0, &vtx_resource ) ) )
+    {
+        // Plan already counted these lists as written; forget them so the next frame rebuilds the ring and uploads all
+        m_uploadCache.Reset();
+        return false;
+    }
+    if ( FAILED( m_ctx->Map( m_ib, 0, mapType, 0, &idx_resource ) ) )
+    {
+        m_ctx->Unmap( m_vb, 0 );
+        m_uploadCache.Reset();
+        return false;
+    }
+
+    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
+    ImDrawIdx* idx_dst  = (ImDrawIdx*)idx_resource.pData;
+    for ( int n = 0; n < drawData->CmdListsCount; n++ )
+    {
+        const DrawListPlacement& placement = m_uploadCache.Placements()[n];
+        if ( !placement.upload )
+            continue;
+        const ImDrawList* cmd_list = drawData->CmdLists[n];
+        memcpy( vtx_dst + placement.vertexOffset, cmd_list->VtxBuffer.Data,
+                cmd_list->VtxBuffer.Size * sizeof( ImDrawVert ) );
+        memcpy( idx_dst + placement.indexOffset, cmd_list->IdxBuffer.Data,
+                cmd_list->IdxBuffer.Size * sizeof( ImDrawIdx ) );
+    }
+    m_ctx->Unmap( m_vb, 0 );
+    m_ctx->Unmap( m_ib, 0 );
+    return true;
+}
+
+void ImGuiRenderer::CreateGeometryBuffers()
+{
+    if ( m_vb )
+        m_vb->Release();
+    if ( m_ib )
+        m_ib->Release();
+    m_vb = nullptr;
+    m_ib = nullptr;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage             = D3D11_USAGE_DYNAMIC;
+    desc.ByteWidth         = m_uploadCache.VertexCapacity() * sizeof( ImDrawVert );
+    desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
+    desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
+    HRESULT hr             = m_device->CreateBuffer( &desc, nullptr, &m_vb );
+    if ( SUCCEEDED( hr ) )
+    {
+        desc.ByteWidth = m_uploadCache.IndexCapacity() * sizeof( ImDrawIdx );
+        desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+        hr             = m_device->CreateBuffer( &desc, nullptr, &m_ib );
+    }
+    if ( FAILED( hr ) )
+    {
+        // Nothing was placed in buffers that do not exist; the next frame plans from scratch
+        m_uploadCache.Reset();
+        throw std::runtime_error( "Failed to create ImGui geometry buffers" );
+    }
+}
+
 void ImGuiRenderer::ProcessWin32Event( UINT msg, WPARAM wParam, LPARAM lParam )
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -205,7 +240,7 @@ void ImGuiRenderer::ProcessWin32Event( UINT msg, WPARAM wParam, LPARAM lParam )
     }
 }
 
-void ImGuiRenderer::CreateDeviceObjects()
+void ImGuiRenderer::CreateDeviceObjects( AssetSource& assets )
 {
     // Create states
     D3D11_SAMPLER_DESC sd = {};
@@ -250,25 +285,14 @@ void ImGuiRenderer::CreateDeviceObjects()
         { "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, offsetof( ImDrawVert, col ), D3D11_INPUT_PER_VERTEX_DATA, 0 },
     };
 
-    // Create shaders from compiled CSO (compiled by CMake fxc rule)
-    ID3DBlob* vsb = nullptr;
-    ID3DBlob* psb = nullptr;
-    ID3DBlob* err = nullptr;
-    // We rely on Utilities to load precompiled CSO
-    // However for simplicity, we use D3DCompileFromFile here for local compile if available
-    // In this codebase, shaders are compiled externally; input layout only needs a blob.
-    // We'll load the CSO via D3DReadFileToBlob.
-    D3DReadFileToBlob( L"ImGuiVertexShader.cso", &vsb );
-    D3DReadFileToBlob( L"ImGuiPixelShader.cso", &psb );
-    m_device->CreateVertexShader( vsb->GetBufferPointer(), vsb->GetBufferSize(), nullptr, &m_vs );
-    m_device->CreatePixelShader( psb->GetBufferPointer(), psb->GetBufferSize(), nullptr, &m_ps );
-    m_device->CreateInputLayout( ied, 3, vsb->GetBufferPointer(), vsb->GetBufferSize(), &m_layout );
-    if ( vsb )
-        vsb->Release();
-    if ( psb )
-        psb->Release();
-    if ( err )
-        err->Release();
+    // Bytecode compiled by the CMake fxc rule, served from the asset bundle (or loose .cso as a fallback)
+    const AssetSpan vs = assets.Get( "ImGuiVertexShader.cso" );
+    const AssetSpan ps = assets.Get( "ImGuiPixelShader.cso" );
+    if ( vs.empty() || ps.empty() )
+        throw std::runtime_error( "Missing ImGui shader assets" );
+    m_device->CreateVertexShader( vs.data(), vs.size(), nullptr, &m_vs );
+    m_device->CreatePixelShader( ps.data(), ps.size(), nullptr, &m_ps );
+    m_device->CreateInputLayout( ied, 3, vs.data(), vs.size(), &m_layout );
 }
 
 void ImGuiRenderer::InvalidateDeviceObjects()
@@ -283,6 +307,7 @@ void ImGuiRenderer::InvalidateDeviceObjects()
         m_ib->Release();
         m_ib = nullptr;
     }
+    m_uploadCache.Reset();
     if ( m_vs )
     {
         m_vs->Release();
@@ -1,13 +1,16 @@
 #pragma once
 #include "imgui.h"
+#include "AssetSource.h"
+#include "DrawListCache.h"
 
 #include <d3d11.h>
+#include <vector>
 #include <windows.h>
 
 class ImGuiRenderer
 {
   public:
-    bool Init( HWND hwnd, ID3D11Device* device, ID3D11DeviceContext* context );
+    bool Init( HWND hwnd, ID3D11Device* device, ID3D11DeviceContext* context, AssetSource& assets );
     void Shutdown();
 
     void NewFrame( float displayWidth, float displayHeight, double deltaTime );
@@ -15,10 +18,19 @@ class ImGuiRenderer
 
     void ProcessWin32Event( UINT msg, WPARAM wParam, LPARAM lParam );
 
+    // Geometry bytes uploaded vs reused in the last Render()
+    const DrawListCacheStats& UploadStats() const
+    {
+        return m_uploadCache.Stats();
+    }
+
   private:
-    void CreateDeviceObjects();
+    void CreateDeviceObjects( AssetSource& assets );
     void InvalidateDeviceObjects();
     void UpdateFontTexture();
+    void CreateGeometryBuffers();
+    // False when the buffers could not be mapped; nothing is resident and the frame's UI must not be drawn
+    bool UploadGeometry( const ImDrawData* drawData );
 
     HWND m_hwnd                = nullptr;
     ID3D11Device* m_device     = nullptr;
@@ -26,8 +38,10 @@ class ImGuiRenderer
 
     ID3D11Buffer* m_vb = nullptr;
     ID3D11Buffer* m_ib = nullptr;
-    int m_vbSize       = 0;
-    int m_ibSize       = 0;
+
+    // Dynamic vb/ib used as a ring; unchanged command lists keep last frame's copy
+    DrawListCache m_uploadCache{ sizeof( ImDrawVert ), sizeof( ImDrawIdx ) };
+    std::vector<DrawListSlice> m_slices;
 
     ID3D11VertexShader* m_vs            = nullptr;
     ID3D11PixelShader* m_ps             = nullptr;
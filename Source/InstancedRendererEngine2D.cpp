@@ -1,8 +1,19 @@
 #include "InstancedRendererEngine2D.h"
 
 #include "Game/AntGame.h"
+#include "Game/GameRules.h"
+#include "AntStepKernel.h"
 
+#include <WICTextureLoader.h>
+
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 
 // Lightweight UI helpers for consistent overlays
 static inline void DrawRoundedBackground( ImDrawList* dl, const ImVec2& p1, const ImVec2& p2, const ImU32 bg, const ImU32 border,
@@ -16,14 +27,10 @@ static inline void DrawRoundedBackground( ImDrawList* dl, const ImVec2& p1, cons
     dl->AddRect( p1, p2, border, radius );
 }
 
-// Re-implemented SafeRelease helper for COM pointers used in this file
-template <class T> inline void SafeRelease( T** ppT )
+Vector2D InstancedRendererEngine2D::MeasureUiText( const std::string_view text )
 {
-    if ( ppT && *ppT )
-    {
-        ( *ppT )->Release();
-        *ppT = nullptr;
-    }
+    const ImVec2 size = ImGui::CalcTextSize( text.data(), text.data() + text.size() );
+    return { size.x, size.y };
 }
 
 void InstancedRendererEngine2D::SetGame( Game::AntGame* game )
@@ -38,8 +45,85 @@ void InstancedRendererEngine2D::Init(const HWND windowHandle, int blockWidth, in
         throw std::runtime_error( "InstancedRendererEngine2D::Init called before game was bound" );
     }
 
+    startupBegin = std::chrono::steady_clock::now();
+    startTime    = startupBegin;
+
+    // --profile records zones from the start; otherwise F8 turns recording on and off
+    Profiler::SetThreadName( "Render" );
+    Profiler::SetEnabled( wcsstr( GetCommandLineW(), L"--profile" ) != nullptr );
+    assertNoAlloc = wcsstr( GetCommandLineW(), L"--assert-no-alloc" ) != nullptr;
+    if ( wcsstr( GetCommandLineW(), L"--metrics-log" ) )
+    {
+        metricsLog.open( MetricsLogFile, std::ios::trunc );
+        MetricsHistory::WriteCsvHeader( metricsLog );
+    }
+
+    // Startup as a dependency graph: the bundle maps while the device is created, then everything that only needs
+    // the device (thread-safe in D3D11, unlike the immediate context) and the bundle runs side by side. COM is in the
+    // process-wide MTA (see Main.cpp), so WIC works on the worker threads too.
+    TaskGraph startup;
+    const TaskId device = startup.Add( "device", [this, windowHandle] { CreateDevice( windowHandle ); }, {},
+                                       TaskAffinity::Main );
+    const TaskId bundle = startup.Add( "asset bundle",
+                                       [this]
+                                       {
+                                           // --loose-assets skips the bundle so freshly compiled .cso files next to
+                                           // the exe can be tried without repacking
+                                           if ( !wcsstr( GetCommandLineW(), L"--loose-assets" ) )
+                                               assets.OpenBundle( L"assets.bundle" );
+                                       } );
+    const TaskId shaders = startup.Add( "shaders", [this] { LoadShaders(); }, { device, bundle } );
+    startup.Add( "constant buffers", [this]
+                 {
+                     CreateConstantBuffers();
+                     CreatePassTimers();
+                 },
+                 { device } );
+    startup.Add( "meshes", [this] { CreateMeshes(); }, { device } );
+    startup.Add( "font", [this] { CreateText(); }, { device, bundle } );
+    // Kept local until Run() returns: window messages sent during device creation already look at imgui
+    std::unique_ptr<ImGuiRenderer> startupImgui;
+    startup.Add( "imgui", [this, windowHandle, &startupImgui]
+                 {
+                     startupImgui = std::make_unique<ImGuiRenderer>();
+                     startupImgui->Init( windowHandle, pDevice.Get(), pDeviceContext.Get(), assets );
+                 },
+                 { device, bundle } );
+    // Settings come from the bundle, the first food spawn needs the window size
+    startup.Add( "game", [this] { game_->initialize(); }, { device, bundle } );
+
+    startup.Run( static_cast<int>( std::clamp( std::thread::hardware_concurrency(), 2u, 5u ) ) - 1 );
+    imgui             = std::move( startupImgui );
+    startupTasks      = startup.Timings();
+    startupWallMs     = startup.WallMs();
+    startupCriticalMs = startup.CriticalPathMs();
+    startupAssetMs    = startupTasks[bundle].durationMs + startupTasks[shaders].durationMs;
+
+    char assetLog[160];
+    std::snprintf( assetLog, sizeof( assetLog ), "Assets: %s, shaders loaded in %.2f ms (%zu mapped, %zu loose)\n",
+                   assets.Stats().bundleOpen ? "assets.bundle" : "loose files", startupAssetMs,
+                   assets.Stats().bundleHits, assets.Stats().looseReads );
+    OutputDebugStringA( assetLog );
+}
+
+void InstancedRendererEngine2D::InitHeadless( const ViewTransform& view )
+{
+    SetHeadlessView( view );
+    if ( !wcsstr( GetCommandLineW(), L"--loose-assets" ) )
+        assets.OpenBundle( L"assets.bundle" );
+}
+
+void InstancedRendererEngine2D::SetHeadlessView( const ViewTransform& view )
+{
+    cameraPosition = view.cameraPosition;
+    cameraZoom     = view.zoom;
+    screenWidth    = static_cast<UINT>( view.width );
+    screenHeight   = static_cast<UINT>( view.height );
+}
+
+void InstancedRendererEngine2D::CreateDevice( const HWND windowHandle )
+{
     HRESULT hr = S_OK;
-    startTime  = std::chrono::steady_clock::now();
 
     // Create the Device and Swap Chain
     DXGI_SWAP_CHAIN_DESC sd = {};
@@ -65,8 +149,10 @@ void InstancedRendererEngine2D::Init(const HWND windowHandle, int blockWidth, in
                                         pDevice.ReleaseAndGetAddressOf(), nullptr,
                                         pDeviceContext.ReleaseAndGetAddressOf() );
 
-    if ( FAILED( hr ) )
-        return;
+    // Everything else in the startup graph needs the device
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create the D3D11 device and swap chain" );
+
+    renderDevice = std::make_unique<D3D11RenderDevice>( pDeviceContext.Get() );
 
     InitRenderBufferAndTargetView( hr );
     if ( FAILED( hr ) )
@@ -80,44 +166,11 @@ void InstancedRendererEngine2D::Init(const HWND windowHandle, int blockWidth, in
     screenHeight = rc.bottom - rc.top;
 
     SetupViewport( screenWidth, screenHeight );
-
-    LoadShaders();
-
-    // Create instance buffer containing per-ant state
-    UINT instanceCount = 1000;
-    game_->state().instances.reserve( instanceCount );
-
-    for ( UINT i = 0; i < instanceCount; ++i )
-    {
-        InstanceData instance{};
-
-        // Start at nest with a tiny jitter to reduce initial overlap
-        instance.posX       = game_->state().nestPos.x;
-        instance.posY       = game_->state().nestPos.y;
-        instance.directionX = 0;
-        instance.directionY = 0;
-        instance.goalX      = game_->state().nestPos.x;
-        instance.goalY      = game_->state().nestPos.y;
-        instance.laneOffset = 0.03f;
-        instance.speedScale = 1.15f;
-        instance.holdTimer  = 0.0f;
-        instance.color = DirectX::XMFLOAT4( 1.0f, 1.0f, 1.0f,1.0f );
-        instance.movementState = 0; // start heading to food
-        instance.sourceIndex   = -1;
-
-        game_->state().instances.emplace( game_->state().instances.begin() + i, instance );
-    }
-
-    // ImGui wrapper
-    imgui = std::make_unique<ImGuiRenderer>();
-    imgui->Init( windowHandle, pDevice.Get(), pDeviceContext.Get() );
-
-    // Load settings (optional file)
-    CreateMeshes();
 }
 
 void InstancedRendererEngine2D::OnPaint(const HWND windowHandle )
 {
+    PROFILE_ZONE( "InstancedRendererEngine2D::OnPaint" );
     CountFps();
 
     auto currentTime = std::chrono::steady_clock::now();
@@ -134,34 +187,81 @@ void InstancedRendererEngine2D::OnPaint(const HWND windowHandle )
         return;
     }
 
+    renderDevice->BeginFrame();
+    static Metric& uploadBytes = Metrics::Counter( "gpu.uploadBytes" );
+    uploadBytes.Add( static_cast<int64_t>( renderDevice->LastFrame().uploadBytes ) );
+    TrackFrameAllocations();
+    if ( !firstFrame )
+        frameTimings.Record( FramePhase::Frame, deltaTime * 1000.0 );
+    firstFrame = false;
+
     // Define a darker sand-like background to reduce brightness.
     constexpr float clearColor[4] = { 0.55f, 0.50f, 0.40f, 1.0f };
 
     pDeviceContext->ClearRenderTargetView( renderTargetView.Get(), clearColor ); // Clear the back buffer.
 
-    game_->update( deltaTime );
+    // Draw the newest finished step while the simulation thread works on the next one
+    frameInput.time = totalTime;
+    frameInput.view = View();
+    snapshot        = &game_->beginFrame( frameInput );
+    if ( snapshot->sequence != appliedSequence )
+    {
+        ApplyInstanceUploads( snapshot->uploads );
+        ApplyFlowFieldUploads( snapshot->flow );
+        ApplyDistanceFieldUploads( snapshot->distance );
+        appliedSequence = snapshot->sequence;
+        frameTimings.Record( FramePhase::Simulation, snapshot->stepMs );
+    }
 
     // Hover outline overlay on top of fills
     POINT mp;
     GetCursorPos( &mp );
     ScreenToClient( windowHandle, &mp );
 
+    RenderWorld( Game::findNearestFood( snapshot->state, frameInput.view, mp.x, mp.y, 24.0f ) );
+
+    const bool sampled = metricsHistory.Sample( totalTime );
+    if ( sampled && metricsLog.is_open() && totalTime - metricsLoggedAt >= MetricsLogInterval )
+    {
+        metricsHistory.WriteCsv( metricsLog );
+        metricsLog.flush(); // a soak run may end in a crash
+        metricsLoggedAt = totalTime;
+    }
+
     // ImGui frame & UI
+    const auto uiStart = std::chrono::steady_clock::now();
     if ( imgui )
     {
         imgui->NewFrame( static_cast<float>(screenWidth), static_cast<float>(screenHeight), deltaTime );
-        // Prominent status text (game_->state().score + time) centered at the top
+        // Prominent status text (score + time) centered at the top
         RenderProminentStatus();
         RenderUI();
+    }
+    const auto presentStart = std::chrono::steady_clock::now();
+    frameTimings.Record( FramePhase::UiBuild,
+                         std::chrono::duration<double, std::milli>( presentStart - uiStart ).count() );
 
+    if ( imgui )
         imgui->Render();
-    }
 
     // Present the back buffer to the screen.
     // The first parameter (1) enables V-Sync, locking the frame rate to the monitor's refresh rate.
     // Change to 0 to disable V-Sync.
-    HRESULT hr = pSwapChain->Present( 1, 0 );
+    HRESULT hr = S_OK;
+    {
+        PROFILE_ZONE( "Present" );
+        hr = pSwapChain->Present( 1, 0 );
+    }
     if ( FAILED( hr ) ) throw std::runtime_error( "Failed to present swap chain" );
+    frameTimings.Record( FramePhase::Present, std::chrono::duration<double, std::milli>(
+                                                  std::chrono::steady_clock::now() - presentStart ).count() );
+
+    if ( startupFirstFrameMs == 0.0 )
+    {
+        startupFirstFrameMs =
+            std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - startupBegin ).count();
+        ReportStartup();
+    }
 }
 
 void InstancedRendererEngine2D::OnResize(const int width, const int height )
@@ -186,6 +286,11 @@ void InstancedRendererEngine2D::OnResize(const int width, const int height )
 
 void InstancedRendererEngine2D::OnShutdown()
 {
+    if ( frameTimings.Get( FramePhase::Frame ).Count() > 0 && !frameTimings.WriteFile( FrameTimingsFile ) )
+        OutputDebugStringA( "Could not write frame_times.txt\n" );
+    if ( Profiler::Enabled() && !Profiler::WriteChromeTrace( ProfileTraceFile ) )
+        OutputDebugStringA( "Could not write profile_trace.json\n" );
+
     square.reset();
     triangle.reset();
 
@@ -217,34 +322,29 @@ void InstancedRendererEngine2D::SetupViewport(const UINT width, const UINT heigh
     aspectRatioX = ( height > 0 ) ? static_cast<float>(width) / static_cast<float>(height) : 1.0f;
 }
 
-Vector2D InstancedRendererEngine2D::ScreenToWorld(const int x, const int y ) const
+ViewTransform InstancedRendererEngine2D::View() const
 {
-    if ( screenWidth == 0 || screenHeight == 0 )
-        return { cameraPosition.x, cameraPosition.y };
-
-    float fx = static_cast<float>( x ) / static_cast<float>( screenWidth );
-    float fy = static_cast<float>( y ) / static_cast<float>( screenHeight );
-
-    float vx = fx * 2.0f - 1.0f;
-    float vy = 1.0f - fy * 2.0f;
+    ViewTransform view;
+    view.cameraPosition = cameraPosition;
+    view.zoom           = cameraZoom;
+    view.width          = static_cast<int>( screenWidth );
+    view.height         = static_cast<int>( screenHeight );
+    return view;
+}
 
-    return { vx + cameraPosition.x, vy + cameraPosition.y };
+Vector2D InstancedRendererEngine2D::ScreenToWorld(const int x, const int y ) const
+{
+    return View().ScreenToWorld( x, y );
 }
 
 Vector2D InstancedRendererEngine2D::WorldToView( const Vector2D& world ) const
 {
-    return { world.x - cameraPosition.x, world.y - cameraPosition.y };
+    return View().WorldToView( world );
 }
 
 Vector2D InstancedRendererEngine2D::WorldToScreen( const Vector2D& world ) const
 {
-    if ( screenWidth == 0 || screenHeight == 0 ) return { 0.0f, 0.0f };
-
-    Vector2D view = WorldToView( world );
-    float px      = ( view.x + 1.0f ) * 0.5f * static_cast<float>( screenWidth );
-    float py      = ( 1.0f - view.y ) * 0.5f * static_cast<float>( screenHeight );
-
-    return { px, py };
+    return View().WorldToScreen( world );
 }
 
 void InstancedRendererEngine2D::InitRenderBufferAndTargetView( HRESULT& hr )
@@ -279,6 +379,12 @@ void InstancedRendererEngine2D::InitRenderBufferAndTargetView( HRESULT& hr )
     bsDesc.RenderTarget[0].DestBlendAlpha        = D3D11_BLEND_ZERO;
     bsDesc.RenderTarget[0].BlendOpAlpha          = D3D11_BLEND_OP_ADD;
     bsDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+    hr = pDevice->CreateBlendState( &bsDesc, alphaBlendState.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) )
+    {
+        throw std::runtime_error( "Failed to create alphaBlendState" );
+    }
 }
 
 void InstancedRendererEngine2D::CountFps()
@@ -293,7 +399,6 @@ void InstancedRendererEngine2D::CountFps()
     {
         double currentFPS = framesSinceFPSUpdate / timeSinceFPSUpdate;
         lastFPS           = currentFPS;
-        swprintf_s( fpsText, L"FPS:%03.0f", currentFPS ); // Update the global text buffer
 
         // Reset for the next second
         timeSinceFPSUpdate   = 0.0;
@@ -303,27 +408,70 @@ void InstancedRendererEngine2D::CountFps()
 
 void InstancedRendererEngine2D::CreateMeshes()
 {
-    square   = std::make_unique<SquareMesh>( *pDevice.Get() );
-    triangle = std::make_unique<TriangleMesh>( *pDevice.Get() );
+    // Every static shape registers into the arena, then the arena goes up as one vertex and one index buffer
+    square   = std::make_unique<SquareMesh>( meshArena );
+    triangle = std::make_unique<TriangleMesh>( meshArena );
+
+    D3D11_BUFFER_DESC bd      = {};
+    D3D11_SUBRESOURCE_DATA sd = {};
+    bd.Usage                  = D3D11_USAGE_IMMUTABLE;
+    bd.ByteWidth              = static_cast<UINT>( meshArena.Vertices().size() * sizeof( Vertex ) );
+    bd.BindFlags              = D3D11_BIND_VERTEX_BUFFER;
+    sd.pSysMem                = meshArena.Vertices().data();
+
+    HRESULT hr = pDevice->CreateBuffer( &bd, &sd, meshVertexBuffer.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create mesh arena vertex buffer" );
+
+    bd.ByteWidth = static_cast<UINT>( meshArena.Indices().size() * sizeof( UINT ) );
+    bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+    sd.pSysMem   = meshArena.Indices().data();
+
+    hr = pDevice->CreateBuffer( &bd, &sd, meshIndexBuffer.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create mesh arena index buffer" );
+
+    meshArena.SetBuffers( meshVertexBuffer.Get(), meshIndexBuffer.Get() );
 }
 
-void InstancedRendererEngine2D::CreateBuffers( const std::vector<InstanceData>& instances )
+void InstancedRendererEngine2D::CreateConstantBuffers()
 {
-    // Create a buffer description for vertices
-    D3D11_BUFFER_DESC bd = {};
+    // Sized per block; created once because instance storage resizes never touch them
+    const std::pair<UINT, Microsoft::WRL::ComPtr<ID3D11Buffer>*> blocks[] = {
+        { static_cast<UINT>( sizeof( FrameConstants ) ), &frameConstantBuffer },
+        { static_cast<UINT>( sizeof( SimulationConstants ) ), &simulationConstantBuffer },
+        { static_cast<UINT>( sizeof( DrawConstants ) ), &drawConstantBuffer },
+        { static_cast<UINT>( sizeof( DensityConstants ) ), &densityConstantBuffer },
+    };
 
-    // Re-use a buffer description for the input layout like position.
-    bd.Usage     = D3D11_USAGE_DEFAULT;
-    bd.ByteWidth = sizeof( VertexInputData );
-    bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    for ( const auto& [byteWidth, buffer] : blocks )
+    {
+        D3D11_BUFFER_DESC bd = {};
+        bd.Usage             = D3D11_USAGE_DEFAULT;
+        bd.ByteWidth         = byteWidth;
+        bd.BindFlags         = D3D11_BIND_CONSTANT_BUFFER;
 
-    HRESULT hr = pDevice->CreateBuffer( &bd, nullptr, pConstantBuffer.ReleaseAndGetAddressOf() );
-    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create constant buffer" );
+        HRESULT hr = pDevice->CreateBuffer( &bd, nullptr, buffer->ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create constant buffer" );
+    }
 
-    hr         = pDevice->CreateBuffer( &bd, nullptr, flockConstantBuffer.ReleaseAndGetAddressOf() );
-    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create constant buffer" );
+    worldPass.InvalidateConstants();
+    drawConstants.Invalidate();
+}
 
+void InstancedRendererEngine2D::BindConstants()
+{
+    // Same slots in every stage; ImGui rebinds VS b0 for its own pass so this runs once per world pass
+    ID3D11Buffer* constantBuffers[ConstantSlotCount] = {};
+    constantBuffers[FrameConstantSlot]               = frameConstantBuffer.Get();
+    constantBuffers[SimulationConstantSlot]          = simulationConstantBuffer.Get();
+    constantBuffers[DrawConstantSlot]                = drawConstantBuffer.Get();
+    constantBuffers[DensityConstantSlot]             = densityConstantBuffer.Get();
+    pDeviceContext->VSSetConstantBuffers( 0, ConstantSlotCount, constantBuffers );
+    pDeviceContext->PSSetConstantBuffers( 0, ConstantSlotCount, constantBuffers );
+    pDeviceContext->CSSetConstantBuffers( 0, ConstantSlotCount, constantBuffers );
+}
 
+void InstancedRendererEngine2D::CreateBuffers( const std::vector<InstanceData>& instances )
+{
     D3D11_SAMPLER_DESC samplerDesc = {};
     samplerDesc.Filter             = D3D11_FILTER_MIN_MAG_MIP_LINEAR; // Use linear filtering for smooth scaling
     samplerDesc.AddressU           = D3D11_TEXTURE_ADDRESS_CLAMP;
@@ -344,7 +492,7 @@ void InstancedRendererEngine2D::CreateBuffers( const std::vector<InstanceData>&
     instanceBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
     instanceBufferDesc.StructureByteStride = sizeof( InstanceData );
 
-    hr = pDevice->CreateBuffer( &instanceBufferDesc, nullptr, computeBufferA.ReleaseAndGetAddressOf() );
+    HRESULT hr = pDevice->CreateBuffer( &instanceBufferDesc, nullptr, computeBufferA.ReleaseAndGetAddressOf() );
     if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create computerBuffer A" );
 
     hr = pDevice->CreateBuffer( &instanceBufferDesc, nullptr, computeBufferB.ReleaseAndGetAddressOf() );
@@ -384,11 +532,13 @@ void InstancedRendererEngine2D::CreateBuffers( const std::vector<InstanceData>&
     // Actually send the initial random positions to the compute shader buffers
     if ( !instances.empty() )
     {
-        pDeviceContext->UpdateSubresource( computeBufferA.Get(), 0, nullptr, instances.data(), 0, 0 );
-        pDeviceContext->CopyResource( computeBufferB.Get(), computeBufferA.Get() );
+        const UINT instanceBytes = static_cast<UINT>( sizeof( InstanceData ) * instances.size() );
+        renderDevice->UpdateSubresource( computeBufferA.Get(), instances.data(), instanceBytes );
+        renderDevice->CopyResource( computeBufferB.Get(), computeBufferA.Get(), instanceBytes );
     }
 
-    // Create a simple instance buffer to satisfy any copy usage
+    // Bound at slot 1 only to satisfy the flock input layout; the flock VS reads positions from the compute SRV, so
+    // nothing is ever copied into it
     D3D11_BUFFER_DESC instanceVBDesc = {};
     instanceVBDesc.Usage             = D3D11_USAGE_DEFAULT;
     instanceVBDesc.ByteWidth         = sizeof( InstanceData ) * instanceCount;
@@ -480,11 +630,12 @@ void InstancedRendererEngine2D::UploadInstanceBuffer( const std::vector<Instance
     if ( desc.ByteWidth < requiredBytes )
     {
         ResizeInstanceStorage( instances );
+        computeBufferA->GetDesc( &desc );
     }
 
-    pDeviceContext->UpdateSubresource( computeBufferA.Get(), 0, nullptr, instances.data(), 0, 0 );
-    pDeviceContext->CopyResource( computeBufferB.Get(), computeBufferA.Get() );
-    pDeviceContext->CopyResource( instanceBuffer.Get(), computeBufferB.Get() );
+    // Only the live prefix; a whole-resource update would read past the vector when the buffer has spare room
+    renderDevice->UpdateSubresourceRange( computeBufferA.Get(), instances.data(), 0, requiredBytes );
+    renderDevice->CopyResource( computeBufferB.Get(), computeBufferA.Get(), desc.ByteWidth );
 }
 
 void InstancedRendererEngine2D::UploadInstanceSlot(const int slot, const InstanceData& data ) const
@@ -504,16 +655,8 @@ void InstancedRendererEngine2D::UploadInstanceSlot(const int slot, const Instanc
         return;
     }
 
-    D3D11_BOX box{};
-    box.left   = offsetBytes;
-    box.right  = offsetBytes + sizeof( InstanceData );
-    box.top    = 0;
-    box.bottom = 1;
-    box.front  = 0;
-    box.back   = 1;
-
-    pDeviceContext->UpdateSubresource( computeBufferA.Get(), 0, &box, &data, 0, 0 );
-    pDeviceContext->UpdateSubresource( computeBufferB.Get(), 0, &box, &data, 0, 0 );
+    renderDevice->UpdateSubresourceRange( computeBufferA.Get(), &data, offsetBytes, sizeof( InstanceData ) );
+    renderDevice->UpdateSubresourceRange( computeBufferB.Get(), &data, offsetBytes, sizeof( InstanceData ) );
 }
 
 void InstancedRendererEngine2D::ResizeInstanceStorage( const std::vector<InstanceData>& instances )
@@ -521,45 +664,190 @@ void InstancedRendererEngine2D::ResizeInstanceStorage( const std::vector<Instanc
     CreateBuffers( instances );
 }
 
+std::vector<InstanceData> InstancedRendererEngine2D::ReadBackInstances()
+{
+    std::vector<InstanceData> instances;
+    if ( !pDevice || !computeBufferA )
+        return instances;
+
+    // After the flock step's swap, A holds the positions the last dispatch wrote
+    D3D11_BUFFER_DESC desc{};
+    computeBufferA->GetDesc( &desc );
+    desc.Usage          = D3D11_USAGE_STAGING;
+    desc.BindFlags      = 0;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    desc.MiscFlags      = 0;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> staging;
+    const HRESULT hr = pDevice->CreateBuffer( &desc, nullptr, staging.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) )
+        throw std::runtime_error( "Failed to create instance readback buffer" );
+
+    renderDevice->CopyResource( staging.Get(), computeBufferA.Get(), desc.ByteWidth );
+    const void* mapped = renderDevice->Map( staging.Get(), MapMode::Read, desc.ByteWidth );
+    if ( !mapped )
+        throw std::runtime_error( "Failed to map instance readback buffer" );
+    const auto* first = static_cast<const InstanceData*>( mapped );
+    instances.assign( first, first + desc.ByteWidth / sizeof( InstanceData ) );
+    renderDevice->Unmap( staging.Get() );
+    return instances;
+}
+
+void InstancedRendererEngine2D::ApplyInstanceUploads( const Game::InstanceUploads& uploads )
+{
+    if ( uploads.recreate || ( uploads.full && !computeBufferA ) )
+        InitializeSimulationBuffers( uploads.instances );
+    else if ( uploads.full )
+        UploadInstanceBuffer( uploads.instances );
+
+    for ( const auto& [slot, data] : uploads.slots )
+        UploadInstanceSlot( slot, data );
+}
+
+void InstancedRendererEngine2D::ApplyFlowFieldUploads( const Game::FlowFieldUploads& flow )
+{
+    if ( !flow.changed )
+        return;
+
+    const size_t cells = static_cast<size_t>( flow.gridSize ) * flow.gridSize;
+    flowGridSize       = flow.directions.empty() ? 0 : flow.gridSize;
+    flowFieldCount     = cells ? flow.directions.size() / cells : 0;
+    if ( flowGridSize == 0 )
+        return;
+
+    // Both buffers only grow, so adding a field for a new food node rarely recreates them
+    const auto directionCount = static_cast<UINT>( flow.directions.size() );
+    if ( directionCount > flowDirectionCapacity || !flowFoodSlotBuffer )
+    {
+        D3D11_BUFFER_DESC bufferDesc   = {};
+        bufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+        bufferDesc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        bufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        bufferDesc.StructureByteStride = sizeof( uint32_t );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+        viewDesc.Format                          = DXGI_FORMAT_UNKNOWN;
+        viewDesc.ViewDimension                   = D3D11_SRV_DIMENSION_BUFFER;
+
+        const UINT capacity  = max( directionCount, flowDirectionCapacity * 2 );
+        bufferDesc.ByteWidth = sizeof( uint32_t ) * capacity;
+        HRESULT hr = pDevice->CreateBuffer( &bufferDesc, nullptr, flowDirectionBuffer.ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create flowDirectionBuffer" );
+        viewDesc.Buffer.NumElements = capacity;
+        hr = pDevice->CreateShaderResourceView( flowDirectionBuffer.Get(), &viewDesc,
+                                                flowDirectionSRV.ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create flowDirectionSRV" );
+        flowDirectionCapacity = capacity;
+
+        bufferDesc.ByteWidth = sizeof( int32_t ) * MaxFoodNodes;
+        hr = pDevice->CreateBuffer( &bufferDesc, nullptr, flowFoodSlotBuffer.ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create flowFoodSlotBuffer" );
+        viewDesc.Buffer.NumElements = MaxFoodNodes;
+        hr = pDevice->CreateShaderResourceView( flowFoodSlotBuffer.Get(), &viewDesc,
+                                                flowFoodSlotSRV.ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create flowFoodSlotSRV" );
+    }
+
+    renderDevice->UpdateSubresourceRange( flowDirectionBuffer.Get(), flow.directions.data(), 0,
+                                          directionCount * static_cast<UINT>( sizeof( uint32_t ) ) );
+    renderDevice->UpdateSubresourceRange( flowFoodSlotBuffer.Get(), flow.foodSlots.data(), 0,
+                                          static_cast<UINT>( flow.foodSlots.size() * sizeof( int32_t ) ) );
+}
+
+void InstancedRendererEngine2D::ApplyDistanceFieldUploads( const Game::DistanceFieldUploads& distance )
+{
+    if ( !distance.changed )
+        return;
+
+    distanceGridSize = distance.distances.empty() ? 0 : distance.gridSize;
+    if ( distanceGridSize == 0 )
+        return;
+
+    // The grid size is fixed for the run, so the buffer is made once
+    const auto cellCount = static_cast<UINT>( distance.distances.size() );
+    if ( !rockDistanceBuffer )
+    {
+        D3D11_BUFFER_DESC bufferDesc   = {};
+        bufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+        bufferDesc.ByteWidth           = sizeof( float ) * cellCount;
+        bufferDesc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        bufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        bufferDesc.StructureByteStride = sizeof( float );
+        HRESULT hr = pDevice->CreateBuffer( &bufferDesc, nullptr, rockDistanceBuffer.ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create rockDistanceBuffer" );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+        viewDesc.Format                          = DXGI_FORMAT_UNKNOWN;
+        viewDesc.ViewDimension                   = D3D11_SRV_DIMENSION_BUFFER;
+        viewDesc.Buffer.NumElements              = cellCount;
+        hr = pDevice->CreateShaderResourceView( rockDistanceBuffer.Get(), &viewDesc,
+                                                rockDistanceSRV.ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create rockDistanceSRV" );
+    }
+
+    renderDevice->UpdateSubresourceRange( rockDistanceBuffer.Get(), distance.distances.data(), 0,
+                                          cellCount * static_cast<UINT>( sizeof( float ) ) );
+}
+
+AssetSpan InstancedRendererEngine2D::ShaderAsset( const std::string_view name )
+{
+    const AssetSpan bytecode = assets.Get( name );
+    if ( bytecode.empty() )
+        throw std::runtime_error( "Missing shader asset: " + std::string( name ) );
+    return bytecode;
+}
+
 void InstancedRendererEngine2D::LoadShaders()
 {
-    HRESULT hr            = S_FALSE;
-    ID3DBlob* flockVsBlob = nullptr;
-    ID3DBlob* colorVsBlob = nullptr;
-    ID3DBlob* errorBlob   = nullptr;
+    HRESULT hr = S_FALSE;
 
-    const wchar_t* shaderFilePath = L"SquareWaveVertexShader.cso"; // Create a wave vertex shader
-    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, shaderFilePath, &waveVertexShader, nullptr ) )
+    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, ShaderAsset( "SquareWaveVertexShader.cso" ),
+                                         &waveVertexShader ) )
     {
         return;
     };
 
-    shaderFilePath = L"UIPanelVertexShader.cso"; // Create a UI panel vertex shader
-    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, shaderFilePath, &uiVertexShader, nullptr ) )
+    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, ShaderAsset( "UIPanelVertexShader.cso" ), &uiVertexShader ) )
     {
         return;
     };
 
-    shaderFilePath = L"FlockVertexShader.cso";
-    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, shaderFilePath, &flockVertexShader, &flockVsBlob ) )
+    const AssetSpan flockVs = ShaderAsset( "FlockVertexShader.cso" );
+    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, flockVs, &flockVertexShader ) )
     {
         return;
     };
 
-    shaderFilePath = L"ColorVertexShader.cso";
-    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, shaderFilePath, &colorVertexShader, &colorVsBlob ) )
+    const AssetSpan colorVs = ShaderAsset( "ColorVertexShader.cso" );
+    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, colorVs, &colorVertexShader ) )
     {
         return;
     };
 
-    shaderFilePath = L"PlainPixelShader.cso"; // Path to your HLSL file
-    if ( !Utilities::CreatePixelShader( pDevice.Get(), hr, shaderFilePath, &plainPixelShader ) )
+    if ( !Utilities::CreatePixelShader( pDevice.Get(), hr, ShaderAsset( "PlainPixelShader.cso" ), &plainPixelShader ) )
     {
         return;
     };
 
-    shaderFilePath = L"FlockComputeShader.cso"; // Path to your HLSL file
-    if ( !Utilities::CreateComputeShader( pDevice.Get(), hr, shaderFilePath, &flockComputeShader ) )
+    if ( !Utilities::CreateComputeShader( pDevice.Get(), hr, ShaderAsset( "FlockComputeShader.cso" ),
+                                          &flockComputeShader ) )
+    {
+        return;
+    };
+
+    if ( !Utilities::CreateComputeShader( pDevice.Get(), hr, ShaderAsset( "DensitySplatComputeShader.cso" ),
+                                          &densitySplatComputeShader ) )
+    {
+        return;
+    };
+
+    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, ShaderAsset( "DensitySplatVertexShader.cso" ),
+                                         &densitySplatVertexShader ) )
+    {
+        return;
+    };
+
+    if ( !Utilities::CreatePixelShader( pDevice.Get(), hr, ShaderAsset( "DensitySplatPixelShader.cso" ),
+                                        &densitySplatPixelShader ) )
     {
         return;
     };
@@ -569,18 +857,19 @@ void InstancedRendererEngine2D::LoadShaders()
         D3D11_INPUT_ELEMENT_DESC{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
         D3D11_INPUT_ELEMENT_DESC{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT,
                                   D3D11_INPUT_PER_VERTEX_DATA, 0 },
-        // No per-instance data for color VS, but keep a slot reserved if needed later
+        // Per-instance marker stream (MarkerInstance) in slot 1
+        D3D11_INPUT_ELEMENT_DESC{ "INSTANCEPOS", 0, DXGI_FORMAT_R32G32_FLOAT, 1, offsetof( MarkerInstance, posX ),
+                                  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        D3D11_INPUT_ELEMENT_DESC{ "INSTANCESIZE", 0, DXGI_FORMAT_R32G32_FLOAT, 1, offsetof( MarkerInstance, sizeX ),
+                                  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        D3D11_INPUT_ELEMENT_DESC{ "INSTANCECODE", 0, DXGI_FORMAT_R32G32_SINT, 1, offsetof( MarkerInstance, colorCode ),
+                                  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
     };
 
     // Create the color input layout using the Color VS signature
-    hr = pDevice->CreateInputLayout( layout, ARRAYSIZE( layout ), colorVsBlob->GetBufferPointer(),
-                                     colorVsBlob->GetBufferSize(), &pInputLayout );
+    hr = pDevice->CreateInputLayout( layout, ARRAYSIZE( layout ), colorVs.data(), colorVs.size(), &pInputLayout );
     if ( FAILED( hr ) )
-    {
-        SafeRelease( &colorVsBlob );
-        SafeRelease( &errorBlob );
         return;
-    }
 
     // This layout ONLY describes what the flock shader needs.
     D3D11_INPUT_ELEMENT_DESC flockLayout[] = {
@@ -588,41 +877,58 @@ void InstancedRendererEngine2D::LoadShaders()
         { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
         { "INSTANCEPOS", 0, DXGI_FORMAT_R32G32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 } };
 
-    hr = pDevice->CreateInputLayout( flockLayout, ARRAYSIZE( flockLayout ), flockVsBlob->GetBufferPointer(),
-                                     flockVsBlob->GetBufferSize(),
+    hr = pDevice->CreateInputLayout( flockLayout, ARRAYSIZE( flockLayout ), flockVs.data(), flockVs.size(),
                                      &flockInputLayout // Create the dedicated layout
     );
 
     if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create input layout for flock" );
 
+    const AssetSpan textVs = ShaderAsset( "TextVertexShader.cso" );
+    if ( !Utilities::CreateVertexShader( pDevice.Get(), hr, textVs, &textVertexShader ) )
+    {
+        return;
+    };
 
-    SafeRelease( &flockVsBlob );
-    SafeRelease( &colorVsBlob );
-    SafeRelease( &errorBlob );
-}
-
-void InstancedRendererEngine2D::SetupVerticesAndShaders( const UINT& stride, const UINT& offset, const Mesh* mesh, ID3D11VertexShader* vertexShader, ID3D11PixelShader* pixelShader ) const
-{
-    pDeviceContext->IASetVertexBuffers( 0, 1, &mesh->vertexBuffer, &stride, &offset );
-    pDeviceContext->IASetIndexBuffer( mesh->indexBuffer, DXGI_FORMAT_R32_UINT, 0 );
+    if ( !Utilities::CreatePixelShader( pDevice.Get(), hr, ShaderAsset( "TextPixelShader.cso" ), &textPixelShader ) )
+    {
+        return;
+    };
 
-    pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST ); // Define what primitive we should draw with the vertex and indices
+    // Unit quad corners from the square mesh, everything else per glyph (GlyphInstance in slot 1)
+    D3D11_INPUT_ELEMENT_DESC textLayout[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "GLYPHANCHOR", 0, DXGI_FORMAT_R32G32_FLOAT, 1, offsetof( GlyphInstance, anchorX ),
+          D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        { "GLYPHOFFSET", 0, DXGI_FORMAT_R32G32_FLOAT, 1, offsetof( GlyphInstance, offsetX ),
+          D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        { "GLYPHSIZE", 0, DXGI_FORMAT_R32G32_FLOAT, 1, offsetof( GlyphInstance, sizeX ), D3D11_INPUT_PER_INSTANCE_DATA,
+          1 },
+        { "GLYPHUV", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof( GlyphInstance, u0 ), D3D11_INPUT_PER_INSTANCE_DATA,
+          1 },
+        { "GLYPHCOLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, offsetof( GlyphInstance, color ),
+          D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    };
 
-    pDeviceContext->VSSetShader( vertexShader, nullptr, 0 );
-    pDeviceContext->PSSetShader( pixelShader, nullptr, 0 );
+    hr = pDevice->CreateInputLayout( textLayout, ARRAYSIZE( textLayout ), textVs.data(), textVs.size(),
+                                     &textInputLayout );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create input layout for text" );
 }
 
-void InstancedRendererEngine2D::PassInputDataAndRunInstanced( ID3D11Buffer* buffer, VertexInputData& cbData, Mesh& mesh, int instanceCount ) const
+void InstancedRendererEngine2D::PassInputDataAndRunInstanced( const DrawConstants& cbData, const MeshId mesh,
+                                                              const int instanceCount )
 {
-    pDeviceContext->UpdateSubresource( buffer, 0, nullptr, &cbData, 0, 0 );
-    pDeviceContext->VSSetConstantBuffers( 0, 1, &buffer ); // Actually pass the variables to the vertex shader
-    pDeviceContext->DrawIndexedInstanced( mesh.indexCount, instanceCount, 0, 0, 0 );
+    drawConstants.Update( *renderDevice, drawConstantBuffer.Get(), cbData ); // b2 is already bound by BindConstants
+    const MeshBinding binding = meshArena.Binding( mesh );
+    renderDevice->BindMesh( binding );
+    renderDevice->DrawMesh( binding, instanceCount, 0 );
 }
 
-void InstancedRendererEngine2D::RunComputeShader( ID3D11Buffer* buffer, VertexInputData& cbData, int instanceCount, ID3D11ComputeShader* computeShader )
+void InstancedRendererEngine2D::BeginFlockStep()
 {
-    ID3D11ShaderResourceView* shaderResourceViewList[] = { shaderResourceViewA.Get() };
-    pDeviceContext->CSSetShaderResources( 0, 1, shaderResourceViewList );
+    ID3D11ShaderResourceView* shaderResourceViewList[] = { shaderResourceViewA.Get(), flowDirectionSRV.Get(),
+                                                           flowFoodSlotSRV.Get(), rockDistanceSRV.Get() };
+    pDeviceContext->CSSetShaderResources( 0, 4, shaderResourceViewList );
 
     // Clear hit counts to zero each frame via UAV clears
     constexpr UINT zeros4[4] = { 0, 0, 0, 0 };
@@ -633,91 +939,382 @@ void InstancedRendererEngine2D::RunComputeShader( ID3D11Buffer* buffer, VertexIn
     UINT initialCounts[]              = { 0, 0, 0 };
     pDeviceContext->CSSetUnorderedAccessViews( 0, 3, unorderedAccessViewList, initialCounts );
 
-    pDeviceContext->UpdateSubresource( buffer, 0, nullptr, &cbData, 0, 0 );
-    pDeviceContext->CSSetConstantBuffers( 0, 1, &buffer );
+    pDeviceContext->CSSetShader( flockComputeShader.Get(), nullptr, 0 );
+}
 
-    pDeviceContext->CSSetShader( computeShader, nullptr, 0 );
-    pDeviceContext->Dispatch( ( instanceCount + 255 ) / 256, 1, 1 );
+void InstancedRendererEngine2D::BeginReadback()
+{
+    readbackStart = std::chrono::steady_clock::now();
+}
 
-    pDeviceContext->CopyResource( instanceBuffer.Get(), computeBufferB.Get() );
+void InstancedRendererEngine2D::FoodCounts( const uint32_t* counts )
+{
+    static Metric& foodHits = Metrics::Counter( "hits.food" );
+    const size_t n          = min( snapshot->state.foodNodes.size(), static_cast<size_t>( MaxFoodNodes ) );
+    const uint64_t added    = HitCounts::AccumulateFood( counts, n, HitBins, frameInput.foodHits.data() );
+    foodHits.Add( static_cast<int64_t>( added ) );
+}
 
-    // Read back food counts and decrease amounts per node
-    int w = readbackCursor;
-    int r = ( readbackCursor + 1 ) % 3;
-    pDeviceContext->CopyResource( foodCountReadback[w].Get(), foodCountBuffer.Get() );
-    pDeviceContext->End( foodQuery[w].Get() );
-    D3D11_MAPPED_SUBRESOURCE mapped = {};
-    if ( pDeviceContext->GetData( foodQuery[r].Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH ) == S_OK &&
-         SUCCEEDED( pDeviceContext->Map( foodCountReadback[r].Get(), 0, D3D11_MAP_READ, 0, &mapped ) ) )
-    {
-        UINT* counts = (UINT*)mapped.pData;
-        size_t n     = game_->state().foodNodes.size();
-        for ( size_t i = 0; i < n && i < static_cast<size_t>(MaxFoodNodes); ++i )
-        {
-            // Sum across bins
-            UINT sum = 0;
-            for ( int b = 0; b < HitBins; b++ )
-                sum += counts[i * HitBins + b];
-            if ( sum > 0 )
-            {
-                auto dec                          = static_cast<float>(sum);
-                game_->state().foodNodes[i].amount = max( 0.0f, game_->state().foodNodes[i].amount - dec );
-            }
-        }
-        pDeviceContext->Unmap( foodCountReadback[r].Get(), 0 );
-    }
+void InstancedRendererEngine2D::NestCounts( const uint32_t* counts )
+{
+    static Metric& nestHits  = Metrics::Counter( "hits.nest" );
+    const size_t n           = min( snapshot->state.foodNodes.size(), static_cast<size_t>( MaxFoodNodes ) );
+    const uint64_t totalHits = HitCounts::SumNest( counts, n, HitBins );
+    frameInput.nestHits += totalHits;
+    nestHits.Add( static_cast<int64_t>( totalHits ) );
+}
 
-    // Read back nest counts and add to game_->state().score/game_->state().stageScore
-    pDeviceContext->CopyResource( nestCountReadback[w].Get(), nestCountBuffer.Get() );
-    pDeviceContext->End( nestQuery[w].Get() );
-    D3D11_MAPPED_SUBRESOURCE mappedN = {};
-    if ( pDeviceContext->GetData( nestQuery[r].Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH ) == S_OK &&
-         SUCCEEDED( pDeviceContext->Map( nestCountReadback[r].Get(), 0, D3D11_MAP_READ, 0, &mappedN ) ) )
-    {
-        UINT* countsN  = (UINT*)mappedN.pData;
-        UINT totalHits = 0;
-        size_t n       = game_->state().foodNodes.size();
-        for ( size_t i = 0; i < n && i < static_cast<size_t>(MaxFoodNodes); ++i )
-        {
-            for ( int b = 0; b < HitBins; b++ )
-                totalHits += countsN[i * HitBins + b];
-        }
-        if ( totalHits > 0 )
-        {
-            // Combo handling
-            if ( game_->state().sinceLastDeposit < 0.5 )
-                game_->state().combo = min( 5, game_->state().combo + 1 );
-            else
-                game_->state().combo = 1;
-            game_->state().sinceLastDeposit = 0.0;
-            int add                         = static_cast<int>(totalHits) * game_->state().combo;
-            game_->state().score += add;
-            game_->state().stageScore += add;
-        }
-        pDeviceContext->Unmap( nestCountReadback[r].Get(), 0 );
-    }
+void InstancedRendererEngine2D::ReadbackMissed()
+{
+    static Metric& droppedReadback = Metrics::Counter( "readback.dropped" ); // copy not ready, its hits are lost
+    droppedReadback.Add();
+}
 
+void InstancedRendererEngine2D::EndReadback()
+{
+    frameTimings.Record( FramePhase::Readback, std::chrono::duration<double, std::milli>(
+                                                   std::chrono::steady_clock::now() - readbackStart ).count() );
+}
+
+void InstancedRendererEngine2D::EndFlockStep()
+{
     // Swap, back buffer style
     std::swap( computeBufferA, computeBufferB );
     std::swap( shaderResourceViewA, shaderResourceViewB );
     std::swap( unorderedAccessViewA, unorderedAccessViewB );
     {
-        ID3D11ShaderResourceView* nullSRVs[1]  = { nullptr };
+        ID3D11ShaderResourceView* nullSRVs[4]  = { nullptr, nullptr, nullptr, nullptr };
         ID3D11UnorderedAccessView* nullUAVs[3] = { nullptr, nullptr, nullptr };
         UINT nullCounts[3]                     = { 0, 0, 0 };
-        pDeviceContext->CSSetShaderResources( 0, 1, nullSRVs );
+        pDeviceContext->CSSetShaderResources( 0, 4, nullSRVs );
         pDeviceContext->CSSetUnorderedAccessViews( 0, 3, nullUAVs, nullCounts );
         pDeviceContext->CSSetShader( nullptr, nullptr, 0 );
     }
 
-    // Unset the compute buffers so they can be used elsewhere
+    pDeviceContext->OMSetBlendState( alphaBlendState.Get(), nullptr, 0xFFFFFFFF );
+}
+
+void InstancedRendererEngine2D::RenderWorld( const int hoverIndex )
+{
+    const auto& state = snapshot->state;
+    if ( !computeBufferA || !flockComputeShader || !square )
+        return;
+
+    const int antCount = min( state.activeAnts, snapshot->instanceCount );
+    static Metric& antsStepped = Metrics::Gauge( "ants.stepped" );
+    antsStepped.Set( antCount );
+
+    WorldPassFrame world;
+    world.antCount             = antCount;
+    world.frame.aspectRatio    = aspectRatioX;
+    world.frame.time           = static_cast<float>( totalTime );
+    world.frame.frameDeltaTime = static_cast<float>( deltaTime );
+    world.frame.cameraZoom     = cameraZoom;
+    world.frame.cameraPosX     = cameraPosition.x;
+    world.frame.cameraPosY     = cameraPosition.y;
+    world.frame.screenWidth    = static_cast<float>( screenWidth );
+    world.frame.screenHeight   = static_cast<float>( screenHeight );
+
+    world.simulation                  = Game::simulationConstants( state, static_cast<float>( deltaTime ) );
+    world.simulation.flowGridSize     = flowGridSize;
+    world.simulation.distanceGridSize = distanceGridSize;
+
+    world.passes = DensityLod::ChoosePasses( lodMode, antCount, lodSettings );
+    // The grid is only made once a zoom level actually needs the density or splat pass
+    if ( world.passes.density || world.passes.splat )
+        EnsureDensityGrid( screenWidth, screenHeight );
+
+    world.density.gridX         = densityGridX;
+    world.density.gridY         = densityGridY;
+    world.density.cellPixels    = lodSettings.cellPixels;
+    world.density.instanceCount = antCount;
+    world.density.lodStart      = lodSettings.startAntsPerPixel;
+    world.density.lodEnd        = lodSettings.endAntsPerPixel;
+    world.density.lodMode       = static_cast<int>( world.passes.mode );
+
+    BuildMarkers( hoverIndex );
+    if ( triangle )
+        world.markers = &markers;
+    BuildLabels();
+    world.glyphs = glyphInstances;
+
+    WorldPassResources resources;
+    resources.frameConstants      = frameConstantBuffer.Get();
+    resources.simulationConstants = simulationConstantBuffer.Get();
+    resources.densityConstants    = densityConstantBuffer.Get();
+    resources.antInstances        = instanceBuffer.Get();
+    resources.markerInstances     = markerInstanceBuffer.Get();
+    resources.glyphInstances      = glyphInstanceBuffer.Get();
+    resources.square              = meshArena.Binding( square->id );
+    if ( triangle )
+        resources.triangle = meshArena.Binding( triangle->id );
+    resources.foodCounts = foodCountBuffer.Get();
+    resources.nestCounts = nestCountBuffer.Get();
+    resources.countBytes = sizeof( UINT ) * MaxFoodNodes * HitBins;
+    for ( int i = 0; i < WorldPassResources::RingDepth; i++ )
+    {
+        resources.foodReadback[i] = foodCountReadback[i].Get();
+        resources.nestReadback[i] = nestCountReadback[i].Get();
+        resources.foodQuery[i]    = foodQuery[i].Get();
+        resources.nestQuery[i]    = nestQuery[i].Get();
+        resources.passDisjoint[i] = passDisjointQuery[i].Get();
+        for ( int stamp = 0; stamp < 4; stamp++ )
+            resources.passTimestamps[i][stamp] = passTimestampQuery[i][stamp].Get();
+    }
+
+    ResolvePassTimers();
+    worldPass.Submit( *renderDevice, *this, resources, world );
+}
+
+void InstancedRendererEngine2D::BuildMarkers( const int hoverIndex )
+{
+    const auto& state = snapshot->state;
+    markers.Build( state.foodNodes, state.activeFoodIndex, hoverIndex, state.nestPos, state.defaultFoodAmount,
+                   aspectRatioX, state.rocks );
+    if ( !markers.Instances().empty() )
+        EnsureMarkerCapacity( markers.Instances().size() );
+}
+
+void InstancedRendererEngine2D::BeginMarkers()
+{
+    // Only the frame block (b0) is read; position, size and color come from the instance stream
+    pDeviceContext->IASetInputLayout( pInputLayout.Get() );
+    pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    pDeviceContext->VSSetShader( colorVertexShader.Get(), nullptr, 0 );
+    pDeviceContext->PSSetShader( plainPixelShader.Get(), nullptr, 0 );
+}
+
+void InstancedRendererEngine2D::EnsureMarkerCapacity( const size_t count )
+{
+    if ( markerInstanceBuffer && count <= markerCapacity )
+        return;
+
+    // Grow geometrically so node spawns don't recreate the buffer every stage
+    UINT capacity = max( 64u, markerCapacity );
+    while ( capacity < count )
+        capacity *= 2;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage             = D3D11_USAGE_DEFAULT;
+    desc.ByteWidth         = static_cast<UINT>( sizeof( MarkerInstance ) ) * capacity;
+    desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
+
+    HRESULT hr = pDevice->CreateBuffer( &desc, nullptr, markerInstanceBuffer.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create markerInstanceBuffer" );
+
+    markerCapacity = capacity;
+}
+
+void InstancedRendererEngine2D::CreateText()
+{
+    // Converted offline by font_converter, so loading is a bounds check over the mapped bytes
+    if ( !font.Load( assets.Get( "testFont.font" ) ) )
+        throw std::runtime_error( "Missing or invalid font asset testFont.font" );
+    glyphLayout = std::make_unique<GlyphLayout>( font );
+
+    const AssetSpan atlas = assets.Get( "testFont_0.png" );
+    HRESULT hr            = DirectX::CreateWICTextureFromMemory( pDevice.Get(), atlas.data(), atlas.size(), nullptr,
+                                                                 fontAtlasSRV.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to load font atlas testFont_0.png" );
+
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter             = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samplerDesc.AddressU           = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressV           = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressW           = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.ComparisonFunc     = D3D11_COMPARISON_NEVER;
+    samplerDesc.MaxLOD             = D3D11_FLOAT32_MAX;
+
+    hr = pDevice->CreateSamplerState( &samplerDesc, fontSampler.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create font sampler" );
+}
+
+void InstancedRendererEngine2D::BuildLabels()
+{
+    glyphInstances.clear();
+    if ( !glyphLayout || !fontAtlasSRV )
+        return;
+
+    // Centered over the nest square (mesh x is divided by the aspect ratio in ColorVertexShader)
+    const auto& state = snapshot->state;
+    TextStyle nestStyle;
+    nestStyle.pixelHeight = 18.0f;
+    nestStyle.color       = IM_COL32( 255, 255, 255, 230 );
+    nestStyle.align       = TextAlign::Center;
+    nestStyle.offset      = Vector2D( 0.0f, -nestStyle.pixelHeight - 4.0f );
+    glyphLayout->Append( "Nest", Vector2D( state.nestPos.x + 0.025f / aspectRatioX, state.nestPos.y ), nestStyle,
+                         glyphInstances );
+
+    if ( !glyphInstances.empty() )
+        EnsureGlyphCapacity( glyphInstances.size() );
+}
+
+void InstancedRendererEngine2D::BeginLabels()
+{
+    pDeviceContext->IASetInputLayout( textInputLayout.Get() );
+    pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    pDeviceContext->VSSetShader( textVertexShader.Get(), nullptr, 0 );
+    pDeviceContext->PSSetShader( textPixelShader.Get(), nullptr, 0 );
+    ID3D11ShaderResourceView* srvs[] = { fontAtlasSRV.Get() };
+    ID3D11SamplerState* samplers[]   = { fontSampler.Get() };
+    pDeviceContext->PSSetShaderResources( 0, 1, srvs );
+    pDeviceContext->PSSetSamplers( 0, 1, samplers );
+}
+
+void InstancedRendererEngine2D::EndLabels()
+{
+    ID3D11ShaderResourceView* nullSRVs[1] = { nullptr };
+    pDeviceContext->PSSetShaderResources( 0, 1, nullSRVs );
+}
+
+void InstancedRendererEngine2D::EnsureGlyphCapacity( const size_t count )
+{
+    if ( glyphInstanceBuffer && count <= glyphCapacity )
+        return;
+
+    UINT capacity = max( 256u, glyphCapacity );
+    while ( capacity < count )
+        capacity *= 2;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage             = D3D11_USAGE_DEFAULT;
+    desc.ByteWidth         = static_cast<UINT>( sizeof( GlyphInstance ) ) * capacity;
+    desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
+
+    HRESULT hr = pDevice->CreateBuffer( &desc, nullptr, glyphInstanceBuffer.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create glyphInstanceBuffer" );
+
+    glyphCapacity = capacity;
+}
+
+void InstancedRendererEngine2D::BeginDensity()
+{
+    constexpr UINT zeros4[4] = { 0, 0, 0, 0 };
+    pDeviceContext->ClearUnorderedAccessViewUint( densityGridUAV.Get(), zeros4 );
+
+    // After the flock step's swap, A holds this frame's positions
+    ID3D11ShaderResourceView* srvs[]  = { shaderResourceViewA.Get() };
+    ID3D11UnorderedAccessView* uavs[] = { densityGridUAV.Get() };
+    pDeviceContext->CSSetShaderResources( 0, 1, srvs );
+    pDeviceContext->CSSetUnorderedAccessViews( 0, 1, uavs, nullptr );
+    pDeviceContext->CSSetShader( densitySplatComputeShader.Get(), nullptr, 0 );
+}
+
+void InstancedRendererEngine2D::EndDensity()
+{
     ID3D11ShaderResourceView* nullSRVs[1]  = { nullptr };
-    ID3D11UnorderedAccessView* nullUAVs[3] = { nullptr, nullptr, nullptr };
+    ID3D11UnorderedAccessView* nullUAVs[1] = { nullptr };
     pDeviceContext->CSSetShaderResources( 0, 1, nullSRVs );
-    pDeviceContext->CSSetUnorderedAccessViews( 0, 3, nullUAVs, nullptr );
+    pDeviceContext->CSSetUnorderedAccessViews( 0, 1, nullUAVs, nullptr );
     pDeviceContext->CSSetShader( nullptr, nullptr, 0 );
+}
+
+void InstancedRendererEngine2D::BeginAnts()
+{
+    pDeviceContext->IASetInputLayout( flockInputLayout.Get() );
+    pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    pDeviceContext->VSSetShader( flockVertexShader.Get(), nullptr, 0 );
+    pDeviceContext->PSSetShader( plainPixelShader.Get(), nullptr, 0 );
 
-    readbackCursor = ( readbackCursor + 1 ) % 3;
+    ID3D11ShaderResourceView* srvs[] = { shaderResourceViewA.Get(), densityGridSRV.Get() };
+    pDeviceContext->VSSetShaderResources( 0, 2, srvs );
+}
+
+void InstancedRendererEngine2D::EndAnts()
+{
+    // Unbind so next frame's compute pass can write these resources
+    ID3D11ShaderResourceView* nullSRVs[2] = { nullptr, nullptr };
+    pDeviceContext->VSSetShaderResources( 0, 2, nullSRVs );
+}
+
+void InstancedRendererEngine2D::BeginSplat()
+{
+    pDeviceContext->IASetInputLayout( nullptr );
+    pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    pDeviceContext->VSSetShader( densitySplatVertexShader.Get(), nullptr, 0 );
+    pDeviceContext->PSSetShader( densitySplatPixelShader.Get(), nullptr, 0 );
+
+    ID3D11ShaderResourceView* srvs[] = { densityGridSRV.Get() };
+    pDeviceContext->PSSetShaderResources( 0, 1, srvs );
+}
+
+void InstancedRendererEngine2D::EndSplat()
+{
+    ID3D11ShaderResourceView* nullSRVs[1] = { nullptr };
+    pDeviceContext->PSSetShaderResources( 0, 1, nullSRVs );
+}
+
+void InstancedRendererEngine2D::EnsureDensityGrid( const UINT width, const UINT height )
+{
+    const int gridX = DensityLod::GridCells( width, lodSettings );
+    const int gridY = DensityLod::GridCells( height, lodSettings );
+    if ( densityGrid && gridX == densityGridX && gridY == densityGridY )
+        return;
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width                = static_cast<UINT>( gridX );
+    desc.Height               = static_cast<UINT>( gridY );
+    desc.MipLevels            = 1;
+    desc.ArraySize            = 1;
+    desc.Format               = DXGI_FORMAT_R32_UINT;
+    desc.SampleDesc.Count     = 1;
+    desc.Usage                = D3D11_USAGE_DEFAULT;
+    desc.BindFlags            = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+
+    HRESULT hr = pDevice->CreateTexture2D( &desc, nullptr, densityGrid.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create densityGrid" );
+
+    hr = pDevice->CreateUnorderedAccessView( densityGrid.Get(), nullptr, densityGridUAV.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create densityGridUAV" );
+
+    hr = pDevice->CreateShaderResourceView( densityGrid.Get(), nullptr, densityGridSRV.ReleaseAndGetAddressOf() );
+    if ( FAILED( hr ) ) throw std::runtime_error( "Failed to create densityGridSRV" );
+
+    densityGridX = gridX;
+    densityGridY = gridY;
+}
+
+void InstancedRendererEngine2D::CreatePassTimers()
+{
+    D3D11_QUERY_DESC disjointDesc = {};
+    disjointDesc.Query            = D3D11_QUERY_TIMESTAMP_DISJOINT;
+    D3D11_QUERY_DESC stampDesc    = {};
+    stampDesc.Query               = D3D11_QUERY_TIMESTAMP;
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        HRESULT hr = pDevice->CreateQuery( &disjointDesc, passDisjointQuery[i].ReleaseAndGetAddressOf() );
+        if ( FAILED( hr ) )
+            throw std::runtime_error( "Failed to create passDisjointQuery" );
+        for ( auto& stamp : passTimestampQuery[i] )
+        {
+            hr = pDevice->CreateQuery( &stampDesc, stamp.ReleaseAndGetAddressOf() );
+            if ( FAILED( hr ) )
+                throw std::runtime_error( "Failed to create passTimestampQuery" );
+        }
+    }
+}
+
+void InstancedRendererEngine2D::ResolvePassTimers()
+{
+    // Oldest slot in the ring; never stall the frame waiting on it
+    const int r = worldPass.ReadSlot();
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+    if ( !renderDevice->GetData( passDisjointQuery[r].Get(), &disjoint, sizeof( disjoint ) ) || disjoint.Disjoint ||
+         disjoint.Frequency == 0 )
+        return;
+
+    UINT64 stamps[4] = {};
+    for ( int i = 0; i < 4; i++ )
+    {
+        if ( !renderDevice->GetData( passTimestampQuery[r][i].Get(), &stamps[i], sizeof( UINT64 ) ) )
+            return;
+    }
+
+    const double toMs = 1000.0 / static_cast<double>( disjoint.Frequency );
+    splatPassMs       = static_cast<double>( ( stamps[1] - stamps[0] ) + ( stamps[3] - stamps[2] ) ) * toMs;
+    antPassMs         = static_cast<double>( stamps[2] - stamps[1] ) * toMs;
 }
 
 void InstancedRendererEngine2D::RenderUI()
@@ -725,11 +1322,18 @@ void InstancedRendererEngine2D::RenderUI()
     // Per-node amounts as overlay (no windows)
     if ( ImGui::GetCurrentContext() )
     {
-        ImDrawList* dl = ImGui::GetForegroundDrawList();
-        float base     = game_->state().defaultFoodAmount > 1e-5f ? game_->state().defaultFoodAmount : 100.0f;
-        for ( size_t i = 0; i < game_->state().foodNodes.size(); ++i )
+        ImDrawList* dl      = ImGui::GetForegroundDrawList();
+        const auto& state   = snapshot->state;
+        float base          = state.defaultFoodAmount > 1e-5f ? state.defaultFoodAmount : 100.0f;
+        const float screenW = static_cast<float>( screenWidth );
+        const float screenH = static_cast<float>( screenHeight );
+        foodLabelsOffScreen = 0;
+        foodLabels.ResetStats();
+        foodLabels.Resize( state.foodNodes.size() );
+        labelCandidates.clear();
+        for ( size_t i = 0; i < state.foodNodes.size(); ++i )
         {
-            const auto& node = game_->state().foodNodes[i];
+            const auto& node = state.foodNodes[i];
             float ratio      = node.amount / base;
             ratio            = max( 0.3f, min( ratio, 2.5f ) );
 
@@ -737,58 +1341,274 @@ void InstancedRendererEngine2D::RenderUI()
             Vector2D screen = WorldToScreen( node.pos );
             float sx        = screen.x;
             float sy        = screen.y;
-            float widthPx   = ( 0.05f * 2.0f * ratio / aspectRatioX ) * ( static_cast<float>(screenWidth) * 0.5f );
-            float heightPx  = ( 0.05f * 2.0f * ratio ) * ( static_cast<float>(screenHeight) * 0.5f );
+            float widthPx   = ( 0.05f * 2.0f * ratio * cameraZoom / aspectRatioX ) * ( screenW * 0.5f );
+            float heightPx  = ( 0.05f * 2.0f * ratio * cameraZoom ) * ( screenH * 0.5f );
             ImVec2 center( sx + widthPx * 0.5f, sy + heightPx * 0.5f );
 
-            wchar_t textBuffer[32];
-            swprintf_s( textBuffer, L"%.0f", max( 0.0f, node.amount ) );
+            // Off-screen nodes are skipped before their label is formatted; the margin covers a label wider than its
+            // node
+            if ( sx + widthPx < -LabelCullMargin || sy + heightPx < -LabelCullMargin ||
+                 sx > screenW + LabelCullMargin || sy > screenH + LabelCullMargin )
+            {
+                foodLabelsOffScreen++;
+                continue;
+            }
 
-            char buf[32];
-            wcstombs( buf, textBuffer, sizeof( buf ) );
+            // Re-formatted and re-measured only when the rounded amount changes
+            const int amount = static_cast<int>( std::lround( max( 0.0f, node.amount ) ) );
+            foodLabels.Get( i, amount, [amount]( char* out, const size_t capacity )
+                            { return static_cast<size_t>( std::to_chars( out, out + capacity, amount ).ptr - out ); } );
+
+            // Snapped to whole pixels so a still camera gives bit-identical candidates and the layout is reused
+            const Vector2D textSize = foodLabels.Extent( i );
+            LabelCandidate candidate;
+            candidate.x      = std::round( center.x - textSize.x * 0.5f );
+            candidate.y      = std::round( center.y - textSize.y * 0.5f );
+            candidate.width  = textSize.x;
+            candidate.height = textSize.y;
+            candidate.tier   = i == static_cast<size_t>( state.activeFoodIndex ) ? 2 : ( node.isBonus ? 1 : 0 );
+            candidate.amount = amount;
+            candidate.index  = static_cast<uint32_t>( i );
+            labelCandidates.push_back( candidate );
+        }
 
-            ImVec2 textSize = ImGui::CalcTextSize( buf );
-            ImVec2 pos( center.x - textSize.x * 0.5f, center.y - textSize.y * 0.5f );
+        for ( const uint32_t position : labelDeclutter.Resolve( labelCandidates, screenW, screenH ) )
+        {
+            const LabelCandidate& label = labelCandidates[position];
+            const std::string_view buf  = foodLabels.Text( label.index );
+            const ImVec2 pos( label.x, label.y );
 
             // Shadow
-            dl->AddText( ImVec2( pos.x + 1, pos.y + 1 ), IM_COL32( 0, 0, 0, 180 ), buf );
+            dl->AddText( ImVec2( pos.x + 1, pos.y + 1 ), IM_COL32( 0, 0, 0, 180 ), buf.data(), buf.data() + buf.size() );
 
             // Text (slightly tinted by active state)
-            ImU32 col = ( i == static_cast<size_t>(game_->state().activeFoodIndex) ) ? IM_COL32( 255, 240, 160, 230 )
-                                                                        : IM_COL32( 255, 255, 255, 220 );
-            dl->AddText( pos, col, buf );
+            ImU32 col = label.tier == 2 ? IM_COL32( 255, 240, 160, 230 ) : IM_COL32( 255, 255, 255, 220 );
+            dl->AddText( pos, col, buf.data(), buf.data() + buf.size() );
         }
     }
 
     // HUD window (ImGui) — closable like a debug menu
-    if ( game_->state().showDebugHud )
+    bool hudOpen = snapshot->state.showDebugHud;
+    if ( hudOpen )
     {
         ImGui::SetNextWindowPos( ImVec2( 20, 20 ), ImGuiCond_Once );
         ImGui::SetNextWindowBgAlpha( 0.6f );
         ImGuiWindowFlags flags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse;
-        if ( ImGui::Begin( "HUD", &game_->state().showDebugHud, flags ) )
+        if ( ImGui::Begin( "HUD", &hudOpen, flags ) )
         {
             // Keep HUD concise; the main screen handles gameplay stats
             ImGui::Text( "FPS: %.0f", lastFPS );
+            ImGui::Text( "LOD: %s (zoom %.2fx)", DensityLod::ModeName( lodMode ), cameraZoom );
+            ImGui::Text( "Ant pass: %.3f ms  Splat pass: %.3f ms", antPassMs, splatPassMs );
+            RenderFrameTimings();
+            const SimulationPipelineStats sim = game_->pipelineStats();
+            ImGui::Text( "Simulation: %s, step %.3f ms, %llu steps, %llu frames reused",
+                         sim.threaded ? "own thread" : "inline", sim.lastStepMs,
+                         static_cast<unsigned long long>( sim.steps ),
+                         static_cast<unsigned long long>( sim.reusedFrames ) );
+            const RenderDeviceStats& frame = renderDevice->LastFrame();
+            ImGui::Text( "Markers: %u squares, %u triangles", markers.SquareCount(), markers.TriangleCount() );
+            ImGui::Text( "Rocks: %zu, flow fields: %zu (%dx%d), distance field %dx%d", snapshot->state.rocks.size(),
+                         flowFieldCount, flowGridSize, flowGridSize, distanceGridSize, distanceGridSize );
+            const LabelDeclutterStats& labelStats = labelDeclutter.Stats();
+            ImGui::Text( "Food labels: %zu shown, %zu overlapped, %zu off screen (%zu re-formatted, layout %s)",
+                         labelStats.shown, labelStats.hidden, foodLabelsOffScreen + labelStats.culled,
+                         foodLabels.Formats(),
+                         labelStats.reused ? "reused" : ( labelStats.resorted ? "re-sorted" : "rebuilt" ) );
+            ImGui::Text( "Device: %d draws, %d updates (%zu bytes)", frame.draws, frame.updates, frame.uploadBytes );
+            ImGui::Text( "Constants skipped: %zu bytes  IA binds: %d (%d redundant skipped)", frame.skippedUploadBytes,
+                         frame.vertexBufferBinds + frame.indexBufferBinds, frame.redundantBindsSkipped );
+            ImGui::Text( "Copies: %d (%zu bytes)  Maps: %d (%zu bytes)  Dispatches: %d", frame.copies, frame.copyBytes,
+                         frame.maps, frame.mapBytes, frame.dispatches );
+            const DrawListCacheStats& ui = imgui->UploadStats();
+            ImGui::Text( "UI geometry: %zu bytes uploaded, %zu reused (%d/%d lists)", ui.uploadBytes, ui.skippedBytes,
+                         ui.listsUploaded, ui.listsUploaded + ui.listsSkipped );
+            const AssetSourceStats& assetStats = assets.Stats();
+            ImGui::Text( "Assets: %s, startup load %.2f ms (open %.2f ms), %zu mapped / %zu loose",
+                         assetStats.bundleOpen ? "bundle" : "loose", startupAssetMs, assetStats.openMs,
+                         assetStats.bundleHits, assetStats.looseReads );
+            RenderStartup();
+            RenderMetrics();
+            RenderAllocations();
+            const ProfilerStats profile = Profiler::Stats();
+            ImGui::Text( "Profiler: %s, %llu zones kept from %d threads", Profiler::Enabled() ? "recording" : "off",
+                         static_cast<unsigned long long>( profile.zonesKept ), profile.threads );
+            for ( const RenderBudgetViolation& violation : RenderBudgetCheck::Check( frame, frameBudget ) )
+            {
+                ImGui::TextColored( ImVec4( 1.0f, 0.4f, 0.3f, 1.0f ), "Over budget: %s %zu > %zu", violation.counter,
+                                    violation.value, violation.limit );
+            }
             ImGui::Separator();
             ImGui::Text( "Debug Controls:" );
             ImGui::BulletText( "F1 or H: toggle HUD" );
             ImGui::BulletText( "F: Frenzy (if off cooldown)" );
+            ImGui::BulletText( "L: cycle LOD mode, wheel: zoom" );
+            ImGui::BulletText( "F8: profiler on/off, F9: write profile_trace.json" );
+            ImGui::BulletText( "F5: quicksave, F6: quickload" );
         }
         ImGui::End();
+        if ( !hudOpen )
+            game_->setDebugHudVisible( false );
     }
 
     // Overlays (stylized panels instead of windows)
-    if ( game_->state().gameState == GameState::StageClear )
+    if ( snapshot->state.gameState == GameState::StageClear )
     {
         RenderStageClearOverlay();
     }
-    else if ( game_->state().gameState == GameState::GameOver )
+    else if ( snapshot->state.gameState == GameState::GameOver )
     {
         RenderOverlay("Game Over","");
     }
 }
 
+void InstancedRendererEngine2D::RenderFrameTimings()
+{
+    constexpr double percentiles[] = { 50.0, 95.0, 99.0, 99.9 };
+    if ( !ImGui::BeginTable( "FrameTimings", 6, ImGuiTableFlags_SizingFixedFit ) )
+        return;
+
+    ImGui::TableSetupColumn( "ms" );
+    ImGui::TableSetupColumn( "p50" );
+    ImGui::TableSetupColumn( "p95" );
+    ImGui::TableSetupColumn( "p99" );
+    ImGui::TableSetupColumn( "p99.9" );
+    ImGui::TableSetupColumn( "max" );
+    ImGui::TableHeadersRow();
+    for ( int phase = 0; phase < static_cast<int>( FramePhase::Count ); phase++ )
+    {
+        const FrameHistogram& histogram = frameTimings.Get( static_cast<FramePhase>( phase ) );
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted( FrameTimings::Name( static_cast<FramePhase>( phase ) ) );
+        for ( const double percentile : percentiles )
+        {
+            ImGui::TableNextColumn();
+            ImGui::Text( "%.2f", histogram.Percentile( percentile ) );
+        }
+        ImGui::TableNextColumn();
+        ImGui::Text( "%.2f", histogram.Max() );
+    }
+    ImGui::EndTable();
+
+    if ( ImGui::SmallButton( "Reset timings" ) )
+        frameTimings.Reset();
+}
+
+void InstancedRendererEngine2D::RenderMetrics() const
+{
+    if ( !ImGui::TreeNode( "Metrics" ) )
+        return;
+
+    if ( ImGui::BeginTable( "MetricsTable", 4, ImGuiTableFlags_SizingFixedFit ) )
+    {
+        ImGui::TableSetupColumn( "metric" );
+        ImGui::TableSetupColumn( "value" );
+        ImGui::TableSetupColumn( "/s" );
+        ImGui::TableSetupColumn( "last 30 s" );
+        ImGui::TableHeadersRow();
+        for ( const MetricSeries& series : metricsHistory.Series() )
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted( series.metric->Name() );
+            ImGui::TableNextColumn();
+            ImGui::Text( "%lld", static_cast<long long>( series.value ) );
+            ImGui::TableNextColumn();
+            if ( series.metric->Kind() == MetricKind::Counter )
+                ImGui::Text( "%.1f", series.perSecond );
+            ImGui::TableNextColumn();
+            ImGui::PushID( series.metric->Name() );
+            ImGui::PlotLines( "", series.history.data(), static_cast<int>( series.history.size() ),
+                              static_cast<int>( series.cursor ), nullptr, FLT_MAX, FLT_MAX, ImVec2( 120.0f, 18.0f ) );
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+    ImGui::TreePop();
+}
+
+void InstancedRendererEngine2D::TrackFrameAllocations()
+{
+    const AllocationCounts total = AllocationTracker::Total();
+    frameAllocations = { total.allocations - allocationsSeen.allocations, total.bytes - allocationsSeen.bytes };
+    allocationsSeen  = total;
+
+    static Metric& allocationCount = Metrics::Counter( "alloc.count" );
+    static Metric& allocationBytes = Metrics::Counter( "alloc.bytes" );
+    allocationCount.Add( static_cast<int64_t>( frameAllocations.allocations ) );
+    allocationBytes.Add( static_cast<int64_t>( frameAllocations.bytes ) );
+
+    if ( !assertNoAlloc )
+        return;
+    if ( !allocationWarm )
+    {
+        // Sites restart here, so the report names only what allocated in steady state
+        allocationWarm = totalTime >= AllocationWarmupSeconds;
+        if ( allocationWarm )
+            AllocationTracker::ResetSites();
+        return;
+    }
+    if ( frameAllocations.allocations == 0 )
+        return;
+
+    std::ofstream report( AllocationReportFile, std::ios::trunc );
+    report << frameAllocations.allocations << " allocations (" << frameAllocations.bytes
+           << " bytes) in one frame of steady-state play at " << totalTime << " s\n";
+    AllocationTracker::Sites( allocationSites );
+    for ( const AllocationSite& site : allocationSites )
+        report << site.zone << ": " << site.counts.allocations << " (" << site.counts.bytes << " bytes)\n";
+    OutputDebugStringA( "Allocation after warm-up, see allocations.txt\n" );
+
+    assertNoAlloc = false;
+    PostQuitMessage( 3 );
+}
+
+void InstancedRendererEngine2D::RenderAllocations()
+{
+    if ( !ImGui::TreeNode( "Allocations", "Allocations: %llu last frame (%llu bytes)",
+                           static_cast<unsigned long long>( frameAllocations.allocations ),
+                           static_cast<unsigned long long>( frameAllocations.bytes ) ) )
+        return;
+
+    // Since startup (or since the warm-up under --assert-no-alloc), by innermost profile zone
+    AllocationTracker::Sites( allocationSites );
+    for ( const AllocationSite& site : allocationSites )
+    {
+        ImGui::Text( "%-40s %8llu %10llu B", site.zone, static_cast<unsigned long long>( site.counts.allocations ),
+                     static_cast<unsigned long long>( site.counts.bytes ) );
+    }
+    ImGui::TreePop();
+}
+
+void InstancedRendererEngine2D::ReportStartup() const
+{
+    char line[160];
+    std::snprintf( line, sizeof( line ), "Startup: first frame at %.2f ms (graph %.2f ms, critical path %.2f ms)\n",
+                   startupFirstFrameMs, startupWallMs, startupCriticalMs );
+    OutputDebugStringA( line );
+    for ( const TaskTiming& task : startupTasks )
+    {
+        std::snprintf( line, sizeof( line ), "  %-16s start %8.2f ms  took %8.2f ms  thread %d\n", task.name.c_str(),
+                       task.startMs, task.durationMs, task.thread );
+        OutputDebugStringA( line );
+    }
+}
+
+void InstancedRendererEngine2D::RenderStartup() const
+{
+    if ( !ImGui::TreeNode( "StartupTasks", "Startup: first frame at %.1f ms (graph %.1f, critical path %.1f)",
+                           startupFirstFrameMs, startupWallMs, startupCriticalMs ) )
+        return;
+
+    for ( const TaskTiming& task : startupTasks )
+    {
+        ImGui::Text( "%-16s %7.2f ms +%7.2f ms  [%d]", task.name.c_str(), task.startMs, task.durationMs,
+                     task.thread );
+    }
+    ImGui::TreePop();
+}
+
 void InstancedRendererEngine2D::ProcessEvent(const UINT msg, const WPARAM wParam, const LPARAM lParam )
 {
 
@@ -800,7 +1620,9 @@ void InstancedRendererEngine2D::ProcessEvent(const UINT msg, const WPARAM wParam
         game_->handleEvent( msg, wParam, lParam );
     }
 
-    const bool wantMouse = ImGui::GetCurrentContext() && ImGui::GetIO().WantCaptureMouse;
+    // imgui, not ImGui's current context: the "imgui" startup task creates that context on a worker while this
+    // thread still pumps messages, and imgui is only set once startup has finished
+    const bool wantMouse = imgui && ImGui::GetIO().WantCaptureMouse;
 
     switch ( msg )
     {
@@ -821,8 +1643,8 @@ void InstancedRendererEngine2D::ProcessEvent(const UINT msg, const WPARAM wParam
                 POINT current{ GET_X_LPARAM( lParam ), GET_Y_LPARAM( lParam ) };
                 if ( screenWidth > 0 && screenHeight > 0 )
                 {
-                    float deltaX = ( static_cast<float>(current.x) - static_cast<float>(lastMousePos.x) ) * ( 2.0f / static_cast<float>( screenWidth ) );
-                    float deltaY = ( static_cast<float>(current.y) - static_cast<float>(lastMousePos.y) ) * ( 2.0f / static_cast<float>( screenHeight ) );
+                    float deltaX = ( static_cast<float>(current.x) - static_cast<float>(lastMousePos.x) ) * ( 2.0f / ( static_cast<float>( screenWidth ) * cameraZoom ) );
+                    float deltaY = ( static_cast<float>(current.y) - static_cast<float>(lastMousePos.y) ) * ( 2.0f / ( static_cast<float>( screenHeight ) * cameraZoom ) );
 
                     cameraPosition.x -= deltaX;
                     cameraPosition.y += deltaY;
@@ -838,47 +1660,80 @@ void InstancedRendererEngine2D::ProcessEvent(const UINT msg, const WPARAM wParam
                 lastMousePos.y = GET_Y_LPARAM( lParam );
             }
             break;
+        case WM_MOUSEWHEEL:
+            if ( !wantMouse )
+            {
+                const float notches = static_cast<float>( GET_WHEEL_DELTA_WPARAM( wParam ) ) / static_cast<float>( WHEEL_DELTA );
+                cameraZoom          = std::clamp( cameraZoom * std::pow( 1.1f, notches ), 0.05f, 4.0f );
+            }
+            break;
+        case WM_KEYUP:
+            if ( wParam == 'L' )
+            {
+                lodMode = DensityLod::NextMode( lodMode );
+            }
+            else if ( wParam == VK_F8 )
+            {
+                Profiler::SetEnabled( !Profiler::Enabled() );
+            }
+            else if ( wParam == VK_F5 && game_ )
+            {
+                // Saved with the ants where the GPU has them, not where the CPU last placed them
+                try
+                {
+                    game_->saveState( Game::AntGame::QuickSaveFile, ReadBackInstances() );
+                }
+                catch ( const std::exception& ex )
+                {
+                    OutputDebugStringA( ex.what() );
+                    OutputDebugStringA( "\n" );
+                }
+            }
+            else if ( wParam == VK_F9 )
+            {
+                // The rings hold the last few seconds, so this catches a hitch that just happened
+                const bool written = Profiler::WriteChromeTrace( ProfileTraceFile );
+                OutputDebugStringA( written ? "Wrote profile_trace.json\n" : "Could not write profile_trace.json\n" );
+            }
+            break;
         default:
             break;
     }
-    // Player placement disabled; sugar/game_->state().hazard spawn randomly now
+    // Player placement disabled; sugar/hazard spawn randomly now
 }
 
 void InstancedRendererEngine2D::RenderProminentStatus()
 {
     if ( !ImGui::GetCurrentContext() )
         return;
-    int totalSec = static_cast<int>(std::ceil(max(0.0, game_->state().stageTimeLeft)));
+    const auto& state = snapshot->state;
+    int totalSec      = static_cast<int>(std::ceil(max(0.0, state.stageTimeLeft)));
     int mm       = totalSec / 60;
     int ss       = totalSec % 60;
 
-    wchar_t w1[64];
-    wchar_t w2[64];
-    wchar_t w3[64];
-    swprintf_s( w1, L"SCORE: %d", game_->state().score );
-    swprintf_s( w2, L"TIME LEFT: %02d:%02d", mm, ss );
-    swprintf_s( w3, L"TARGET: %d / %d", game_->state().stageScore, game_->state().stageTarget );
-    char l1[96];
-    char l2[96];
-    char l3[96];
-    wcstombs( l1, w1, sizeof( l1 ) );
-    wcstombs( l2, w2, sizeof( l2 ) );
-    wcstombs( l3, w3, sizeof( l3 ) );
+    // Slot keys: the score, whole seconds left, and stage score/target packed together
+    const int score       = state.score;
+    const int stageScore  = state.stageScore;
+    const int stageTarget = state.stageTarget;
+    statusLabels.Resize( 3 );
+    const std::string_view l1 = statusLabels.Get( 0, score, [score]( char* out, const size_t capacity )
+                                                  { return Utilities::FormatTo( out, capacity, "SCORE: %d", score ); } );
+    const std::string_view l2 =
+        statusLabels.Get( 1, totalSec, [mm, ss]( char* out, const size_t capacity )
+                          { return Utilities::FormatTo( out, capacity, "TIME LEFT: %02d:%02d", mm, ss ); } );
+    const std::string_view l3 = statusLabels.Get(
+        2, ( static_cast<int64_t>( stageScore ) << 32 ) | static_cast<uint32_t>( stageTarget ),
+        [stageScore, stageTarget]( char* out, const size_t capacity )
+        { return Utilities::FormatTo( out, capacity, "TARGET: %d / %d", stageScore, stageTarget ); } );
 
     // Measure and build a centered banner-like panel (distinct style from top-right)
     float titleSize = 32.0f; // slightly smaller than before to fit a panel
     float lineSize  = 22.0f;
     float scaleT    = titleSize / ImGui::GetFontSize();
     float scaleL    = lineSize / ImGui::GetFontSize();
-    ImVec2 s1       = ImGui::CalcTextSize( l1 );
-    s1.x *= scaleT;
-    s1.y *= scaleT;
-    ImVec2 s2 = ImGui::CalcTextSize( l2 );
-    s2.x *= scaleL;
-    s2.y *= scaleL;
-    ImVec2 s3 = ImGui::CalcTextSize( l3 );
-    s3.x *= scaleL;
-    s3.y *= scaleL;
+    ImVec2 s1( statusLabels.Extent( 0 ).x * scaleT, statusLabels.Extent( 0 ).y * scaleT );
+    ImVec2 s2( statusLabels.Extent( 1 ).x * scaleL, statusLabels.Extent( 1 ).y * scaleL );
+    ImVec2 s3( statusLabels.Extent( 2 ).x * scaleL, statusLabels.Extent( 2 ).y * scaleL );
 
     float padX   = 18.0f;
     float padY   = 10.0f;
@@ -897,11 +1752,11 @@ void InstancedRendererEngine2D::RenderProminentStatus()
 
     float x = p1.x + padX;
     float y = p1.y + padY;
-    dl->AddText( f, titleSize, ImVec2( x, y ), IM_COL32( 255, 255, 255, 245 ), l1 );
+    dl->AddText( f, titleSize, ImVec2( x, y ), IM_COL32( 255, 255, 255, 245 ), l1.data(), l1.data() + l1.size() );
     y += s1.y + gap;
-    dl->AddText( f, lineSize, ImVec2( x, y ), IM_COL32( 230, 230, 230, 235 ), l2 );
+    dl->AddText( f, lineSize, ImVec2( x, y ), IM_COL32( 230, 230, 230, 235 ), l2.data(), l2.data() + l2.size() );
     y += s2.y + gap;
-    dl->AddText( f, lineSize, ImVec2( x, y ), IM_COL32( 230, 230, 230, 235 ), l3 );
+    dl->AddText( f, lineSize, ImVec2( x, y ), IM_COL32( 230, 230, 230, 235 ), l3.data(), l3.data() + l3.size() );
 }
 
 void InstancedRendererEngine2D::RenderStageClearOverlay()
@@ -1049,5 +1904,5 @@ void InstancedRendererEngine2D::RenderOverlay(const char* overlayTitle, const ch
 
 int InstancedRendererEngine2D::GetActiveFoodIndex() const
 {
-    return game_->state().activeFoodIndex;
+    return snapshot ? snapshot->state.activeFoodIndex : -1;
 }
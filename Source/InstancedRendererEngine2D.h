@@ -3,12 +3,30 @@
 #include "Objects/SquareMesh.h"
 #include "Objects/TriangleMesh.h"
 #include "Game/AntGame.h"
+#include "Game/SimulationFrame.h"
+#include "AllocationTracker.h"
+#include "AssetSource.h"
 #include "BaseRenderer.h"
+#include "ConstantBlock.h"
+#include "D3D11RenderDevice.h"
+#include "DensityLod.h"
+#include "FontData.h"
+#include "FrameHistogram.h"
+#include "GlyphLayout.h"
 #include "ImGuiRenderer.h"
 #include "InstanceData.h"
+#include "LabelCache.h"
+#include "LabelDeclutter.h"
+#include "MarkerBatch.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "RenderBudget.h"
+#include "ShaderConstants.h"
+#include "TaskGraph.h"
 #include "Vector2D.h"
-#include "VertexInputData.h"
+#include "ViewTransform.h"
 #include "Utilities.h"
+#include "WorldPass.h"
 #include "Button.h"
 
 #include <algorithm>
@@ -17,7 +35,9 @@
 #include <chrono>
 #include <d3d11.h>
 #include <dxgi.h>
+#include <fstream>
 #include <memory>
+#include <string_view>
 #include <vector>
 #include <wrl/client.h>
 
@@ -28,11 +48,16 @@
 #pragma comment( lib, "user32.lib" )
 
 
-class InstancedRendererEngine2D : public BaseRenderer
+class InstancedRendererEngine2D : public BaseRenderer, private WorldPassStages
 {
   public:
     void Init( HWND windowHandle, int blockWidth, int blockHeight ) override;
 
+    // Scenario runs: no window or device, only the view size and the asset bundle the game reads its settings from
+    void InitHeadless( const ViewTransform& view );
+    // Headless runs: the camera and window size as a replay recorded them
+    void SetHeadlessView( const ViewTransform& view );
+
     void OnPaint( HWND windowHandle ) override;
 
     void OnResize( int width, int height ) override;
@@ -66,11 +91,21 @@ class InstancedRendererEngine2D : public BaseRenderer
     void UploadInstanceBuffer( const std::vector<InstanceData>& instances );
     void UploadInstanceSlot( int slot, const InstanceData& data ) const;
     void ResizeInstanceStorage( const std::vector<InstanceData>& instances );
+    // The ants as the compute pass last wrote them. Waits for the GPU, so it is for one-off uses like the F5
+    // quicksave, never per frame.
+    std::vector<InstanceData> ReadBackInstances();
 
+    // Snapshot of the camera for the simulation thread; the three mappings below go through it
+    ViewTransform View() const;
     Vector2D ScreenToWorld( int x, int y ) const;
     Vector2D WorldToScreen( const Vector2D& world ) const;
     Vector2D WorldToView( const Vector2D& world ) const;
 
+    const AssetSource& Assets() const
+    {
+        return assets;
+    }
+
   private:
     std::chrono::time_point<std::chrono::steady_clock> startTime;
 
@@ -80,7 +115,28 @@ class InstancedRendererEngine2D : public BaseRenderer
     double totalTime          = 0.0f;
     double lastFPS            = 0.0;
 
-    wchar_t fpsText[30];
+    // Whole-run frame and phase time distributions; percentiles in the HUD, dumped to FrameTimingsFile on shutdown
+    static constexpr const char* FrameTimingsFile = "frame_times.txt";
+    static constexpr const char* ProfileTraceFile = "profile_trace.json"; // F9, and on exit while recording
+    FrameTimings frameTimings;
+
+    // Registry samples for the HUD; with --metrics-log also appended to MetricsLogFile every MetricsLogInterval s
+    static constexpr const char* MetricsLogFile = "metrics.csv";
+    static constexpr double MetricsLogInterval  = 10.0;
+    MetricsHistory metricsHistory;
+    std::ofstream metricsLog;
+    double metricsLoggedAt = 0.0;
+
+    // Allocations per frame for the HUD; --assert-no-alloc quits with code 3 and writes AllocationReportFile on the
+    // first allocation after the warm-up
+    static constexpr double AllocationWarmupSeconds   = 5.0;
+    static constexpr const char* AllocationReportFile = "allocations.txt";
+    AllocationCounts allocationsSeen;  // AllocationTracker::Total() when this frame began
+    AllocationCounts frameAllocations; // during the previous frame, all threads
+    bool assertNoAlloc  = false;
+    bool allocationWarm = false;
+    std::vector<AllocationSite> allocationSites;
+    bool firstFrame = true; // its delta includes startup
 
     Microsoft::WRL::ComPtr<ID3D11Device> pDevice;
     Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext;
@@ -89,8 +145,6 @@ class InstancedRendererEngine2D : public BaseRenderer
     Microsoft::WRL::ComPtr<ID3D11Texture2D> backBuffer;
 
     // for rendering
-    Microsoft::WRL::ComPtr<ID3D11Buffer> pConstantBuffer;
-    Microsoft::WRL::ComPtr<ID3D11Buffer> flockConstantBuffer;
     Microsoft::WRL::ComPtr<ID3D11VertexShader> waveVertexShader;
 
     Microsoft::WRL::ComPtr<ID3D11VertexShader> flockVertexShader;
@@ -102,9 +156,28 @@ class InstancedRendererEngine2D : public BaseRenderer
     Microsoft::WRL::ComPtr<ID3D11InputLayout> pInputLayout;          // Used to define input variables for the shaders
     Microsoft::WRL::ComPtr<ID3D11InputLayout> flockInputLayout;      // Used to define input variables for the shaders
     Microsoft::WRL::ComPtr<ID3D11RasterizerState> scissorRasterizer; // For rain overlay clipping
+    Microsoft::WRL::ComPtr<ID3D11BlendState> alphaBlendState;        // World pass (ants fade into the splat)
 
     Microsoft::WRL::ComPtr<ID3D11Buffer> instanceBuffer;
 
+    // Food nodes, nest and highlights: one instance stream, one draw per shape
+    Microsoft::WRL::ComPtr<ID3D11Buffer> markerInstanceBuffer;
+    UINT markerCapacity = 0;
+    MarkerBatch markers;
+
+    // Constant blocks by update frequency (see ShaderConstants.h), uploaded only when their contents change
+    Microsoft::WRL::ComPtr<ID3D11Buffer> frameConstantBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> simulationConstantBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> drawConstantBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> densityConstantBuffer;
+    ConstantBlock<DrawConstants> drawConstants;
+
+    // Device calls of the world pass; the frame, simulation and density blocks are shadowed there
+    WorldPass worldPass;
+
+    // Routes per-frame uploads and draws so they can be counted (and recorded off-GPU)
+    std::unique_ptr<RenderDevice> renderDevice;
+
     // Compute shader buffers
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceViewA;
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceViewB;
@@ -113,8 +186,8 @@ class InstancedRendererEngine2D : public BaseRenderer
     Microsoft::WRL::ComPtr<ID3D11Buffer> computeBufferA;
     Microsoft::WRL::ComPtr<ID3D11Buffer> computeBufferB;
     // Food/nest hit counts (GPU) with simple binning to reduce atomics contention
-    static const int MaxFoodNodes = 128;
-    static const int HitBins      = 8;
+    static const int MaxFoodNodes = Game::MaxFoodNodes;
+    static const int HitBins      = Game::HitBins;
     Microsoft::WRL::ComPtr<ID3D11Buffer> foodCountBuffer;
     Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> foodCountUAV;
     std::array<Microsoft::WRL::ComPtr<ID3D11Buffer>, 3> foodCountReadback{};
@@ -124,10 +197,46 @@ class InstancedRendererEngine2D : public BaseRenderer
     Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> nestCountUAV;
     std::array<Microsoft::WRL::ComPtr<ID3D11Buffer>, 3> nestCountReadback{};
     std::array<Microsoft::WRL::ComPtr<ID3D11Query>, 3> nestQuery{};
-    int readbackCursor = 0;
-
-    UINT screenWidth;
-    UINT screenHeight;
+    std::chrono::steady_clock::time_point readbackStart;
+    // Flow fields the flock shader steers by around rocks (t1 directions, t2 slot per food node); flowGridSize 0
+    // while the stage has no rocks, and the shader then reads neither buffer
+    Microsoft::WRL::ComPtr<ID3D11Buffer> flowDirectionBuffer;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> flowDirectionSRV;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> flowFoodSlotBuffer;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> flowFoodSlotSRV;
+    UINT flowDirectionCapacity = 0;
+    int flowGridSize           = 0;
+    size_t flowFieldCount      = 0;
+    // Rock distance field the flock shader collides ants with (t3); distanceGridSize 0 while there are no rocks
+    Microsoft::WRL::ComPtr<ID3D11Buffer> rockDistanceBuffer;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> rockDistanceSRV;
+    int distanceGridSize = 0;
+
+    // Steady-state frame limits, checked against the last frame in the HUD (and by render_tests). The hit-count
+    // readbacks are the only copies a normal frame may make; a full instance buffer copy shows up as a copyBytes
+    // violation.
+    RenderBudget frameBudget = RenderBudget::SteadyFrame( sizeof( UINT ) * MaxFoodNodes * HitBins );
+
+    // Density splat LOD: ants binned into a screen-space grid, drawn as one fullscreen splat when dense
+    Microsoft::WRL::ComPtr<ID3D11ComputeShader> densitySplatComputeShader;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> densitySplatVertexShader;
+    Microsoft::WRL::ComPtr<ID3D11PixelShader> densitySplatPixelShader;
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> densityGrid;
+    Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> densityGridUAV;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> densityGridSRV;
+    int densityGridX = 0;
+    int densityGridY = 0;
+    DensityLodSettings lodSettings{};
+    LodMode lodMode = LodMode::Auto;
+
+    // GPU timestamps around the per-ant and splat passes, ring of 3 like the hit readbacks
+    std::array<Microsoft::WRL::ComPtr<ID3D11Query>, 3> passDisjointQuery{};
+    std::array<std::array<Microsoft::WRL::ComPtr<ID3D11Query>, 4>, 3> passTimestampQuery{};
+    double antPassMs   = 0.0;
+    double splatPassMs = 0.0;
+
+    UINT screenWidth  = 0;
+    UINT screenHeight = 0;
     float aspectRatioX;
 
     Vector2D cameraPosition{};
@@ -135,28 +244,120 @@ class InstancedRendererEngine2D : public BaseRenderer
     POINT lastMousePos{};
     float cameraZoom = 1.0f;
 
+    AssetSource assets;
+    double startupAssetMs = 0.0;
+
+    // Init() runs as a task graph; per-task timings are reported once the first frame is presented
+    std::chrono::steady_clock::time_point startupBegin;
+    std::vector<TaskTiming> startupTasks;
+    double startupWallMs       = 0.0;
+    double startupCriticalMs   = 0.0;
+    double startupFirstFrameMs = 0.0; // Init() start to the first Present() returning
+
+    // Text: binary BMFont glyph table and its atlas; every label's glyphs go out in one instanced draw
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> textVertexShader;
+    Microsoft::WRL::ComPtr<ID3D11PixelShader> textPixelShader;
+    Microsoft::WRL::ComPtr<ID3D11InputLayout> textInputLayout;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> fontAtlasSRV;
+    Microsoft::WRL::ComPtr<ID3D11SamplerState> fontSampler;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> glyphInstanceBuffer;
+    UINT glyphCapacity = 0;
+    FontData font; // points into the asset bundle
+    std::unique_ptr<GlyphLayout> glyphLayout;
+    std::vector<GlyphInstance> glyphInstances;
+
+    // ImGui overlay text, formatted into a char arena only when the shown number changes
+    LabelCache foodLabels{ &InstancedRendererEngine2D::MeasureUiText };
+    LabelCache statusLabels{ &InstancedRendererEngine2D::MeasureUiText };
+
+    // Food labels: off-screen ones culled, overlaps resolved by priority in a screen grid
+    static constexpr float LabelCullMargin = 64.0f;
+    std::vector<LabelCandidate> labelCandidates;
+    LabelDeclutter labelDeclutter;
+    size_t foodLabelsOffScreen = 0;
+
+    // All static shapes share one vertex and one index buffer
+    MeshArena meshArena;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> meshVertexBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> meshIndexBuffer;
     std::unique_ptr<SquareMesh> square;
     std::unique_ptr<TriangleMesh> triangle;
 
+    // Shader bytecode from the bundle (or loose .cso); throws when missing
+    AssetSpan ShaderAsset( std::string_view name );
+
+    // Device, swap chain, back buffer view and viewport; the only startup task bound to the window thread
+    void CreateDevice( HWND windowHandle );
+
     void LoadShaders();
 
     void CreateMeshes();
 
     void CreateBuffers( const std::vector<InstanceData>& instances );
 
-    void RunComputeShader( ID3D11Buffer* buffer, VertexInputData& cbData, int instanceCount, ID3D11ComputeShader* computeShader );
+    void CreateConstantBuffers();
+
+    // Fills the frame's constants, markers and labels, then submits the world pass
+    void RenderWorld( int hoverIndex );
+
+    void BuildMarkers( int hoverIndex );
+
+    void EnsureMarkerCapacity( size_t count );
+
+    void CreateText();
+
+    void BuildLabels();
+
+    void EnsureGlyphCapacity( size_t count );
+
+    // WorldPassStages: the D3D11 state around the world pass's device calls
+    void BindConstants() override;
+    void BeginFlockStep() override;
+    void BeginReadback() override;
+    void FoodCounts( const uint32_t* counts ) override;
+    void NestCounts( const uint32_t* counts ) override;
+    void ReadbackMissed() override;
+    void EndReadback() override;
+    void EndFlockStep() override;
+    void BeginMarkers() override;
+    void BeginDensity() override;
+    void EndDensity() override;
+    void BeginAnts() override;
+    void EndAnts() override;
+    void BeginSplat() override;
+    void EndSplat() override;
+    void BeginLabels() override;
+    void EndLabels() override;
+
+    void EnsureDensityGrid( UINT width, UINT height );
+
+    void CreatePassTimers();
+
+    void ResolvePassTimers();
 
     void SetupViewport( UINT width, UINT height );
 
     void InitRenderBufferAndTargetView( HRESULT& hr );
 
-    void SetupVerticesAndShaders( const UINT& stride, const UINT& offset, const Mesh* mesh, ID3D11VertexShader* vertexShader, ID3D11PixelShader* pixelShader ) const;
-
-    void PassInputDataAndRunInstanced( ID3D11Buffer* pConstantBuffer, VertexInputData& cbData, Mesh& mesh, int instanceCount ) const;
+    void PassInputDataAndRunInstanced( const DrawConstants& cbData, MeshId mesh, int instanceCount );
     void RenderUI();
 
+    void RenderFrameTimings();
+
+    void RenderMetrics() const;
+
+    void TrackFrameAllocations();
+
+    void RenderAllocations();
+
+    void ReportStartup() const;
+
+    void RenderStartup() const;
+
     void RenderProminentStatus();
 
+    static Vector2D MeasureUiText( std::string_view text );
+
     void RenderStageClearOverlay();
 
     void RenderOverlay(const char* overlayTitle, const char* overlaySubtitle);
@@ -165,5 +366,17 @@ class InstancedRendererEngine2D : public BaseRenderer
 
     Game::AntGame* game_ = nullptr;
 
+    // The world as of the newest finished simulation step; only this is read while drawing
+    const Game::WorldSnapshot* snapshot = nullptr;
+    uint64_t appliedSequence            = 0;
+    // Next step's input; the hit readbacks add to its running totals
+    Game::FrameInput frameInput;
+
+    void ApplyInstanceUploads( const Game::InstanceUploads& uploads );
+
+    void ApplyFlowFieldUploads( const Game::FlowFieldUploads& flow );
+
+    void ApplyDistanceFieldUploads( const Game::DistanceFieldUploads& distance );
+
     std::unique_ptr<ImGuiRenderer> imgui;
 };
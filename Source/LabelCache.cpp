@@ -0,0 +1,31 @@
+#include "LabelCache.h"
+
+LabelCache::LabelCache( Measure measure ) : measure_( std::move( measure ) )
+{
+}
+
+void LabelCache::Resize( const size_t slots )
+{
+    entries_.resize( slots );
+    arena_.resize( slots * SlotSize );
+}
+
+void LabelCache::Invalidate()
+{
+    for ( Entry& entry : entries_ )
+        entry.stale = true;
+}
+
+void LabelCache::Store( const size_t slot, const int64_t key, size_t length )
+{
+    if ( length > SlotSize - 1 )
+        length = SlotSize - 1;
+    arena_[slot * SlotSize + length] = '\0';
+
+    Entry& entry = entries_[slot];
+    entry.key    = key;
+    entry.length = length;
+    entry.extent = measure_( std::string_view( &arena_[slot * SlotSize], length ) );
+    entry.stale  = false;
+    formats_++;
+}
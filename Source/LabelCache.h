@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Vector2D.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// Short UI strings (food amounts, status lines) keyed by an integer per slot. A slot is re-formatted and re-measured
+// only when its key changes; the text lives in one reusable char arena of fixed-size slots, so steady frames do no
+// formatting, measuring or allocation.
+class LabelCache
+{
+  public:
+    static constexpr size_t SlotSize = 48; // including the terminating zero
+
+    using Measure = std::function<Vector2D( std::string_view )>;
+
+    explicit LabelCache( Measure measure );
+
+    // Keeps existing slots; new ones start stale
+    void Resize( size_t slots );
+
+    // Returns the slot's text. format( char* out, size_t capacity ) -> length is only called when key differs from
+    // the slot's last key; capacity counts the terminating zero, which Get() writes itself.
+    template <typename Format> std::string_view Get( const size_t slot, const int64_t key, Format&& format )
+    {
+        Entry& entry = entries_[slot];
+        if ( entry.key != key || entry.stale )
+        {
+            char* out = &arena_[slot * SlotSize];
+            Store( slot, key, format( out, SlotSize ) );
+        }
+        return { &arena_[slot * SlotSize], entry.length };
+    }
+
+    // The slot's current text, as returned by the last Get()
+    std::string_view Text( const size_t slot ) const
+    {
+        return { &arena_[slot * SlotSize], entries_[slot].length };
+    }
+
+    // Measured size of the slot's current text
+    Vector2D Extent( const size_t slot ) const
+    {
+        return entries_[slot].extent;
+    }
+
+    // Forces every slot to re-format, e.g. after a font change
+    void Invalidate();
+
+    size_t Size() const
+    {
+        return entries_.size();
+    }
+
+    // Slots re-formatted since the last ResetStats()
+    size_t Formats() const
+    {
+        return formats_;
+    }
+    void ResetStats()
+    {
+        formats_ = 0;
+    }
+
+  private:
+    struct Entry
+    {
+        int64_t key   = 0;
+        size_t length = 0;
+        Vector2D extent;
+        bool stale = true;
+    };
+
+    void Store( size_t slot, int64_t key, size_t length );
+
+    Measure measure_;
+    std::vector<Entry> entries_;
+    std::vector<char> arena_;
+    size_t formats_ = 0;
+};
@@ -0,0 +1,136 @@
+#include "LabelDeclutter.h"
+
+#include "Hash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace
+{
+    bool MoreImportant( const LabelCandidate& a, const LabelCandidate& b )
+    {
+        if ( a.tier != b.tier )
+            return a.tier > b.tier;
+        if ( a.amount != b.amount )
+            return a.amount > b.amount;
+        return a.index < b.index;
+    }
+
+    int CellOf( const float pixels, const int cells )
+    {
+        const int cell = static_cast<int>( std::floor( pixels / LabelDeclutter::CellPixels ) );
+        return cell < 0 ? 0 : ( cell >= cells ? cells - 1 : cell );
+    }
+} // namespace
+
+const std::vector<uint32_t>& LabelDeclutter::Resolve( const std::vector<LabelCandidate>& candidates,
+                                                      const float screenWidth, const float screenHeight )
+{
+    // Everything but the amount: rect and tier are the first five fields, the index the last
+    const float viewport[2] = { screenWidth, screenHeight };
+    uint64_t hash           = HashBytes( viewport, sizeof( viewport ) );
+    for ( const LabelCandidate& label : candidates )
+    {
+        hash = HashBytes( &label, offsetof( LabelCandidate, amount ), hash );
+        hash = HashBytes( &label.index, sizeof( label.index ), hash );
+    }
+
+    const auto byPriority = [&candidates]( uint32_t a, uint32_t b )
+    { return MoreImportant( candidates[a], candidates[b] ); };
+    if ( hasResult_ && hash == geometryHash_ )
+    {
+        // Same labels in the same places: the cull stands, and unless the amounts reordered them so does the layout
+        stats_.reused   = std::is_sorted( order_.begin(), order_.end(), byPriority );
+        stats_.resorted = !stats_.reused;
+        if ( stats_.resorted )
+        {
+            std::sort( order_.begin(), order_.end(), byPriority );
+            PlaceInOrder( candidates );
+        }
+        return visible_;
+    }
+
+    geometryHash_     = hash;
+    hasResult_        = true;
+    stats_            = {};
+    stats_.candidates = candidates.size();
+
+    order_.clear();
+    for ( uint32_t i = 0; i < candidates.size(); i++ )
+    {
+        const LabelCandidate& label = candidates[i];
+        if ( label.x + label.width < 0.0f || label.y + label.height < 0.0f || label.x > screenWidth ||
+             label.y > screenHeight )
+            stats_.culled++;
+        else
+            order_.push_back( i );
+    }
+    std::sort( order_.begin(), order_.end(), byPriority );
+
+    cellsX_ = std::max( 1, static_cast<int>( std::ceil( screenWidth / CellPixels ) ) );
+    cellsY_ = std::max( 1, static_cast<int>( std::ceil( screenHeight / CellPixels ) ) );
+    cells_.resize( static_cast<size_t>( cellsX_ ) * cellsY_ );
+    PlaceInOrder( candidates );
+    return visible_;
+}
+
+void LabelDeclutter::PlaceInOrder( const std::vector<LabelCandidate>& candidates )
+{
+    for ( std::vector<uint32_t>& cell : cells_ )
+        cell.clear();
+    placed_.clear();
+    visible_.clear();
+    stats_.hidden = 0;
+
+    for ( const uint32_t position : order_ )
+    {
+        const LabelCandidate& label = candidates[position];
+        if ( Overlaps( label ) )
+        {
+            stats_.hidden++;
+            continue;
+        }
+        Place( label );
+        visible_.push_back( position );
+    }
+    stats_.shown = visible_.size();
+}
+
+bool LabelDeclutter::Overlaps( const LabelCandidate& label ) const
+{
+    const int x0 = CellOf( label.x - Padding, cellsX_ );
+    const int x1 = CellOf( label.x + label.width + Padding, cellsX_ );
+    const int y0 = CellOf( label.y - Padding, cellsY_ );
+    const int y1 = CellOf( label.y + label.height + Padding, cellsY_ );
+    for ( int cy = y0; cy <= y1; cy++ )
+    {
+        for ( int cx = x0; cx <= x1; cx++ )
+        {
+            for ( const uint32_t placedIndex : cells_[static_cast<size_t>( cy ) * cellsX_ + cx] )
+            {
+                const LabelCandidate& other = placed_[placedIndex];
+                if ( label.x < other.x + other.width + Padding && other.x < label.x + label.width + Padding &&
+                     label.y < other.y + other.height + Padding && other.y < label.y + label.height + Padding )
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void LabelDeclutter::Place( const LabelCandidate& label )
+{
+    const auto placedIndex = static_cast<uint32_t>( placed_.size() );
+    placed_.push_back( label );
+
+    const int x0 = CellOf( label.x, cellsX_ );
+    const int x1 = CellOf( label.x + label.width, cellsX_ );
+    const int y0 = CellOf( label.y, cellsY_ );
+    const int y1 = CellOf( label.y + label.height, cellsY_ );
+    for ( int cy = y0; cy <= y1; cy++ )
+    {
+        for ( int cx = x0; cx <= x1; cx++ )
+            cells_[static_cast<size_t>( cy ) * cellsX_ + cx].push_back( placedIndex );
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A label's screen rect (pixels, top-left origin) and how much it matters when labels collide
+struct LabelCandidate
+{
+    float x;
+    float y;
+    float width;
+    float height;
+    int tier;       // higher wins: active node, then bonus nodes, then the rest
+    int amount;     // within a tier, larger amounts win
+    uint32_t index; // caller's id (food node index), also the final tie-break
+};
+
+static_assert( sizeof( LabelCandidate ) == 28, "rect and tier are hashed as raw bytes, keep it free of padding" );
+
+struct LabelDeclutterStats
+{
+    size_t candidates = 0;
+    size_t culled     = 0; // entirely off screen
+    size_t hidden     = 0; // overlapped a more important label
+    size_t shown      = 0;
+    bool reused       = false; // same rects and priority order as the previous frame, layout not recomputed
+    bool resorted     = false; // same rects, amounts moved the priority order: placement redone, cull kept
+};
+
+// Keeps on-screen food labels readable in dense fields: off-screen labels are culled, then labels are placed in
+// priority order into a coarse screen-space grid and any label overlapping an already placed one is dropped.
+// The cull is cached against a hash of the viewport and each label's rect, tier and index, but not its amount, which
+// changes with every delivery. With those unchanged the kept labels only need their priority order checked: a still
+// camera costs one hash and one ordered pass per frame, and a sort plus grid pass only when amounts reorder labels.
+class LabelDeclutter
+{
+  public:
+    static constexpr float CellPixels = 64.0f;
+    static constexpr float Padding    = 2.0f; // minimum gap kept between labels
+
+    // Positions in candidates of the labels to draw, most important first
+    const std::vector<uint32_t>& Resolve( const std::vector<LabelCandidate>& candidates, float screenWidth,
+                                          float screenHeight );
+
+    const LabelDeclutterStats& Stats() const
+    {
+        return stats_;
+    }
+
+  private:
+    void PlaceInOrder( const std::vector<LabelCandidate>& candidates );
+    bool Overlaps( const LabelCandidate& label ) const;
+    void Place( const LabelCandidate& label );
+
+    std::vector<uint32_t> visible_;
+    std::vector<uint32_t> order_;
+    std::vector<std::vector<uint32_t>> cells_; // indices into placed_, reused between frames
+    std::vector<LabelCandidate> placed_;
+    int cellsX_            = 0;
+    int cellsY_            = 0;
+    uint64_t geometryHash_ = 0;
+    bool hasResult_        = false;
+    LabelDeclutterStats stats_;
+};
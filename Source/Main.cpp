@@ -1,8 +1,25 @@
 // Refactored entry to a cohesive Application class
 #include "Application.h"
+#include "ScenarioRunner.h"
 
 int WINAPI wWinMain( HINSTANCE hInstance, HINSTANCE, PWSTR, int nCmdShow )
 {
-    Application app;
-    return app.run( hInstance, nCmdShow );
+    // WIC (font atlas decoding) needs COM on the UI thread
+    const HRESULT com = CoInitializeEx( nullptr, COINIT_MULTITHREADED );
+
+    int result;
+    if ( wcsstr( GetCommandLineW(), L"--scenario" ) || wcsstr( GetCommandLineW(), L"--replay" ) )
+    {
+        // Headless benchmark runs: no window, see ScenarioRunner
+        result = ScenarioRunner::RunFromCommandLine();
+    }
+    else
+    {
+        Application app;
+        result = app.run( hInstance, nCmdShow );
+    }
+
+    if ( SUCCEEDED( com ) )
+        CoUninitialize();
+    return result;
 }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// Read-only memory map of a whole file. Win32 file mapping on Windows, mmap elsewhere.
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile( const MappedFile& )            = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    bool Open( const std::filesystem::path& path );
+    void Close();
+
+    bool IsOpen() const
+    {
+        return data_ != nullptr;
+    }
+    const unsigned char* Data() const
+    {
+        return data_;
+    }
+    size_t Size() const
+    {
+        return size_;
+    }
+
+  private:
+    const unsigned char* data_ = nullptr;
+    size_t size_               = 0;
+#ifdef _WIN32
+    void* file_    = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
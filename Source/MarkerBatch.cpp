@@ -0,0 +1,87 @@
+#include "MarkerBatch.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr float kMeshExtent   = 0.05f; // SquareMesh/TriangleMesh edge in world units at size 1
+    constexpr float kOutlineGrow  = 1.2f;  // hover outline footprint relative to the node
+    constexpr int kOutlineLighten = 2;
+} // namespace
+
+void MarkerBatch::Build( const std::vector<FoodNode>& foodNodes, const int activeIndex, const int hoverIndex,
+                         const Vector2D& nestPos, const float baseAmount, const float aspectRatio,
+                         const std::vector<Rock>& rocks )
+{
+    instances_.clear();
+
+    // Rocks lie under everything else, sized to their world footprint (the mesh is squeezed by the aspect ratio)
+    const float aspect = aspectRatio > 1e-5f ? aspectRatio : 1.0f;
+    for ( const Rock& rock : rocks )
+    {
+        const float size = 2.0f * rock.halfSize / kMeshExtent;
+        instances_.push_back( MarkerInstance{ rock.pos.x - rock.halfSize, rock.pos.y + rock.halfSize,
+                                              size * aspect, size, 7, 0 } );
+    }
+
+    // Nest is the first square over the rocks
+    instances_.push_back( MarkerInstance{ nestPos.x, nestPos.y, 1.0f, 1.0f, 2, 0 } );
+    AppendShape( false, foodNodes, activeIndex, hoverIndex, baseAmount, aspectRatio );
+    squareCount_ = static_cast<unsigned int>( instances_.size() );
+    AppendShape( true, foodNodes, activeIndex, hoverIndex, baseAmount, aspectRatio );
+}
+
+void MarkerBatch::AppendShape( const bool triangles, const std::vector<FoodNode>& foodNodes, const int activeIndex,
+                               const int hoverIndex, const float baseAmount, const float aspectRatio )
+{
+    const float base   = baseAmount > 1e-5f ? baseAmount : 100.0f;
+    const float aspect = aspectRatio > 1e-5f ? aspectRatio : 1.0f;
+
+    for ( size_t i = 0; i < foodNodes.size(); ++i )
+    {
+        const FoodNode& node = foodNodes[i];
+        if ( node.isTriangle != triangles || !node.isActive || node.amount <= 0.0f )
+            continue;
+
+        // Same footprint the amount labels are centred on
+        const float ratio = std::clamp( node.amount / base, 0.3f, 2.5f );
+        const float size  = 2.0f * ratio;
+        int colorCode     = node.isBonus ? 6 : 1;
+        if ( static_cast<int>( i ) == activeIndex )
+            colorCode = 3;
+
+        // Outline goes first so the node fill draws over it and only the rim shows
+        if ( static_cast<int>( i ) == hoverIndex )
+        {
+            const float grow = kMeshExtent * size * ( kOutlineGrow - 1.0f ) * 0.5f;
+            const float dx   = triangles ? 0.0f : grow / aspect; // triangles are anchored at the apex
+            instances_.push_back( MarkerInstance{ node.pos.x - dx, node.pos.y + grow, size * kOutlineGrow,
+                                                  size * kOutlineGrow, colorCode, kOutlineLighten } );
+        }
+
+        instances_.push_back( MarkerInstance{ node.pos.x, node.pos.y, size, size, colorCode, 0 } );
+    }
+}
+
+void MarkerBatch::Submit( RenderDevice& device, ID3D11Buffer* instanceBuffer, const MeshBinding& square,
+                          const MeshBinding& triangle ) const
+{
+    if ( instances_.empty() )
+        return;
+
+    const auto bytes = static_cast<unsigned int>( instances_.size() * sizeof( MarkerInstance ) );
+    device.UpdateSubresourceRange( instanceBuffer, instances_.data(), 0, bytes );
+    device.IASetVertexBuffer( 1, instanceBuffer, sizeof( MarkerInstance ) );
+
+    if ( squareCount_ > 0 )
+    {
+        device.BindMesh( square );
+        device.DrawMesh( square, squareCount_, 0 );
+    }
+
+    if ( TriangleCount() > 0 )
+    {
+        device.BindMesh( triangle ); // no-op when both shapes live in the mesh arena
+        device.DrawMesh( triangle, TriangleCount(), squareCount_ );
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FoodNode.h"
+#include "MarkerInstance.h"
+#include "RenderDevice.h"
+#include "Rock.h"
+#include "Vector2D.h"
+
+#include <vector>
+
+// All on-field markers (rocks, food nodes, nest, active and hover highlights) as per-instance data, so every square
+// goes out in one draw and every triangle in another, whatever the node count.
+class MarkerBatch
+{
+  public:
+    void Build( const std::vector<FoodNode>& foodNodes, int activeIndex, int hoverIndex, const Vector2D& nestPos,
+                float baseAmount, float aspectRatio, const std::vector<Rock>& rocks );
+
+    // One instance upload, then at most one draw per shape, square then triangle (MeshArena order)
+    void Submit( RenderDevice& device, ID3D11Buffer* instanceBuffer, const MeshBinding& square,
+                 const MeshBinding& triangle ) const;
+
+    const std::vector<MarkerInstance>& Instances() const
+    {
+        return instances_;
+    }
+    unsigned int SquareCount() const
+    {
+        return squareCount_;
+    }
+    unsigned int TriangleCount() const
+    {
+        return static_cast<unsigned int>( instances_.size() ) - squareCount_;
+    }
+
+  private:
+    void AppendShape( bool triangles, const std::vector<FoodNode>& foodNodes, int activeIndex, int hoverIndex,
+                      float baseAmount, float aspectRatio );
+
+    std::vector<MarkerInstance> instances_; // squares first, then triangles
+    unsigned int squareCount_ = 0;
+};
@@ -0,0 +1,10 @@
+#pragma once
+struct MarkerInstance
+{
+    float posX;    // world top-left
+    float posY;    // world top-left
+    float sizeX;   // scale relative to the base mesh
+    float sizeY;   // scale relative to the base mesh
+    int colorCode; // ColorVertexShader palette: 1 food, 2 nest, 3 active food, 6 bonus sugar, 7 rock
+    int outline;   // lightening level for hover outlines, 0 = plain fill
+}; // Per-instance vertex stream (slot 1) for ColorVertexShader, 24 bytes
@@ -0,0 +1,45 @@
+#include "MeshArena.h"
+
+#include <stdexcept>
+
+MeshId MeshArena::Add( const Vertex* vertices, const size_t vertexCount, const unsigned int* indices,
+                       const size_t indexCount )
+{
+    if ( vertexCount == 0 || indexCount == 0 )
+        throw std::runtime_error( "MeshArena: empty mesh" );
+
+    MeshRange range;
+    range.startIndex = static_cast<unsigned int>( indices_.size() );
+    range.indexCount = static_cast<unsigned int>( indexCount );
+    range.baseVertex = static_cast<int>( vertices_.size() );
+
+    vertices_.insert( vertices_.end(), vertices, vertices + vertexCount );
+    indices_.insert( indices_.end(), indices, indices + indexCount );
+    ranges_.push_back( range );
+    return static_cast<MeshId>( ranges_.size() - 1 );
+}
+
+void MeshArena::SetBuffers( ID3D11Buffer* vertexBuffer, ID3D11Buffer* indexBuffer )
+{
+    vertexBuffer_ = vertexBuffer;
+    indexBuffer_  = indexBuffer;
+}
+
+const MeshRange& MeshArena::Range( const MeshId id ) const
+{
+    return ranges_.at( static_cast<size_t>( id ) );
+}
+
+MeshBinding MeshArena::Binding( const MeshId id ) const
+{
+    const MeshRange& range = Range( id );
+
+    MeshBinding binding;
+    binding.vertexBuffer = vertexBuffer_;
+    binding.indexBuffer  = indexBuffer_;
+    binding.vertexStride = sizeof( Vertex );
+    binding.indexCount   = range.indexCount;
+    binding.startIndex   = range.startIndex;
+    binding.baseVertex   = range.baseVertex;
+    return binding;
+}
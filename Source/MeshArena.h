@@ -0,0 +1,58 @@
+#pragma once
+
+#include "RenderDevice.h"
+#include "Vertex.h"
+
+#include <cstddef>
+#include <vector>
+
+using MeshId = int;
+
+// Where one shape lives inside the shared arena buffers
+struct MeshRange
+{
+    unsigned int startIndex = 0;
+    unsigned int indexCount = 0;
+    int baseVertex          = 0;
+};
+
+// Packs every static 2D shape into one vertex and one index list. The renderer uploads both once and all shapes
+// draw from the same two buffers with per-mesh startIndex/baseVertex, so switching shapes costs no IA rebinds.
+// Register shapes before the renderer uploads the arena; indices are relative to each shape's own vertices.
+class MeshArena
+{
+  public:
+    MeshId Add( const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount );
+
+    template <size_t VertexCount, size_t IndexCount>
+    MeshId Add( const Vertex ( &vertices )[VertexCount], const unsigned int ( &indices )[IndexCount] )
+    {
+        return Add( vertices, VertexCount, indices, IndexCount );
+    }
+
+    // Set once the arena contents are on the GPU; Binding() hands these out for every mesh
+    void SetBuffers( ID3D11Buffer* vertexBuffer, ID3D11Buffer* indexBuffer );
+
+    const MeshRange& Range( MeshId id ) const;
+    MeshBinding Binding( MeshId id ) const;
+
+    const std::vector<Vertex>& Vertices() const
+    {
+        return vertices_;
+    }
+    const std::vector<unsigned int>& Indices() const
+    {
+        return indices_;
+    }
+    size_t MeshCount() const
+    {
+        return ranges_.size();
+    }
+
+  private:
+    std::vector<Vertex> vertices_;
+    std::vector<unsigned int> indices_;
+    std::vector<MeshRange> ranges_;
+    ID3D11Buffer* vertexBuffer_ = nullptr;
+    ID3D11Buffer* indexBuffer_  = nullptr;
+};
@@ -0,0 +1,124 @@
+#include "Metrics.h"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    struct Registry
+    {
+        std::mutex mutex; // registration only
+        std::array<Metric, Metrics::Capacity> metrics;
+        std::atomic<size_t> count{ 0 };
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+} // namespace
+
+Metric& Metrics::Counter( const char* name )
+{
+    return Register( name, MetricKind::Counter );
+}
+
+Metric& Metrics::Gauge( const char* name )
+{
+    return Register( name, MetricKind::Gauge );
+}
+
+size_t Metrics::Count()
+{
+    return GetRegistry().count.load( std::memory_order_acquire );
+}
+
+const Metric& Metrics::At( const size_t index )
+{
+    return GetRegistry().metrics[index];
+}
+
+Metric& Metrics::Register( const char* name, const MetricKind kind )
+{
+    Registry& registry = GetRegistry();
+    const std::lock_guard lock( registry.mutex );
+
+    const size_t count = registry.count.load( std::memory_order_relaxed );
+    for ( size_t i = 0; i < count; i++ )
+    {
+        Metric& metric = registry.metrics[i];
+        if ( std::strcmp( metric.name_, name ) != 0 )
+            continue;
+        if ( metric.kind_ != kind )
+            throw std::invalid_argument( std::string( "Metric registered as another kind: " ) + name );
+        return metric;
+    }
+
+    if ( count == Capacity )
+        throw std::length_error( std::string( "Metrics registry is full, cannot add " ) + name );
+
+    // Name and kind are written before count is published, so readers of At() see them complete
+    Metric& metric = registry.metrics[count];
+    metric.name_   = name;
+    metric.kind_   = kind;
+    registry.count.store( count + 1, std::memory_order_release );
+    return metric;
+}
+
+MetricsHistory::MetricsHistory( const double intervalSeconds ) : interval_( intervalSeconds )
+{
+}
+
+bool MetricsHistory::Sample( const double nowSeconds )
+{
+    if ( lastSample_ >= 0.0 && nowSeconds - lastSample_ < interval_ )
+        return false;
+    const double elapsed = lastSample_ >= 0.0 ? nowSeconds - lastSample_ : 0.0;
+    lastSample_          = nowSeconds;
+
+    // Metrics registered since the last sample start with their current value, so they show no spike
+    const size_t count = Metrics::Count();
+    while ( series_.size() < count )
+    {
+        MetricSeries series;
+        series.metric = &Metrics::At( series_.size() );
+        series.value  = series.metric->Value();
+        series_.push_back( series );
+    }
+
+    for ( MetricSeries& series : series_ )
+    {
+        const int64_t value = series.metric->Value();
+        float plotted       = static_cast<float>( value );
+        if ( series.metric->Kind() == MetricKind::Counter )
+        {
+            series.perSecond = elapsed > 0.0 ? static_cast<double>( value - series.value ) / elapsed : 0.0;
+            plotted          = static_cast<float>( series.perSecond );
+        }
+        series.value                  = value;
+        series.history[series.cursor] = plotted;
+        series.cursor                 = ( series.cursor + 1 ) % series.history.size();
+    }
+    return true;
+}
+
+void MetricsHistory::WriteCsvHeader( std::ostream& out )
+{
+    out << "time_s,name,kind,value,per_second\n";
+}
+
+void MetricsHistory::WriteCsv( std::ostream& out ) const
+{
+    for ( const MetricSeries& series : series_ )
+    {
+        const bool counter = series.metric->Kind() == MetricKind::Counter;
+        out << lastSample_ << ',' << series.metric->Name() << ',' << ( counter ? "counter" : "gauge" ) << ','
+            << series.value << ',';
+        if ( counter )
+            out << series.perSecond;
+        out << '\n';
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+enum class MetricKind
+{
+    Counter, // only grows; shown as a rate
+    Gauge,   // latest value wins
+};
+
+// One named value any thread can bump. Each metric has its own cache line, so two threads bumping different
+// metrics never contend.
+class alignas( 64 ) Metric
+{
+  public:
+    void Add( const int64_t amount = 1 )
+    {
+        value_.fetch_add( amount, std::memory_order_relaxed );
+    }
+
+    void Set( const int64_t value )
+    {
+        value_.store( value, std::memory_order_relaxed );
+    }
+
+    int64_t Value() const
+    {
+        return value_.load( std::memory_order_relaxed );
+    }
+
+    const char* Name() const
+    {
+        return name_;
+    }
+
+    MetricKind Kind() const
+    {
+        return kind_;
+    }
+
+  private:
+    friend class Metrics;
+
+    std::atomic<int64_t> value_{ 0 };
+    const char* name_ = "";
+    MetricKind kind_  = MetricKind::Counter;
+};
+
+// Process-wide registry with fixed storage. Registering takes a lock and should happen once per call site (keep the
+// returned reference in a static); bumping afterwards is a single relaxed atomic. Names must be string literals.
+class Metrics
+{
+  public:
+    static constexpr size_t Capacity = 64;
+
+    // Returns the existing metric when the name is already registered; throws when it was registered as the other
+    // kind or the registry is full
+    static Metric& Counter( const char* name );
+    static Metric& Gauge( const char* name );
+
+    // Metrics registered so far; At() is valid below Count()
+    static size_t Count();
+    static const Metric& At( size_t index );
+
+  private:
+    static Metric& Register( const char* name, MetricKind kind );
+};
+
+struct MetricSeries
+{
+    const Metric* metric = nullptr;
+    int64_t value        = 0;
+    double perSecond     = 0.0; // counters only
+    std::array<float, 120> history{}; // per-second rate for counters, value for gauges; a ring starting at cursor
+    size_t cursor = 0;
+};
+
+// Render-thread view of the registry: samples every metric at a fixed interval and keeps a short history of each
+// for the HUD sparklines, and writes samples as CSV rows for soak runs.
+class MetricsHistory
+{
+  public:
+    explicit MetricsHistory( double intervalSeconds = 0.25 );
+
+    // Call every frame; returns true when it took a sample
+    bool Sample( double nowSeconds );
+
+    const std::vector<MetricSeries>& Series() const
+    {
+        return series_;
+    }
+
+    // time_s,name,kind,value,per_second rows for the last sample
+    static void WriteCsvHeader( std::ostream& out );
+    void WriteCsv( std::ostream& out ) const;
+
+  private:
+    double interval_;
+    double lastSample_ = -1.0;
+    std::vector<MetricSeries> series_;
+};
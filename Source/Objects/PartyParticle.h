@@ -5,6 +5,8 @@
 #ifndef RENDERENGINE_PARTYPARTICLES_H
 #define RENDERENGINE_PARTYPARTICLES_H
 
+#include <cstdint>
+
 
 // --- Fun elements state ---
 struct PartyParticle
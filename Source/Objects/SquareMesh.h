@@ -1,11 +1,10 @@
 #pragma once
 
-#include "../Mesh.h"
-#include "../Vertex.h"
+#include "../MeshArena.h"
 
 class SquareMesh
 {
   public:
-    Mesh* renderingData;
-    explicit SquareMesh( ID3D11Device& pDevice );
+    MeshId id;
+    explicit SquareMesh( MeshArena& arena );
 };
\ No newline at end of file
@@ -1,9 +1,7 @@
 #include "TriangleMesh.h"
 
-TriangleMesh::TriangleMesh( ID3D11Device& pDevice )
+TriangleMesh::TriangleMesh( MeshArena& arena )
 {
-    renderingData = new Mesh();
-
     Vertex vertices[] = {
         { 0.0f, 0.0f, 0.0f },
         { 0.025f, -0.05f, 0.0f },
@@ -11,35 +9,11 @@ TriangleMesh::TriangleMesh( ID3D11Device& pDevice )
     };
 
     // Create triangle indices
-    UINT indices[] = {
+    unsigned int indices[] = {
         0,
         1,
         2, // first triangle
     };
 
-    renderingData->indexCount = std::size( indices );
-
-    // Create buffer description for vertices
-    D3D11_BUFFER_DESC bd      = {};
-    D3D11_SUBRESOURCE_DATA sd = {};
-
-    bd.Usage     = D3D11_USAGE_DEFAULT;
-    bd.ByteWidth = sizeof( vertices );
-    bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-    sd.pSysMem = vertices;
-
-    HRESULT hr = pDevice.CreateBuffer( &bd, &sd, &renderingData->vertexBuffer );
-    if ( FAILED( hr ) )
-        return;
-
-    // Re-use buffer description for the indices
-    bd.ByteWidth = sizeof( indices );
-    bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-
-    sd.pSysMem = indices;
-
-    hr = pDevice.CreateBuffer( &bd, &sd, &renderingData->indexBuffer );
-    if ( FAILED( hr ) )
-        return;
+    id = arena.Add( vertices, indices );
 }
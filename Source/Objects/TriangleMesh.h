@@ -1,11 +1,10 @@
 #pragma once
 
-#include "../Mesh.h"
-#include "../Vertex.h"
+#include "../MeshArena.h"
 
 class TriangleMesh
 {
   public:
-    Mesh* renderingData;
-    explicit TriangleMesh( ID3D11Device& pDevice );
+    MeshId id;
+    explicit TriangleMesh( MeshArena& arena );
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Runs work(0..count-1) on up to one thread per item, the calling thread included. Items are handed out one at a
+// time, so uneven items balance; the threads live for this one call.
+template <class Work> void ForEachParallel( const size_t count, Work&& work )
+{
+    if ( count <= 1 )
+    {
+        if ( count == 1 )
+            work( size_t{ 0 } );
+        return;
+    }
+
+    std::atomic<size_t> next{ 0 };
+    const auto run = [&next, &work, count]
+    {
+        for ( size_t i = next.fetch_add( 1 ); i < count; i = next.fetch_add( 1 ) )
+            work( i );
+    };
+    const size_t threads = std::min<size_t>( count, std::max( 1u, std::thread::hardware_concurrency() ) ) - 1;
+    std::vector<std::thread> workers;
+    workers.reserve( threads );
+    for ( size_t t = 0; t < threads; t++ )
+        workers.emplace_back( run );
+    run();
+    for ( std::thread& worker : workers )
+        worker.join();
+}
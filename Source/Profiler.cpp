@@ -0,0 +1,225 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+#include <intrin.h>
+#define PROFILER_HAS_TSC 1
+#elif defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#define PROFILER_HAS_TSC 1
+#endif
+
+std::atomic<bool> Profiler::enabled_{ false };
+
+namespace
+{
+    // Fields are relaxed atomics so the exporter can read a ring while its thread writes; on x86 they compile to
+    // plain moves
+    struct RingEvent
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> end{ 0 };
+    };
+
+    struct ThreadRing
+    {
+        int id = 0;
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> head{ 0 }; // zones ever written; the slot is head % RingCapacity
+        std::unique_ptr<RingEvent[]> events = std::make_unique<RingEvent[]>( Profiler::RingCapacity );
+    };
+
+    struct Clock
+    {
+        std::chrono::steady_clock::time_point wall;
+        uint64_t ticks;
+    };
+
+    uint64_t ReadTicks()
+    {
+#ifdef PROFILER_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch() )
+                                          .count() );
+#endif
+    }
+
+    Clock SampleClock()
+    {
+        return { std::chrono::steady_clock::now(), ReadTicks() };
+    }
+
+    // Rings are never freed, so a thread that has exited still shows up in the next trace
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadRing>> rings;
+        Clock origin = SampleClock();
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadRing& LocalRing()
+    {
+        thread_local ThreadRing* ring = []
+        {
+            Registry& registry = GetRegistry();
+            const std::lock_guard lock( registry.mutex );
+            registry.rings.push_back( std::make_unique<ThreadRing>() );
+            registry.rings.back()->id = static_cast<int>( registry.rings.size() );
+            return registry.rings.back().get();
+        }();
+        return *ring;
+    }
+
+    struct CopiedEvent
+    {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // Copies the ring's live window, dropping slots the writer may have been overwriting during the copy
+    std::vector<CopiedEvent> CopyRing( const ThreadRing& ring )
+    {
+        const uint64_t head  = ring.head.load( std::memory_order_acquire );
+        const uint64_t first = head > Profiler::RingCapacity ? head - Profiler::RingCapacity : 0;
+
+        std::vector<CopiedEvent> events;
+        events.reserve( static_cast<size_t>( head - first ) );
+        for ( uint64_t i = first; i < head; i++ )
+        {
+            const RingEvent& event = ring.events[i % Profiler::RingCapacity];
+            events.push_back( { event.name.load( std::memory_order_relaxed ), event.start.load( std::memory_order_relaxed ),
+                                event.end.load( std::memory_order_relaxed ) } );
+        }
+
+        // The writer fills slot `after` before publishing after + 1, so that slot counts as dirty too
+        std::atomic_thread_fence( std::memory_order_acquire );
+        const uint64_t after = ring.head.load( std::memory_order_relaxed );
+        const uint64_t clean = after + 1 > Profiler::RingCapacity ? after + 1 - Profiler::RingCapacity : 0;
+        if ( clean > first )
+            events.erase( events.begin(), events.begin() + static_cast<std::ptrdiff_t>(
+                                                                std::min<uint64_t>( clean - first, events.size() ) ) );
+        return events;
+    }
+
+    void WriteJsonString( std::ofstream& out, const char* text )
+    {
+        out << '"';
+        for ( const char* c = text; *c; c++ )
+        {
+            if ( *c == '"' || *c == '\\' )
+                out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+} // namespace
+
+void Profiler::SetEnabled( const bool enabled )
+{
+    GetRegistry(); // take the clock origin before the first zone
+    enabled_.store( enabled, std::memory_order_relaxed );
+}
+
+void Profiler::SetThreadName( const char* name )
+{
+    LocalRing().name.store( name, std::memory_order_relaxed );
+}
+
+uint64_t Profiler::Now()
+{
+    return ReadTicks();
+}
+
+void Profiler::Record( const char* name, const uint64_t start, const uint64_t end )
+{
+    ThreadRing& ring    = LocalRing();
+    const uint64_t head = ring.head.load( std::memory_order_relaxed );
+    RingEvent& event    = ring.events[head % RingCapacity];
+    event.name.store( name, std::memory_order_relaxed );
+    event.start.store( start, std::memory_order_relaxed );
+    event.end.store( end, std::memory_order_relaxed );
+    ring.head.store( head + 1, std::memory_order_release );
+}
+
+bool Profiler::WriteChromeTrace( const std::filesystem::path& path )
+{
+    Registry& registry = GetRegistry();
+
+    // Ticks to microseconds from the span since the registry was created; TSC rate is constant on anything recent
+    const Clock now           = SampleClock();
+    const double elapsedMicro = std::chrono::duration<double, std::micro>( now.wall - registry.origin.wall ).count();
+    const double microPerTick =
+        now.ticks > registry.origin.ticks && elapsedMicro > 0.0
+            ? elapsedMicro / static_cast<double>( now.ticks - registry.origin.ticks )
+            : 0.001;
+
+    std::ofstream out( path, std::ios::trunc );
+    if ( !out )
+        return false;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    const std::lock_guard lock( registry.mutex );
+    for ( const std::unique_ptr<ThreadRing>& ring : registry.rings )
+    {
+        if ( const char* name = ring->name.load( std::memory_order_relaxed ) )
+        {
+            out << ( first ? "" : ",\n" ) << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->id
+                << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            WriteJsonString( out, name );
+            out << "}}";
+            first = false;
+        }
+
+        for ( const CopiedEvent& event : CopyRing( *ring ) )
+        {
+            const double ts  = static_cast<double>( event.start - registry.origin.ticks ) * microPerTick;
+            const double dur = static_cast<double>( event.end - event.start ) * microPerTick;
+            out << ( first ? "" : ",\n" ) << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->id << ",\"ts\":" << ts
+                << ",\"dur\":" << dur << ",\"name\":";
+            WriteJsonString( out, event.name );
+            out << '}';
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>( out );
+}
+
+ProfilerStats Profiler::Stats()
+{
+    Registry& registry = GetRegistry();
+    const Clock now    = SampleClock();
+    const double micro = std::chrono::duration<double, std::micro>( now.wall - registry.origin.wall ).count();
+
+    ProfilerStats stats;
+    stats.ticksPerMicro = micro > 0.0 ? static_cast<double>( now.ticks - registry.origin.ticks ) / micro : 0.0;
+
+    const std::lock_guard lock( registry.mutex );
+    stats.threads = static_cast<int>( registry.rings.size() );
+    for ( const std::unique_ptr<ThreadRing>& ring : registry.rings )
+    {
+        const uint64_t head = ring->head.load( std::memory_order_relaxed );
+        stats.zones += head;
+        stats.zonesKept += std::min<uint64_t>( head, RingCapacity );
+    }
+    return stats;
+}
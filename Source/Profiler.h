@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+struct ProfilerStats
+{
+    int threads          = 0;
+    uint64_t zones       = 0; // recorded since start, including ones the rings have since overwritten
+    uint64_t zonesKept   = 0; // still in the rings, i.e. what a trace written now would contain
+    double ticksPerMicro = 0.0;
+};
+
+// Scoped CPU zones for "where did this frame go". Every thread writes into its own fixed ring (no locks, no
+// allocation after the thread's first zone), so the rings always hold the last few seconds and a trace can be written
+// right after a hitch. Timestamps are raw TSC reads, converted to microseconds only when the trace is written.
+//
+// Zone names must outlive the profiler (string literals).
+class Profiler
+{
+  public:
+    // Zones per thread ring; at a few dozen zones per frame that is several seconds of history
+    static constexpr uint32_t RingCapacity = 1u << 15;
+
+    static bool Enabled()
+    {
+        return enabled_.load( std::memory_order_relaxed );
+    }
+
+    static void SetEnabled( bool enabled );
+
+    // Shown as the thread's track name in the trace
+    static void SetThreadName( const char* name );
+
+    static uint64_t Now();
+
+    static void Record( const char* name, uint64_t start, uint64_t end );
+
+    // chrome://tracing / Perfetto JSON ("X" complete events) of everything still in the rings
+    static bool WriteChromeTrace( const std::filesystem::path& path );
+
+    static ProfilerStats Stats();
+
+    // Innermost zone open on this thread, tracked even while recording is off (AllocationTracker attributes to it)
+    static const char* CurrentZone()
+    {
+        return currentZone_;
+    }
+
+  private:
+    friend class ProfileZone;
+
+    static std::atomic<bool> enabled_;
+    static inline thread_local const char* currentZone_ = nullptr;
+};
+
+class ProfileZone
+{
+  public:
+    explicit ProfileZone( const char* name )
+        : parent_( Profiler::currentZone_ ), name_( Profiler::Enabled() ? name : nullptr ),
+          start_( name_ ? Profiler::Now() : 0 )
+    {
+        Profiler::currentZone_ = name;
+    }
+
+    ~ProfileZone()
+    {
+        Profiler::currentZone_ = parent_;
+        if ( name_ )
+            Profiler::Record( name_, start_, Profiler::Now() );
+    }
+
+    ProfileZone( const ProfileZone& )            = delete;
+    ProfileZone& operator=( const ProfileZone& ) = delete;
+
+  private:
+    const char* parent_;
+    const char* name_; // null while recording is off
+    uint64_t start_;
+};
+
+#define PROFILE_ZONE_JOIN2( a, b ) a##b
+#define PROFILE_ZONE_JOIN( a, b ) PROFILE_ZONE_JOIN2( a, b )
+#define PROFILE_ZONE( name ) const ProfileZone PROFILE_ZONE_JOIN( profileZone, __LINE__ )( name )
@@ -0,0 +1,104 @@
+#include "RecordingRenderDevice.h"
+
+#include <cstring>
+
+int RecordingRenderDevice::Count( const RenderCommandType type ) const
+{
+    int count = 0;
+    for ( const RenderCommand& command : commands_ )
+    {
+        if ( command.type == type )
+            count++;
+    }
+    return count;
+}
+
+size_t RecordingRenderDevice::Bytes( const RenderCommandType type ) const
+{
+    size_t bytes = 0;
+    for ( const RenderCommand& command : commands_ )
+    {
+        if ( command.type == type )
+            bytes += command.bytes;
+    }
+    return bytes;
+}
+
+void RecordingRenderDevice::Clear()
+{
+    commands_.clear();
+}
+
+void RecordingRenderDevice::DoUpdateSubresource( ID3D11Buffer* buffer, const void* /*data*/,
+                                                 unsigned int /*byteOffset*/, const unsigned int byteCount,
+                                                 bool /*wholeResource*/ )
+{
+    commands_.push_back( { RenderCommandType::UpdateSubresource, buffer, byteCount, 0, 0 } );
+}
+
+void RecordingRenderDevice::DoCopyResource( ID3D11Buffer* destination, ID3D11Buffer* /*source*/,
+                                            const unsigned int byteCount )
+{
+    commands_.push_back( { RenderCommandType::CopyResource, destination, byteCount, 0, 0 } );
+}
+
+void* RecordingRenderDevice::DoMap( ID3D11Buffer* buffer, MapMode /*mode*/, const unsigned int byteCount )
+{
+    commands_.push_back( { RenderCommandType::Map, buffer, byteCount, 0, 0 } );
+    mapScratch_.assign( byteCount > 0 ? byteCount : 1, 0 );
+    return mapScratch_.data();
+}
+
+void RecordingRenderDevice::DoUnmap( ID3D11Buffer* buffer )
+{
+    commands_.push_back( { RenderCommandType::Unmap, buffer, 0, 0, 0 } );
+}
+
+void RecordingRenderDevice::DoBegin( ID3D11Query* query )
+{
+    commands_.push_back( { RenderCommandType::BeginQuery, query, 0, 0, 0 } );
+}
+
+void RecordingRenderDevice::DoEnd( ID3D11Query* query )
+{
+    commands_.push_back( { RenderCommandType::EndQuery, query, 0, 0, 0 } );
+}
+
+bool RecordingRenderDevice::DoGetData( ID3D11Query* query, void* data, const unsigned int byteCount )
+{
+    commands_.push_back( { RenderCommandType::GetData, query, byteCount, 0, 0 } );
+    if ( !queriesReady_ )
+        return false;
+    if ( data && byteCount > 0 )
+        std::memset( data, 0, byteCount );
+    return true;
+}
+
+void RecordingRenderDevice::DoDispatch( const unsigned int groupsX, const unsigned int groupsY,
+                                        const unsigned int groupsZ )
+{
+    commands_.push_back( { RenderCommandType::Dispatch, nullptr, 0, groupsX * groupsY * groupsZ, 0 } );
+}
+
+void RecordingRenderDevice::DoIASetVertexBuffer( const unsigned int slot, ID3D11Buffer* buffer,
+                                                 unsigned int /*stride*/ )
+{
+    commands_.push_back( { RenderCommandType::SetVertexBuffer, buffer, 0, slot, 0 } );
+}
+
+void RecordingRenderDevice::DoIASetIndexBuffer( ID3D11Buffer* buffer )
+{
+    commands_.push_back( { RenderCommandType::SetIndexBuffer, buffer, 0, 0, 0 } );
+}
+
+void RecordingRenderDevice::DoDrawIndexedInstanced( const unsigned int indexCount, const unsigned int instanceCount,
+                                                    unsigned int /*startIndex*/, int /*baseVertex*/,
+                                                    unsigned int /*startInstance*/ )
+{
+    commands_.push_back( { RenderCommandType::DrawIndexedInstanced, nullptr, 0, indexCount, instanceCount } );
+}
+
+void RecordingRenderDevice::DoDraw( const unsigned int vertexCount, unsigned int /*startVertex*/ )
+{
+    commands_.push_back( { RenderCommandType::Draw, nullptr, 0, vertexCount, 1 } );
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "RenderDevice.h"
+
+#include <vector>
+
+enum class RenderCommandType
+{
+    UpdateSubresource,
+    CopyResource,
+    Map,
+    Unmap,
+    BeginQuery,
+    EndQuery,
+    GetData,
+    Dispatch,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    DrawIndexedInstanced,
+    Draw,
+};
+
+struct RenderCommand
+{
+    RenderCommandType type;
+    const void* resource;   // target buffer or query, nullptr for draws and dispatches
+    unsigned int bytes;     // bytes uploaded, copied, mapped or polled; 0 for binds, draws and dispatches
+    unsigned int count;     // index/vertex count for draws, slot for vertex buffer binds, groups for dispatches
+    unsigned int instances; // instance count for draws
+};
+
+// Null device that logs every call instead of talking to a GPU. Runs anywhere, no D3D headers needed.
+class RecordingRenderDevice : public RenderDevice
+{
+  public:
+    const std::vector<RenderCommand>& Commands() const
+    {
+        return commands_;
+    }
+
+    int Count( RenderCommandType type ) const;
+    size_t Bytes( RenderCommandType type ) const;
+    void Clear();
+
+    // GetData results are zero-filled; when not ready every poll misses, like a GPU running frames behind
+    void SetQueriesReady( bool ready )
+    {
+        queriesReady_ = ready;
+    }
+
+  protected:
+    void DoUpdateSubresource( ID3D11Buffer* buffer, const void* data, unsigned int byteOffset, unsigned int byteCount,
+                              bool wholeResource ) override;
+    void DoCopyResource( ID3D11Buffer* destination, ID3D11Buffer* source, unsigned int byteCount ) override;
+    void* DoMap( ID3D11Buffer* buffer, MapMode mode, unsigned int byteCount ) override;
+    void DoUnmap( ID3D11Buffer* buffer ) override;
+    void DoBegin( ID3D11Query* query ) override;
+    void DoEnd( ID3D11Query* query ) override;
+    bool DoGetData( ID3D11Query* query, void* data, unsigned int byteCount ) override;
+    void DoDispatch( unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ ) override;
+    void DoIASetVertexBuffer( unsigned int slot, ID3D11Buffer* buffer, unsigned int stride ) override;
+    void DoIASetIndexBuffer( ID3D11Buffer* buffer ) override;
+    void DoDrawIndexedInstanced( unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex,
+                                 int baseVertex, unsigned int startInstance ) override;
+    void DoDraw( unsigned int vertexCount, unsigned int startVertex ) override;
+
+  private:
+    std::vector<RenderCommand> commands_;
+    std::vector<unsigned char> mapScratch_; // zeroed memory handed out by Map
+    bool queriesReady_ = true;
+};
@@ -0,0 +1,28 @@
+#include "RenderBudget.h"
+
+namespace
+{
+    void CheckLimit( std::vector<RenderBudgetViolation>& violations, const char* counter, const size_t value,
+                     const size_t limit )
+    {
+        if ( limit != RenderBudget::Unlimited && value > limit )
+            violations.push_back( { counter, value, limit } );
+    }
+} // namespace
+
+RenderBudget RenderBudget::SteadyFrame( const size_t readbackBytes )
+{
+    return RenderBudget{ 8, 2, Unlimited, 2 * readbackBytes, 2 * readbackBytes };
+}
+
+std::vector<RenderBudgetViolation> RenderBudgetCheck::Check( const RenderDeviceStats& frame,
+                                                             const RenderBudget& budget )
+{
+    std::vector<RenderBudgetViolation> violations;
+    CheckLimit( violations, "draws", static_cast<size_t>( frame.draws ), budget.maxDraws );
+    CheckLimit( violations, "dispatches", static_cast<size_t>( frame.dispatches ), budget.maxDispatches );
+    CheckLimit( violations, "uploadBytes", frame.uploadBytes, budget.maxUploadBytes );
+    CheckLimit( violations, "copyBytes", frame.copyBytes, budget.maxCopyBytes );
+    CheckLimit( violations, "mapBytes", frame.mapBytes, budget.maxMapBytes );
+    return violations;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "RenderDevice.h"
+
+#include <cstddef>
+#include <vector>
+
+// Per-frame limits on what the renderer may submit; fields left at Unlimited are not checked. Checked against
+// RenderDeviceStats, so the same budget applies to the D3D11 and the recording device.
+struct RenderBudget
+{
+    static constexpr size_t Unlimited = static_cast<size_t>( -1 );
+
+    size_t maxDraws       = Unlimited;
+    size_t maxDispatches  = Unlimited;
+    size_t maxUploadBytes = Unlimited;
+    size_t maxCopyBytes   = Unlimited; // steady state only pays for readback copies, never a full instance copy
+    size_t maxMapBytes    = Unlimited;
+
+    // The game's steady-state frame, as the debug HUD checks it: at most 8 draws (markers, ants or the density
+    // passes, labels) and 2 dispatches, with the food and nest hit-count readbacks of readbackBytes each as the only
+    // copies and maps
+    static RenderBudget SteadyFrame( size_t readbackBytes );
+};
+
+struct RenderBudgetViolation
+{
+    const char* counter; // name of the RenderDeviceStats field
+    size_t value;
+    size_t limit;
+};
+
+class RenderBudgetCheck
+{
+  public:
+    // Empty when the frame stayed within every limit
+    static std::vector<RenderBudgetViolation> Check( const RenderDeviceStats& frame, const RenderBudget& budget );
+};
@@ -0,0 +1,166 @@
+#include "RenderDevice.h"
+
+void RenderDevice::BeginFrame()
+{
+    last_    = current_;
+    current_ = {};
+    InvalidateBindings();
+}
+
+void RenderDevice::InvalidateBindings()
+{
+    bindingsValid_ = false;
+}
+
+void RenderDevice::UpdateSubresource( ID3D11Buffer* buffer, const void* data, const unsigned int byteCount )
+{
+    current_.updates++;
+    current_.uploadBytes += byteCount;
+    DoUpdateSubresource( buffer, data, 0, byteCount, true );
+}
+
+void RenderDevice::UpdateSubresourceRange( ID3D11Buffer* buffer, const void* data, const unsigned int byteOffset,
+                                           const unsigned int byteCount )
+{
+    if ( byteCount == 0 )
+        return;
+    current_.updates++;
+    current_.uploadBytes += byteCount;
+    DoUpdateSubresource( buffer, data, byteOffset, byteCount, false );
+}
+
+void RenderDevice::CountSkippedUpload( const unsigned int byteCount )
+{
+    current_.skippedUploadBytes += byteCount;
+}
+
+void RenderDevice::CopyResource( ID3D11Buffer* destination, ID3D11Buffer* source, const unsigned int byteCount )
+{
+    current_.copies++;
+    current_.copyBytes += byteCount;
+    DoCopyResource( destination, source, byteCount );
+}
+
+void* RenderDevice::Map( ID3D11Buffer* buffer, const MapMode mode, const unsigned int byteCount )
+{
+    void* data = DoMap( buffer, mode, byteCount );
+    if ( data )
+    {
+        current_.maps++;
+        current_.mapBytes += byteCount;
+    }
+    return data;
+}
+
+void RenderDevice::Unmap( ID3D11Buffer* buffer )
+{
+    DoUnmap( buffer );
+}
+
+void RenderDevice::Begin( ID3D11Query* query )
+{
+    DoBegin( query );
+}
+
+void RenderDevice::End( ID3D11Query* query )
+{
+    current_.queryEnds++;
+    DoEnd( query );
+}
+
+bool RenderDevice::GetData( ID3D11Query* query, void* data, const unsigned int byteCount )
+{
+    current_.queryPolls++;
+    const bool ready = DoGetData( query, data, byteCount );
+    if ( !ready )
+        current_.queryMisses++;
+    return ready;
+}
+
+void RenderDevice::Dispatch( const unsigned int groupsX, const unsigned int groupsY, const unsigned int groupsZ )
+{
+    if ( groupsX == 0 || groupsY == 0 || groupsZ == 0 )
+        return;
+    current_.dispatches++;
+    DoDispatch( groupsX, groupsY, groupsZ );
+}
+
+void RenderDevice::ResetBindingCacheIfStale()
+{
+    if ( bindingsValid_ )
+        return;
+
+    for ( unsigned int i = 0; i < TrackedVertexSlots; i++ )
+    {
+        boundVertexBuffers_[i] = nullptr;
+        boundVertexStrides_[i] = 0;
+    }
+    boundIndexBuffer_ = nullptr;
+    bindingsValid_    = true;
+}
+
+void RenderDevice::IASetVertexBuffer( const unsigned int slot, ID3D11Buffer* buffer, const unsigned int stride )
+{
+    ResetBindingCacheIfStale();
+
+    if ( slot < TrackedVertexSlots )
+    {
+        if ( boundVertexBuffers_[slot] == buffer && boundVertexStrides_[slot] == stride && buffer )
+        {
+            current_.redundantBindsSkipped++;
+            return;
+        }
+        boundVertexBuffers_[slot] = buffer;
+        boundVertexStrides_[slot] = stride;
+    }
+
+    current_.vertexBufferBinds++;
+    DoIASetVertexBuffer( slot, buffer, stride );
+}
+
+void RenderDevice::IASetIndexBuffer( ID3D11Buffer* buffer )
+{
+    ResetBindingCacheIfStale();
+
+    if ( boundIndexBuffer_ == buffer && buffer )
+    {
+        current_.redundantBindsSkipped++;
+        return;
+    }
+    boundIndexBuffer_ = buffer;
+
+    current_.indexBufferBinds++;
+    DoIASetIndexBuffer( buffer );
+}
+
+void RenderDevice::BindMesh( const MeshBinding& mesh )
+{
+    IASetVertexBuffer( 0, mesh.vertexBuffer, mesh.vertexStride );
+    IASetIndexBuffer( mesh.indexBuffer );
+}
+
+void RenderDevice::DrawMesh( const MeshBinding& mesh, const unsigned int instanceCount,
+                             const unsigned int startInstance )
+{
+    DrawIndexedInstanced( mesh.indexCount, instanceCount, mesh.startIndex, mesh.baseVertex, startInstance );
+}
+
+void RenderDevice::DrawIndexedInstanced( const unsigned int indexCount, const unsigned int instanceCount,
+                                         const unsigned int startIndex, const int baseVertex,
+                                         const unsigned int startInstance )
+{
+    if ( instanceCount == 0 )
+        return;
+    current_.draws++;
+    current_.instances += static_cast<int>( instanceCount );
+    DoDrawIndexedInstanced( indexCount, instanceCount, startIndex, baseVertex, startInstance );
+}
+
+void RenderDevice::Draw( const unsigned int vertexCount, const unsigned int startVertex )
+{
+    if ( vertexCount == 0 )
+        return;
+    current_.draws++;
+    current_.instances++;
+    DoDraw( vertexCount, startVertex );
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+
+struct ID3D11Buffer;
+struct ID3D11Query;
+
+// Mesh geometry as the device sees it; shapes in the MeshArena share both buffers and differ only in their range
+struct MeshBinding
+{
+    ID3D11Buffer* vertexBuffer = nullptr;
+    ID3D11Buffer* indexBuffer  = nullptr;
+    unsigned int vertexStride  = 0;
+    unsigned int indexCount    = 0;
+    unsigned int startIndex    = 0;
+    int baseVertex             = 0;
+};
+
+enum class MapMode
+{
+    Read,             // staging readback
+    WriteDiscard,     // dynamic buffer, previous contents dropped
+    WriteNoOverwrite, // dynamic buffer, caller promises not to touch ranges in flight
+};
+
+struct RenderDeviceStats
+{
+    int updates               = 0; // UpdateSubresource calls
+    size_t uploadBytes        = 0;
+    size_t skippedUploadBytes = 0; // constant data that was unchanged and not re-uploaded
+    int copies                = 0; // CopyResource calls
+    size_t copyBytes          = 0;
+    int maps                  = 0;
+    size_t mapBytes           = 0; // bytes made visible to the CPU (read) or handed to the GPU (write)
+    int vertexBufferBinds     = 0;
+    int indexBufferBinds      = 0;
+    int redundantBindsSkipped = 0; // binds of a buffer that was already bound at that slot
+    int draws                 = 0; // Draw and DrawIndexedInstanced
+    int instances             = 0;
+    int dispatches            = 0;
+    int queryEnds             = 0;
+    int queryPolls            = 0; // GetData calls
+    int queryMisses           = 0; // GetData calls whose result was not ready yet
+};
+
+// Thin layer over the immediate context calls the renderer issues each frame. The D3D11 device forwards them,
+// the recording device only logs them so draw and upload counts can be checked without a GPU.
+class RenderDevice
+{
+  public:
+    virtual ~RenderDevice() = default;
+
+    // Moves the running counters to LastFrame() and starts a new frame. Also forgets the IA bindings, since other
+    // code (ImGui) binds through the context directly between frames.
+    void BeginFrame();
+
+    // Call after anything outside this device touched IA vertex/index buffer state
+    void InvalidateBindings();
+
+    void UpdateSubresource( ID3D11Buffer* buffer, const void* data, unsigned int byteCount );
+    void UpdateSubresourceRange( ID3D11Buffer* buffer, const void* data, unsigned int byteOffset,
+                                 unsigned int byteCount );
+    void CountSkippedUpload( unsigned int byteCount );
+
+    // Whole-buffer copy; byteCount is the size of the copied buffers, used for accounting only
+    void CopyResource( ID3D11Buffer* destination, ID3D11Buffer* source, unsigned int byteCount );
+
+    // Returns nullptr when the map failed; byteCount is the mapped size, used for accounting only
+    void* Map( ID3D11Buffer* buffer, MapMode mode, unsigned int byteCount );
+    void Unmap( ID3D11Buffer* buffer );
+
+    void Begin( ID3D11Query* query );
+    void End( ID3D11Query* query );
+
+    // Non-blocking poll; false while the GPU has not produced the result
+    bool GetData( ID3D11Query* query, void* data, unsigned int byteCount );
+
+    void Dispatch( unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ );
+    void IASetVertexBuffer( unsigned int slot, ID3D11Buffer* buffer, unsigned int stride );
+    void IASetIndexBuffer( ID3D11Buffer* buffer );
+    void BindMesh( const MeshBinding& mesh );
+    // Draws the mesh's own index range
+    void DrawMesh( const MeshBinding& mesh, unsigned int instanceCount, unsigned int startInstance );
+    void DrawIndexedInstanced( unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex,
+                               int baseVertex, unsigned int startInstance );
+    void Draw( unsigned int vertexCount, unsigned int startVertex );
+
+    const RenderDeviceStats& CurrentFrame() const
+    {
+        return current_;
+    }
+    const RenderDeviceStats& LastFrame() const
+    {
+        return last_;
+    }
+
+  protected:
+    // byteOffset/byteCount describe the written range; wholeResource updates must not pass a box (constant buffers)
+    virtual void DoUpdateSubresource( ID3D11Buffer* buffer, const void* data, unsigned int byteOffset,
+                                      unsigned int byteCount, bool wholeResource ) = 0;
+
+    virtual void DoCopyResource( ID3D11Buffer* destination, ID3D11Buffer* source, unsigned int byteCount ) = 0;
+
+    virtual void* DoMap( ID3D11Buffer* buffer, MapMode mode, unsigned int byteCount ) = 0;
+
+    virtual void DoUnmap( ID3D11Buffer* buffer ) = 0;
+
+    virtual void DoBegin( ID3D11Query* query ) = 0;
+
+    virtual void DoEnd( ID3D11Query* query ) = 0;
+
+    virtual bool DoGetData( ID3D11Query* query, void* data, unsigned int byteCount ) = 0;
+
+    virtual void DoDispatch( unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ ) = 0;
+
+    virtual void DoIASetVertexBuffer( unsigned int slot, ID3D11Buffer* buffer, unsigned int stride ) = 0;
+
+    virtual void DoIASetIndexBuffer( ID3D11Buffer* buffer ) = 0;
+
+    virtual void DoDrawIndexedInstanced( unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex,
+                                         int baseVertex, unsigned int startInstance ) = 0;
+
+    virtual void DoDraw( unsigned int vertexCount, unsigned int startVertex ) = 0;
+
+  private:
+    static constexpr unsigned int TrackedVertexSlots = 4;
+
+    void ResetBindingCacheIfStale();
+
+    RenderDeviceStats current_{};
+    RenderDeviceStats last_{};
+
+    // Last buffer and stride bound per slot, so repeated binds of the shared mesh arena are dropped
+    ID3D11Buffer* boundVertexBuffers_[TrackedVertexSlots] = {};
+    unsigned int boundVertexStrides_[TrackedVertexSlots]  = {};
+    ID3D11Buffer* boundIndexBuffer_                       = nullptr;
+    bool bindingsValid_                                   = false;
+};
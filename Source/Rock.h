@@ -0,0 +1,12 @@
+#pragma once
+#include "Vector2D.h"
+
+// A static obstacle: an axis-aligned square the ants route around (see FlowField.h)
+struct Rock
+{
+    Vector2D pos; // centre
+    float halfSize;
+};
+
+// Largest halfSize placeRocks makes; the rock distance field is baked deeper than this (see DistanceField.h)
+constexpr float MaxRockHalfSize = 0.08f;
@@ -0,0 +1,566 @@
+#include "ScenarioRunner.h"
+
+#include "Game/AntGame.h"
+#include "Game/GameRules.h"
+#include "AllocationTracker.h"
+#include "AntStepKernel.h"
+#include "InstancedRendererEngine2D.h"
+#include "Metrics.h"
+#include "SpectatorCodec.h"
+#include "SpectatorSocket.h"
+
+#include <Windows.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cwchar>
+#include <fstream>
+#include <optional>
+#include <psapi.h>
+#include <random>
+#include <shellapi.h>
+#include <sstream>
+#include <stdexcept>
+
+#pragma comment( lib, "psapi.lib" )
+#pragma comment( lib, "shell32.lib" )
+
+namespace
+{
+    // What a script sees between frames: the snapshot the last frame drew and the input to send
+    struct ScenarioContext
+    {
+        Game::AntGame& game;
+        const Game::WorldSnapshot& snapshot;
+        const ViewTransform& view;
+        std::mt19937& rng;
+        int frame;
+    };
+
+    struct Scenario
+    {
+        const char* name;
+        const char* settings; // applied over settings.ini before the restart
+        int stage;
+        int frames; // upper bound; done() may end the run earlier
+        uint32_t seed;
+        void ( *script )( ScenarioContext& context );
+        bool ( *done )( const Game::WorldSnapshot& snapshot );
+    };
+
+    void PressKey( Game::AntGame& game, const WPARAM key )
+    {
+        game.handleEvent( WM_KEYUP, key, 0 );
+    }
+
+    void Click( Game::AntGame& game, const int x, const int y )
+    {
+        game.handleEvent( WM_LBUTTONUP, 0, MAKELPARAM( x, y ) );
+    }
+
+    // A player who keeps a node selected (a random one after each restart) and takes the max-ants upgrade at
+    // every stage clear
+    void Play( ScenarioContext& context )
+    {
+        const Game::GameWorldState& state = context.snapshot.state;
+        if ( state.gameState == GameState::StageClear )
+        {
+            PressKey( context.game, '3' );
+            return;
+        }
+        if ( state.gameState != GameState::Playing || state.activeFoodIndex >= 0 || state.foodNodes.empty() )
+            return;
+
+        std::uniform_int_distribution<size_t> pick( 0, state.foodNodes.size() - 1 );
+        const Vector2D screen = context.view.WorldToScreen( state.foodNodes[pick( context.rng )].pos );
+        Click( context.game, static_cast<int>( screen.x ), static_cast<int>( screen.y ) );
+    }
+
+    void Idle( ScenarioContext& )
+    {
+    }
+
+    // Frenzy whenever its cooldown allows, and a new hazard sweeping the field every 1.5 s
+    void Storm( ScenarioContext& context )
+    {
+        Play( context );
+        if ( context.frame % 60 == 0 )
+            PressKey( context.game, 'F' );
+        if ( context.frame % 90 == 0 )
+        {
+            std::uniform_real_distribution<float> position( -0.8f, 0.8f );
+            std::uniform_real_distribution<float> velocity( -0.6f, 0.6f );
+            std::uniform_real_distribution<float> radius( 0.05f, 0.2f );
+            const Vector2D pos = { position( context.rng ), position( context.rng ) };
+            const Vector2D vel = { velocity( context.rng ), velocity( context.rng ) };
+            context.game.spawnHazard( pos, vel, radius( context.rng ), 3.0 );
+        }
+    }
+
+    void Endless( ScenarioContext& context )
+    {
+        if ( context.frame == 0 )
+            PressKey( context.game, 'E' );
+        Play( context );
+    }
+
+    bool Never( const Game::WorldSnapshot& )
+    {
+        return false;
+    }
+
+    bool PastStage30( const Game::WorldSnapshot& snapshot )
+    {
+        return snapshot.state.stage > 30 || snapshot.state.gameState == GameState::GameOver;
+    }
+
+    const Scenario Scenarios[] = {
+        { "stage1_idle", "", 1, 60 * 60, 1, Idle, Never },
+        { "stage10_max_ants", "initialAnts = 65536\n", 10, 60 * 60, 2, Play, Never },
+        { "frenzy_hazard_storm", "initialAnts = 16384\n", 5, 60 * 60, 3, Storm, Never },
+        // Stages last 60 s and up; the bound only stops a run that no longer advances
+        { "endless_30_stages", "initialAnts = 4096\n", 1, 60 * 60 * 60 * 3, 4, Endless, PastStage30 },
+        { "cpu_1m_ants", "initialAnts = 1000000\n", 1, 60 * 10, 5, Play, Never },
+        // Rocks across the way to every node, so the colony walks the flow fields
+        { "rocks_detour", "initialAnts = 16384\nrocks = 9\n", 3, 60 * 60, 6, Play, Never },
+    };
+
+    const Scenario& Find( const std::string& name )
+    {
+        for ( const Scenario& scenario : Scenarios )
+        {
+            if ( name == scenario.name )
+                return scenario;
+        }
+        throw std::runtime_error( "Unknown scenario: " + name );
+    }
+
+    uint64_t PeakRssBytes()
+    {
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+            return 0;
+        return counters.PeakWorkingSetSize;
+    }
+
+    // The compute pass on the CPU: the same ping-pong pair and running hit totals the renderer keeps
+    class CpuColony
+    {
+      public:
+        void Apply( const Game::InstanceUploads& uploads )
+        {
+            // Both halves of the pair take every write, like the GPU storage the renderer recreates or fills
+            if ( uploads.recreate || uploads.full )
+            {
+                current_ = uploads.instances;
+                next_    = uploads.instances;
+            }
+            for ( const auto& [slot, data] : uploads.slots )
+            {
+                current_[slot] = data;
+                next_[slot]    = data;
+            }
+        }
+
+        // Kept as the renderer keeps its flow and distance field buffers: replaced whole when the step changed them
+        void Apply( const Game::FlowFieldUploads& flow )
+        {
+            if ( !flow.changed )
+                return;
+            flowGridSize_ = flow.gridSize;
+            flowDirections_.assign( flow.directions.begin(), flow.directions.end() );
+            flowFoodSlots_.assign( flow.foodSlots.begin(), flow.foodSlots.end() );
+        }
+
+        void Apply( const Game::DistanceFieldUploads& distance )
+        {
+            if ( !distance.changed )
+                return;
+            distanceGridSize_ = distance.gridSize;
+            rockDistances_.assign( distance.distances.begin(), distance.distances.end() );
+        }
+
+        int Step( const Game::WorldSnapshot& snapshot, Game::FrameInput& input )
+        {
+            const int antCount = min( min( snapshot.state.activeAnts, snapshot.instanceCount ),
+                                      static_cast<int>( current_.size() ) );
+            SimulationConstants constants =
+                Game::simulationConstants( snapshot.state, static_cast<float>( ScenarioRunner::TimeStep ) );
+            constants.flowGridSize     = flowGridSize_;
+            constants.distanceGridSize = distanceGridSize_;
+            FlowFieldView flow;
+            flow.gridSize      = flowGridSize_;
+            flow.directions    = flowDirections_.data();
+            flow.foodSlots     = flowFoodSlots_.data();
+            flow.foodSlotCount = flowFoodSlots_.size();
+            const DistanceFieldView distance{ distanceGridSize_, rockDistances_.data() };
+
+            foodHits_.fill( 0 );
+            nestHits_.fill( 0 );
+            AntStepKernel::Run( current_.data(), next_.data(), static_cast<size_t>( antCount ), constants,
+                                foodHits_.data(), nestHits_.data(), flow, distance );
+            current_.swap( next_ );
+
+            for ( size_t i = 0; i < foodHits_.size(); i++ )
+            {
+                input.foodHits[i] += foodHits_[i];
+                input.nestHits += nestHits_[i];
+            }
+            return antCount;
+        }
+
+        const std::vector<InstanceData>& Ants() const
+        {
+            return current_;
+        }
+
+      private:
+        std::vector<InstanceData> current_;
+        std::vector<InstanceData> next_;
+        int flowGridSize_ = 0;
+        std::vector<uint32_t> flowDirections_;
+        std::vector<int32_t> flowFoodSlots_;
+        int distanceGridSize_ = 0;
+        std::vector<float> rockDistances_;
+        std::array<uint32_t, Game::MaxFoodNodes> foodHits_{};
+        std::array<uint32_t, Game::MaxFoodNodes> nestHits_{};
+    };
+
+    ViewTransform DefaultView()
+    {
+        ViewTransform view;
+        view.width  = ScenarioRunner::ViewWidth;
+        view.height = ScenarioRunner::ViewHeight;
+        return view;
+    }
+
+    // Publishes each frame for spectators; the colony comes from the CPU compute pass, the rest from the snapshot
+    class SpectatorFeed
+    {
+      public:
+        explicit SpectatorFeed( const uint16_t port ) : publisher_( port )
+        {
+        }
+
+        void Publish( const Game::WorldSnapshot& snapshot, const std::vector<InstanceData>& ants )
+        {
+            static Metric& bytes     = Metrics::Counter( "spectator.bytes" );
+            static Metric& keyframes = Metrics::Counter( "spectator.keyframes" );
+            static Metric& encodeUs  = Metrics::Gauge( "spectator.encodeUs" );
+            static Metric& watching  = Metrics::Gauge( "spectator.watching" );
+
+            const Game::GameWorldState& state = snapshot.state;
+            SpectatorScore score;
+            score.stage         = state.stage;
+            score.score         = state.score;
+            score.stageScore    = state.stageScore;
+            score.stageTarget   = state.stageTarget;
+            score.gameState     = static_cast<int32_t>( state.gameState );
+            score.stageTimeLeft = static_cast<float>( state.stageTimeLeft );
+            food_.resize( state.foodNodes.size() );
+            for ( size_t i = 0; i < food_.size(); i++ )
+            {
+                const FoodNode& node = state.foodNodes[i];
+                uint8_t flags        = 0;
+                if ( node.isActive )
+                    flags |= SpectatorFood::ActiveFood;
+                if ( node.isBonus )
+                    flags |= SpectatorFood::BonusFood;
+                if ( static_cast<int>( i ) == state.activeFoodIndex )
+                    flags |= SpectatorFood::SelectedFood;
+                food_[i] = { node.pos.x, node.pos.y, node.amount, flags };
+            }
+            const int active  = max( 0, min( state.activeAnts, snapshot.instanceCount ) );
+            const auto colony = std::span( ants ).first( min( static_cast<size_t>( active ), ants.size() ) );
+
+            const auto start    = std::chrono::steady_clock::now();
+            const bool keyframe = encoder_.Encode( snapshot.sequence, score, food_, colony, frame_ );
+            const auto elapsed  = std::chrono::steady_clock::now() - start;
+            encodeUs.Set( std::chrono::duration_cast<std::chrono::microseconds>( elapsed ).count() );
+            publisher_.Publish( frame_, keyframe );
+            bytes.Add( static_cast<int64_t>( frame_.size() ) );
+            keyframes.Add( keyframe ? 1 : 0 );
+            watching.Set( static_cast<int64_t>( publisher_.Spectators() ) );
+        }
+
+      private:
+        SpectatorPublisher publisher_;
+        SpectatorEncoder encoder_;
+        std::vector<SpectatorFood> food_;
+        std::vector<uint8_t> frame_;
+    };
+
+    // One game without a window: the renderer only stands in for its view and assets, the CPU colony for the compute
+    // pass. Frames are timed and allocations counted from the end of setup to Finish(); a start state is part of the
+    // setup.
+    class HeadlessRun
+    {
+      public:
+        HeadlessRun( std::string name, const uint32_t seed, const std::string& settings, const int stage,
+                     const ViewTransform& view, const ScenarioOptions& options )
+            : game( renderer )
+        {
+            renderer.InitHeadless( view );
+            game.initialize();
+            std::istringstream in( settings );
+            game.restartScenario( in, stage );
+            if ( !options.startState.empty() )
+                game.restoreState( options.startState );
+            if ( options.spectatePort != 0 )
+                spectators_.emplace( options.spectatePort );
+            if ( !options.trajectory.empty() )
+                trajectory_.emplace( options.trajectory, options.trajectoryInterval );
+
+            input.view   = view;
+            result_.name = std::move( name );
+            result_.seed = seed;
+            from_        = AllocationTracker::Total();
+            begin_       = std::chrono::steady_clock::now();
+        }
+
+        ~HeadlessRun()
+        {
+            renderer.SetGame( nullptr );
+        }
+
+        // Sends input, applies the snapshot's uploads and steps the colony; its hits are added to hits
+        const Game::WorldSnapshot& Frame( Game::FrameInput& hits )
+        {
+            const auto frameStart = std::chrono::steady_clock::now();
+
+            const Game::WorldSnapshot& snapshot = game.beginFrame( input );
+            if ( snapshot.sequence != appliedSequence_ )
+            {
+                colony_.Apply( snapshot.uploads );
+                colony_.Apply( snapshot.flow );
+                colony_.Apply( snapshot.distance );
+                appliedSequence_ = snapshot.sequence;
+                result_.stepTimes.Record( snapshot.stepMs );
+            }
+            // The colony steps once per frame, so frames are the trajectory's ticks
+            const int stepped = colony_.Step( snapshot, hits );
+            result_.antSteps += static_cast<uint64_t>( stepped );
+            if ( trajectory_ )
+                trajectory_->Sample( static_cast<uint64_t>( result_.frames ),
+                                     std::span( colony_.Ants() ).first( static_cast<size_t>( stepped ) ) );
+            result_.frameTimes.Record(
+                std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - frameStart ).count() );
+            result_.frames++;
+            result_.finalStage = snapshot.state.stage;
+            result_.score      = snapshot.state.score;
+            if ( spectators_ )
+                spectators_->Publish( snapshot, colony_.Ants() );
+            return snapshot;
+        }
+
+        // The colony as the CPU compute pass left it, not as the game last wrote it
+        void SaveState( const std::filesystem::path& path )
+        {
+            game.saveState( path, colony_.Ants() );
+        }
+
+        ScenarioResult Finish()
+        {
+            result_.wallMs =
+                std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - begin_ ).count();
+            const AllocationCounts to = AllocationTracker::Total();
+            result_.allocations       = to.allocations - from_.allocations;
+            result_.allocatedBytes    = to.bytes - from_.bytes;
+            result_.peakRssBytes      = PeakRssBytes();
+            if ( trajectory_ )
+                trajectory_->Close();
+            return std::move( result_ );
+        }
+
+        InstancedRendererEngine2D renderer;
+        Game::AntGame game;
+        Game::FrameInput input;
+
+      private:
+        CpuColony colony_;
+        std::optional<SpectatorFeed> spectators_;
+        std::optional<TrajectoryRecorder> trajectory_;
+        uint64_t appliedSequence_ = 0;
+        ScenarioResult result_;
+        AllocationCounts from_{};
+        std::chrono::steady_clock::time_point begin_;
+    };
+
+    void WriteTimes( std::ostream& out, const char* name, const FrameHistogram& histogram )
+    {
+        out << "      \"" << name << "\": { \"mean\": " << histogram.Mean()
+            << ", \"p50\": " << histogram.Percentile( 50.0 ) << ", \"p95\": " << histogram.Percentile( 95.0 )
+            << ", \"p99\": " << histogram.Percentile( 99.0 ) << ", \"p99.9\": " << histogram.Percentile( 99.9 )
+            << ", \"max\": " << histogram.Max() << " },\n";
+    }
+} // namespace
+
+std::vector<std::string> ScenarioRunner::Names()
+{
+    std::vector<std::string> names;
+    for ( const Scenario& scenario : Scenarios )
+        names.emplace_back( scenario.name );
+    return names;
+}
+
+ScenarioResult ScenarioRunner::Run( const std::string& name, const ScenarioOptions& options )
+{
+    const Scenario& scenario = Find( name );
+    HeadlessRun run( scenario.name, scenario.seed, scenario.settings, scenario.stage, DefaultView(), options );
+    std::mt19937 rng( scenario.seed );
+
+    for ( int frame = 0; frame < scenario.frames; frame++ )
+    {
+        run.input.time                      = frame * TimeStep;
+        const Game::WorldSnapshot& snapshot = run.Frame( run.input );
+        if ( scenario.done( snapshot ) )
+            break;
+
+        // Input for the next frame, outside the timing like the player's think time
+        ScenarioContext context{ run.game, snapshot, run.input.view, rng, frame };
+        scenario.script( context );
+    }
+    ScenarioResult result = run.Finish();
+    if ( !options.endState.empty() )
+        run.SaveState( options.endState );
+    return result;
+}
+
+ScenarioResult ScenarioRunner::Replay( const std::filesystem::path& path, const ScenarioOptions& options )
+{
+    const Game::InputReplay replay( path );
+    const auto& records = replay.records();
+    const auto firstView =
+        std::find_if( records.begin(), records.end(),
+                      []( const Game::InputRecord& record ) { return record.kind == Game::InputRecordKind::View; } );
+    // A replay starts where its recording started, so of the options only the spectators and trajectory apply
+    ScenarioOptions watch;
+    watch.spectatePort       = options.spectatePort;
+    watch.trajectory         = options.trajectory;
+    watch.trajectoryInterval = options.trajectoryInterval;
+    HeadlessRun run( "replay " + path.filename().string(), 0, replay.settings(), 1,
+                     firstView != records.end() ? firstView->view : DefaultView(), watch );
+
+    // Hits come from the recording, so the game takes the same path it took live; the CPU colony still runs for the
+    // cost, with its hits thrown away. The first Step record is the step initialize() ran, which the first Frame()
+    // hands out.
+    Game::FrameInput cpuHits;
+    for ( const Game::InputRecord& record : records )
+    {
+        switch ( record.kind )
+        {
+        case Game::InputRecordKind::Step:
+            run.input.time += record.deltaTime;
+            for ( const auto& [node, hits] : record.foodHits )
+                run.input.foodHits[node] += hits;
+            run.input.nestHits += record.nestHits;
+            run.Frame( cpuHits );
+            break;
+        case Game::InputRecordKind::View:
+            run.input.view = record.view;
+            run.renderer.SetHeadlessView( record.view );
+            break;
+        case Game::InputRecordKind::Key:
+            PressKey( run.game, record.value );
+            break;
+        case Game::InputRecordKind::Click:
+            Click( run.game, record.x, record.y );
+            break;
+        case Game::InputRecordKind::Upgrade:
+            run.game.applyUpgrade( static_cast<int>( record.value ) );
+            break;
+        case Game::InputRecordKind::DebugHud:
+            run.game.setDebugHudVisible( record.value != 0 );
+            break;
+        case Game::InputRecordKind::Settings:
+        {
+            std::istringstream settings( record.settings );
+            run.game.reloadSettings( settings );
+            break;
+        }
+        }
+    }
+    return run.Finish();
+}
+
+bool ScenarioRunner::WriteReport( const std::filesystem::path& path, const std::vector<ScenarioResult>& results )
+{
+    std::ofstream out( path, std::ios::trunc );
+    if ( !out )
+        return false;
+
+    out << "{\n  \"timeStep\": " << TimeStep << ",\n  \"scenarios\": [\n";
+    for ( size_t i = 0; i < results.size(); i++ )
+    {
+        const ScenarioResult& r = results[i];
+        const double seconds    = r.wallMs / 1000.0;
+        out << "    {\n      \"name\": \"" << r.name << "\",\n      \"seed\": " << r.seed
+            << ",\n      \"frames\": " << r.frames << ",\n      \"wallMs\": " << r.wallMs << ",\n";
+        WriteTimes( out, "frameMs", r.frameTimes );
+        WriteTimes( out, "stepMs", r.stepTimes );
+        out << "      \"framesPerSecond\": " << ( seconds > 0.0 ? r.frames / seconds : 0.0 )
+            << ",\n      \"antStepsPerSecond\": " << ( seconds > 0.0 ? r.antSteps / seconds : 0.0 )
+            << ",\n      \"peakRssBytes\": " << r.peakRssBytes << ",\n      \"allocations\": " << r.allocations
+            << ",\n      \"allocatedBytes\": " << r.allocatedBytes << ",\n      \"finalStage\": " << r.finalStage
+            << ",\n      \"score\": " << r.score << "\n    }" << ( i + 1 < results.size() ? "," : "" ) << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>( out );
+}
+
+int ScenarioRunner::RunFromCommandLine()
+{
+    int argc     = 0;
+    LPWSTR* argv = CommandLineToArgvW( GetCommandLineW(), &argc );
+    std::string selected;
+    std::vector<std::filesystem::path> replays;
+    std::filesystem::path report = ReportFile;
+    ScenarioOptions options;
+    for ( int i = 1; argv && i + 1 < argc; i++ )
+    {
+        if ( wcscmp( argv[i], L"--scenario" ) == 0 )
+            selected = std::filesystem::path( argv[i + 1] ).string();
+        else if ( wcscmp( argv[i], L"--replay" ) == 0 )
+            replays.emplace_back( argv[i + 1] );
+        else if ( wcscmp( argv[i], L"--scenario-report" ) == 0 )
+            report = argv[i + 1];
+        else if ( wcscmp( argv[i], L"--load-state" ) == 0 )
+            options.startState = argv[i + 1];
+        else if ( wcscmp( argv[i], L"--save-state" ) == 0 )
+            options.endState = argv[i + 1];
+        else if ( wcscmp( argv[i], L"--spectate" ) == 0 )
+            options.spectatePort = static_cast<uint16_t>( std::wcstol( argv[i + 1], nullptr, 10 ) );
+        else if ( wcscmp( argv[i], L"--trajectory" ) == 0 )
+            options.trajectory = argv[i + 1];
+        else if ( wcscmp( argv[i], L"--trajectory-every" ) == 0 )
+            options.trajectoryInterval = static_cast<uint32_t>( std::wcstoul( argv[i + 1], nullptr, 10 ) );
+    }
+    LocalFree( argv );
+
+    try
+    {
+        std::vector<ScenarioResult> results;
+        for ( const std::string& name : Names() )
+        {
+            if ( selected == "all" || selected == name )
+                results.push_back( Run( name, options ) );
+        }
+        if ( !selected.empty() && results.empty() )
+            throw std::runtime_error( "Unknown scenario: " + selected );
+        for ( const std::filesystem::path& replay : replays )
+            results.push_back( Replay( replay, options ) );
+
+        if ( !WriteReport( report, results ) )
+        {
+            OutputDebugStringA( "Could not write the scenario report\n" );
+            return 1;
+        }
+    }
+    catch ( const std::exception& ex )
+    {
+        OutputDebugStringA( ex.what() );
+        OutputDebugStringA( "\n" );
+        return 1;
+    }
+    return 0;
+}
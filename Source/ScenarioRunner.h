@@ -0,0 +1,86 @@
+#pragma once
+
+#include "FrameHistogram.h"
+#include "TrajectoryRecorder.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Command-line extras that apply to every run in the process
+struct ScenarioOptions
+{
+    std::filesystem::path startState; // --load-state, empty for none
+    std::filesystem::path endState;   // --save-state, empty for none
+    uint16_t spectatePort = 0;        // --spectate, 0 for no spectators
+    std::filesystem::path trajectory; // --trajectory, empty for none
+    uint32_t trajectoryInterval = TrajectoryRecorder::DefaultInterval; // --trajectory-every, ticks between samples
+};
+
+// What one scenario measured; one object in the JSON report
+struct ScenarioResult
+{
+    std::string name;
+    uint32_t seed = 0;
+    int frames    = 0;
+    double wallMs = 0.0;
+    FrameHistogram frameTimes; // game step, instance uploads and the CPU ant step
+    FrameHistogram stepTimes;  // game step only
+    uint64_t antSteps       = 0; // ants stepped, summed over all frames
+    uint64_t allocations    = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t peakRssBytes   = 0; // process peak working set when the scenario ended
+    int finalStage          = 0;
+    int score               = 0;
+};
+
+// Scripted end-to-end runs of AntGame with no window or device, for comparing builds on one machine. The game steps
+// inline at a fixed timestep; input goes through handleEvent as a player's would. The compute pass is replaced by
+// AntStepKernel, whose hit counts go back to the game as the readback's would. Every random choice (which node gets
+// clicked, where a hazard appears) comes from the scenario's fixed seed, so two builds run the same frames.
+//
+//   RenderEngine --scenario <name|all> [--load-state <file>] [--save-state <file>] [--spectate <port>]
+//                [--trajectory <file> [--trajectory-every <ticks>]] [--scenario-report <file>]
+//   RenderEngine --replay <session.input> [--replay <another>] [--spectate <port>] [--trajectory <file>]
+//                [--scenario-report <file>]
+//
+// A replay feeds a recording made with --record back as fast as it steps, with the recorded time deltas, view
+// changes and GPU hit counts, so the game takes the path it took live and the final stage and score match the
+// session; only the ants themselves are stepped again, on the CPU.
+//
+// --save-state writes the game as the scenario left it (with "all", the last one) and --load-state starts the
+// scenario from such a file instead of its own stage, after the scenario's settings; so a run can start warm, mid-stage
+// with its colony spread out, rather than from ants leaving the nest.
+//
+// --spectate publishes every frame on 127.0.0.1:<port> (SpectatorEncoder over SpectatorPublisher) for the spectator
+// tool to watch from another process. Encoding and sending are outside frameMs; the spectator.* metrics count them.
+//
+// --trajectory samples the colony every --trajectory-every ticks (default 6, 10 Hz) into a TrajectoryRecorder file
+// (with "all", the last scenario's). The copy the sim thread makes is inside frameMs, so the report shows what
+// recording costs; coding and writing happen on the recorder's thread.
+//
+// Peak RSS is the process peak, so with "all" each scenario also reports the ones before it; run one scenario per
+// process when comparing memory.
+class ScenarioRunner
+{
+  public:
+    static constexpr double TimeStep        = 1.0 / 60.0;
+    static constexpr int ViewWidth          = 1280;
+    static constexpr int ViewHeight         = 720;
+    static constexpr const char* ReportFile = "scenario_report.json";
+
+    // Runs what the command line asks for and writes the report; returns the process exit code
+    static int RunFromCommandLine();
+
+    static std::vector<std::string> Names();
+
+    // Throws std::runtime_error for an unknown name, a state or trajectory file that cannot be read or written, or a
+    // spectator port that cannot be opened
+    static ScenarioResult Run( const std::string& name, const ScenarioOptions& options = {} );
+    // Only the spectator and trajectory options apply. Throws std::runtime_error when the recording cannot be read,
+    // the spectator port cannot be opened or the trajectory cannot be written.
+    static ScenarioResult Replay( const std::filesystem::path& path, const ScenarioOptions& options = {} );
+
+    static bool WriteReport( const std::filesystem::path& path, const std::vector<ScenarioResult>& results );
+};
@@ -0,0 +1,86 @@
+#include "ShaderConstants.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr size_t Scalar = 4;
+    constexpr size_t Pair   = 8;
+
+    constexpr ConstantMember FrameMembers[] = {
+        { "aspectRatio", offsetof( FrameConstants, aspectRatio ), Scalar },
+        { "time", offsetof( FrameConstants, time ), Scalar },
+        { "frameDeltaTime", offsetof( FrameConstants, frameDeltaTime ), Scalar },
+        { "cameraZoom", offsetof( FrameConstants, cameraZoom ), Scalar },
+        { "cameraPos", offsetof( FrameConstants, cameraPosX ), Pair },
+        { "screenSize", offsetof( FrameConstants, screenWidth ), Pair },
+    };
+
+    constexpr ConstantMember SimulationMembers[] = {
+        { "targetPos", offsetof( SimulationConstants, targetPosX ), Pair },
+        { "nestPos", offsetof( SimulationConstants, nestPosX ), Pair },
+        { "speed", offsetof( SimulationConstants, speed ), Scalar },
+        { "deltaTime", offsetof( SimulationConstants, deltaTime ), Scalar },
+        { "activeFoodIndex", offsetof( SimulationConstants, activeFoodIndex ), Scalar },
+        { "hazardActive", offsetof( SimulationConstants, hazardActive ), Scalar },
+        { "hazardPos", offsetof( SimulationConstants, hazardPosX ), Pair },
+        { "hazardRadius", offsetof( SimulationConstants, hazardRadius ), Scalar },
+        { "flowGridSize", offsetof( SimulationConstants, flowGridSize ), Scalar },
+        { "distanceGridSize", offsetof( SimulationConstants, distanceGridSize ), Scalar },
+    };
+
+    constexpr ConstantMember DrawMembers[] = {
+        { "size", offsetof( DrawConstants, sizeX ), Pair },
+        { "objectPos", offsetof( DrawConstants, objectPosX ), Pair },
+        { "indexes", offsetof( DrawConstants, indexesX ), Pair },
+        { "grid", offsetof( DrawConstants, gridX ), Pair },
+        { "waveSpeed", offsetof( DrawConstants, waveSpeed ), Scalar },
+    };
+
+    constexpr ConstantMember DensityMembers[] = {
+        { "gridSize", offsetof( DensityConstants, gridX ), Pair },
+        { "cellPixels", offsetof( DensityConstants, cellPixels ), Scalar },
+        { "instanceCount", offsetof( DensityConstants, instanceCount ), Scalar },
+        { "lodStart", offsetof( DensityConstants, lodStart ), Scalar },
+        { "lodEnd", offsetof( DensityConstants, lodEnd ), Scalar },
+        { "lodMode", offsetof( DensityConstants, lodMode ), Scalar },
+    };
+
+    const ConstantLayout Layouts[] = {
+        { "FrameConstants", FrameConstantSlot, sizeof( FrameConstants ), FrameMembers },
+        { "SimulationConstants", SimulationConstantSlot, sizeof( SimulationConstants ), SimulationMembers },
+        { "DrawConstants", DrawConstantSlot, sizeof( DrawConstants ), DrawMembers },
+        { "DensityConstants", DensityConstantSlot, sizeof( DensityConstants ), DensityMembers },
+    };
+} // namespace
+
+const ConstantLayout* FindConstantLayout( const std::string_view cbufferName )
+{
+    for ( const ConstantLayout& layout : Layouts )
+        if ( cbufferName == layout.name )
+            return &layout;
+    return nullptr;
+}
+
+std::string CheckConstantLayout( const ConstantLayout& layout, const unsigned int slot,
+                                 const std::span<const ShaderConstantVariable> variables )
+{
+    const std::string block = layout.name;
+    if ( slot != layout.slot )
+        return block + " is bound at b" + std::to_string( slot ) + ", the renderer binds it at b" +
+               std::to_string( layout.slot );
+
+    for ( const ShaderConstantVariable& variable : variables )
+    {
+        const auto member = std::find_if( layout.members.begin(), layout.members.end(),
+                                          [&variable]( const ConstantMember& m ) { return variable.name == m.name; } );
+        if ( member == layout.members.end() )
+            return block + "." + variable.name + " has no member in the C++ struct";
+        if ( variable.offset != member->offset || variable.size != member->size )
+            return block + "." + variable.name + " is bytes " + std::to_string( variable.offset ) + ".." +
+                   std::to_string( variable.offset + variable.size ) + " in the shader, " +
+                   std::to_string( member->offset ) + ".." + std::to_string( member->offset + member->size ) +
+                   " in the C++ struct";
+    }
+    return {};
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Constant blocks split by update frequency. Every shader that reads a block declares it at the same register, the
+// renderer binds all four once per frame and only re-uploads a block when its contents change (see ConstantBlock).
+//
+//   b0  FrameConstants       per frame   camera, zoom, time, screen size
+//   b1  SimulationConstants  per pass    flock step targets, hazard, flow field and distance field grids
+//   b2  DrawConstants        per draw    object transform for non-instanced draws
+//   b3  DensityConstants     per pass    density splat LOD
+//
+// The HLSL declarations pin every member with packoffset and fxc rejects offsets that break its packing rules. Each
+// block's ConstantLayout below lists the shader variables with the bytes the C++ struct gives them (offsetof, so it
+// follows the structs). Utilities reflects every shader it creates and throws when a block's register or a variable's
+// bytes disagree with it; render_tests checks the packoffset declarations in Source/Shaders the same way.
+
+constexpr unsigned int FrameConstantSlot      = 0;
+constexpr unsigned int SimulationConstantSlot = 1;
+constexpr unsigned int DrawConstantSlot       = 2;
+constexpr unsigned int DensityConstantSlot    = 3;
+constexpr unsigned int ConstantSlotCount      = 4;
+
+struct FrameConstants
+{
+    float aspectRatio;
+    float time;
+    float frameDeltaTime;
+    float cameraZoom;
+
+    float cameraPosX;
+    float cameraPosY;
+    float screenWidth;
+    float screenHeight;
+};
+
+static_assert( sizeof( FrameConstants ) == 32 );
+
+struct SimulationConstants
+{
+    float targetPosX; // active food
+    float targetPosY;
+    float nestPosX;
+    float nestPosY;
+
+    float speed;
+    float deltaTime; // simulation step, 0 while the stage is not being played
+    int activeFoodIndex;
+    int hazardActive;
+
+    float hazardPosX;
+    float hazardPosY;
+    float hazardRadius;
+    int flowGridSize; // flow field cells per side, 0 without obstacles (see FlowField.h)
+
+    int distanceGridSize; // rock distance field cells per side, 0 without rocks (see DistanceField.h)
+    float padding[3];
+};
+
+static_assert( sizeof( SimulationConstants ) == 64 );
+
+struct DrawConstants
+{
+    float sizeX;
+    float sizeY;
+    float objectPosX;
+    float objectPosY;
+
+    int indexesX; // color code
+    int indexesY; // outline lightening
+    int gridX;
+    int gridY;
+
+    float waveSpeed;
+    float padding[3];
+};
+
+static_assert( sizeof( DrawConstants ) == 48 );
+
+struct DensityConstants
+{
+    int gridX;         // density grid cells across
+    int gridY;         // density grid cells down
+    int cellPixels;    // cell edge in screen pixels
+    int instanceCount; // ants binned this frame
+
+    float lodStart; // ants per pixel where the splat starts to fade in
+    float lodEnd;   // ants per pixel where per-ant quads are fully replaced
+    int lodMode;    // LodMode as int
+    float padding;
+};
+
+static_assert( sizeof( DensityConstants ) == 32 );
+
+// A shader variable of a block and the bytes of the C++ struct it reads. HLSL vectors span consecutive members
+// (float2 cameraPos is cameraPosX, cameraPosY).
+struct ConstantMember
+{
+    const char* name;
+    size_t offset;
+    size_t size;
+};
+
+struct ConstantLayout
+{
+    const char* name; // the cbuffer name in HLSL
+    unsigned int slot;
+    size_t size;
+    std::span<const ConstantMember> members;
+};
+
+// The layout of the shared block a shader declares under that name, nullptr for a shader's own cbuffer
+const ConstantLayout* FindConstantLayout( std::string_view cbufferName );
+
+// A variable as the shader declares it, from reflection or the packoffset declaration
+struct ShaderConstantVariable
+{
+    std::string name;
+    size_t offset;
+    size_t size;
+};
+
+// Empty when the shader's declaration of the block matches the C++ layout: bound at the block's slot, and every
+// variable it declares (it may leave some out) at the bytes of its C++ members. Otherwise what differs.
+std::string CheckConstantLayout( const ConstantLayout& layout, unsigned int slot,
+                                 std::span<const ShaderConstantVariable> variables );
@@ -1,33 +1,22 @@
-cbuffer VertexInputData : register(b0)
+// Per frame, mirrors FrameConstants in ShaderConstants.h
+cbuffer FrameConstants : register(b0)
 {
-    float2 size;          // sizeX, sizeY
-    float2 objectPos;     // objectPosX, objectPosY (world)
-    float aspectRatio;
-    float time;
-    int2 indexes;         // indexesX used as color code
-    float speed;
-    int2 grid;
-    float padding1;
-    float2 targetPos;
-    float orbitDistance;
-    float jitter;
-    float2 previousTargetPos;
-    float flockTransitionTime;
-    float deltaTime;
-    int activeFoodIndex;
-    float cameraPosX;
-    float cameraPosY;
-    float cameraZoom;
-    float hazardPosX;
-    float hazardPosY;
-    float hazardRadius;
-    int hazardActive;
+    float aspectRatio    : packoffset(c0.x);
+    float time           : packoffset(c0.y);
+    float frameDeltaTime : packoffset(c0.z);
+    float cameraZoom     : packoffset(c0.w);
+    float2 cameraPos     : packoffset(c1.x);
+    float2 screenSize    : packoffset(c1.z);
 }
 
 struct VS_INPUT
 {
     float3 pos : POSITION;
     float2 uv  : TEXCOORD0;
+    // Per-instance marker data (MarkerInstance, vertex slot 1)
+    float2 instancePos  : INSTANCEPOS;  // world top-left
+    float2 instanceSize : INSTANCESIZE; // scale relative to the base mesh
+    int2 instanceCode   : INSTANCECODE; // x = color code, y = outline lightening
 };
 
 struct VS_OUTPUT
@@ -44,50 +33,55 @@ VS_OUTPUT main(VS_INPUT input)
     p.x /= aspectRatio;
 
     // Scale relative to the base quad size (SquareMesh uses ~0.05 unit size)
-    p.x *= size.x;
-    p.y *= size.y;
+    p.x *= input.instanceSize.x;
+    p.y *= input.instanceSize.y;
 
     // Offset to camera-relative position
-    float2 cameraOffset = float2(cameraPosX, cameraPosY);
-    p += objectPos - cameraOffset;
+    p += input.instancePos - cameraPos;
+    p *= cameraZoom;
 
     output.position = float4(p, 0.0f, 1.0f);
 
-    // Choose color by indexes.x code
-    if (indexes.x == 1)
+    // Choose color by instance color code
+    int2 code = input.instanceCode;
+    if (code.x == 1)
     {
         output.color = float4(0.2f, 0.9f, 0.2f, 1.0f); // food - green
     }
-    else if (indexes.x == 2)
+    else if (code.x == 2)
     {
         output.color = float4(0.95f, 0.2f, 0.2f, 1.0f); // nest - red
     }
-    else if (indexes.x == 3)
+    else if (code.x == 3)
     {
         output.color = float4(1.0f, 0.9f, 0.2f, 1.0f); // active food - yellow
     }
-    else if (indexes.x == 4)
+    else if (code.x == 4)
     {
         output.color = float4(0.75f, 0.4f, 0.95f, 0.85f); // hazard - purple
     }
-    else if (indexes.x == 5)
+    else if (code.x == 5)
     {
         output.color = float4(0.08f, 0.10f, 0.12f, 0.6f); // UI panel - translucent dark
     }
-    else if (indexes.x == 6)
+    else if (code.x == 6)
     {
         output.color = float4(1.0f, 0.8f, 0.2f, 1.0f); // bonus sugar - gold
     }
+    else if (code.x == 7)
+    {
+        output.color = float4(0.36f, 0.32f, 0.28f, 1.0f); // rock - grey-brown
+    }
     else
     {
         output.color = float4(1.0f, 1.0f, 1.0f, 1.0f); // default white
     }
 
-    // Lighten effect for outlines: indexes.y = 1..3 increases lightening
-    if (indexes.y > 0)
+    // Lighten effect for outlines: code.y = 1..3 increases lightening
+    if (code.y > 0)
     {
-        float t = saturate(0.15f * indexes.y);
-        float a = output.color.a * (0.7f + 0.1f * indexes.y);
+        float t = saturate(0.15f * code.y);
+        float a = output.color.a * (0.7f + 0.1f * code.y);
         output.color.rgb = lerp(output.color.rgb, float3(1.0f, 1.0f, 1.0f), t);
         output.color.a = a;
     }
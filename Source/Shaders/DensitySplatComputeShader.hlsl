@@ -0,0 +1,58 @@
+// Per frame, mirrors FrameConstants in ShaderConstants.h
+cbuffer FrameConstants : register(b0)
+{
+    float aspectRatio    : packoffset(c0.x);
+    float time           : packoffset(c0.y);
+    float frameDeltaTime : packoffset(c0.z);
+    float cameraZoom     : packoffset(c0.w);
+    float2 cameraPos     : packoffset(c1.x);
+    float2 screenSize    : packoffset(c1.z);
+}
+
+// Density splat LOD, mirrors DensityConstants in ShaderConstants.h
+cbuffer DensityConstants : register(b3)
+{
+    int2 gridSize     : packoffset(c0.x);
+    int cellPixels    : packoffset(c0.z);
+    int instanceCount : packoffset(c0.w);
+    float lodStart    : packoffset(c1.x);
+    float lodEnd      : packoffset(c1.y);
+    int lodMode       : packoffset(c1.z); // 0 = auto, 1 = ants only, 2 = splat only
+}
+
+struct InstanceData
+{
+    float x;
+    float y;
+    float directionX;
+    float directionY;
+    float goalX;
+    float goalY;
+    float laneOffset;
+    float speedScale;
+    float holdTimer;
+    float4 color;
+    int movementState;
+    int sourceIndex;
+};
+
+StructuredBuffer<InstanceData> CurrPos : register(t0);
+RWTexture2D<uint> DensityGrid : register(u0);
+
+// Bins every visible ant into a coarse screen-space grid for the density splat LOD
+
+[numthreads(256, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    uint id = threadId.x;
+    if (id >= (uint)instanceCount)
+        return;
+
+    float2 view = (float2(CurrPos[id].x, CurrPos[id].y) - cameraPos) * cameraZoom;
+    if (abs(view.x) >= 1.0f || abs(view.y) >= 1.0f)
+        return;
+
+    float2 pixel = float2((view.x + 1.0f) * 0.5f * screenSize.x, (1.0f - view.y) * 0.5f * screenSize.y);
+    int2 cell = min(int2(pixel) / cellPixels, gridSize - 1);
+    InterlockedAdd(DensityGrid[cell], 1);
+}
@@ -0,0 +1,43 @@
+// Density splat LOD, mirrors DensityConstants in ShaderConstants.h
+cbuffer DensityConstants : register(b3)
+{
+    int2 gridSize     : packoffset(c0.x);
+    int cellPixels    : packoffset(c0.z);
+    int instanceCount : packoffset(c0.w);
+    float lodStart    : packoffset(c1.x);
+    float lodEnd      : packoffset(c1.y);
+    int lodMode       : packoffset(c1.z); // 0 = auto, 1 = ants only, 2 = splat only
+}
+
+Texture2D<uint> DensityGrid : register(t0);
+
+struct VS_OUTPUT
+{
+    float4 position : SV_POSITION;
+};
+
+// Must match FlockVertexShader and DensityLod::SplatWeight
+float SplatWeight(uint count)
+{
+    if (lodMode == 1)
+        return 0.0f;
+    float antsPerPixel = count / float(cellPixels * cellPixels);
+    if (lodMode == 2)
+        return antsPerPixel > 0.0f ? 1.0f : 0.0f;
+    return saturate((antsPerPixel - lodStart) / max(lodEnd - lodStart, 1e-5f));
+}
+
+float4 main(VS_OUTPUT input) : SV_TARGET
+{
+    int2 cell = min(int2(input.position.xy) / cellPixels, gridSize - 1);
+    uint count = DensityGrid.Load(int3(cell, 0));
+    float weight = SplatWeight(count);
+    if (weight <= 0.0f)
+        discard;
+
+    // Heat ramp from the ToNest cyan to the ToFood yellow as cells get denser
+    float antsPerPixel = count / float(cellPixels * cellPixels);
+    float heat = saturate(log2(1.0f + antsPerPixel) / 4.0f);
+    float3 color = lerp(float3(0.2f, 0.9f, 0.9f), float3(1.0f, 0.9f, 0.2f), heat);
+    return float4(color, weight);
+}
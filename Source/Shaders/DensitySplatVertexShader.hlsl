@@ -0,0 +1,13 @@
+struct VS_OUTPUT
+{
+    float4 position : SV_POSITION;
+};
+
+// Fullscreen triangle from SV_VertexID, drawn with Draw(3, 0) and no input layout
+VS_OUTPUT main(uint vertexId : SV_VertexID)
+{
+    VS_OUTPUT output;
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    output.position = float4(uv * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+    return output;
+}
@@ -1,27 +1,16 @@
-cbuffer VertexInputData : register(b0)
+// Per simulation pass, mirrors SimulationConstants in ShaderConstants.h
+cbuffer SimulationConstants : register(b1)
 {
-    float2 size;
-    float2 objectPos; // objectPosX and objectPosY from C++ map here
-    float aspectRatio;
-    float time;
-    int2 indexes;
-    float speed;
-    int2 grid;
-    float padding1;
-    float2 targetPos;
-    float orbitDistance;
-    float jitter;
-    float2 previousTargetPos;
-    float flockTransitionTime;
-    float deltaTime;
-    int activeFoodIndex;
-    float cameraPosX;
-    float cameraPosY;
-    float cameraZoom;
-    float hazardPosX;
-    float hazardPosY;
-    float hazardRadius;
-    int hazardActive;
+    float2 targetPos     : packoffset(c0.x); // active food
+    float2 nestPos       : packoffset(c0.z);
+    float speed          : packoffset(c1.x);
+    float deltaTime      : packoffset(c1.y); // simulation step, 0 while paused
+    int activeFoodIndex  : packoffset(c1.z);
+    int hazardActive     : packoffset(c1.w);
+    float2 hazardPos     : packoffset(c2.x);
+    float hazardRadius   : packoffset(c2.z);
+    int flowGridSize     : packoffset(c2.w); // 0 without obstacles
+    int distanceGridSize : packoffset(c3.x); // 0 without rocks
 }
 
 struct InstanceData
@@ -45,8 +34,76 @@ RWStructuredBuffer<InstanceData> CurrPosOut : register(u0);
 RWStructuredBuffer<uint> FoodHitCounts : register(u1);
 RWStructuredBuffer<uint> NestHitCounts : register(u2);
 
+// Flow fields (FlowField.h): per slot, one packed snorm16 direction per cell over the world square [-1, 1]; slot 0
+// leads to the nest, FlowFoodSlots maps a food node index to its slot (-1 for none)
+StructuredBuffer<uint> FlowDirections : register(t1);
+StructuredBuffer<int> FlowFoodSlots : register(t2);
+
+// Rock distance field (DistanceField.h): signed distance to the nearest rock edge per cell over the world square
+StructuredBuffer<float> RockDistances : register(t3);
+
 // States: 0 = ToFood, 1 = ToNest
 
+float2 UnpackDirection(uint packed)
+{
+    int2 s = int2((int)(packed << 16) >> 16, (int)packed >> 16);
+    return float2(s) / 32767.0f;
+}
+
+// Bilinear between cell centres, like AntStepKernel's FlowDirection
+float2 FlowDirection(int slot, float2 pos)
+{
+    float cell = 2.0f / flowGridSize;
+    float2 g = clamp((pos + 1.0f) / cell - 0.5f, 0.0f, flowGridSize - 1.0f);
+    int2 i0 = min((int2)g, flowGridSize - 2);
+    float2 f = g - i0;
+    uint base = (uint)slot * flowGridSize * flowGridSize + i0.y * flowGridSize + i0.x;
+    float2 d00 = UnpackDirection(FlowDirections[base]);
+    float2 d10 = UnpackDirection(FlowDirections[base + 1]);
+    float2 d01 = UnpackDirection(FlowDirections[base + flowGridSize]);
+    float2 d11 = UnpackDirection(FlowDirections[base + flowGridSize + 1]);
+    return lerp(lerp(d00, d10, f.x), lerp(d01, d11, f.x), f.y);
+}
+
+// Down the slot's flow field while there is one and the target is more than two cells away, straight otherwise
+float2 Heading(float2 pos, float2 toTarget, float d, int slot)
+{
+    float2 straight = toTarget / d;
+    if (slot < 0 || flowGridSize == 0 || d <= 2.0f * 2.0f / flowGridSize)
+        return straight;
+    float2 flow = FlowDirection(slot, pos);
+    float len = length(flow);
+    return len > 0.1f ? flow / len : straight;
+}
+
+// Pushes a position closer than the contact distance to a rock back out along the gradient of one bilinear sample,
+// like AntStepKernel's Collide; the push is along the edge normal, so ants slide round rocks
+float2 Collide(float2 pos)
+{
+    const float contactDistance = 0.005f;
+    if (distanceGridSize == 0)
+        return pos;
+    float scale = distanceGridSize / 2.0f; // cells per world unit
+    float2 g = clamp((pos + 1.0f) * scale - 0.5f, 0.0f, distanceGridSize - 1.0f);
+    int2 i0 = min((int2)g, distanceGridSize - 2);
+    float2 f = g - i0;
+    uint base = i0.y * distanceGridSize + i0.x;
+    float d00 = RockDistances[base];
+    float d10 = RockDistances[base + 1];
+    float d01 = RockDistances[base + distanceGridSize];
+    float d11 = RockDistances[base + distanceGridSize + 1];
+    float bottomSlope = d10 - d00;
+    float topSlope = d11 - d01;
+    float bottom = d00 + bottomSlope * f.x;
+    float top = d01 + topSlope * f.x;
+    float d = lerp(bottom, top, f.y);
+    if (d >= contactDistance)
+        return pos;
+    // The gradient of true distances is close to unit length: used as the edge normal without normalizing
+    float2 grad = float2(lerp(bottomSlope, topSlope, f.y), top - bottom) * scale;
+    return pos + grad * (contactDistance - d);
+}
+
 [numthreads(256, 1, 1)]
 void main(uint3 threadId : SV_DispatchThreadID)
 {
@@ -58,12 +115,12 @@ void main(uint3 threadId : SV_DispatchThreadID)
     CurrPosOut[id].goalX = CurrPosIn[id].goalX;
     CurrPosOut[id].goalY = CurrPosIn[id].goalY;
     CurrPosOut[id].holdTimer = CurrPosIn[id].holdTimer;
+    CurrPosOut[id].sourceIndex = CurrPosIn[id].sourceIndex;
 
     float stopDistance = 0.03f;
 
     float2 food = targetPos;              // current global food target (for newly leaving ants)
-    float2 nest = previousTargetPos;      // nest position
-    float2 hazardPos = float2(hazardPosX, hazardPosY);
+    float2 nest = nestPos;
 
     float2 dir = float2(0.0f, 0.0f);
     float2 newPos = pos;
@@ -88,7 +145,8 @@ void main(uint3 threadId : SV_DispatchThreadID)
             if(d > 1e-5f)
             {
                 float step = min(d, speed * CurrPosIn[id].speedScale * deltaTime);
-                float2 baseDir = toGoal / d;
+                int source = CurrPosIn[id].sourceIndex;
+                float2 baseDir = Heading(pos, toGoal, d, source >= 0 ? FlowFoodSlots[source] : -1);
                 float2 side = float2(-baseDir.y, baseDir.x);
                 float amp = CurrPosIn[id].laneOffset * saturate(d / 0.2f); // fade near goal
                 float2 steer = normalize(baseDir + side * amp);
@@ -137,7 +195,7 @@ void main(uint3 threadId : SV_DispatchThreadID)
         if(distNest > 1e-5f)
         {
             float step = min(distNest, speed * CurrPosIn[id].speedScale * deltaTime);
-            float2 baseDir = toNest / distNest;
+            float2 baseDir = Heading(pos, toNest, distNest, 0);
             float2 side = float2(-baseDir.y, baseDir.x);
             float amp = CurrPosIn[id].laneOffset * saturate(distNest / 0.2f);
             float2 steer = normalize(baseDir + side * amp);
@@ -169,6 +227,8 @@ void main(uint3 threadId : SV_DispatchThreadID)
             if (sidxN >= 0)
             {
                 InterlockedAdd(NestHitCounts[sidxN], 1);
+                // Deposit once; waiting at the nest must not score every frame
+                CurrPosOut[id].sourceIndex = -1;
             }
             float ht = CurrPosIn[id].holdTimer;
             if (activeFoodIndex < 0)
@@ -205,6 +265,8 @@ void main(uint3 threadId : SV_DispatchThreadID)
         }
     }
 
+    // After the arrival checks, as in AntStepKernel; rocks keep well clear of the nest and food nodes
+    newPos = Collide(newPos);
     CurrPosOut[id].x = newPos.x;
     CurrPosOut[id].y = newPos.y;
     CurrPosOut[id].directionX = dir.x;
@@ -1,29 +1,37 @@
-cbuffer VertexInputData : register(b0)
+// Per frame, mirrors FrameConstants in ShaderConstants.h
+cbuffer FrameConstants : register(b0)
 {
-    float2 size;
-    float2 objectPos; // objectPosX and objectPosY from C++ map here
-    float aspectRatio;
-    float time;
-    int2 indexes;
-    float speed;
-    int2 grid;
-    float padding1;
-    float2 targetPos;
-    float orbitDistance;
-    float jitter;
-    float2 previousTargetPos;
-    float flockTransitionTime;
-    float deltaTime;
-    int activeFoodIndex;
-    float cameraPosX;
-    float cameraPosY;
-    float cameraZoom;
-    float hazardPosX;
-    float hazardPosY;
-    float hazardRadius;
-    int hazardActive;
+    float aspectRatio    : packoffset(c0.x);
+    float time           : packoffset(c0.y);
+    float frameDeltaTime : packoffset(c0.z);
+    float cameraZoom     : packoffset(c0.w);
+    float2 cameraPos     : packoffset(c1.x);
+    float2 screenSize    : packoffset(c1.z);
 }
 
+// Per simulation pass, mirrors SimulationConstants in ShaderConstants.h
+cbuffer SimulationConstants : register(b1)
+{
+    float2 targetPos     : packoffset(c0.x); // active food
+    float2 nestPos       : packoffset(c0.z);
+    float speed          : packoffset(c1.x);
+    float deltaTime      : packoffset(c1.y); // simulation step, 0 while paused
+    int activeFoodIndex  : packoffset(c1.z);
+    int hazardActive     : packoffset(c1.w);
+    float2 hazardPos     : packoffset(c2.x);
+    float hazardRadius   : packoffset(c2.z);
+}
+
+// Density splat LOD, mirrors DensityConstants in ShaderConstants.h
+cbuffer DensityConstants : register(b3)
+{
+    int2 gridSize     : packoffset(c0.x);
+    int cellPixels    : packoffset(c0.z);
+    int instanceCount : packoffset(c0.w);
+    float lodStart    : packoffset(c1.x);
+    float lodEnd      : packoffset(c1.y);
+    int lodMode       : packoffset(c1.z); // 0 = auto, 1 = ants only, 2 = splat only
+}
 
 struct InstanceData
 {
@@ -42,6 +50,18 @@ struct InstanceData
 };
 
 StructuredBuffer<InstanceData> CurrPos : register(t0); // same as CurrPosIn after swap
+Texture2D<uint> DensityGrid : register(t1);            // ants per screen cell, filled by DensitySplatComputeShader
+
+// Must match DensitySplatPixelShader and DensityLod::SplatWeight
+float SplatWeight(uint count)
+{
+    if (lodMode == 1)
+        return 0.0f;
+    float antsPerPixel = count / float(cellPixels * cellPixels);
+    if (lodMode == 2)
+        return antsPerPixel > 0.0f ? 1.0f : 0.0f;
+    return saturate((antsPerPixel - lodStart) / max(lodEnd - lodStart, 1e-5f));
+}
 
 struct VsInput
 {
@@ -61,11 +81,26 @@ VS_OUTPUT main(VsInput input)
 {
     VS_OUTPUT output;
     
-    float2 quad = float2(input.pos.x / aspectRatio, input.pos.y);
-    float2 cameraOffset = float2(cameraPosX, cameraPosY);
-    float2 finalPos     = quad + float2(CurrPos[input.instanceId].x, CurrPos[input.instanceId].y) - cameraOffset;
+    float2 quad = float2(input.pos.x / aspectRatio, input.pos.y) * cameraZoom;
+    float2 antView      = (float2(CurrPos[input.instanceId].x, CurrPos[input.instanceId].y) - cameraPos) * cameraZoom;
+    float2 finalPos     = quad + antView;
     
     output.position = float4(finalPos, 0.0f, 1.0f);
+
+    // Fade out ants whose screen cell is covered by the density splat; fully covered ants collapse
+    float fade = 0.0f;
+    if (lodMode != 1 && abs(antView.x) < 1.0f && abs(antView.y) < 1.0f)
+    {
+        float2 pixel = float2((antView.x + 1.0f) * 0.5f * screenSize.x, (1.0f - antView.y) * 0.5f * screenSize.y);
+        int2 cell = min(int2(pixel) / cellPixels, gridSize - 1);
+        fade = SplatWeight(DensityGrid.Load(int3(cell, 0)));
+    }
+    if (fade >= 1.0f)
+    {
+        output.position = float4(-2.0f, -2.0f, 0.0f, 1.0f);
+        output.color = float4(0.0f, 0.0f, 0.0f, 0.0f);
+        return output;
+    }
     
     // Visual cue:
     // - ToFood ants heading to current active food: yellow
@@ -83,5 +118,6 @@ VS_OUTPUT main(VsInput input)
     {
         output.color = float4(0.2f, 0.9f, 0.9f, 1.0f);
     }
+    output.color.a *= 1.0f - fade;
     return output;
 }
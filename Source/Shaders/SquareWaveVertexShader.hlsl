@@ -1,27 +1,22 @@
-cbuffer VertexInputData : register(b0)
+// Per frame, mirrors FrameConstants in ShaderConstants.h
+cbuffer FrameConstants : register(b0)
 {
-    float2 size;
-    float2 objectPos;
-    float aspectRatio;
-    float time;
-    int2 indexes;
-    float speed;
-    int2 grid;
-    float padding1;
-    float2 targetPos;
-    float orbitDistance;
-    float jitter;
-    float2 previousTargetPos;
-    float flockTransitionTime;
-    float deltaTime;
-    int activeFoodIndex;
-    float cameraPosX;
-    float cameraPosY;
-    float cameraZoom;
-    float hazardPosX;
-    float hazardPosY;
-    float hazardRadius;
-    int hazardActive;
+    float aspectRatio    : packoffset(c0.x);
+    float time           : packoffset(c0.y);
+    float frameDeltaTime : packoffset(c0.z);
+    float cameraZoom     : packoffset(c0.w);
+    float2 cameraPos     : packoffset(c1.x);
+    float2 screenSize    : packoffset(c1.z);
+}
+
+// Per draw, mirrors DrawConstants in ShaderConstants.h
+cbuffer DrawConstants : register(b2)
+{
+    float2 size      : packoffset(c0.x);
+    float2 objectPos : packoffset(c0.z);
+    int2 indexes     : packoffset(c1.x);
+    int2 grid        : packoffset(c1.z);
+    float waveSpeed  : packoffset(c2.x);
 }
 
 struct VsInput
@@ -56,16 +51,15 @@ VS_OUTPUT main(VsInput input)
 	//pos.y += 1.0f - (objectPos.y * 2.0f);
 	//pos.y += sin(time * speed - (indexes.x + indexes.y)) *0.03f; // waves!
 		
-    float sinWave = sin(time * speed - ((float)i + j)) * 0.03f;
+    float sinWave = sin(time * waveSpeed - ((float)i + j)) * 0.03f;
     input.pos.y += sinWave;
 	
-    float2 cameraOffset = float2(cameraPosX, cameraPosY);
-    input.pos.xy -= cameraOffset;
+    input.pos.xy -= cameraPos;
 
     output.position = float4(input.pos, 1.0f);
 	
     // Subtle teal tint with mild shimmering based on phase
-    float phase = sin(time * speed - ((float)i + j));
+    float phase = sin(time * waveSpeed - ((float)i + j));
     float tint = 0.7f + 0.3f * (0.5f + 0.5f * phase); // 0.7..1.0
     output.color = float4(0.0f, 0.60f * tint, 0.55f * tint, 0.2f);
 	
@@ -8,10 +8,9 @@ struct VS_OUTPUT
 Texture2D g_fontTexture : register(t0);
 SamplerState g_samplerState : register(s0);
 
-float4 main(VS_OUTPUT input) : SV_TARGET
-{
-    float4 sample = g_fontTexture.Sample(g_samplerState, input.uv);
-    // Some atlases pack coverage in R; prefer max(R, A) for robustness
-    float a = max(sample.r, sample.a);
-    return float4(1.0, 1.0, 1.0, a);
-}
+float4 main(VS_OUTPUT input) : SV_TARGET
+{
+    // The BMFont atlas is a grayscale PNG, loaded as R8: coverage is in red
+    float coverage = g_fontTexture.Sample(g_samplerState, input.uv).r;
+    return float4(input.color.rgb, input.color.a * coverage);
+}
@@ -1,46 +1,44 @@
-cbuffer TextInputData : register(b0)
-{
-    float2 size;
-    float2 objectPos;
-    float2 screenSize;
-    float2 uvOffset;
-    float2 uvScale;
-}
-
+// Per frame, mirrors FrameConstants in ShaderConstants.h
+cbuffer FrameConstants : register(b0)
+{
+    float aspectRatio    : packoffset(c0.x);
+    float time           : packoffset(c0.y);
+    float frameDeltaTime : packoffset(c0.z);
+    float cameraZoom     : packoffset(c0.w);
+    float2 cameraPos     : packoffset(c1.x);
+    float2 screenSize    : packoffset(c1.z);
+}
+
 struct VS_INPUT
 {
-    float4 position : POSITION;
+    float3 position : POSITION; // SquareMesh, only its 0..1 uv corners are used
+    float2 uv : TEXCOORD0;
+    // Per-glyph data (GlyphInstance, vertex slot 1)
+    float2 anchor : GLYPHANCHOR; // world position of the label
+    float2 offset : GLYPHOFFSET; // screen pixels from the anchor, y down
+    float2 size : GLYPHSIZE;     // screen pixels
+    float4 uvRect : GLYPHUV;     // atlas u0, v0, u1, v1
+    float4 color : GLYPHCOLOR;
+};
+
+struct VS_OUTPUT
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
     float2 uv : TEXCOORD0;
-};
-
-struct VS_OUTPUT
-{
-    float4 position : SV_POSITION;
-    float4 color : COLOR;
-    float2 uv : TEXCOORD0;
-};
-
-Texture2D g_fontTexture : register(t0);
-SamplerState g_samplerState : register(s0);
-
-
+};
+
 VS_OUTPUT main(VS_INPUT input)
-{
-    VS_OUTPUT output;
-    
-    float vertexDistance = 0.05f;
-    
-    float aspect = screenSize.x / screenSize.y;
-    float pixelHeight = 2.0f / screenSize.y;
-    float pixelWidth = 2.0f / screenSize.x;
-    
-    input.position.x = (input.position.x / vertexDistance) * size.x * pixelWidth; // Convert including aspect ratio
-    input.position.y = (input.position.y / vertexDistance) * size.y * pixelHeight;
-    input.position.x += objectPos.x * pixelWidth - 1.0f; // convert from normal 0,1 to weird -1,1 - also takes into a account the aspect ratio now
-    input.position.y += 1.0f - objectPos.y * pixelHeight;
-		
-    output.position = input.position;
-    output.color = float4(1.0f, 1.0f, 1.0f, 1.0f);
-    output.uv = (input.uv * uvScale) + uvOffset;
-    return output;
-};
\ No newline at end of file
+{
+    VS_OUTPUT output;
+
+    // The anchor follows the camera like the markers; glyphs keep their pixel size at any zoom
+    float2 anchor = (input.anchor - cameraPos) * cameraZoom;
+    float2 pixels = input.offset + input.uv * input.size;
+    float2 p = anchor + float2(pixels.x, -pixels.y) * (2.0f / screenSize);
+
+    output.position = float4(p, 0.0f, 1.0f);
+    output.color = input.color;
+    output.uv = lerp(input.uvRect.xy, input.uvRect.zw, input.uv);
+    return output;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Profiler.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <utility>
+
+struct SimulationPipelineStats
+{
+    bool threaded         = false;
+    uint64_t steps        = 0; // snapshots produced
+    uint64_t reusedFrames = 0; // frames that drew the previous snapshot again because the next was not ready
+    double lastStepMs     = 0.0;
+};
+
+// Runs a simulation step on its own thread, one frame ahead of the renderer. Each Advance() hands the worker the
+// input for the next step and returns the newest finished snapshot, so the render thread draws frame N while frame
+// N+1 is simulated. Inputs and snapshots cross through triple buffers; neither thread blocks on the other.
+//
+// A snapshot is never overwritten before the render thread has acquired it (the worker skips a request while the
+// last one is still pending), so per-snapshot work such as buffer uploads is seen exactly once. Inputs can coalesce
+// when the worker falls behind, so they should carry running totals rather than per-frame deltas.
+//
+// Without Start() the step runs inline inside Advance(), which is the single-threaded fallback.
+template <class Input, class Snapshot> class SimulationPipeline
+{
+  public:
+    using Step = std::function<void( const Input&, Snapshot& )>;
+
+    explicit SimulationPipeline( Step step ) : step_( std::move( step ) )
+    {
+    }
+
+    SimulationPipeline( const SimulationPipeline& )            = delete;
+    SimulationPipeline& operator=( const SimulationPipeline& ) = delete;
+
+    ~SimulationPipeline()
+    {
+        Stop();
+    }
+
+    // Produces the first snapshot on the calling thread, then (when threaded) starts the worker
+    void Start( const Input& first, const bool threaded )
+    {
+        Stop();
+        RunStep( first );
+        if ( threaded )
+        {
+            stopping_.store( false, std::memory_order_relaxed );
+            // Read here, not on the worker: a Stop() that comes before the worker first runs must still wake it
+            const uint64_t handled = requested_.load( std::memory_order_relaxed );
+            worker_                = std::thread( [this, handled] { WorkerLoop( handled ); } );
+        }
+    }
+
+    void Stop()
+    {
+        if ( !worker_.joinable() )
+            return;
+        stopping_.store( true, std::memory_order_release );
+        requested_.fetch_add( 1, std::memory_order_release );
+        requested_.notify_one();
+        worker_.join();
+    }
+
+    bool Threaded() const
+    {
+        return worker_.joinable();
+    }
+
+    // Render thread: queue the next step and return the newest finished snapshot. Rethrows a worker failure.
+    const Snapshot& Advance( const Input& input )
+    {
+        if ( !Threaded() )
+        {
+            // The snapshot from Start() is still pending: hand it out first (its uploads create the buffers), and let
+            // this input coalesce into the next step, as the worker would
+            if ( !snapshots_.Pending() )
+                RunStep( input );
+            snapshots_.Acquire();
+            return snapshots_.Front();
+        }
+
+        if ( failure_.load( std::memory_order_acquire ) )
+        {
+            Stop();
+            std::rethrow_exception( error_ );
+        }
+
+        // Acquire before requesting, so the worker sees this snapshot as taken when the request arrives
+        if ( !snapshots_.Acquire() )
+            reusedFrames_++;
+
+        inputs_.Back() = input;
+        inputs_.Publish();
+        requested_.fetch_add( 1, std::memory_order_release );
+        requested_.notify_one();
+        return snapshots_.Front();
+    }
+
+    SimulationPipelineStats Stats() const
+    {
+        SimulationPipelineStats stats;
+        stats.threaded     = Threaded();
+        stats.steps        = steps_.load( std::memory_order_relaxed );
+        stats.reusedFrames = reusedFrames_;
+        stats.lastStepMs   = lastStepMs_.load( std::memory_order_relaxed );
+        return stats;
+    }
+
+  private:
+    void RunStep( const Input& input )
+    {
+        PROFILE_ZONE( "SimulationPipeline::RunStep" );
+        const auto start = std::chrono::steady_clock::now();
+        step_( input, snapshots_.Back() );
+        snapshots_.Publish();
+        lastStepMs_.store( std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count(),
+                           std::memory_order_relaxed );
+        steps_.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void WorkerLoop( uint64_t handled )
+    {
+        Profiler::SetThreadName( "Simulation" );
+        for ( ;; )
+        {
+            requested_.wait( handled, std::memory_order_acquire );
+            if ( stopping_.load( std::memory_order_acquire ) )
+                return;
+            handled = requested_.load( std::memory_order_acquire );
+
+            // Render has not taken the last snapshot yet; its next Advance() acquires it and asks again
+            if ( snapshots_.Pending() || !inputs_.Acquire() )
+                continue;
+
+            try
+            {
+                RunStep( inputs_.Front() );
+            }
+            catch ( ... )
+            {
+                error_ = std::current_exception();
+                failure_.store( true, std::memory_order_release );
+                return;
+            }
+        }
+    }
+
+    Step step_;
+    TripleBuffer<Input> inputs_;
+    TripleBuffer<Snapshot> snapshots_;
+
+    std::thread worker_;
+    std::atomic<uint64_t> requested_{ 0 };
+    std::atomic<bool> stopping_{ false };
+    std::atomic<bool> failure_{ false };
+    std::exception_ptr error_;
+
+    std::atomic<uint64_t> steps_{ 0 };
+    std::atomic<double> lastStepMs_{ 0.0 };
+    uint64_t reusedFrames_ = 0; // render thread only
+};
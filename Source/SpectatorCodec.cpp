@@ -0,0 +1,188 @@
+#include "SpectatorCodec.h"
+
+#include "ByteCoder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint8_t KeyFlag   = 1;
+    constexpr uint8_t ScoreFlag = 2;
+    constexpr uint8_t FoodFlag  = 4;
+
+    // A constant plane codes any number of ants in two bytes, so the count is only bounded by this
+    constexpr uint64_t MaxAnts = uint64_t( 1 ) << 26;
+
+    // Linear prediction from the last two positions; wraps like the residual XOR undoes it
+    uint16_t Predict( const uint16_t last, const uint16_t beforeLast )
+    {
+        return static_cast<uint16_t>( 2 * last - beforeLast );
+    }
+} // namespace
+
+uint16_t SpectatorEncoder::Quantize( const float value )
+{
+    const float unit = ( std::clamp( value, -WorldExtent, WorldExtent ) + WorldExtent ) / ( 2.0f * WorldExtent );
+    return static_cast<uint16_t>( unit * 65535.0f + 0.5f );
+}
+
+float SpectatorEncoder::Dequantize( const uint16_t value )
+{
+    return static_cast<float>( value ) / 65535.0f * ( 2.0f * WorldExtent ) - WorldExtent;
+}
+
+bool SpectatorEncoder::Encode( const uint64_t tick, const SpectatorScore& score,
+                               const std::span<const SpectatorFood> food, const std::span<const InstanceData> ants,
+                               std::vector<uint8_t>& out )
+{
+    const bool key = forceKey_ || sinceKey_ >= KeyframeInterval;
+    forceKey_      = false;
+    sinceKey_      = key ? 1 : sinceKey_ + 1;
+
+    const bool scoreChanged = key || score != lastScore_;
+    const bool foodChanged  = key || !std::equal( food.begin(), food.end(), lastFood_.begin(), lastFood_.end() );
+
+    out.clear();
+    out.push_back( static_cast<uint8_t>( ( key ? KeyFlag : 0 ) | ( scoreChanged ? ScoreFlag : 0 ) |
+                                         ( foodChanged ? FoodFlag : 0 ) ) );
+    ByteCoder::PutVarint( out, tick );
+    ByteCoder::PutVarint( out, ants.size() );
+    if ( scoreChanged )
+    {
+        ByteCoder::PutSigned( out, score.stage );
+        ByteCoder::PutSigned( out, score.score );
+        ByteCoder::PutSigned( out, score.stageScore );
+        ByteCoder::PutSigned( out, score.stageTarget );
+        ByteCoder::PutSigned( out, score.gameState );
+        ByteCoder::PutFloat( out, score.stageTimeLeft );
+        lastScore_ = score;
+    }
+    if ( foodChanged )
+    {
+        ByteCoder::PutVarint( out, food.size() );
+        for ( const SpectatorFood& node : food )
+        {
+            ByteCoder::PutFloat( out, node.x );
+            ByteCoder::PutFloat( out, node.y );
+            ByteCoder::PutFloat( out, node.amount );
+            out.push_back( node.flags );
+        }
+        lastFood_.assign( food.begin(), food.end() );
+    }
+
+    // Ants past the previous count (just spawned) have no history, like every ant in a keyframe
+    const size_t count    = ants.size();
+    const size_t previous = key ? 0 : std::min( x1_.size(), count );
+    x1_.resize( count );
+    x2_.resize( count );
+    y1_.resize( count );
+    y2_.resize( count );
+    state1_.resize( count );
+    for ( std::vector<uint8_t>& plane : planes_ )
+        plane.resize( count );
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+        const uint16_t x     = Quantize( ants[i].posX );
+        const uint16_t y     = Quantize( ants[i].posY );
+        const auto state     = static_cast<uint8_t>( ants[i].movementState );
+        const bool history   = i < previous;
+        const uint16_t xPred = history ? Predict( x1_[i], x2_[i] ) : 0;
+        const uint16_t yPred = history ? Predict( y1_[i], y2_[i] ) : 0;
+        const uint16_t dx    = x ^ xPred;
+        const uint16_t dy    = y ^ yPred;
+        planes_[0][i]        = static_cast<uint8_t>( dx );
+        planes_[1][i]        = static_cast<uint8_t>( dx >> 8 );
+        planes_[2][i]        = static_cast<uint8_t>( dy );
+        planes_[3][i]        = static_cast<uint8_t>( dy >> 8 );
+        planes_[4][i]        = state ^ ( history ? state1_[i] : 0 );
+
+        x2_[i]     = history ? x1_[i] : x;
+        y2_[i]     = history ? y1_[i] : y;
+        x1_[i]     = x;
+        y1_[i]     = y;
+        state1_[i] = state;
+    }
+
+    for ( const std::vector<uint8_t>& plane : planes_ )
+        ByteCoder::EncodePlane( plane, out, scratch_ );
+    return key;
+}
+
+bool SpectatorDecoder::IsKeyframe( const std::span<const uint8_t> frame )
+{
+    return !frame.empty() && ( frame[0] & KeyFlag ) != 0;
+}
+
+bool SpectatorDecoder::Decode( const std::span<const uint8_t> frame, SpectatorWorld& world )
+{
+    try
+    {
+        ByteReader in( frame, "Spectator frame" );
+        const uint8_t flags = in.Byte();
+        const bool key      = ( flags & KeyFlag ) != 0;
+        if ( !key && !synced_ )
+            return false;
+
+        const uint64_t tick  = in.Varint();
+        const uint64_t count = in.Varint();
+        if ( count > MaxAnts )
+            in.Fail( "has an impossible ant count" );
+        world.tick = tick;
+        if ( flags & ScoreFlag )
+        {
+            world.score.stage         = static_cast<int32_t>( in.Signed() );
+            world.score.score         = static_cast<int32_t>( in.Signed() );
+            world.score.stageScore    = static_cast<int32_t>( in.Signed() );
+            world.score.stageTarget   = static_cast<int32_t>( in.Signed() );
+            world.score.gameState     = static_cast<int32_t>( in.Signed() );
+            world.score.stageTimeLeft = in.Float();
+        }
+        if ( flags & FoodFlag )
+        {
+            const uint64_t nodes = in.Varint();
+            if ( nodes > frame.size() )
+                in.Fail( "has an impossible food count" );
+            world.food.resize( nodes );
+            for ( SpectatorFood& node : world.food )
+            {
+                node.x      = in.Float();
+                node.y      = in.Float();
+                node.amount = in.Float();
+                node.flags  = in.Byte();
+            }
+        }
+
+        for ( std::vector<uint8_t>& plane : planes_ )
+            in.Plane( count, plane );
+
+        const size_t previous = key ? 0 : std::min( world.antX.size(), count );
+        world.antX.resize( count );
+        world.antY.resize( count );
+        world.antState.resize( count );
+        x2_.resize( count );
+        y2_.resize( count );
+        for ( size_t i = 0; i < count; i++ )
+        {
+            const bool history   = i < previous;
+            const uint16_t xPred = history ? Predict( world.antX[i], x2_[i] ) : 0;
+            const uint16_t yPred = history ? Predict( world.antY[i], y2_[i] ) : 0;
+            const uint16_t x     = xPred ^ static_cast<uint16_t>( planes_[0][i] | planes_[1][i] << 8 );
+            const uint16_t y     = yPred ^ static_cast<uint16_t>( planes_[2][i] | planes_[3][i] << 8 );
+            world.antState[i]    = planes_[4][i] ^ ( history ? world.antState[i] : 0 );
+
+            x2_[i]        = history ? world.antX[i] : x;
+            y2_[i]        = history ? world.antY[i] : y;
+            world.antX[i] = x;
+            world.antY[i] = y;
+        }
+        synced_ = true;
+        return true;
+    }
+    catch ( const std::runtime_error& )
+    {
+        synced_ = false;
+        throw;
+    }
+}
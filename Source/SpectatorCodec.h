@@ -0,0 +1,107 @@
+#pragma once
+
+#include "InstanceData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Everything a spectator sees besides the ants; sent only in frames where it changed
+struct SpectatorScore
+{
+    int32_t stage       = 0;
+    int32_t score       = 0;
+    int32_t stageScore  = 0;
+    int32_t stageTarget = 0;
+    int32_t gameState   = 0;
+    float stageTimeLeft = 0.0f;
+
+    bool operator==( const SpectatorScore& ) const = default;
+};
+
+struct SpectatorFood
+{
+    static constexpr uint8_t ActiveFood   = 1;
+    static constexpr uint8_t BonusFood    = 2;
+    static constexpr uint8_t SelectedFood = 4;
+
+    float x       = 0.0f;
+    float y       = 0.0f;
+    float amount  = 0.0f;
+    uint8_t flags = 0; // ActiveFood | BonusFood | SelectedFood
+
+    bool operator==( const SpectatorFood& ) const = default;
+};
+
+// What a spectator has after decoding: ants quantized to 16 bits per axis, as sent
+struct SpectatorWorld
+{
+    uint64_t tick = 0;
+    SpectatorScore score;
+    std::vector<SpectatorFood> food;
+    std::vector<uint16_t> antX;
+    std::vector<uint16_t> antY;
+    std::vector<uint8_t> antState; // InstanceData::movementState
+};
+
+// Per-tick frames of the world for spectators in other processes. Ant positions are quantized to 16 bits over
+// [-WorldExtent, WorldExtent] and XORed with a linear prediction from the two frames before (ants mostly walk
+// straight), so a walking ant leaves a few low bits set. The residuals are split into byte planes (x low/high, y
+// low/high, state) and each plane is coded on its own with static rANS; the high-byte and state planes are nearly all
+// zero and cost almost nothing. Food and score go whole, and only when they changed.
+//
+// A keyframe predicts from nothing and is sent every KeyframeInterval ticks; a spectator that joins late or misses a
+// frame waits for the next one. Encoder and decoder keep the same two frames of history.
+//
+// Frame: flags byte, tick and ant count varints, [score], [food], then the five planes.
+class SpectatorEncoder
+{
+  public:
+    static constexpr int KeyframeInterval = 60;
+    static constexpr float WorldExtent    = 2.0f;
+
+    static uint16_t Quantize( float value );
+    static float Dequantize( uint16_t value );
+
+    // Replaces out with the frame for this tick; returns true for a keyframe. Buffers are kept between calls, so
+    // after the first few ticks at a steady colony size encoding does not allocate.
+    bool Encode( uint64_t tick, const SpectatorScore& score, std::span<const SpectatorFood> food,
+                 std::span<const InstanceData> ants, std::vector<uint8_t>& out );
+
+    // Sends a keyframe on the next call whatever the interval
+    void ForceKeyframe()
+    {
+        forceKey_ = true;
+    }
+
+  private:
+    uint64_t sinceKey_ = 0;
+    bool forceKey_     = true;
+    SpectatorScore lastScore_;
+    std::vector<SpectatorFood> lastFood_;
+    std::vector<uint16_t> x1_, x2_, y1_, y2_; // last and second-to-last quantized positions
+    std::vector<uint8_t> state1_;
+    std::vector<uint8_t> planes_[5];
+    std::vector<uint8_t> scratch_;
+};
+
+class SpectatorDecoder
+{
+  public:
+    // Applies one frame to world. Deltas before the first keyframe are skipped (returns false). Throws
+    // std::runtime_error on a malformed frame, after which the decoder waits for a keyframe again.
+    bool Decode( std::span<const uint8_t> frame, SpectatorWorld& world );
+
+    bool Synced() const
+    {
+        return synced_;
+    }
+
+    static bool IsKeyframe( std::span<const uint8_t> frame );
+
+  private:
+    bool synced_ = false;
+    std::vector<uint16_t> x2_, y2_; // second-to-last positions; the last ones are in the world
+    std::vector<uint8_t> planes_[5];
+};
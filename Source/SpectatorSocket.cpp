@@ -0,0 +1,239 @@
+#include "SpectatorSocket.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#pragma comment( lib, "ws2_32.lib" )
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+    using Socket                     = SOCKET;
+    constexpr intptr_t InvalidSocket = static_cast<intptr_t>( INVALID_SOCKET );
+    constexpr int SendFlags          = 0;
+
+    void StartSockets()
+    {
+        static const bool started = []
+        {
+            WSADATA data{};
+            return WSAStartup( MAKEWORD( 2, 2 ), &data ) == 0;
+        }();
+        if ( !started )
+            throw std::runtime_error( "WSAStartup failed" );
+    }
+
+    void CloseSocket( const intptr_t socket )
+    {
+        closesocket( static_cast<Socket>( socket ) );
+    }
+
+    bool SetNonBlocking( const intptr_t socket )
+    {
+        u_long enabled = 1;
+        return ioctlsocket( static_cast<Socket>( socket ), FIONBIO, &enabled ) == 0;
+    }
+
+    bool WouldBlock()
+    {
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    }
+#else
+    using Socket                     = int;
+    constexpr intptr_t InvalidSocket = -1;
+    constexpr int SendFlags          = MSG_NOSIGNAL; // a spectator hanging up is an error return, not SIGPIPE
+
+    void StartSockets()
+    {
+    }
+
+    void CloseSocket( const intptr_t socket )
+    {
+        ::close( static_cast<Socket>( socket ) );
+    }
+
+    bool SetNonBlocking( const intptr_t socket )
+    {
+        const int flags = fcntl( static_cast<Socket>( socket ), F_GETFL, 0 );
+        return flags >= 0 && fcntl( static_cast<Socket>( socket ), F_SETFL, flags | O_NONBLOCK ) == 0;
+    }
+
+    bool WouldBlock()
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+#endif
+
+    sockaddr_in Loopback( const uint16_t port )
+    {
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons( port );
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        return address;
+    }
+
+    // Keyframes of a large colony are megabytes; a big send buffer lets one go out in a single call
+    void TuneForFrames( const intptr_t socket )
+    {
+        const int sendBuffer = 8 * 1024 * 1024;
+        const int noDelay    = 1;
+        setsockopt( static_cast<Socket>( socket ), SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>( &sendBuffer ),
+                    sizeof( sendBuffer ) );
+        setsockopt( static_cast<Socket>( socket ), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>( &noDelay ),
+                    sizeof( noDelay ) );
+    }
+} // namespace
+
+SpectatorPublisher::SpectatorPublisher( const uint16_t port )
+{
+    StartSockets();
+    const auto listener = static_cast<intptr_t>( socket( AF_INET, SOCK_STREAM, IPPROTO_TCP ) );
+    if ( listener == InvalidSocket )
+        throw std::runtime_error( "Cannot create the spectator socket" );
+
+    const int reuse = 1;
+    setsockopt( static_cast<Socket>( listener ), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>( &reuse ),
+                sizeof( reuse ) );
+    const sockaddr_in address = Loopback( port );
+    const bool listening = bind( static_cast<Socket>( listener ), reinterpret_cast<const sockaddr*>( &address ),
+                                 sizeof( address ) ) == 0 &&
+                           listen( static_cast<Socket>( listener ), 8 ) == 0 && SetNonBlocking( listener );
+    if ( !listening )
+    {
+        CloseSocket( listener );
+        throw std::runtime_error( "Cannot listen for spectators on port " + std::to_string( port ) );
+    }
+    listener_ = listener;
+}
+
+SpectatorPublisher::~SpectatorPublisher()
+{
+    for ( const Spectator& spectator : spectators_ )
+        CloseSocket( spectator.socket );
+    CloseSocket( listener_ );
+}
+
+void SpectatorPublisher::Publish( const std::span<const uint8_t> frame, const bool keyframe )
+{
+    for ( ;; )
+    {
+        const auto accepted = static_cast<intptr_t>( accept( static_cast<Socket>( listener_ ), nullptr, nullptr ) );
+        if ( accepted == InvalidSocket )
+            break;
+        if ( !SetNonBlocking( accepted ) )
+        {
+            CloseSocket( accepted );
+            continue;
+        }
+        TuneForFrames( accepted );
+        Spectator spectator;
+        spectator.socket = accepted;
+        spectators_.push_back( std::move( spectator ) );
+    }
+
+    for ( size_t i = 0; i < spectators_.size(); )
+    {
+        Spectator& spectator = spectators_[i];
+        bool connected       = Flush( spectator );
+        if ( connected && spectator.sent < spectator.pending.size() )
+        {
+            spectator.waitingForKey = true;
+        }
+        else if ( connected && ( keyframe || !spectator.waitingForKey ) )
+        {
+            const auto size = static_cast<uint32_t>( frame.size() );
+            spectator.pending.resize( sizeof( size ) );
+            for ( size_t b = 0; b < sizeof( size ); b++ )
+                spectator.pending[b] = static_cast<uint8_t>( size >> ( b * 8 ) );
+            spectator.pending.insert( spectator.pending.end(), frame.begin(), frame.end() );
+            spectator.sent          = 0;
+            spectator.waitingForKey = false;
+            connected               = Flush( spectator );
+        }
+
+        if ( connected )
+        {
+            i++;
+            continue;
+        }
+        CloseSocket( spectator.socket );
+        spectators_.erase( spectators_.begin() + static_cast<std::ptrdiff_t>( i ) );
+    }
+}
+
+bool SpectatorPublisher::Flush( Spectator& spectator )
+{
+    while ( spectator.sent < spectator.pending.size() )
+    {
+        const size_t left = spectator.pending.size() - spectator.sent;
+        const auto chunk  = static_cast<int>( left < ( 1u << 30 ) ? left : ( 1u << 30 ) );
+        const auto sent   = send( static_cast<Socket>( spectator.socket ),
+                                  reinterpret_cast<const char*>( spectator.pending.data() + spectator.sent ), chunk,
+                                  SendFlags );
+        if ( sent > 0 )
+            spectator.sent += static_cast<size_t>( sent );
+        else
+            return sent < 0 && WouldBlock();
+    }
+    return true;
+}
+
+SpectatorSubscriber::SpectatorSubscriber( const uint16_t port )
+{
+    StartSockets();
+    const auto connection = static_cast<intptr_t>( socket( AF_INET, SOCK_STREAM, IPPROTO_TCP ) );
+    if ( connection == InvalidSocket )
+        throw std::runtime_error( "Cannot create the spectator socket" );
+
+    const sockaddr_in address = Loopback( port );
+    if ( connect( static_cast<Socket>( connection ), reinterpret_cast<const sockaddr*>( &address ),
+                  sizeof( address ) ) != 0 )
+    {
+        CloseSocket( connection );
+        throw std::runtime_error( "No publisher on port " + std::to_string( port ) );
+    }
+    socket_ = connection;
+}
+
+SpectatorSubscriber::~SpectatorSubscriber()
+{
+    CloseSocket( socket_ );
+}
+
+bool SpectatorSubscriber::Receive( std::vector<uint8_t>& frame )
+{
+    uint8_t length[4];
+    if ( !ReceiveAll( length, sizeof( length ) ) )
+        return false;
+    const uint32_t size = length[0] | length[1] << 8 | length[2] << 16 | static_cast<uint32_t>( length[3] ) << 24;
+    frame.resize( size );
+    return ReceiveAll( frame.data(), frame.size() );
+}
+
+bool SpectatorSubscriber::ReceiveAll( uint8_t* data, size_t size )
+{
+    while ( size > 0 )
+    {
+        const int chunk     = static_cast<int>( size < ( 1u << 30 ) ? size : ( 1u << 30 ) );
+        const auto received = recv( static_cast<Socket>( socket_ ), reinterpret_cast<char*>( data ), chunk, 0 );
+        if ( received <= 0 )
+            return false;
+        data += received;
+        size -= static_cast<size_t>( received );
+    }
+    return true;
+}
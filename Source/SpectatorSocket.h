@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Loopback TCP transport for SpectatorEncoder frames; each frame goes out behind a 4-byte little-endian length.
+// Winsock on Windows, BSD sockets elsewhere.
+class SpectatorPublisher
+{
+  public:
+    static constexpr uint16_t DefaultPort = 47800;
+
+    // Listens on 127.0.0.1:port; throws std::runtime_error when the port cannot be bound
+    explicit SpectatorPublisher( uint16_t port );
+    ~SpectatorPublisher();
+
+    SpectatorPublisher( const SpectatorPublisher& )            = delete;
+    SpectatorPublisher& operator=( const SpectatorPublisher& ) = delete;
+
+    // Takes in spectators waiting to connect, then queues the frame for each. Never blocks: a spectator still
+    // taking an earlier frame skips this one, and one that skipped or just joined waits for the next keyframe, since
+    // deltas only apply to the frame before. Spectators that hang up are dropped.
+    void Publish( std::span<const uint8_t> frame, bool keyframe );
+
+    size_t Spectators() const
+    {
+        return spectators_.size();
+    }
+
+  private:
+    struct Spectator
+    {
+        intptr_t socket = -1;
+        std::vector<uint8_t> pending; // length and frame being sent
+        size_t sent        = 0;
+        bool waitingForKey = true;
+    };
+
+    // false when the spectator hung up
+    static bool Flush( Spectator& spectator );
+
+    intptr_t listener_ = -1;
+    std::vector<Spectator> spectators_;
+};
+
+class SpectatorSubscriber
+{
+  public:
+    // Connects to a publisher on 127.0.0.1:port; throws std::runtime_error when none is listening
+    explicit SpectatorSubscriber( uint16_t port );
+    ~SpectatorSubscriber();
+
+    SpectatorSubscriber( const SpectatorSubscriber& )            = delete;
+    SpectatorSubscriber& operator=( const SpectatorSubscriber& ) = delete;
+
+    // Blocks until the next whole frame is in; false once the publisher has gone
+    bool Receive( std::vector<uint8_t>& frame );
+
+  private:
+    bool ReceiveAll( uint8_t* data, size_t size );
+
+    intptr_t socket_ = -1;
+};
@@ -0,0 +1,145 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+TaskId TaskGraph::Add( std::string name, std::function<void()> work, const std::initializer_list<TaskId> dependencies,
+                       const TaskAffinity affinity )
+{
+    const auto id = static_cast<TaskId>( tasks_.size() );
+    for ( const TaskId dependency : dependencies )
+    {
+        if ( dependency < 0 || dependency >= id )
+            throw std::invalid_argument( "TaskGraph: task '" + name + "' depends on a task not added before it" );
+    }
+
+    Task task;
+    task.work         = std::move( work );
+    task.dependencies = dependencies;
+    task.affinity     = affinity;
+    tasks_.push_back( std::move( task ) );
+    for ( const TaskId dependency : dependencies )
+        tasks_[dependency].dependents.push_back( id );
+
+    TaskTiming timing;
+    timing.name = std::move( name );
+    timings_.push_back( std::move( timing ) );
+    return id;
+}
+
+void TaskGraph::Run( const int workers )
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto since = [start]
+    { return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count(); };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<TaskId> readyAny;
+    std::deque<TaskId> readyMain;
+    std::vector<size_t> waitingOn( tasks_.size() );
+    size_t finished = 0;
+    size_t running  = 0;
+    std::exception_ptr failure;
+
+    for ( size_t i = 0; i < tasks_.size(); i++ )
+    {
+        waitingOn[i] = tasks_[i].dependencies.size();
+        if ( waitingOn[i] == 0 )
+            ( tasks_[i].affinity == TaskAffinity::Main ? readyMain : readyAny ).push_back( static_cast<TaskId>( i ) );
+    }
+
+    // Returns when the graph is done (or failed and drained)
+    const auto drain = [&]( const int thread )
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        for ( ;; )
+        {
+            wake.wait( lock,
+                       [&]
+                       {
+                           return finished == tasks_.size() || ( failure && running == 0 ) ||
+                                  ( !failure && ( !readyAny.empty() || ( thread == 0 && !readyMain.empty() ) ) );
+                       } );
+            if ( finished == tasks_.size() || ( failure && running == 0 ) )
+                return;
+            if ( failure )
+                continue;
+
+            // The calling thread prefers work only it can do
+            std::deque<TaskId>& queue = ( thread == 0 && !readyMain.empty() ) ? readyMain : readyAny;
+            const TaskId id           = queue.front();
+            queue.pop_front();
+            running++;
+
+            lock.unlock();
+            const double begin = since();
+            std::exception_ptr error;
+            try
+            {
+                tasks_[id].work();
+            }
+            catch ( ... )
+            {
+                error = std::current_exception();
+            }
+            const double end = since();
+            lock.lock();
+
+            timings_[id].startMs    = begin;
+            timings_[id].durationMs = end - begin;
+            timings_[id].thread     = thread;
+            running--;
+            finished++;
+            if ( error && !failure )
+                failure = error;
+            for ( const TaskId dependent : tasks_[id].dependents )
+            {
+                if ( --waitingOn[dependent] == 0 )
+                    ( tasks_[dependent].affinity == TaskAffinity::Main ? readyMain : readyAny ).push_back( dependent );
+            }
+            wake.notify_all();
+        }
+    };
+
+    const int extra = std::clamp( workers, 0, std::max( 0, static_cast<int>( tasks_.size() ) - 1 ) );
+    std::vector<std::thread> threads;
+    threads.reserve( extra );
+    for ( int i = 1; i <= extra; i++ )
+        threads.emplace_back( drain, i );
+    drain( 0 );
+    {
+        // Workers may still be parked in wait() when the graph failed
+        std::lock_guard<std::mutex> lock( mutex );
+        wake.notify_all();
+    }
+    for ( std::thread& thread : threads )
+        thread.join();
+
+    wallMs_      = since();
+    threadsUsed_ = extra + 1;
+    if ( failure )
+        std::rethrow_exception( failure );
+}
+
+double TaskGraph::CriticalPathMs() const
+{
+    // Tasks are stored in dependency order, so one forward pass finds each task's earliest finish
+    std::vector<double> finish( tasks_.size(), 0.0 );
+    double longest = 0.0;
+    for ( size_t i = 0; i < tasks_.size(); i++ )
+    {
+        double ready = 0.0;
+        for ( const TaskId dependency : tasks_[i].dependencies )
+            ready = std::max( ready, finish[dependency] );
+        finish[i] = ready + timings_[i].durationMs;
+        longest   = std::max( longest, finish[i] );
+    }
+    return longest;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+using TaskId = int;
+
+enum class TaskAffinity
+{
+    Any,  // any thread of the graph
+    Main, // only the thread that calls Run() (window and swap chain work)
+};
+
+struct TaskTiming
+{
+    std::string name;
+    double startMs    = 0.0; // since Run() began
+    double durationMs = 0.0;
+    int thread        = 0; // 0 is the thread that called Run(), workers count from 1
+};
+
+// One-shot dependency graph for startup work. Tasks start as soon as everything they depend on has finished, on a
+// few worker threads plus the calling thread, and every task's start and duration is recorded so the critical path
+// to the first frame can be read off. A task may only depend on tasks added before it, so there are no cycles.
+class TaskGraph
+{
+  public:
+    TaskId Add( std::string name, std::function<void()> work, std::initializer_list<TaskId> dependencies = {},
+                TaskAffinity affinity = TaskAffinity::Any );
+
+    // Blocks until every task ran. After the first exception no new task starts; the exception is rethrown once the
+    // tasks already running have finished.
+    void Run( int workers );
+
+    const std::vector<TaskTiming>& Timings() const
+    {
+        return timings_;
+    }
+
+    double WallMs() const
+    {
+        return wallMs_;
+    }
+
+    // Longest chain of dependent task durations: how fast Run() could be with unlimited threads
+    double CriticalPathMs() const;
+
+    int ThreadsUsed() const
+    {
+        return threadsUsed_;
+    }
+
+  private:
+    struct Task
+    {
+        std::function<void()> work;
+        std::vector<TaskId> dependencies;
+        std::vector<TaskId> dependents;
+        TaskAffinity affinity = TaskAffinity::Any;
+    };
+
+    std::vector<Task> tasks_;
+    std::vector<TaskTiming> timings_;
+    double wallMs_   = 0.0;
+    int threadsUsed_ = 1;
+};
@@ -0,0 +1,366 @@
+#include "TrajectoryRecorder.h"
+
+#include "ByteCoder.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "SpectatorCodec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr char Magic[4]    = { 'A', 'N', 'T', 'T' };
+    constexpr uint32_t KeyFlag = 1;
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t interval;
+        uint32_t chunkAnts;
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t payloadBytes;
+        uint32_t flags;
+        uint64_t tick;
+        uint32_t sample;
+        uint32_t sampleAnts;
+        uint32_t antBegin;
+        uint32_t antCount;
+    };
+    static_assert( sizeof( FileHeader ) == 16 && sizeof( ChunkHeader ) == 32 );
+
+    uint16_t ZigZag( const uint16_t delta )
+    {
+        const auto value = static_cast<int16_t>( delta );
+        return static_cast<uint16_t>( ( static_cast<uint16_t>( value ) << 1 ) ^ static_cast<uint16_t>( value >> 15 ) );
+    }
+
+    uint16_t UnZigZag( const uint16_t value )
+    {
+        return static_cast<uint16_t>( ( value >> 1 ) ^ static_cast<uint16_t>( -static_cast<int>( value & 1 ) ) );
+    }
+
+    // Ants of the sample that fall in the chunk starting at antBegin
+    uint32_t ChunkCount( const size_t sampleAnts, const size_t antBegin )
+    {
+        return static_cast<uint32_t>(
+            std::min<size_t>( TrajectoryRecorder::ChunkAnts, sampleAnts > antBegin ? sampleAnts - antBegin : 0 ) );
+    }
+
+    size_t ChunksIn( const size_t sampleAnts )
+    {
+        constexpr size_t Chunk = TrajectoryRecorder::ChunkAnts;
+        return std::max<size_t>( 1, ( sampleAnts + Chunk - 1 ) / Chunk );
+    }
+} // namespace
+
+TrajectoryRecorder::TrajectoryRecorder( const std::filesystem::path& path, const uint32_t interval )
+    : path_( path ), out_( path, std::ios::binary | std::ios::trunc ), interval_( std::max<uint32_t>( 1, interval ) )
+{
+    FileHeader header{};
+    std::memcpy( header.magic, Magic, sizeof( Magic ) );
+    header.version   = Version;
+    header.interval  = interval_;
+    header.chunkAnts = ChunkAnts;
+    if ( !out_.write( reinterpret_cast<const char*>( &header ), sizeof( header ) ) )
+        throw std::runtime_error( "Cannot create trajectory file " + path.string() );
+
+    free_.reserve( BufferCount );
+    queued_.reserve( BufferCount );
+    for ( Buffer& buffer : buffers_ )
+        free_.push_back( &buffer );
+    writer_ = std::thread( [this] { WriterLoop(); } );
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    try
+    {
+        Close();
+    }
+    catch ( const std::runtime_error& )
+    {
+        // Close() is where failures are reported; a recorder dropped without it has nobody to tell
+    }
+}
+
+bool TrajectoryRecorder::Sample( const uint64_t tick, const std::span<const InstanceData> ants )
+{
+    static Metric& recorded = Metrics::Counter( "trajectory.samples" );
+    static Metric& dropped  = Metrics::Counter( "trajectory.dropped" );
+    static Metric& copyUs   = Metrics::Gauge( "trajectory.copyUs" );
+
+    if ( tick % interval_ != 0 )
+        return true;
+
+    PROFILE_ZONE( "TrajectoryRecorder::Sample" );
+    const auto start = std::chrono::steady_clock::now();
+    Buffer* buffer   = nullptr;
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        if ( !free_.empty() )
+        {
+            buffer = free_.back();
+            free_.pop_back();
+        }
+    }
+    if ( !buffer )
+    {
+        dropped.Add();
+        return false;
+    }
+
+    // One pass over the colony, which is bound by reading it; quantizing here as well took a third longer
+    const size_t count = ants.size();
+    buffer->tick       = tick;
+    buffer->x.resize( count );
+    buffer->y.resize( count );
+    buffer->state.resize( count );
+    for ( size_t i = 0; i < count; i++ )
+    {
+        buffer->x[i]     = ants[i].posX;
+        buffer->y[i]     = ants[i].posY;
+        buffer->state[i] = static_cast<uint8_t>( ants[i].movementState );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        queued_.push_back( buffer );
+    }
+    wake_.notify_one();
+    recorded.Add();
+    copyUs.Set(
+        std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count() );
+    return true;
+}
+
+void TrajectoryRecorder::Close()
+{
+    if ( writer_.joinable() )
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+        out_.close();
+        failed_ = failed_ || out_.fail();
+    }
+    if ( failed_ )
+        throw std::runtime_error( "Could not write trajectory file " + path_.string() );
+}
+
+void TrajectoryRecorder::WriterLoop()
+{
+    Profiler::SetThreadName( "Trajectory writer" );
+    for ( ;; )
+    {
+        Buffer* sample = nullptr;
+        {
+            std::unique_lock<std::mutex> lock( mutex_ );
+            wake_.wait( lock, [this] { return stopping_ || !queued_.empty(); } );
+            if ( queued_.empty() )
+                return;
+            sample = queued_.front();
+            queued_.erase( queued_.begin() );
+        }
+
+        Write( *sample );
+
+        std::lock_guard<std::mutex> lock( mutex_ );
+        free_.push_back( sample );
+        failed_ = failed_ || out_.fail();
+    }
+}
+
+void TrajectoryRecorder::Write( const Buffer& sample )
+{
+    PROFILE_ZONE( "TrajectoryRecorder::Write" );
+    static Metric& bytes = Metrics::Counter( "trajectory.bytes" );
+
+    const size_t count    = sample.x.size();
+    const bool key        = samples_ % KeyInterval == 0;
+    const size_t previous = key ? 0 : std::min( prevCount_, count );
+    prevX_.resize( count );
+    prevY_.resize( count );
+
+    record_.clear();
+    for ( size_t chunk = 0, chunks = ChunksIn( count ); chunk < chunks; chunk++ )
+    {
+        const size_t begin = chunk * ChunkAnts;
+        const uint32_t n   = ChunkCount( count, begin );
+        for ( int p = 0; p < 4; p++ )
+            planes_[p].resize( n );
+        planes_[4].assign( ( n + 3 ) / 4, 0 );
+        for ( size_t i = 0; i < n; i++ )
+        {
+            const size_t ant   = begin + i;
+            const bool history = ant < previous;
+            const uint16_t x   = SpectatorEncoder::Quantize( sample.x[ant] );
+            const uint16_t y   = SpectatorEncoder::Quantize( sample.y[ant] );
+            const uint16_t dx  = ZigZag( static_cast<uint16_t>( x - ( history ? prevX_[ant] : 0 ) ) );
+            const uint16_t dy  = ZigZag( static_cast<uint16_t>( y - ( history ? prevY_[ant] : 0 ) ) );
+            planes_[0][i]      = static_cast<uint8_t>( dx );
+            planes_[1][i]      = static_cast<uint8_t>( dx >> 8 );
+            planes_[2][i]      = static_cast<uint8_t>( dy );
+            planes_[3][i]      = static_cast<uint8_t>( dy >> 8 );
+            prevX_[ant]        = x;
+            prevY_[ant]        = y;
+            planes_[4][i / 4] |= static_cast<uint8_t>( ( sample.state[ant] & 3 ) << ( i % 4 * 2 ) );
+        }
+
+        const size_t at = record_.size();
+        record_.resize( at + sizeof( ChunkHeader ) );
+        for ( const std::vector<uint8_t>& plane : planes_ )
+            ByteCoder::EncodePlane( plane, record_, scratch_ );
+
+        ChunkHeader header{};
+        header.payloadBytes = static_cast<uint32_t>( record_.size() - at - sizeof( ChunkHeader ) );
+        header.flags        = key ? KeyFlag : 0;
+        header.tick         = sample.tick;
+        header.sample       = samples_;
+        header.sampleAnts   = static_cast<uint32_t>( count );
+        header.antBegin     = static_cast<uint32_t>( begin );
+        header.antCount     = n;
+        std::memcpy( record_.data() + at, &header, sizeof( header ) );
+    }
+
+    out_.write( reinterpret_cast<const char*>( record_.data() ), static_cast<std::streamsize>( record_.size() ) );
+    bytes.Add( static_cast<int64_t>( record_.size() ) );
+    prevCount_ = count;
+    samples_++;
+}
+
+TrajectoryFile::TrajectoryFile( const std::filesystem::path& path )
+{
+    if ( !file_.Open( path ) )
+        throw std::runtime_error( "Cannot open trajectory file " + path.string() );
+
+    const unsigned char* data = file_.Data();
+    const size_t size         = file_.Size();
+    FileHeader header{};
+    if ( size >= sizeof( header ) )
+        std::memcpy( &header, data, sizeof( header ) );
+    if ( size < sizeof( header ) || std::memcmp( header.magic, Magic, sizeof( Magic ) ) != 0 ||
+         header.version != TrajectoryRecorder::Version || header.chunkAnts != TrajectoryRecorder::ChunkAnts ||
+         header.interval == 0 )
+        throw std::runtime_error( path.string() + " is not a version " +
+                                  std::to_string( TrajectoryRecorder::Version ) + " trajectory file" );
+    interval_ = header.interval;
+
+    // Index every whole sample; a sample cut short at the end is left out
+    size_t at = sizeof( header );
+    while ( size - at >= sizeof( ChunkHeader ) )
+    {
+        ChunkHeader chunk{};
+        std::memcpy( &chunk, data + at, sizeof( chunk ) );
+        const size_t index = chunks_.size() - ( samples_.empty() ? 0 : samples_.back().firstChunk );
+        const bool first   = samples_.empty() || index == ChunksIn( samples_.back().ants );
+        if ( chunk.payloadBytes > size - at - sizeof( chunk ) )
+            break;
+        if ( first )
+        {
+            if ( chunk.sample != samples_.size() || chunk.antBegin != 0 )
+                throw std::runtime_error( path.string() + " has a chunk out of place" );
+            SampleEntry entry;
+            entry.tick       = chunk.tick;
+            entry.ants       = chunk.sampleAnts;
+            entry.key        = ( chunk.flags & KeyFlag ) != 0;
+            entry.firstChunk = chunks_.size();
+            if ( samples_.empty() && !entry.key )
+                throw std::runtime_error( path.string() + " does not start with a key sample" );
+            samples_.push_back( entry );
+        }
+        else if ( chunk.sample != samples_.size() - 1 || chunk.antBegin != index * TrajectoryRecorder::ChunkAnts )
+        {
+            throw std::runtime_error( path.string() + " has a chunk out of place" );
+        }
+        if ( chunk.antCount != ChunkCount( samples_.back().ants, chunk.antBegin ) )
+            throw std::runtime_error( path.string() + " has a chunk out of place" );
+        chunks_.push_back( { at + sizeof( chunk ), chunk.payloadBytes } );
+        at += sizeof( chunk ) + chunk.payloadBytes;
+    }
+    if ( !samples_.empty() && chunks_.size() - samples_.back().firstChunk < ChunksIn( samples_.back().ants ) )
+    {
+        chunks_.resize( samples_.back().firstChunk );
+        samples_.pop_back();
+    }
+}
+
+TrajectorySlice TrajectoryFile::Read( const uint32_t antBegin, const uint32_t antEnd, const uint64_t tickBegin,
+                                      const uint64_t tickEnd ) const
+{
+    const auto byTick = []( const SampleEntry& entry, const uint64_t tick ) { return entry.tick < tick; };
+    const auto firstSample = std::lower_bound( samples_.begin(), samples_.end(), tickBegin, byTick );
+    const auto lastSample  = std::lower_bound( firstSample, samples_.end(), std::max( tickBegin, tickEnd ), byTick );
+    const auto first       = static_cast<size_t>( firstSample - samples_.begin() );
+    const auto last        = static_cast<size_t>( lastSample - samples_.begin() );
+
+    TrajectorySlice slice;
+    slice.antBegin      = antBegin;
+    slice.antCount      = antEnd > antBegin ? antEnd - antBegin : 0;
+    const size_t stride = slice.antCount;
+    for ( size_t s = first; s < last; s++ )
+        slice.ticks.push_back( samples_[s].tick );
+    slice.x.assign( slice.ticks.size() * stride, 0.0f );
+    slice.y.assign( slice.ticks.size() * stride, 0.0f );
+    slice.state.assign( slice.ticks.size() * stride, TrajectorySlice::Absent );
+    if ( stride == 0 || first >= last )
+        return slice;
+
+    // Each chunk the ant range covers is decoded from the key sample before the range on, since its deltas chain
+    size_t key = first;
+    while ( !samples_[key].key )
+        key--;
+    std::vector<uint16_t> x( TrajectoryRecorder::ChunkAnts );
+    std::vector<uint16_t> y( TrajectoryRecorder::ChunkAnts );
+    std::vector<uint8_t> planes[5];
+    for ( size_t begin = antBegin / TrajectoryRecorder::ChunkAnts * TrajectoryRecorder::ChunkAnts; begin < antEnd;
+          begin += TrajectoryRecorder::ChunkAnts )
+    {
+        uint32_t previous = 0; // ants this chunk had in the sample before
+        for ( size_t s = key; s < last; s++ )
+        {
+            const SampleEntry& sample = samples_[s];
+            const uint32_t n          = ChunkCount( sample.ants, begin );
+            const size_t history      = sample.key ? 0 : previous;
+            previous                  = n;
+            if ( n == 0 )
+                continue;
+
+            const ChunkEntry& chunk = chunks_[sample.firstChunk + begin / TrajectoryRecorder::ChunkAnts];
+            ByteReader in( { file_.Data() + chunk.offset, chunk.size }, "Trajectory chunk" );
+            for ( int p = 0; p < 4; p++ )
+                in.Plane( n, planes[p] );
+            in.Plane( ( n + 3 ) / 4, planes[4] );
+            for ( size_t i = 0; i < n; i++ )
+            {
+                const bool known = i < history;
+                x[i] = static_cast<uint16_t>( ( known ? x[i] : 0 ) + UnZigZag( planes[0][i] | planes[1][i] << 8 ) );
+                y[i] = static_cast<uint16_t>( ( known ? y[i] : 0 ) + UnZigZag( planes[2][i] | planes[3][i] << 8 ) );
+            }
+            if ( s < first )
+                continue;
+
+            const size_t from = std::max<size_t>( antBegin, begin );
+            const size_t to   = std::min<size_t>( antEnd, begin + n );
+            const size_t row  = ( s - first ) * stride;
+            for ( size_t ant = from; ant < to; ant++ )
+            {
+                const size_t i      = ant - begin;
+                const size_t column = row + ant - antBegin;
+                slice.x[column]     = SpectatorEncoder::Dequantize( x[i] );
+                slice.y[column]     = SpectatorEncoder::Dequantize( y[i] );
+                slice.state[column] = static_cast<uint8_t>( planes[4][i / 4] >> ( i % 4 * 2 ) & 3 );
+            }
+        }
+    }
+    return slice;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "InstanceData.h"
+#include "MappedFile.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Ants read back from a trajectory file: sample-major, antCount values per sample
+struct TrajectorySlice
+{
+    static constexpr uint8_t Absent = 0xFF; // state of an ant that had not spawned by that sample
+
+    uint32_t antBegin = 0;
+    uint32_t antCount = 0;
+    std::vector<uint64_t> ticks;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<uint8_t> state; // InstanceData::movementState, or Absent
+};
+
+// Samples every ant's position and movementState every interval ticks into a column file, for offline analysis of
+// ant traffic. The sim thread only copies positions and states out of the colony into a free buffer; a writer thread
+// quantizes them (on SpectatorEncoder's grid), codes and appends them, so recording never waits on the disk. When
+// every buffer is still with the writer the sample is dropped and counted in trajectory.dropped.
+//
+// Each sample is stored as chunks of ChunkAnts ants. A chunk holds five byte planes, coded like the spectator
+// stream's: the low and high bytes of each axis's zigzagged delta from the ant's previous sample, and the states
+// packed four to a byte. Every KeyInterval samples the positions are stored whole, so a reader only decodes from the
+// key sample before the range it wants.
+//
+// File: "ANTT", version, interval, ChunkAnts; then per chunk a 32-byte header (payload size, key flag, tick, sample
+// index, ants in the sample, first ant, ant count) and its planes. A file cut short by a crash reads up to the last
+// whole sample.
+class TrajectoryRecorder
+{
+  public:
+    static constexpr uint32_t Version         = 1;
+    static constexpr uint32_t ChunkAnts       = 65536;
+    static constexpr uint32_t KeyInterval     = 50; // samples
+    static constexpr uint32_t DefaultInterval = 6;  // 10 Hz at the 60 Hz step
+    static constexpr size_t BufferCount       = 3;
+
+    // Creates the file and starts the writer; throws std::runtime_error when the file cannot be created
+    explicit TrajectoryRecorder( const std::filesystem::path& path, uint32_t interval = DefaultInterval );
+    ~TrajectoryRecorder();
+
+    TrajectoryRecorder( const TrajectoryRecorder& )            = delete;
+    TrajectoryRecorder& operator=( const TrajectoryRecorder& ) = delete;
+
+    // Sim thread, once per tick; copies the colony on ticks that are a multiple of the interval. Never blocks: returns
+    // false when the sample was dropped because every buffer was still with the writer.
+    bool Sample( uint64_t tick, std::span<const InstanceData> ants );
+
+    // Writes the samples still queued and stops the writer; throws std::runtime_error when a write failed
+    void Close();
+
+  private:
+    struct Buffer
+    {
+        uint64_t tick = 0;
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<uint8_t> state;
+    };
+
+    void WriterLoop();
+    void Write( const Buffer& sample );
+
+    std::filesystem::path path_;
+    std::ofstream out_;
+    uint32_t interval_ = DefaultInterval;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    Buffer buffers_[BufferCount];
+    std::vector<Buffer*> free_;
+    std::vector<Buffer*> queued_; // oldest first
+    bool stopping_ = false;
+    bool failed_   = false;
+    std::thread writer_;
+
+    // Writer thread only
+    uint32_t samples_  = 0;
+    size_t prevCount_  = 0; // ants in the sample before, which the deltas are against
+    std::vector<uint16_t> prevX_;
+    std::vector<uint16_t> prevY_;
+    std::vector<uint8_t> planes_[5];
+    std::vector<uint8_t> scratch_;
+    std::vector<uint8_t> record_;
+};
+
+// Reads a trajectory file by ant range and tick range. The file is memory-mapped and indexed when opened; only the
+// chunks a read covers are decoded.
+class TrajectoryFile
+{
+  public:
+    // Throws std::runtime_error when the file cannot be opened or is not a trajectory file of this version
+    explicit TrajectoryFile( const std::filesystem::path& path );
+
+    uint32_t Interval() const
+    {
+        return interval_;
+    }
+
+    size_t Samples() const
+    {
+        return samples_.size();
+    }
+
+    uint64_t Tick( const size_t sample ) const
+    {
+        return samples_[sample].tick;
+    }
+
+    // Ants alive at that sample
+    uint32_t Ants( const size_t sample ) const
+    {
+        return samples_[sample].ants;
+    }
+
+    // Ants [antBegin, antEnd) at every sample with a tick in [tickBegin, tickEnd). Throws std::runtime_error when a
+    // chunk does not decode.
+    TrajectorySlice Read( uint32_t antBegin, uint32_t antEnd, uint64_t tickBegin, uint64_t tickEnd ) const;
+
+  private:
+    struct SampleEntry
+    {
+        uint64_t tick     = 0;
+        uint32_t ants     = 0;
+        bool key          = false;
+        size_t firstChunk = 0;
+    };
+
+    struct ChunkEntry
+    {
+        size_t offset = 0; // of the payload
+        uint32_t size = 0;
+    };
+
+    MappedFile file_;
+    uint32_t interval_ = 0;
+    std::vector<SampleEntry> samples_;
+    std::vector<ChunkEntry> chunks_;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer handoff of whole values. The producer fills Back() and publishes it; the
+// consumer acquires the newest published value into Front(). Neither side ever waits: a slower consumer just skips
+// values, and a slower producer leaves the consumer re-reading its current Front().
+template <class T> class TripleBuffer
+{
+  public:
+    // Producer side
+    T& Back()
+    {
+        return slots_[back_];
+    }
+
+    void Publish()
+    {
+        back_ = middle_.exchange( static_cast<uint8_t>( back_ | FreshBit ), std::memory_order_acq_rel ) & IndexMask;
+    }
+
+    // True while the last published value has not been acquired yet. Either side may ask.
+    bool Pending() const
+    {
+        return ( middle_.load( std::memory_order_acquire ) & FreshBit ) != 0;
+    }
+
+    // Consumer side; false (and Front() unchanged) when nothing new was published
+    bool Acquire()
+    {
+        if ( !Pending() )
+            return false;
+        front_ = middle_.exchange( front_, std::memory_order_acq_rel ) & IndexMask;
+        return true;
+    }
+
+    const T& Front() const
+    {
+        return slots_[front_];
+    }
+
+  private:
+    static constexpr uint8_t IndexMask = 0x3;
+    static constexpr uint8_t FreshBit  = 0x4;
+
+    std::array<T, 3> slots_{};
+    std::atomic<uint8_t> middle_{ 1 };
+    uint8_t back_  = 0; // producer-owned
+    uint8_t front_ = 2; // consumer-owned
+};
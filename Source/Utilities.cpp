@@ -1,4 +1,20 @@
 #include "Utilities.h"
+#include "ShaderConstants.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <d3d11shader.h>
+#include <stdexcept>
+#include <string>
+#include <wrl/client.h>
+
+namespace
+{
+    std::span<const unsigned char> Bytes( const std::vector<char>& compiledShader )
+    {
+        return { reinterpret_cast<const unsigned char*>( compiledShader.data() ), compiledShader.size() };
+    }
+} // namespace
 
 std::vector<char> Utilities::ReadShaderBinary( const wchar_t* filePath )
 {
@@ -22,12 +38,28 @@ std::vector<char> Utilities::ReadShaderBinary( const wchar_t* filePath )
     return fileData;
 }
 
+size_t Utilities::FormatTo( char* out, size_t capacity, const char* format, ... )
+{
+    if ( capacity == 0 )
+        return 0;
+
+    va_list args;
+    va_start( args, format );
+    const int written = std::vsnprintf( out, capacity, format, args );
+    va_end( args );
+
+    if ( written < 0 )
+        return 0;
+    return static_cast<size_t>( written ) < capacity ? static_cast<size_t>( written ) : capacity - 1;
+}
+
 bool Utilities::CreateVertexShader( ID3D11Device* device, HRESULT& hr, const wchar_t* vsFilePath,
                                     ID3D11VertexShader** vertexShader, ID3DBlob** vsBlob )
 {
 
     // Already compiled by msbuild
     std::vector<char> compiledShader = Utilities::ReadShaderBinary( vsFilePath );
+    CheckConstantLayouts( Bytes( compiledShader ) );
 
     hr = device->CreateVertexShader( compiledShader.data(), compiledShader.size(), nullptr, vertexShader );
     if ( FAILED( hr ) )
@@ -52,6 +84,7 @@ bool Utilities::CreatePixelShader( ID3D11Device* device, HRESULT& hr, const wcha
 {
     // Already compiled by msbuild
     std::vector<char> compiledShader = Utilities::ReadShaderBinary( psFilePath );
+    CheckConstantLayouts( Bytes( compiledShader ) );
 
     hr = device->CreatePixelShader( compiledShader.data(), compiledShader.size(), nullptr, pixelShader );
     if ( FAILED( hr ) )
@@ -67,6 +100,7 @@ bool Utilities::CreateComputeShader( ID3D11Device* device, HRESULT& hr, const wc
 {
     // Already compiled by msbuild
     std::vector<char> compiledShader = Utilities::ReadShaderBinary( csFilePath );
+    CheckConstantLayouts( Bytes( compiledShader ) );
 
     hr = device->CreateComputeShader( compiledShader.data(), compiledShader.size(), nullptr, computeShader );
     if ( FAILED( hr ) )
@@ -76,3 +110,61 @@ bool Utilities::CreateComputeShader( ID3D11Device* device, HRESULT& hr, const wc
 
     return true;
 }
+
+bool Utilities::CreateVertexShader( ID3D11Device* device, HRESULT& hr, std::span<const unsigned char> bytecode,
+                                    ID3D11VertexShader** vertexShader )
+{
+    CheckConstantLayouts( bytecode );
+    hr = device->CreateVertexShader( bytecode.data(), bytecode.size(), nullptr, vertexShader );
+    return SUCCEEDED( hr );
+}
+
+bool Utilities::CreatePixelShader( ID3D11Device* device, HRESULT& hr, std::span<const unsigned char> bytecode,
+                                   ID3D11PixelShader** pixelShader )
+{
+    CheckConstantLayouts( bytecode );
+    hr = device->CreatePixelShader( bytecode.data(), bytecode.size(), nullptr, pixelShader );
+    return SUCCEEDED( hr );
+}
+
+bool Utilities::CreateComputeShader( ID3D11Device* device, HRESULT& hr, std::span<const unsigned char> bytecode,
+                                     ID3D11ComputeShader** computeShader )
+{
+    CheckConstantLayouts( bytecode );
+    hr = device->CreateComputeShader( bytecode.data(), bytecode.size(), nullptr, computeShader );
+    return SUCCEEDED( hr );
+}
+
+void Utilities::CheckConstantLayouts( const std::span<const unsigned char> bytecode )
+{
+    Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflection;
+    if ( FAILED( D3DReflect( bytecode.data(), bytecode.size(), __uuidof( ID3D11ShaderReflection ),
+                             reinterpret_cast<void**>( reflection.GetAddressOf() ) ) ) )
+        throw std::runtime_error( "Failed to reflect shader" );
+
+    D3D11_SHADER_DESC shaderDesc{};
+    reflection->GetDesc( &shaderDesc );
+    std::vector<ShaderConstantVariable> variables;
+    for ( UINT b = 0; b < shaderDesc.ConstantBuffers; b++ )
+    {
+        ID3D11ShaderReflectionConstantBuffer* buffer = reflection->GetConstantBufferByIndex( b );
+        D3D11_SHADER_BUFFER_DESC bufferDesc{};
+        buffer->GetDesc( &bufferDesc );
+        const ConstantLayout* layout = FindConstantLayout( bufferDesc.Name );
+        D3D11_SHADER_INPUT_BIND_DESC bind{};
+        if ( bufferDesc.Type != D3D_CT_CBUFFER || !layout ||
+             FAILED( reflection->GetResourceBindingDescByName( bufferDesc.Name, &bind ) ) )
+            continue;
+
+        variables.clear();
+        for ( UINT v = 0; v < bufferDesc.Variables; v++ )
+        {
+            D3D11_SHADER_VARIABLE_DESC variable{};
+            buffer->GetVariableByIndex( v )->GetDesc( &variable );
+            variables.push_back( { variable.Name, variable.StartOffset, variable.Size } );
+        }
+        const std::string mismatch = CheckConstantLayout( *layout, bind.BindPoint, variables );
+        if ( !mismatch.empty() )
+            throw std::runtime_error( "Shader constant layout mismatch: " + mismatch );
+    }
+}
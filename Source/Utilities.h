@@ -5,6 +5,7 @@
 #include <d3dcompiler.h> // Needed for compiling shaders
 #include <dxgi.h>
 #include <fstream>
+#include <span>
 #include <vector>
 
 #pragma comment( lib, "d3d11.lib" )
@@ -16,10 +17,24 @@ class Utilities
   public:
     static void CustomDrawText( HDC buffer, const wchar_t textToDraw[] );
     static std::vector<char> ReadShaderBinary( const wchar_t* filePath );
+    // snprintf into a fixed buffer (capacity includes the terminator); returns the length written
+    static size_t FormatTo( char* out, size_t capacity, const char* format, ... );
     static bool CreateVertexShader( ID3D11Device* device, HRESULT& hr, const wchar_t* vsFilePath,
                                     ID3D11VertexShader** vertexShader, ID3DBlob** vsBlob );
     static bool CreatePixelShader( ID3D11Device* device, HRESULT& hr, const wchar_t* psFilePath,
                                    ID3D11PixelShader** pixelShader );
     static bool CreateComputeShader( ID3D11Device* device, HRESULT& hr, const wchar_t* csFilePath,
                                      ID3D11ComputeShader** computeShader );
+
+    // Bytecode already in memory, e.g. a span into the asset bundle
+    static bool CreateVertexShader( ID3D11Device* device, HRESULT& hr, std::span<const unsigned char> bytecode,
+                                    ID3D11VertexShader** vertexShader );
+    static bool CreatePixelShader( ID3D11Device* device, HRESULT& hr, std::span<const unsigned char> bytecode,
+                                   ID3D11PixelShader** pixelShader );
+    static bool CreateComputeShader( ID3D11Device* device, HRESULT& hr, std::span<const unsigned char> bytecode,
+                                     ID3D11ComputeShader** computeShader );
+
+    // Reflects the shader's cbuffers and throws when a shared block (ShaderConstants.h) is bound at another register
+    // or a variable's bytes differ from the C++ struct. Every Create*Shader above runs it first.
+    static void CheckConstantLayouts( std::span<const unsigned char> bytecode );
 };
@@ -0,0 +1,32 @@
+#include "ViewTransform.h"
+
+Vector2D ViewTransform::ScreenToWorld( const int x, const int y ) const
+{
+    if ( width <= 0 || height <= 0 )
+        return { cameraPosition.x, cameraPosition.y };
+
+    const float fx = static_cast<float>( x ) / static_cast<float>( width );
+    const float fy = static_cast<float>( y ) / static_cast<float>( height );
+
+    const float vx = fx * 2.0f - 1.0f;
+    const float vy = 1.0f - fy * 2.0f;
+
+    return { vx / zoom + cameraPosition.x, vy / zoom + cameraPosition.y };
+}
+
+Vector2D ViewTransform::WorldToView( const Vector2D& world ) const
+{
+    return { ( world.x - cameraPosition.x ) * zoom, ( world.y - cameraPosition.y ) * zoom };
+}
+
+Vector2D ViewTransform::WorldToScreen( const Vector2D& world ) const
+{
+    if ( width <= 0 || height <= 0 )
+        return { 0.0f, 0.0f };
+
+    const Vector2D view = WorldToView( world );
+    const float px      = ( view.x + 1.0f ) * 0.5f * static_cast<float>( width );
+    const float py      = ( 1.0f - view.y ) * 0.5f * static_cast<float>( height );
+
+    return { px, py };
+}
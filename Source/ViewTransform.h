@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Vector2D.h"
+
+// Camera and window size as one value, so the simulation thread can map screen points to the world without reading
+// the renderer. World to NDC is (world - cameraPosition) * zoom; screen y grows downwards.
+struct ViewTransform
+{
+    Vector2D cameraPosition{};
+    float zoom = 1.0f;
+    int width  = 0;
+    int height = 0;
+
+    Vector2D ScreenToWorld( int x, int y ) const;
+    Vector2D WorldToScreen( const Vector2D& world ) const;
+    Vector2D WorldToView( const Vector2D& world ) const;
+};
@@ -0,0 +1,127 @@
+#include "WorldPass.h"
+
+#include "InstanceData.h"
+#include "Profiler.h"
+
+namespace
+{
+    unsigned int Groups( const int count )
+    {
+        return ( static_cast<unsigned int>( count ) + 255 ) / 256;
+    }
+
+    // The readback written RingDepth - 1 frames ago, mapped, or nullptr while the GPU has not finished the copy
+    const uint32_t* Poll( RenderDevice& device, ID3D11Query* query, ID3D11Buffer* readback, const unsigned int bytes )
+    {
+        if ( !device.GetData( query, nullptr, 0 ) )
+            return nullptr;
+        return static_cast<const uint32_t*>( device.Map( readback, MapMode::Read, bytes ) );
+    }
+} // namespace
+
+void WorldPass::Submit( RenderDevice& device, WorldPassStages& stages, const WorldPassResources& resources,
+                        const WorldPassFrame& frame )
+{
+    PROFILE_ZONE( "WorldPass::Submit" );
+    frameConstants_.Update( device, resources.frameConstants, frame.frame );
+    simulationConstants_.Update( device, resources.simulationConstants, frame.simulation );
+    densityConstants_.Update( device, resources.densityConstants, frame.density );
+    stages.BindConstants();
+
+    const int w = cursor_;
+    const int r = ReadSlot();
+
+    stages.BeginFlockStep();
+    device.Dispatch( Groups( frame.antCount ), 1, 1 );
+    {
+        PROFILE_ZONE( "Readback" );
+        stages.BeginReadback();
+        // Food counts feed the per-node totals the next step takes from the node amounts
+        device.CopyResource( resources.foodReadback[w], resources.foodCounts, resources.countBytes );
+        device.End( resources.foodQuery[w] );
+        if ( const uint32_t* counts = Poll( device, resources.foodQuery[r], resources.foodReadback[r],
+                                            resources.countBytes ) )
+        {
+            stages.FoodCounts( counts );
+            device.Unmap( resources.foodReadback[r] );
+        }
+        else
+        {
+            stages.ReadbackMissed();
+        }
+
+        // Nest counts; the next step scores them (with the combo)
+        device.CopyResource( resources.nestReadback[w], resources.nestCounts, resources.countBytes );
+        device.End( resources.nestQuery[w] );
+        if ( const uint32_t* counts = Poll( device, resources.nestQuery[r], resources.nestReadback[r],
+                                            resources.countBytes ) )
+        {
+            stages.NestCounts( counts );
+            device.Unmap( resources.nestReadback[r] );
+        }
+        else
+        {
+            stages.ReadbackMissed();
+        }
+        stages.EndReadback();
+    }
+    stages.EndFlockStep();
+
+    // Markers under the colony so ants walk over their nodes
+    if ( frame.markers && !frame.markers->Instances().empty() )
+    {
+        stages.BeginMarkers();
+        frame.markers->Submit( device, resources.markerInstances, resources.square, resources.triangle );
+    }
+
+    // Timestamps: [0] density [1] per-ant quads [2] splat [3]
+    ID3D11Query* const* stamps = resources.passTimestamps[w];
+    device.Begin( resources.passDisjoint[w] );
+    device.End( stamps[0] );
+    if ( frame.passes.density )
+    {
+        stages.BeginDensity();
+        device.Dispatch( Groups( frame.antCount ), 1, 1 );
+        stages.EndDensity();
+    }
+    device.End( stamps[1] );
+    if ( frame.passes.ants )
+    {
+        stages.BeginAnts();
+        device.BindMesh( resources.square ); // already bound by the marker pass, skipped by the device
+        device.IASetVertexBuffer( 1, resources.antInstances, sizeof( InstanceData ) );
+        device.DrawMesh( resources.square, static_cast<unsigned int>( frame.antCount ), 0 );
+        stages.EndAnts();
+    }
+    device.End( stamps[2] );
+    if ( frame.passes.splat )
+    {
+        stages.BeginSplat();
+        device.Draw( 3, 0 );
+        stages.EndSplat();
+    }
+    device.End( stamps[3] );
+    device.End( resources.passDisjoint[w] );
+
+    // Labels on top of the colony, every glyph of every label in one draw
+    if ( !frame.glyphs.empty() )
+    {
+        const auto count = static_cast<unsigned int>( frame.glyphs.size() );
+        device.UpdateSubresourceRange( resources.glyphInstances, frame.glyphs.data(), 0,
+                                       count * static_cast<unsigned int>( sizeof( GlyphInstance ) ) );
+        stages.BeginLabels();
+        device.IASetVertexBuffer( 1, resources.glyphInstances, sizeof( GlyphInstance ) );
+        device.BindMesh( resources.square );
+        device.DrawMesh( resources.square, count, 0 );
+        stages.EndLabels();
+    }
+
+    cursor_ = ( cursor_ + 1 ) % WorldPassResources::RingDepth;
+}
+
+void WorldPass::InvalidateConstants()
+{
+    frameConstants_.Invalidate();
+    simulationConstants_.Invalidate();
+    densityConstants_.Invalidate();
+}
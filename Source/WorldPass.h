@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ConstantBlock.h"
+#include "DensityLod.h"
+#include "GlyphLayout.h"
+#include "MarkerBatch.h"
+#include "RenderDevice.h"
+#include "ShaderConstants.h"
+
+#include <cstdint>
+#include <span>
+
+struct ID3D11Query;
+
+// Pipeline state the D3D11 renderer sets around the device calls of a world pass: shaders, input layouts, views and
+// blend state, none of which the device counts. Readbacks are handed over while mapped. Every hook defaults to doing
+// nothing, which is all the recording device's tests need.
+class WorldPassStages
+{
+  public:
+    virtual ~WorldPassStages() = default;
+
+    virtual void BindConstants() {}
+    virtual void BeginFlockStep() {} // instance and field views, hit-count clears, flock compute shader
+    virtual void BeginReadback() {}
+    virtual void FoodCounts( const uint32_t* /*counts*/ ) {} // HitBins counters per food node, two frames old
+    virtual void NestCounts( const uint32_t* /*counts*/ ) {}
+    virtual void ReadbackMissed() {} // the copy was not ready; its hits are lost
+    virtual void EndReadback() {}
+    virtual void EndFlockStep() {} // swap the instance buffers, unbind, world blend state
+    virtual void BeginMarkers() {}
+    virtual void BeginDensity() {}
+    virtual void EndDensity() {}
+    virtual void BeginAnts() {}
+    virtual void EndAnts() {}
+    virtual void BeginSplat() {}
+    virtual void EndSplat() {}
+    virtual void BeginLabels() {}
+    virtual void EndLabels() {}
+};
+
+// Buffers and queries a world pass uses, owned by the renderer. The hit-count readbacks and the pass timers are
+// rings: a slot is written this frame and read RingDepth - 1 frames later, so the CPU never waits on the GPU.
+struct WorldPassResources
+{
+    static constexpr int RingDepth = 3;
+
+    ID3D11Buffer* frameConstants      = nullptr;
+    ID3D11Buffer* simulationConstants = nullptr;
+    ID3D11Buffer* densityConstants    = nullptr;
+
+    ID3D11Buffer* antInstances    = nullptr; // per-ant vertex stream
+    ID3D11Buffer* markerInstances = nullptr;
+    ID3D11Buffer* glyphInstances  = nullptr;
+    MeshBinding square;
+    MeshBinding triangle;
+
+    ID3D11Buffer* foodCounts                  = nullptr;
+    ID3D11Buffer* nestCounts                  = nullptr;
+    unsigned int countBytes                   = 0; // size of each count buffer and readback
+    ID3D11Buffer* foodReadback[RingDepth]     = {};
+    ID3D11Buffer* nestReadback[RingDepth]     = {};
+    ID3D11Query* foodQuery[RingDepth]         = {};
+    ID3D11Query* nestQuery[RingDepth]         = {};
+    ID3D11Query* passDisjoint[RingDepth]      = {};
+    ID3D11Query* passTimestamps[RingDepth][4] = {}; // around the density, per-ant and splat passes
+};
+
+// What one frame draws
+struct WorldPassFrame
+{
+    FrameConstants frame{};
+    SimulationConstants simulation{};
+    DensityConstants density{};
+    DensityLodPasses passes{};
+    int antCount               = 0;
+    const MarkerBatch* markers = nullptr; // nullptr or empty: no marker draws
+    std::span<const GlyphInstance> glyphs;
+};
+
+// The device side of InstancedRendererEngine2D::RenderWorld, kept free of D3D11 so render_tests can run the same
+// sequence against RecordingRenderDevice: the constant blocks, the flock dispatch and the hit-count readback ring,
+// markers, the density, per-ant and splat passes between GPU timestamps, and the labels.
+class WorldPass
+{
+  public:
+    void Submit( RenderDevice& device, WorldPassStages& stages, const WorldPassResources& resources,
+                 const WorldPassFrame& frame );
+
+    // Ring slot written RingDepth - 1 frames ago, the one the next Submit reads back; pass timers resolve from it
+    int ReadSlot() const
+    {
+        return ( cursor_ + 1 ) % WorldPassResources::RingDepth;
+    }
+
+    // Forget the constant shadows, e.g. after the buffers were recreated
+    void InvalidateConstants();
+
+  private:
+    ConstantBlock<FrameConstants> frameConstants_;
+    ConstantBlock<SimulationConstants> simulationConstants_;
+    ConstantBlock<DensityConstants> densityConstants_;
+    int cursor_ = 0;
+};
@@ -0,0 +1,73 @@
+#include "LabelDeclutter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+// Amounts change with every delivery; only a change in the labels' rects or priority order should redo the layout
+namespace
+{
+    class LabelDeclutterTest : public ::testing::Test
+    {
+      protected:
+        // A row of labels clear of each other, then a pair stacked on the same spot
+        void SetUp() override
+        {
+            for ( uint32_t i = 0; i < 6; i++ )
+                labels.push_back( { 40.0f + 100.0f * static_cast<float>( i ), 100.0f, 30.0f, 14.0f, 0, 20, i } );
+            labels.push_back( { 300.0f, 400.0f, 30.0f, 14.0f, 0, 80, 6 } );
+            labels.push_back( { 305.0f, 402.0f, 30.0f, 14.0f, 0, 60, 7 } );
+        }
+
+        std::vector<uint32_t> Resolve()
+        {
+            return declutter.Resolve( labels, 1280.0f, 720.0f );
+        }
+
+        std::vector<LabelCandidate> labels;
+        LabelDeclutter declutter;
+    };
+} // namespace
+
+TEST_F( LabelDeclutterTest, HarvestingThatKeepsTheOrderReusesTheLayout )
+{
+    const std::vector<uint32_t> first = Resolve();
+    EXPECT_FALSE( declutter.Stats().reused );
+    EXPECT_EQ( declutter.Stats().hidden, 1u );
+
+    for ( int delivery = 0; delivery < 10; delivery++ )
+    {
+        labels[6].amount--;
+        labels[7].amount--;
+        EXPECT_EQ( Resolve(), first );
+        EXPECT_TRUE( declutter.Stats().reused );
+        EXPECT_FALSE( declutter.Stats().resorted );
+        EXPECT_EQ( declutter.Stats().hidden, 1u );
+    }
+}
+
+TEST_F( LabelDeclutterTest, HarvestingThatReordersReplacesWithoutACull )
+{
+    Resolve();
+    labels[6].amount = 40; // the hidden label now outranks the shown one
+
+    const std::vector<uint32_t> visible = Resolve();
+    EXPECT_FALSE( declutter.Stats().reused );
+    EXPECT_TRUE( declutter.Stats().resorted );
+    EXPECT_EQ( declutter.Stats().hidden, 1u );
+    EXPECT_EQ( visible.front(), 7u );
+    EXPECT_EQ( std::count( visible.begin(), visible.end(), 6u ), 0 );
+}
+
+TEST_F( LabelDeclutterTest, MovingTheCameraRebuilds )
+{
+    Resolve();
+    for ( LabelCandidate& label : labels )
+        label.x -= 200.0f;
+
+    Resolve();
+    EXPECT_FALSE( declutter.Stats().reused );
+    EXPECT_FALSE( declutter.Stats().resorted );
+    EXPECT_EQ( declutter.Stats().culled, 2u );
+}
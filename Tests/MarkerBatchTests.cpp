@@ -0,0 +1,92 @@
+#include "MarkerBatch.h"
+#include "RecordingRenderDevice.h"
+#include "RenderTestFixtures.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// Markers go out as one instance upload and at most one draw per shape, whatever the node count
+namespace
+{
+    class MarkerBatchTest : public ::testing::Test
+    {
+      protected:
+        // Every third node a triangle, every fifth a bonus, one of them emptied out
+        static std::vector<FoodNode> FoodNodes( const int count )
+        {
+            std::vector<FoodNode> nodes( static_cast<size_t>( count ) );
+            for ( int i = 0; i < count; i++ )
+            {
+                FoodNode& node  = nodes[static_cast<size_t>( i )];
+                node.pos        = Vector2D( -0.9f + 1.8f * static_cast<float>( i ) / count, 0.2f );
+                node.amount     = i == 1 ? 0.0f : 50.0f + static_cast<float>( i );
+                node.isTriangle = i % 3 == 2;
+                node.isBonus    = i % 5 == 4;
+            }
+            return nodes;
+        }
+
+        void Submit( const MarkerBatch& batch )
+        {
+            device.BeginFrame();
+            batch.Submit( device, meshes.handles.Buffer( 2 ), meshes.Square(), meshes.Triangle() );
+        }
+
+        ShapeMeshes meshes;
+        RecordingRenderDevice device;
+    };
+
+    class MarkerBatchNodesTest : public MarkerBatchTest, public ::testing::WithParamInterface<int>
+    {
+    };
+} // namespace
+
+TEST_P( MarkerBatchNodesTest, OneUploadAndOneDrawPerShape )
+{
+    const int nodes                  = GetParam();
+    const std::vector<FoodNode> food = FoodNodes( nodes );
+    const std::vector<Rock> rocks    = { { Vector2D( 0.3f, -0.4f ), 0.05f }, { Vector2D( -0.5f, 0.5f ), 0.08f } };
+    MarkerBatch batch;
+    batch.Build( food, 0, 0, Vector2D( 0.0f, -0.8f ), 100.0f, 16.0f / 9.0f, rocks );
+    Submit( batch );
+
+    // Rocks, nest, every node with food left, and the hover outline of the active node
+    const size_t expected = rocks.size() + 1 + static_cast<size_t>( nodes - ( nodes > 1 ? 1 : 0 ) ) + 1;
+    ASSERT_EQ( batch.Instances().size(), expected );
+
+    EXPECT_EQ( device.Count( RenderCommandType::UpdateSubresource ), 1 );
+    EXPECT_EQ( device.Bytes( RenderCommandType::UpdateSubresource ), expected * sizeof( MarkerInstance ) );
+    const int draws = device.Count( RenderCommandType::DrawIndexedInstanced );
+    EXPECT_EQ( draws, batch.TriangleCount() > 0 ? 2 : 1 );
+
+    // The draws cover every instance once, squares then triangles
+    unsigned int drawn = 0;
+    for ( const RenderCommand& command : device.Commands() )
+    {
+        if ( command.type == RenderCommandType::DrawIndexedInstanced )
+        {
+            drawn += command.instances;
+        }
+    }
+    EXPECT_EQ( drawn, expected );
+
+    // Both shapes live in the mesh arena, so the second draw binds nothing
+    EXPECT_EQ( device.CurrentFrame().indexBufferBinds, 1 );
+}
+
+INSTANTIATE_TEST_SUITE_P( NodeCounts, MarkerBatchNodesTest, ::testing::Values( 1, 2, 12, 128 ) );
+
+TEST_F( MarkerBatchTest, SquaresOnlyIsOneDraw )
+{
+    std::vector<FoodNode> food = FoodNodes( 6 );
+    for ( FoodNode& node : food )
+        node.isTriangle = false;
+    MarkerBatch batch;
+    batch.Build( food, -1, -1, Vector2D( 0.0f, 0.0f ), 100.0f, 1.0f, {} );
+    Submit( batch );
+
+    EXPECT_EQ( batch.TriangleCount(), 0u );
+    EXPECT_EQ( device.Count( RenderCommandType::UpdateSubresource ), 1 );
+    EXPECT_EQ( device.Count( RenderCommandType::DrawIndexedInstanced ), 1 );
+}
@@ -0,0 +1,167 @@
+#include "Game/SimulationFrame.h"
+#include "InstanceData.h"
+#include "RecordingRenderDevice.h"
+#include "RenderBudget.h"
+#include "RenderTestFixtures.h"
+#include "WorldPass.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+// A steady-state game frame through RecordingRenderDevice, checked against the budget the debug HUD checks the D3D11
+// device against (RenderBudget::SteadyFrame)
+namespace
+{
+    constexpr unsigned int ReadbackBytes = sizeof( uint32_t ) * Game::MaxFoodNodes * Game::HitBins;
+    constexpr unsigned int Ants          = 100000;
+    constexpr unsigned int InstanceBytes = Ants * sizeof( InstanceData );
+
+    class SteadyFrameTest : public ::testing::Test
+    {
+      protected:
+        // Handles 0 and 1 are the mesh arena's, 2 and 3 the flock's A and B instance buffers
+        void SetUp() override
+        {
+            resources.frameConstants      = d3d.Buffer( 4 );
+            resources.simulationConstants = d3d.Buffer( 5 );
+            resources.densityConstants    = d3d.Buffer( 6 );
+            resources.antInstances        = d3d.Buffer( 2 );
+            resources.markerInstances     = d3d.Buffer( 7 );
+            resources.glyphInstances      = d3d.Buffer( 8 );
+            resources.square              = meshes.Square();
+            resources.triangle            = meshes.Triangle();
+            resources.foodCounts          = d3d.Buffer( 9 );
+            resources.nestCounts          = d3d.Buffer( 10 );
+            resources.countBytes          = ReadbackBytes;
+            for ( int slot = 0; slot < WorldPassResources::RingDepth; slot++ )
+            {
+                resources.foodReadback[slot] = d3d.Buffer( 11 + slot );
+                resources.nestReadback[slot] = d3d.Buffer( 14 + slot );
+                resources.foodQuery[slot]    = d3d.Query( slot );
+                resources.nestQuery[slot]    = d3d.Query( 3 + slot );
+                resources.passDisjoint[slot] = d3d.Query( 6 + slot );
+                for ( int stamp = 0; stamp < 4; stamp++ )
+                    resources.passTimestamps[slot][stamp] = d3d.Query( 9 + slot * 4 + stamp );
+            }
+
+            // Nest, two food nodes (one a triangle) and the hover outline; a few labels' glyphs
+            std::vector<FoodNode> food( 2 );
+            food[0].pos        = Vector2D( -0.5f, 0.2f );
+            food[0].amount     = 60.0f;
+            food[1].pos        = Vector2D( 0.5f, 0.2f );
+            food[1].amount     = 40.0f;
+            food[1].isTriangle = true;
+            markers.Build( food, 0, 0, Vector2D( 0.0f, -0.8f ), 100.0f, 16.0f / 9.0f, {} );
+            glyphs.resize( 4 );
+
+            world.frame.aspectRatio = 16.0f / 9.0f;
+            world.passes            = DensityLod::ChoosePasses( LodMode::Auto, Ants, DensityLodSettings{} );
+            world.antCount          = Ants;
+            world.markers           = &markers;
+            world.glyphs            = glyphs;
+        }
+
+        // One frame once every buffer exists: the instance slots the step wrote (ApplyInstanceUploads), then the
+        // renderer's world pass
+        void RunFrame( const int slotWrites )
+        {
+            device.BeginFrame();
+            device.Clear();
+
+            for ( int slot = 0; slot < slotWrites; slot++ )
+            {
+                const InstanceData ant{};
+                const auto offset = static_cast<unsigned int>( slot * sizeof( InstanceData ) );
+                device.UpdateSubresourceRange( d3d.Buffer( 2 ), &ant, offset, sizeof( InstanceData ) );
+                device.UpdateSubresourceRange( d3d.Buffer( 3 ), &ant, offset, sizeof( InstanceData ) );
+            }
+
+            pass.Submit( device, stages, resources, world );
+        }
+
+        ShapeMeshes meshes;
+        FakeHandles& d3d = meshes.handles;
+        WorldPassResources resources;
+        MarkerBatch markers;
+        std::vector<GlyphInstance> glyphs;
+        WorldPassFrame world;
+        WorldPassStages stages; // no pipeline state to set on the recording device
+        WorldPass pass;
+        RecordingRenderDevice device;
+        const RenderBudget budget = RenderBudget::SteadyFrame( ReadbackBytes );
+    };
+} // namespace
+
+TEST_F( SteadyFrameTest, StaysWithinBudget )
+{
+    for ( int frame = 0; frame < 4; frame++ )
+        RunFrame( 3 );
+
+    const RenderDeviceStats& stats = device.CurrentFrame();
+    EXPECT_TRUE( RenderBudgetCheck::Check( stats, budget ).empty() );
+    EXPECT_LE( static_cast<size_t>( stats.draws ), budget.maxDraws );
+    EXPECT_EQ( stats.copies, 2 );
+    EXPECT_EQ( stats.copyBytes, 2u * ReadbackBytes );
+    EXPECT_EQ( stats.dispatches, world.passes.density ? 2 : 1 );
+    // The constants did not change, so only the written slots and the marker and glyph instances went up
+    EXPECT_EQ( stats.skippedUploadBytes, sizeof( FrameConstants ) + sizeof( SimulationConstants ) +
+                                             sizeof( DensityConstants ) );
+    EXPECT_EQ( stats.uploadBytes, 6 * sizeof( InstanceData ) + markers.Instances().size() * sizeof( MarkerInstance ) +
+                                      glyphs.size() * sizeof( GlyphInstance ) );
+    // Every shape draws from the mesh arena, bound once
+    EXPECT_EQ( stats.indexBufferBinds, 1 );
+}
+
+TEST_F( SteadyFrameTest, NeverCopiesTheInstanceBuffer )
+{
+    for ( int frame = 0; frame < 4; frame++ )
+        RunFrame( 3 );
+
+    for ( const RenderCommand& command : device.Commands() )
+    {
+        if ( command.type == RenderCommandType::CopyResource )
+        {
+            EXPECT_LT( command.bytes, InstanceBytes );
+        }
+    }
+}
+
+TEST_F( SteadyFrameTest, FullInstanceUploadIsOverBudget )
+{
+    RunFrame( 0 );
+    // What UploadInstanceBuffer does: the whole colony into A, then A copied into B
+    device.UpdateSubresourceRange( d3d.Buffer( 2 ), nullptr, 0, InstanceBytes );
+    device.CopyResource( d3d.Buffer( 3 ), d3d.Buffer( 2 ), InstanceBytes );
+
+    const std::vector<RenderBudgetViolation> violations = RenderBudgetCheck::Check( device.CurrentFrame(), budget );
+    ASSERT_EQ( violations.size(), 1u );
+    EXPECT_STREQ( violations[0].counter, "copyBytes" );
+    EXPECT_EQ( violations[0].value, InstanceBytes + 2u * ReadbackBytes );
+}
+
+TEST_F( SteadyFrameTest, DrawPerFoodNodeIsOverBudget )
+{
+    RunFrame( 0 );
+    for ( int node = 0; node < 16; node++ )
+        device.DrawMesh( meshes.Square(), 1, 0 );
+
+    const std::vector<RenderBudgetViolation> violations = RenderBudgetCheck::Check( device.CurrentFrame(), budget );
+    ASSERT_EQ( violations.size(), 1u );
+    EXPECT_STREQ( violations[0].counter, "draws" );
+}
+
+TEST( RecordingRenderDeviceTest, MissedReadbacksAreNotMapped )
+{
+    FakeHandles d3d;
+    RecordingRenderDevice device;
+    device.SetQueriesReady( false );
+    device.BeginFrame();
+    if ( device.GetData( d3d.Query( 0 ), nullptr, 0 ) )
+        device.Map( d3d.Buffer( 0 ), MapMode::Read, ReadbackBytes );
+
+    EXPECT_EQ( device.CurrentFrame().queryPolls, 1 );
+    EXPECT_EQ( device.CurrentFrame().queryMisses, 1 );
+    EXPECT_EQ( device.Count( RenderCommandType::Map ), 0 );
+}
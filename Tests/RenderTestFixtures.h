@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MeshArena.h"
+#include "Objects/SquareMesh.h"
+#include "Objects/TriangleMesh.h"
+
+// Stand-ins for the D3D objects; the devices only pass the pointers on
+struct FakeHandles
+{
+    char storage[64] = {};
+
+    ID3D11Buffer* Buffer( const int id )
+    {
+        return reinterpret_cast<ID3D11Buffer*>( storage + id );
+    }
+    ID3D11Query* Query( const int id )
+    {
+        return reinterpret_cast<ID3D11Query*>( storage + 32 + id );
+    }
+};
+
+// The renderer's square and triangle in one mesh arena, its buffers on handles 0 and 1
+struct ShapeMeshes
+{
+    ShapeMeshes()
+    {
+        arena.SetBuffers( handles.Buffer( 0 ), handles.Buffer( 1 ) );
+    }
+
+    MeshBinding Square() const
+    {
+        return arena.Binding( square.id );
+    }
+    MeshBinding Triangle() const
+    {
+        return arena.Binding( triangle.id );
+    }
+
+    FakeHandles handles;
+    MeshArena arena;
+    SquareMesh square{ arena };
+    TriangleMesh triangle{ arena };
+};
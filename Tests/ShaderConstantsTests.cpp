@@ -0,0 +1,135 @@
+#include "ShaderConstants.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The cbuffer declarations in Source/Shaders against the C++ layouts, the same check Utilities runs on the compiled
+// shaders through reflection when it creates them
+namespace
+{
+    struct DeclaredBlock
+    {
+        std::string shader;
+        std::string name;
+        unsigned int slot = 0;
+        std::vector<ShaderConstantVariable> variables;
+    };
+
+    // float, int and uint scalars and vectors; packoffset only places those
+    size_t HlslSize( const std::string& type )
+    {
+        const char last = type.back();
+        return last >= '1' && last <= '4' ? 4 * static_cast<size_t>( last - '0' ) : 4;
+    }
+
+    std::vector<DeclaredBlock> ReadBlocks( const std::filesystem::path& file )
+    {
+        std::ifstream stream( file );
+        std::stringstream text;
+        text << stream.rdbuf();
+        static const std::regex comment( R"(//[^\n]*)" );
+        const std::string source = std::regex_replace( text.str(), comment, "" );
+
+        static const std::regex cbuffer( R"(cbuffer\s+(\w+)\s*:\s*register\s*\(\s*b(\d+)\s*\)\s*\{([^}]*)\})" );
+        static const std::regex member( R"((\w+)\s+(\w+)\s*:\s*packoffset\s*\(\s*c(\d+)(?:\.([xyzw]))?\s*\))" );
+        static const std::regex declaration( R"((\w+)\s+(\w+)\s*[:;])" );
+
+        std::vector<DeclaredBlock> blocks;
+        for ( std::sregex_iterator it( source.begin(), source.end(), cbuffer ), end; it != end; ++it )
+        {
+            DeclaredBlock block;
+            block.shader           = file.filename().string();
+            block.name             = ( *it )[1];
+            block.slot             = static_cast<unsigned int>( std::stoul( ( *it )[2] ) );
+            const std::string body = ( *it )[3];
+            for ( std::sregex_iterator m( body.begin(), body.end(), member ); m != end; ++m )
+            {
+                const std::string component = ( *m )[4];
+                const size_t offset = std::stoul( ( *m )[3] ) * 16 +
+                                      ( component.empty() ? 0 : 4 * std::string( "xyzw" ).find( component[0] ) );
+                block.variables.push_back( { ( *m )[2], offset, HlslSize( ( *m )[1] ) } );
+            }
+            // A shared block member without packoffset would be placed by fxc's packing, not checked here
+            size_t declared = 0;
+            for ( std::sregex_iterator d( body.begin(), body.end(), declaration ); d != end; ++d )
+                declared++;
+            if ( declared != block.variables.size() )
+                block.variables.push_back( { "<member without packoffset>", 0, 0 } );
+            blocks.push_back( std::move( block ) );
+        }
+        return blocks;
+    }
+
+    std::vector<DeclaredBlock> SharedBlocks()
+    {
+        std::vector<DeclaredBlock> shared;
+        for ( const auto& entry : std::filesystem::directory_iterator( RENDERENGINE_SHADER_DIR ) )
+        {
+            if ( entry.path().extension() != ".hlsl" )
+                continue;
+            for ( DeclaredBlock& block : ReadBlocks( entry.path() ) )
+                if ( FindConstantLayout( block.name ) )
+                    shared.push_back( std::move( block ) );
+        }
+        return shared;
+    }
+} // namespace
+
+TEST( ShaderConstantsTest, ShaderDeclarationsMatchTheStructs )
+{
+    const std::vector<DeclaredBlock> blocks = SharedBlocks();
+    ASSERT_FALSE( blocks.empty() );
+    for ( const DeclaredBlock& block : blocks )
+    {
+        const ConstantLayout& layout = *FindConstantLayout( block.name );
+        EXPECT_EQ( CheckConstantLayout( layout, block.slot, block.variables ), "" ) << block.shader;
+    }
+}
+
+TEST( ShaderConstantsTest, EveryBlockIsDeclaredInFull )
+{
+    // Some shaders leave members out; each member is still declared by at least one shader
+    const std::vector<DeclaredBlock> blocks = SharedBlocks();
+    for ( const char* name : { "FrameConstants", "SimulationConstants", "DrawConstants", "DensityConstants" } )
+    {
+        const ConstantLayout* layout = FindConstantLayout( name );
+        ASSERT_NE( layout, nullptr ) << name;
+        for ( const ConstantMember& member : layout->members )
+        {
+            bool declared = false;
+            for ( const DeclaredBlock& block : blocks )
+                for ( const ShaderConstantVariable& variable : block.variables )
+                    declared |= block.name == name && variable.name == member.name;
+            EXPECT_TRUE( declared ) << name << "." << member.name;
+        }
+    }
+}
+
+TEST( ShaderConstantsTest, ShaderOwnBlocksAreSkipped )
+{
+    EXPECT_EQ( FindConstantLayout( "VSConstants" ), nullptr );
+    EXPECT_EQ( FindConstantLayout( "UIPanelInputData" ), nullptr );
+}
+
+TEST( ShaderConstantsTest, MismatchesAreReported )
+{
+    const ConstantLayout& layout                       = *FindConstantLayout( "SimulationConstants" );
+    const std::vector<ShaderConstantVariable> matching = { { "distanceGridSize", 48, 4 } };
+    const std::vector<ShaderConstantVariable> moved    = { { "distanceGridSize", 52, 4 } };
+    const std::vector<ShaderConstantVariable> resized  = { { "hazardPos", 32, 12 } };
+    const std::vector<ShaderConstantVariable> unknown  = { { "windSpeed", 52, 4 } };
+
+    EXPECT_EQ( CheckConstantLayout( layout, SimulationConstantSlot, matching ), "" );
+    EXPECT_EQ( CheckConstantLayout( layout, SimulationConstantSlot, moved ),
+               "SimulationConstants.distanceGridSize is bytes 52..56 in the shader, 48..52 in the C++ struct" );
+    EXPECT_NE( CheckConstantLayout( layout, SimulationConstantSlot, resized ), "" );
+    EXPECT_NE( CheckConstantLayout( layout, SimulationConstantSlot, unknown ), "" );
+    EXPECT_EQ( CheckConstantLayout( layout, DrawConstantSlot, matching ),
+               "SimulationConstants is bound at b2, the renderer binds it at b1" );
+}
@@ -0,0 +1,128 @@
+#include "SpectatorCodec.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+// SpectatorEncoder to SpectatorDecoder across keyframes, a colony that shrinks and grows, and damaged frames
+namespace
+{
+    // Shrinks below and grows past the last count; every size change leaves ants with and without history
+    size_t AntsAt( const uint64_t tick )
+    {
+        return 3000 + static_cast<size_t>( tick * 1237 % 2000 );
+    }
+
+    // Ants walk straight for a while, then turn, so the prediction is sometimes right and sometimes not
+    std::vector<InstanceData> Colony( const uint64_t tick )
+    {
+        std::vector<InstanceData> ants( AntsAt( tick ) );
+        for ( size_t i = 0; i < ants.size(); i++ )
+        {
+            const float heading   = static_cast<float>( i ) * 0.61f + static_cast<float>( tick / 20 ) * 0.9f;
+            const float walked    = static_cast<float>( tick ) * 0.004f;
+            ants[i].posX          = std::fmod( static_cast<float>( i ) * 0.013f + walked * std::cos( heading ), 1.9f );
+            ants[i].posY          = std::fmod( static_cast<float>( i ) * 0.007f + walked * std::sin( heading ), 1.9f );
+            ants[i].movementState = static_cast<int>( ( i + tick / 7 ) % 3 );
+        }
+        return ants;
+    }
+
+    SpectatorScore ScoreAt( const uint64_t tick )
+    {
+        SpectatorScore score;
+        score.stage         = 1 + static_cast<int32_t>( tick / 100 );
+        score.score         = static_cast<int32_t>( tick / 3 );
+        score.stageTarget   = 500;
+        score.stageTimeLeft = 90.0f - static_cast<float>( tick / 60 );
+        return score;
+    }
+
+    std::vector<SpectatorFood> FoodAt( const uint64_t tick )
+    {
+        std::vector<SpectatorFood> food( 2 + tick / 50 % 3 );
+        for ( size_t i = 0; i < food.size(); i++ )
+        {
+            food[i].x      = -0.8f + 0.4f * static_cast<float>( i );
+            food[i].y      = 0.3f;
+            food[i].amount = 100.0f - static_cast<float>( tick / 10 );
+            food[i].flags  = i == 0 ? SpectatorFood::ActiveFood : 0;
+        }
+        return food;
+    }
+
+    class SpectatorCodecTest : public ::testing::Test
+    {
+      protected:
+        const std::vector<uint8_t>& EncodeTick( const uint64_t tick )
+        {
+            const std::vector<SpectatorFood> food = FoodAt( tick );
+            encoder.Encode( tick, ScoreAt( tick ), food, Colony( tick ), frame );
+            return frame;
+        }
+
+        // Checks the decoded world against what was encoded at that tick
+        static void ExpectWorld( const SpectatorWorld& world, const uint64_t tick )
+        {
+            const std::vector<InstanceData> ants = Colony( tick );
+            EXPECT_EQ( world.tick, tick );
+            EXPECT_EQ( world.score, ScoreAt( tick ) );
+            EXPECT_EQ( world.food, FoodAt( tick ) );
+            ASSERT_EQ( world.antX.size(), ants.size() );
+            size_t mismatches = 0;
+            for ( size_t i = 0; i < ants.size(); i++ )
+                mismatches += world.antX[i] != SpectatorEncoder::Quantize( ants[i].posX ) ||
+                              world.antY[i] != SpectatorEncoder::Quantize( ants[i].posY ) ||
+                              world.antState[i] != static_cast<uint8_t>( ants[i].movementState );
+            EXPECT_EQ( mismatches, 0u ) << "tick " << tick;
+        }
+
+        SpectatorEncoder encoder;
+        SpectatorDecoder decoder;
+        SpectatorWorld world;
+        std::vector<uint8_t> frame;
+    };
+} // namespace
+
+TEST_F( SpectatorCodecTest, RoundTripsAColonyThatShrinksAndGrows )
+{
+    // Past two keyframes, with the score and food changing on some ticks only
+    for ( uint64_t tick = 0; tick < 2 * SpectatorEncoder::KeyframeInterval + 10; tick++ )
+    {
+        const bool key = SpectatorDecoder::IsKeyframe( EncodeTick( tick ) );
+        EXPECT_EQ( key, tick % SpectatorEncoder::KeyframeInterval == 0 ) << "tick " << tick;
+        ASSERT_TRUE( decoder.Decode( frame, world ) );
+        ExpectWorld( world, tick );
+    }
+}
+
+TEST_F( SpectatorCodecTest, LateJoinerWaitsForAKeyframe )
+{
+    EncodeTick( 0 );
+    for ( uint64_t tick = 1; tick < 5; tick++ )
+        EXPECT_FALSE( decoder.Decode( EncodeTick( tick ), world ) );
+    EXPECT_FALSE( decoder.Synced() );
+
+    encoder.ForceKeyframe();
+    EXPECT_TRUE( decoder.Decode( EncodeTick( 5 ), world ) );
+    for ( uint64_t tick = 6; tick < 10; tick++ )
+        EXPECT_TRUE( decoder.Decode( EncodeTick( tick ), world ) );
+    ExpectWorld( world, 9 );
+}
+
+TEST_F( SpectatorCodecTest, FrameCutShortThrowsAndResyncsOnTheNextKeyframe )
+{
+    ASSERT_TRUE( decoder.Decode( EncodeTick( 0 ), world ) );
+    std::vector<uint8_t> cut = EncodeTick( 1 );
+    cut.resize( cut.size() / 2 );
+    EXPECT_THROW( decoder.Decode( cut, world ), std::runtime_error );
+    EXPECT_FALSE( decoder.Synced() );
+
+    // Its history is gone, so deltas are skipped until a keyframe comes
+    EXPECT_FALSE( decoder.Decode( EncodeTick( 2 ), world ) );
+    encoder.ForceKeyframe();
+    ASSERT_TRUE( decoder.Decode( EncodeTick( 3 ), world ) );
+    ExpectWorld( world, 3 );
+}
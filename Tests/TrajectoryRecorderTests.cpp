@@ -0,0 +1,139 @@
+#include "SpectatorCodec.h"
+#include "TrajectoryRecorder.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// Recorder to file to TrajectoryFile::Read, with a colony that crosses the ChunkAnts boundary both ways
+namespace
+{
+    constexpr uint32_t Interval = 6;
+    constexpr size_t Samples    = 56; // past the second key sample; the last one spans two chunks
+    constexpr uint32_t MaxAnts  = 72000;
+
+    // Shrinks and grows between 60000 and 72000 ants, on either side of ChunkAnts
+    uint32_t AntsAt( const size_t sample )
+    {
+        return 60000 + static_cast<uint32_t>( sample * 3701 % 12000 );
+    }
+
+    uint64_t TickOf( const size_t sample )
+    {
+        return sample * Interval;
+    }
+
+    // Every ant moves every sample, so each delta chains on the one before
+    std::vector<InstanceData> Colony( const size_t sample )
+    {
+        std::vector<InstanceData> ants( AntsAt( sample ) );
+        for ( size_t i = 0; i < ants.size(); i++ )
+        {
+            const float phase     = static_cast<float>( i ) * 0.37f + static_cast<float>( sample ) * 0.05f;
+            ants[i].posX          = 1.8f * std::sin( phase );
+            ants[i].posY          = 1.8f * std::cos( phase * 1.3f );
+            ants[i].movementState = static_cast<int>( ( i + sample ) % 3 );
+        }
+        return ants;
+    }
+
+    class TrajectoryFileTest : public ::testing::Test
+    {
+      protected:
+        void SetUp() override
+        {
+            path = std::filesystem::temp_directory_path() /
+                   ( std::string( "render_tests_" ) + ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+                     ".antt" );
+            TrajectoryRecorder recorder( path, Interval );
+            for ( size_t sample = 0; sample < Samples; sample++ )
+            {
+                const std::vector<InstanceData> ants = Colony( sample );
+                // The writer may still hold every buffer; the test wants every sample, so it waits instead
+                while ( !recorder.Sample( TickOf( sample ), ants ) )
+                    std::this_thread::yield();
+            }
+            recorder.Close();
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove( path );
+        }
+
+        // Compares a slice with what was recorded; returns the number of ants that differ
+        static size_t Mismatches( const TrajectorySlice& slice, const size_t firstSample )
+        {
+            size_t mismatches = 0;
+            for ( size_t row = 0; row < slice.ticks.size(); row++ )
+            {
+                const std::vector<InstanceData> ants = Colony( firstSample + row );
+                for ( uint32_t column = 0; column < slice.antCount; column++ )
+                {
+                    const size_t ant = slice.antBegin + column;
+                    const size_t at  = row * slice.antCount + column;
+                    if ( ant >= ants.size() )
+                    {
+                        mismatches += slice.state[at] != TrajectorySlice::Absent;
+                        continue;
+                    }
+                    const float x = SpectatorEncoder::Dequantize( SpectatorEncoder::Quantize( ants[ant].posX ) );
+                    const float y = SpectatorEncoder::Dequantize( SpectatorEncoder::Quantize( ants[ant].posY ) );
+                    mismatches += slice.x[at] != x || slice.y[at] != y ||
+                                  slice.state[at] != static_cast<uint8_t>( ants[ant].movementState );
+                }
+            }
+            return mismatches;
+        }
+
+        std::filesystem::path path;
+    };
+} // namespace
+
+TEST_F( TrajectoryFileTest, RoundTripsAColonyThatShrinksAndGrows )
+{
+    const TrajectoryFile file( path );
+    EXPECT_EQ( file.Interval(), Interval );
+    ASSERT_EQ( file.Samples(), Samples );
+    for ( size_t sample = 0; sample < Samples; sample++ )
+    {
+        EXPECT_EQ( file.Tick( sample ), TickOf( sample ) );
+        EXPECT_EQ( file.Ants( sample ), AntsAt( sample ) );
+    }
+
+    const TrajectorySlice slice = file.Read( 0, MaxAnts, 0, std::numeric_limits<uint64_t>::max() );
+    ASSERT_EQ( slice.ticks.size(), Samples );
+    EXPECT_EQ( Mismatches( slice, 0 ), 0u );
+}
+
+TEST_F( TrajectoryFileTest, SliceAfterAKeySampleSpansChunks )
+{
+    // Samples 51..54 chain from the key sample at 50; the ants straddle the first chunk boundary
+    const TrajectoryFile file( path );
+    const uint32_t antBegin     = TrajectoryRecorder::ChunkAnts - 500;
+    const uint32_t antEnd       = TrajectoryRecorder::ChunkAnts + 1500;
+    const TrajectorySlice slice = file.Read( antBegin, antEnd, TickOf( 51 ), TickOf( 55 ) );
+
+    ASSERT_EQ( slice.ticks.size(), 4u );
+    EXPECT_EQ( slice.ticks.front(), TickOf( 51 ) );
+    EXPECT_EQ( slice.antBegin, antBegin );
+    EXPECT_EQ( slice.antCount, antEnd - antBegin );
+    EXPECT_EQ( Mismatches( slice, 51 ), 0u );
+}
+
+TEST_F( TrajectoryFileTest, FileCutShortMidSampleReadsTheWholeSamples )
+{
+    // Into the last sample's second chunk; its first chunk is whole but the sample is not
+    ASSERT_GT( AntsAt( Samples - 1 ), TrajectoryRecorder::ChunkAnts );
+    std::filesystem::resize_file( path, std::filesystem::file_size( path ) - 100 );
+
+    const TrajectoryFile file( path );
+    ASSERT_EQ( file.Samples(), Samples - 1 );
+    const TrajectorySlice slice = file.Read( 0, MaxAnts, TickOf( Samples - 3 ), TickOf( Samples ) );
+    ASSERT_EQ( slice.ticks.size(), 2u );
+    EXPECT_EQ( Mismatches( slice, Samples - 3 ), 0u );
+}
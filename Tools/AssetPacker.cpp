@@ -0,0 +1,234 @@
+// Packs shaders, fonts and default settings into assets.bundle and inspects or times existing bundles.
+//
+//   asset_packer pack <out.bundle> <name>=<path>...
+//   asset_packer list <bundle>
+//   asset_packer time <bundle> <looseDir> [iterations]
+//
+// `time` reads every asset loose through ifstream and from the mapped bundle, and hashes every byte either way, so
+// both sides fault in the same data. Cold runs first drop the loose files and the bundle from the OS file cache
+// (POSIX_FADV_DONTNEED, or a FILE_FLAG_NO_BUFFERING open on Windows, which purges the file's cached pages); warm runs
+// follow with everything cached.
+
+#include "AssetBundle.h"
+#include "AssetBundleWriter.h"
+#include "Hash.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int Usage()
+    {
+        std::fprintf( stderr, "usage: asset_packer pack <out.bundle> <name>=<path>...\n"
+                              "       asset_packer list <bundle>\n"
+                              "       asset_packer time <bundle> <looseDir> [iterations]\n" );
+        return 2;
+    }
+
+    int Pack( const int argc, char** argv )
+    {
+        AssetBundleWriter writer;
+        for ( int i = 3; i < argc; i++ )
+        {
+            const std::string arg = argv[i];
+            const size_t split    = arg.find( '=' );
+            if ( split == std::string::npos )
+                return Usage();
+
+            if ( !writer.AddFile( arg.substr( 0, split ), arg.substr( split + 1 ) ) )
+            {
+                std::fprintf( stderr, "asset_packer: cannot read %s\n", arg.c_str() + split + 1 );
+                return 1;
+            }
+        }
+        writer.Write( argv[2] );
+        return 0;
+    }
+
+    int List( const char* path )
+    {
+        AssetBundle bundle;
+        if ( !bundle.Open( path ) )
+        {
+            std::fprintf( stderr, "asset_packer: %s is not a valid bundle\n", path );
+            return 1;
+        }
+
+        for ( uint32_t i = 0; i < bundle.EntryCount(); i++ )
+        {
+            const BundleEntry& entry    = bundle.EntryAt( i );
+            const std::string_view name = bundle.NameAt( i );
+            std::printf( "%016llx %10llu  %.*s\n", static_cast<unsigned long long>( entry.contentHash ),
+                         static_cast<unsigned long long>( entry.size ), static_cast<int>( name.size() ), name.data() );
+        }
+
+        const bool valid = bundle.Verify();
+        std::printf( "%u assets, %zu bytes, hashes %s\n", bundle.EntryCount(), bundle.MappedBytes(),
+                     valid ? "ok" : "MISMATCH" );
+        return valid ? 0 : 1;
+    }
+
+    // Drops the file's pages from the OS file cache; false when that is not possible
+    bool EvictFromCache( const std::string& path )
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                   OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr );
+        if ( file == INVALID_HANDLE_VALUE )
+            return false;
+        CloseHandle( file );
+        return true;
+#else
+        const int fd = open( path.c_str(), O_RDONLY );
+        if ( fd < 0 )
+            return false;
+        const bool evicted = posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED ) == 0;
+        close( fd );
+        return evicted;
+#endif
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    double Elapsed( const Clock::time_point start )
+    {
+        return std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+    }
+
+    // One start from loose files: open, read and hash every asset
+    double LooseStart( const std::string& looseDir, const std::vector<std::string>& names, uint64_t& sink )
+    {
+        const auto start = Clock::now();
+        for ( const std::string& name : names )
+        {
+            std::ifstream input( looseDir + "/" + name, std::ios::binary );
+            const std::vector<char> bytes( ( std::istreambuf_iterator<char>( input ) ),
+                                           std::istreambuf_iterator<char>() );
+            sink += HashBytes( bytes.data(), bytes.size() );
+        }
+        return Elapsed( start );
+    }
+
+    // One start from the bundle: map it, look up and hash every asset in place
+    double BundleStart( const char* bundlePath, const std::vector<std::string>& names, uint64_t& sink )
+    {
+        const auto start = Clock::now();
+        AssetBundle bundle;
+        bundle.Open( bundlePath );
+        for ( const std::string& name : names )
+        {
+            const AssetSpan bytes = bundle.Find( name );
+            sink += HashBytes( bytes.data(), bytes.size() );
+        }
+        return Elapsed( start );
+    }
+
+    int Time( const char* bundlePath, const std::string& looseDir, const int iterations )
+    {
+        std::vector<std::string> names;
+        size_t bytes = 0;
+        {
+            AssetBundle bundle;
+            if ( !bundle.Open( bundlePath ) )
+            {
+                std::fprintf( stderr, "asset_packer: %s is not a valid bundle\n", bundlePath );
+                return 1;
+            }
+            for ( uint32_t i = 0; i < bundle.EntryCount(); i++ )
+            {
+                names.emplace_back( bundle.NameAt( i ) );
+                bytes += bundle.EntryAt( i ).size;
+            }
+        }
+
+        const auto evictAll = [&]
+        {
+            bool evicted = EvictFromCache( bundlePath );
+            for ( const std::string& name : names )
+                evicted = EvictFromCache( looseDir + "/" + name ) && evicted;
+            return evicted;
+        };
+
+        uint64_t looseSink  = 0;
+        uint64_t bundleSink = 0;
+        const int coldRuns  = std::min( iterations, 5 );
+        double looseCold    = 0.0;
+        double bundleCold   = 0.0;
+        bool cold           = true;
+        for ( int it = 0; it < coldRuns && cold; it++ )
+        {
+            cold = evictAll();
+            looseCold += LooseStart( looseDir, names, looseSink );
+            cold = evictAll() && cold;
+            bundleCold += BundleStart( bundlePath, names, bundleSink );
+        }
+
+        double looseWarm  = 0.0;
+        double bundleWarm = 0.0;
+        for ( int it = 0; it < iterations; it++ )
+        {
+            looseWarm += LooseStart( looseDir, names, looseSink );
+            bundleWarm += BundleStart( bundlePath, names, bundleSink );
+        }
+
+        // Same assets hashed the same number of times on both sides
+        if ( looseSink != bundleSink )
+        {
+            std::fprintf( stderr, "asset_packer: loose files in %s differ from the bundle\n", looseDir.c_str() );
+            return 1;
+        }
+
+        std::printf( "%zu assets, %zu bytes, %d cold and %d warm starts\n", names.size(), bytes, coldRuns, iterations );
+        std::printf( "                    cold ms    warm ms\n" );
+        if ( cold )
+        {
+            std::printf( "loose  (ifstream): %8.3f   %8.3f\n", looseCold / coldRuns, looseWarm / iterations );
+            std::printf( "bundle (mapped):   %8.3f   %8.3f\n", bundleCold / coldRuns, bundleWarm / iterations );
+        }
+        else
+        {
+            std::printf( "loose  (ifstream):        -   %8.3f\n", looseWarm / iterations );
+            std::printf( "bundle (mapped):          -   %8.3f\n", bundleWarm / iterations );
+            std::printf( "cold starts not measured: the files could not be dropped from the file cache\n" );
+        }
+        return 0;
+    }
+} // namespace
+
+int main( int argc, char** argv )
+{
+    if ( argc < 3 )
+        return Usage();
+
+    try
+    {
+        const std::string command = argv[1];
+        if ( command == "pack" )
+            return Pack( argc, argv );
+        if ( command == "list" )
+            return List( argv[2] );
+        if ( command == "time" && argc >= 4 )
+            return Time( argv[2], argv[3], argc >= 5 ? std::max( 1, std::atoi( argv[4] ) ) : 100 );
+    }
+    catch ( const std::exception& ex )
+    {
+        std::fprintf( stderr, "asset_packer: %s\n", ex.what() );
+        return 1;
+    }
+    return Usage();
+}
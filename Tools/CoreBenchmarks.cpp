@@ -0,0 +1,622 @@
+// Google Benchmark suite for the per-frame CPU work that does not need a device: the ant step (CPU mirror of the
+// compute shader), hit-count folding, the gameplay rules the simulation thread runs every step, view mapping in
+// bulk, settings parsing, game state save/load, spectator frame encoding, trajectory sampling and the ImGui draw-data
+// copy.
+//
+//   bench_core --benchmark_out=bench_core.json --benchmark_out_format=json
+//
+// The run_bench_core target does exactly that, so the JSON can be collected and compared between builds.
+
+#include "AntStepKernel.h"
+#include "DistanceField.h"
+#include "DrawListCache.h"
+#include "FlowField.h"
+#include "SpectatorCodec.h"
+#include "TrajectoryRecorder.h"
+#include "Game/GameRules.h"
+#include "Game/GameStateFile.h"
+#include "Game/SimulationFrame.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Game::HitBins;
+
+    // A colony spread between the nest and one food node, half of it on each leg
+    std::vector<InstanceData> Colony( const size_t count )
+    {
+        std::mt19937 rng( 42 );
+        std::uniform_real_distribution<float> unit( -1.0f, 1.0f );
+        std::vector<InstanceData> ants( count );
+        for ( size_t i = 0; i < count; i++ )
+        {
+            InstanceData& ant = ants[i];
+            ant.posX          = unit( rng );
+            ant.posY          = unit( rng );
+            ant.goalX         = 0.6f;
+            ant.goalY         = 0.4f;
+            ant.laneOffset    = 0.03f * unit( rng );
+            ant.speedScale    = 1.0f + 0.15f * unit( rng );
+            ant.movementState = static_cast<int>( i & 1 );
+            ant.sourceIndex   = ant.movementState == 0 ? 0 : -1;
+            ant.holdTimer     = 0.1f;
+        }
+        return ants;
+    }
+
+    SimulationConstants StepConstants()
+    {
+        SimulationConstants constants{};
+        constants.targetPosX      = 0.6f;
+        constants.targetPosY      = 0.4f;
+        constants.speed           = 0.5f;
+        constants.deltaTime       = 1.0f / 60.0f;
+        constants.activeFoodIndex = 0;
+        constants.hazardActive    = 1;
+        constants.hazardPosX      = 0.2f;
+        constants.hazardPosY      = 0.1f;
+        constants.hazardRadius    = 0.3f;
+        return constants;
+    }
+
+    void BM_AntStep( benchmark::State& state )
+    {
+        const auto count                    = static_cast<size_t>( state.range( 0 ) );
+        std::vector<InstanceData> current   = Colony( count );
+        std::vector<InstanceData> next      = current;
+        const SimulationConstants constants = StepConstants();
+        std::vector<uint32_t> foodHits( Game::MaxFoodNodes );
+        std::vector<uint32_t> nestHits( Game::MaxFoodNodes );
+
+        for ( auto _ : state )
+        {
+            // Ping-pong like the GPU buffers, so the colony keeps moving between iterations
+            AntStepKernel::Run( current.data(), next.data(), count, constants, foodHits.data(), nestHits.data() );
+            current.swap( next );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+        state.SetBytesProcessed( state.iterations() * state.range( 0 ) * 2 * sizeof( InstanceData ) );
+    }
+    BENCHMARK( BM_AntStep )->Arg( 10000 )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMicrosecond );
+
+    // A wall of rocks across the way from the nest to StepConstants' food node, and a few loose ones
+    std::vector<Rock> BenchRocks()
+    {
+        return { { { 0.25f, 0.20f }, 0.08f }, { { 0.35f, 0.10f }, 0.06f }, { { 0.15f, 0.30f }, 0.06f },
+                 { { -0.50f, 0.40f }, 0.05f }, { { 0.40f, -0.60f }, 0.07f }, { { -0.30f, -0.30f }, 0.04f } };
+    }
+
+    ObstacleGrid BenchGrid( const int size, const std::vector<Rock>& rocks )
+    {
+        ObstacleGrid grid( size );
+        for ( const Rock& rock : rocks )
+            grid.Block( rock );
+        return grid;
+    }
+
+    void BM_FlowFieldBuild( benchmark::State& state )
+    {
+        const ObstacleGrid grid = BenchGrid( static_cast<int>( state.range( 0 ) ), BenchRocks() );
+        FlowField field;
+        for ( auto _ : state )
+        {
+            field.Build( grid, 0.6f, 0.4f );
+            benchmark::DoNotOptimize( field.Directions().data() );
+        }
+        state.SetItemsProcessed( state.iterations() * static_cast<int64_t>( grid.Cells() ) );
+    }
+    BENCHMARK( BM_FlowFieldBuild )->Arg( 64 )->Arg( 128 )->Arg( 256 )->Unit( benchmark::kMicrosecond );
+
+    // One rock dropped onto the route and taken away again, repaired in place each time
+    void BM_FlowFieldRepair( benchmark::State& state )
+    {
+        const int size              = static_cast<int>( state.range( 0 ) );
+        const std::vector<Rock> off = BenchRocks();
+        std::vector<Rock> on        = off;
+        on.push_back( { { 0.45f, 0.30f }, 0.05f } );
+        const ObstacleGrid grids[2] = { BenchGrid( size, off ), BenchGrid( size, on ) };
+        std::vector<uint32_t> changed;
+        for ( size_t cell = 0; cell < grids[0].Cells(); cell++ )
+            if ( grids[0].Blocked( cell ) != grids[1].Blocked( cell ) )
+                changed.push_back( static_cast<uint32_t>( cell ) );
+
+        FlowField field;
+        field.Build( grids[0], 0.6f, 0.4f );
+        size_t flip = 1;
+        size_t cells = 0;
+        for ( auto _ : state )
+        {
+            cells += field.Repair( grids[flip], changed );
+            flip ^= 1;
+        }
+        state.counters["cells"] =
+            benchmark::Counter( static_cast<double>( cells ), benchmark::Counter::kAvgIterations );
+    }
+    BENCHMARK( BM_FlowFieldRepair )->Arg( 128 )->Arg( 256 )->Unit( benchmark::kMicrosecond );
+
+    // BM_AntStep with the colony steering by flow fields around BenchRocks: the per-ant cost of the bilinear sample
+    void BM_AntStepFlowField( benchmark::State& state )
+    {
+        const auto count                  = static_cast<size_t>( state.range( 0 ) );
+        std::vector<InstanceData> current = Colony( count );
+        std::vector<InstanceData> next    = current;
+        std::vector<uint32_t> foodHits( Game::MaxFoodNodes );
+        std::vector<uint32_t> nestHits( Game::MaxFoodNodes );
+
+        const ObstacleGrid grid = BenchGrid( ObstacleGrid::DefaultSize, BenchRocks() );
+        const FoodNode food[]   = { { { 0.6f, 0.4f }, 100.0f } };
+        FlowFields fields;
+        fields.Update( grid, { 0.0f, 0.0f }, food );
+        SimulationConstants constants = StepConstants();
+        constants.flowGridSize        = grid.Size();
+
+        for ( auto _ : state )
+        {
+            AntStepKernel::Run( current.data(), next.data(), count, constants, foodHits.data(), nestHits.data(),
+                                fields.View() );
+            current.swap( next );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_AntStepFlowField )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMicrosecond );
+
+    // Every cell of a fresh field; what a stage with BenchRocks costs at most
+    void BM_DistanceFieldBake( benchmark::State& state )
+    {
+        const std::vector<Rock> rocks = BenchRocks();
+        size_t cells                  = 0;
+        for ( auto _ : state )
+        {
+            state.PauseTiming();
+            DistanceField field( static_cast<int>( state.range( 0 ) ) );
+            state.ResumeTiming();
+            cells += field.Bake( rocks );
+            benchmark::DoNotOptimize( field.Distances().data() );
+        }
+        state.counters["cells"] =
+            benchmark::Counter( static_cast<double>( cells ), benchmark::Counter::kAvgIterations );
+    }
+    BENCHMARK( BM_DistanceFieldBake )->Arg( 256 )->Arg( 1024 )->Unit( benchmark::kMicrosecond );
+
+    // One rock moved back and forth: only the cells around its old and new place are baked again
+    void BM_DistanceFieldEdit( benchmark::State& state )
+    {
+        std::vector<Rock> rocks[2] = { BenchRocks(), BenchRocks() };
+        rocks[1][0].pos.x += 0.05f;
+        DistanceField field( static_cast<int>( state.range( 0 ) ) );
+        field.Bake( rocks[0] );
+        size_t flip  = 1;
+        size_t cells = 0;
+        for ( auto _ : state )
+        {
+            cells += field.Bake( rocks[flip] );
+            flip ^= 1;
+        }
+        state.counters["cells"] =
+            benchmark::Counter( static_cast<double>( cells ), benchmark::Counter::kAvgIterations );
+    }
+    BENCHMARK( BM_DistanceFieldEdit )->Arg( 256 )->Arg( 1024 )->Unit( benchmark::kMicrosecond );
+
+    // BM_AntStep colliding with BenchRocks through the distance field: one bilinear sample per ant, any rock count
+    void BM_AntStepCollision( benchmark::State& state )
+    {
+        const auto count                  = static_cast<size_t>( state.range( 0 ) );
+        std::vector<InstanceData> current = Colony( count );
+        std::vector<InstanceData> next    = current;
+        std::vector<uint32_t> foodHits( Game::MaxFoodNodes );
+        std::vector<uint32_t> nestHits( Game::MaxFoodNodes );
+
+        DistanceField field;
+        field.Bake( BenchRocks() );
+        SimulationConstants constants    = StepConstants();
+        constants.distanceGridSize       = field.Size();
+        const DistanceFieldView distance = { field.Size(), field.Distances().data() };
+
+        for ( auto _ : state )
+        {
+            AntStepKernel::Run( current.data(), next.data(), count, constants, foodHits.data(), nestHits.data(), {},
+                                distance );
+            current.swap( next );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_AntStepCollision )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMicrosecond );
+
+    void BM_HitCountFold( benchmark::State& state )
+    {
+        std::vector<uint32_t> food( Game::MaxFoodNodes * HitBins );
+        std::vector<uint32_t> nest( Game::MaxFoodNodes * HitBins );
+        for ( size_t i = 0; i < food.size(); i++ )
+        {
+            food[i] = static_cast<uint32_t>( i % 7 );
+            nest[i] = static_cast<uint32_t>( i % 5 );
+        }
+        const auto nodes = static_cast<size_t>( state.range( 0 ) );
+        Game::FrameInput input;
+
+        for ( auto _ : state )
+        {
+            benchmark::DoNotOptimize( HitCounts::AccumulateFood( food.data(), nodes, HitBins, input.foodHits.data() ) );
+            benchmark::DoNotOptimize( HitCounts::SumNest( nest.data(), nodes, HitBins ) );
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) * HitBins * 2 );
+    }
+    BENCHMARK( BM_HitCountFold )->Arg( 8 )->Arg( Game::MaxFoodNodes );
+
+    PartyParticle Confetti( std::mt19937& rng )
+    {
+        std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+        PartyParticle p{};
+        p.x      = 640.0f * unit( rng );
+        p.y      = 360.0f * unit( rng );
+        p.vx     = 200.0f * ( unit( rng ) - 0.5f );
+        p.vy     = -300.0f * unit( rng );
+        p.ttl    = 1.0f + 2.0f * unit( rng );
+        p.life   = p.ttl;
+        p.color  = 0xFF40C0FF;
+        p.rotVel = 6.0f * ( unit( rng ) - 0.5f );
+        return p;
+    }
+
+    // updateParty: the burst ages out while the benchmark runs, so it is refilled to size outside the timing
+    void BM_UpdateParty( benchmark::State& state )
+    {
+        const auto count = static_cast<size_t>( state.range( 0 ) );
+        std::mt19937 rng( 7 );
+        std::vector<PartyParticle> particles;
+        particles.reserve( count );
+
+        for ( auto _ : state )
+        {
+            state.PauseTiming();
+            while ( particles.size() < count )
+                particles.push_back( Confetti( rng ) );
+            state.ResumeTiming();
+
+            Game::updatePartyParticles( particles, 1.0 / 60.0 );
+            benchmark::DoNotOptimize( particles.data() );
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_UpdateParty )->Arg( 256 )->Arg( 4096 );
+
+    // updatePendingSpawns: one queue-and-release cycle per spawn, with the instance write the game does
+    void BM_UpdatePendingSpawns( benchmark::State& state )
+    {
+        Game::GameWorldState world;
+        world.mode            = AntMode::ToFood;
+        world.activeFoodIndex = 0;
+        world.maxAnts         = static_cast<int>( state.range( 0 ) );
+        world.activeAnts      = 0;
+        world.spawnDelaySec   = 0.01;
+        world.instances.resize( static_cast<size_t>( world.maxAnts ) );
+        world.pendingSpawns.reserve( 1 );
+
+        for ( auto _ : state )
+        {
+            const int slot = Game::releasePendingSpawn( world, 0.02 );
+            if ( slot >= 0 )
+                world.instances[static_cast<size_t>( slot )] = Game::spawnedAnt( world );
+            if ( world.activeAnts >= world.maxAnts )
+                world.activeAnts = 0;
+            benchmark::DoNotOptimize( world.instances.data() );
+        }
+        state.SetItemsProcessed( state.iterations() );
+    }
+    BENCHMARK( BM_UpdatePendingSpawns )->Arg( 100000 );
+
+    Game::GameWorldState FoodField( const size_t nodes )
+    {
+        std::mt19937 rng( 3 );
+        std::uniform_real_distribution<float> unit( -1.0f, 1.0f );
+        Game::GameWorldState world;
+        for ( size_t i = 0; i < nodes; i++ )
+            world.foodNodes.push_back( FoodNode{ { unit( rng ), unit( rng ) }, 100.0f } );
+        return world;
+    }
+
+    ViewTransform View()
+    {
+        ViewTransform view;
+        view.cameraPosition = { 0.1f, -0.2f };
+        view.zoom           = 1.5f;
+        view.width          = 1920;
+        view.height         = 1080;
+        return view;
+    }
+
+    // findNearestFoodScreen: one pick per mouse position, over a screen's worth of positions
+    void BM_FindNearestFood( benchmark::State& state )
+    {
+        const Game::GameWorldState world = FoodField( static_cast<size_t>( state.range( 0 ) ) );
+        const ViewTransform view         = View();
+        int x                            = 0;
+
+        for ( auto _ : state )
+        {
+            benchmark::DoNotOptimize( Game::findNearestFood( world, view, x, ( x * 7 ) % view.height, 0.2f ) );
+            x = ( x + 13 ) % view.width;
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_FindNearestFood )->Arg( 16 )->Arg( Game::MaxFoodNodes );
+
+    void BM_ScreenToWorld( benchmark::State& state )
+    {
+        const auto count         = static_cast<size_t>( state.range( 0 ) );
+        const ViewTransform view = View();
+        std::vector<Vector2D> world( count );
+
+        for ( auto _ : state )
+        {
+            for ( size_t i = 0; i < count; i++ )
+                world[i] = view.ScreenToWorld( static_cast<int>( i % 1920 ), static_cast<int>( i / 1920 % 1080 ) );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_ScreenToWorld )->Arg( 100000 );
+
+    void BM_WorldToScreen( benchmark::State& state )
+    {
+        const auto count               = static_cast<size_t>( state.range( 0 ) );
+        const ViewTransform view       = View();
+        std::vector<InstanceData> ants = Colony( count );
+        std::vector<Vector2D> screen( count );
+
+        for ( auto _ : state )
+        {
+            for ( size_t i = 0; i < count; i++ )
+                screen[i] = view.WorldToScreen( { ants[i].posX, ants[i].posY } );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_WorldToScreen )->Arg( 100000 );
+
+    // loadSettings: the shipped settings.ini plus comments, as the parser sees it from disk
+    void BM_LoadSettings( benchmark::State& state )
+    {
+        const std::string text = "# Ant colony settings\n"
+                                 "initialAnts = 20000\n"
+                                 "antsPerSecond = 32\n"
+                                 "spawnDelaySec = 0.1\n"
+                                 "; food\n"
+                                 "defaultFoodAmount = 100\n"
+                                 "minFoodSpacing = 0.12\n"
+                                 "// movement\n"
+                                 "initialSpeed = 0.5\n"
+                                 "unknownKey = 1\n"
+                                 "initialAnts = not a number\n";
+        Game::GameWorldState world;
+
+        for ( auto _ : state )
+        {
+            std::istringstream in( text );
+            Game::applySettings( in, world );
+            benchmark::DoNotOptimize( world.maxAnts );
+        }
+        state.SetBytesProcessed( state.iterations() * static_cast<int64_t>( text.size() ) );
+    }
+    BENCHMARK( BM_LoadSettings );
+
+    // A mid-stage world with a colony of the given size, as a warm start would save it
+    Game::GameWorldState SavedWorld( const size_t ants )
+    {
+        Game::GameWorldState world;
+        world.stage     = 5;
+        world.score     = 1234;
+        world.instances = Colony( ants );
+        for ( int i = 0; i < 8; i++ )
+            world.foodNodes.push_back( FoodNode{ { 0.1f * i, -0.1f * i }, 100.0f } );
+        world.pendingSpawns.assign( 64, 0.05 );
+        std::mt19937 rng( 9 );
+        for ( int i = 0; i < 256; i++ )
+            world.partyParticles.push_back( Confetti( rng ) );
+        return world;
+    }
+
+    std::filesystem::path StateFile()
+    {
+        return std::filesystem::temp_directory_path() / "bench_core.state";
+    }
+
+    // Both through the OS file cache, which is what a warm start or a rewind during a session sees
+    void BM_GameStateSave( benchmark::State& state )
+    {
+        const Game::GameWorldState world = SavedWorld( static_cast<size_t>( state.range( 0 ) ) );
+        for ( auto _ : state )
+            Game::saveGameState( StateFile(), world );
+        state.SetBytesProcessed( state.iterations() * state.range( 0 ) * sizeof( InstanceData ) );
+    }
+    BENCHMARK( BM_GameStateSave )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMillisecond );
+
+    void BM_GameStateLoad( benchmark::State& state )
+    {
+        Game::saveGameState( StateFile(), SavedWorld( static_cast<size_t>( state.range( 0 ) ) ) );
+        Game::GameWorldState world;
+        for ( auto _ : state )
+        {
+            Game::loadGameState( StateFile(), world );
+            benchmark::DoNotOptimize( world.instances.data() );
+        }
+        state.SetBytesProcessed( state.iterations() * state.range( 0 ) * sizeof( InstanceData ) );
+    }
+    BENCHMARK( BM_GameStateLoad )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMillisecond );
+
+    // One spectator frame per tick of a walking colony, which steps between frames outside the timing. A keyframe
+    // goes out every SpectatorEncoder::KeyframeInterval frames; the counters split the bytes between the two kinds.
+    void BM_SpectatorEncode( benchmark::State& state )
+    {
+        const auto count                    = static_cast<size_t>( state.range( 0 ) );
+        std::vector<InstanceData> current   = Colony( count );
+        std::vector<InstanceData> next      = current;
+        const SimulationConstants constants = StepConstants();
+        std::vector<uint32_t> foodHits( Game::MaxFoodNodes );
+        std::vector<uint32_t> nestHits( Game::MaxFoodNodes );
+        const std::vector<SpectatorFood> food = { { 0.6f, 0.4f, 100.0f, SpectatorFood::ActiveFood } };
+        SpectatorEncoder encoder;
+        std::vector<uint8_t> frame;
+        uint64_t tick    = 0;
+        double bytes     = 0.0;
+        double keyBytes  = 0.0;
+        double keyframes = 0.0;
+
+        for ( auto _ : state )
+        {
+            state.PauseTiming();
+            AntStepKernel::Run( current.data(), next.data(), count, constants, foodHits.data(), nestHits.data() );
+            current.swap( next );
+            SpectatorScore score;
+            score.score = static_cast<int32_t>( tick / 10 );
+            state.ResumeTiming();
+
+            const bool keyframe = encoder.Encode( tick++, score, food, current, frame );
+            bytes += static_cast<double>( frame.size() );
+            if ( keyframe )
+            {
+                keyBytes += static_cast<double>( frame.size() );
+                keyframes++;
+            }
+        }
+        const double deltas           = static_cast<double>( state.iterations() ) - keyframes;
+        state.counters["bytes/frame"] = benchmark::Counter( bytes, benchmark::Counter::kAvgIterations );
+        state.counters["bytes/delta"] = deltas > 0.0 ? ( bytes - keyBytes ) / deltas : 0.0;
+        state.counters["bytes/key"]   = keyframes > 0.0 ? keyBytes / keyframes : 0.0;
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_SpectatorEncode )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMillisecond );
+
+    // What recording at 10 Hz costs the sim thread: a walking colony steps DefaultInterval times between samples,
+    // outside the timing, while the recorder's thread codes and writes the sample before. stepShare is the sample's
+    // time over the steps', the share of frame time recording adds.
+    void BM_TrajectorySample( benchmark::State& state )
+    {
+        const auto count                    = static_cast<size_t>( state.range( 0 ) );
+        std::vector<InstanceData> current   = Colony( count );
+        std::vector<InstanceData> next      = current;
+        const SimulationConstants constants = StepConstants();
+        std::vector<uint32_t> foodHits( Game::MaxFoodNodes );
+        std::vector<uint32_t> nestHits( Game::MaxFoodNodes );
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "bench_core.traj";
+        TrajectoryRecorder recorder( path, 1 );
+        uint64_t tick   = 0;
+        double stepsMs  = 0.0;
+        double sampleMs = 0.0;
+
+        for ( auto _ : state )
+        {
+            state.PauseTiming();
+            const auto start = std::chrono::steady_clock::now();
+            for ( uint32_t step = 0; step < TrajectoryRecorder::DefaultInterval; step++ )
+            {
+                AntStepKernel::Run( current.data(), next.data(), count, constants, foodHits.data(), nestHits.data() );
+                current.swap( next );
+            }
+            stepsMs += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+            state.ResumeTiming();
+
+            const auto sampled = std::chrono::steady_clock::now();
+            recorder.Sample( tick++, current );
+            sampleMs += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - sampled ).count();
+        }
+        recorder.Close();
+        const auto bytes               = static_cast<double>( std::filesystem::file_size( path ) );
+        state.counters["bytes/sample"] = bytes / static_cast<double>( state.iterations() );
+        state.counters["stepShare"]    = stepsMs > 0.0 ? sampleMs / stepsMs : 0.0;
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( BM_TrajectorySample )->Arg( 100000 )->Arg( 1000000 )->Unit( benchmark::kMillisecond );
+
+    // ImGui draw-data copy: plan the ring placement and copy the lists that changed, as ImGuiRenderer::Render does
+    // into the mapped buffers. Arg 1 is the percentage of lists that change each frame.
+    struct ImDrawVertex
+    {
+        float pos[2];
+        float uv[2];
+        uint32_t col;
+    };
+    using ImDrawIndex = uint16_t;
+
+    void BM_ImGuiDrawDataCopy( benchmark::State& state )
+    {
+        constexpr int Lists        = 24;
+        constexpr int VertsPerList = 2400;
+        constexpr int IdxPerList   = 3600;
+        const int changedPercent   = static_cast<int>( state.range( 0 ) );
+
+        std::vector<std::vector<ImDrawVertex>> vertices( Lists, std::vector<ImDrawVertex>( VertsPerList ) );
+        std::vector<std::vector<ImDrawIndex>> indices( Lists, std::vector<ImDrawIndex>( IdxPerList ) );
+        for ( int n = 0; n < Lists; n++ )
+            for ( int i = 0; i < IdxPerList; i++ )
+                indices[n][i] = static_cast<ImDrawIndex>( ( i + n ) % VertsPerList );
+
+        DrawListCache cache( sizeof( ImDrawVertex ), sizeof( ImDrawIndex ) );
+        std::vector<DrawListSlice> slices( Lists );
+        std::vector<ImDrawVertex> vertexRing;
+        std::vector<ImDrawIndex> indexRing;
+        uint32_t frame         = 0;
+        double uploadBytes     = 0.0;
+        double reuploadBytes   = 0.0; // lists that had not changed but were uploaded again
+        int64_t reuploadFrames = 0;
+
+        for ( auto _ : state )
+        {
+            frame++;
+            const int changed = Lists * changedPercent / 100;
+            for ( int n = 0; n < changed; n++ )
+                vertices[n][0].col = frame; // a moving widget
+            for ( int n = 0; n < Lists; n++ )
+                slices[n] = { vertices[n].data(), VertsPerList, indices[n].data(), IdxPerList };
+
+            cache.Plan( slices );
+            uploadBytes += static_cast<double>( cache.Stats().uploadBytes );
+            if ( cache.NeedsRecreate() )
+            {
+                vertexRing.resize( cache.VertexCapacity() );
+                indexRing.resize( cache.IndexCapacity() );
+            }
+            bool reuploaded = false;
+            for ( int n = 0; n < Lists; n++ )
+            {
+                const DrawListPlacement& placement = cache.Placements()[n];
+                if ( !placement.upload )
+                    continue;
+                std::memcpy( vertexRing.data() + placement.vertexOffset, vertices[n].data(),
+                             VertsPerList * sizeof( ImDrawVertex ) );
+                std::memcpy( indexRing.data() + placement.indexOffset, indices[n].data(),
+                             IdxPerList * sizeof( ImDrawIndex ) );
+                if ( frame > 1 && n >= changed )
+                {
+                    reuploadBytes += VertsPerList * sizeof( ImDrawVertex ) + IdxPerList * sizeof( ImDrawIndex );
+                    reuploaded = true;
+                }
+            }
+            reuploadFrames += reuploaded ? 1 : 0;
+            benchmark::ClobberMemory();
+        }
+        // Only a ring restart uploads an unchanged list again. Restarting on more than one frame in eight means the
+        // ring has no room for the changed lists, and the cache is close to copying everything every frame.
+        if ( reuploadFrames * 8 > state.iterations() )
+            state.SkipWithError( "unchanged lists re-uploaded on more than one frame in eight" );
+        state.counters["uploadBytes/frame"]   = benchmark::Counter( uploadBytes, benchmark::Counter::kAvgIterations );
+        state.counters["reuploadBytes/frame"] = benchmark::Counter( reuploadBytes, benchmark::Counter::kAvgIterations );
+        state.SetBytesProcessed( state.iterations() * Lists *
+                                 ( VertsPerList * sizeof( ImDrawVertex ) + IdxPerList * sizeof( ImDrawIndex ) ) );
+    }
+    BENCHMARK( BM_ImGuiDrawDataCopy )->Arg( 0 )->Arg( 25 )->Arg( 100 );
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,98 @@
+// Converts a BMFont XML descriptor (.fnt) into the binary glyph and kerning table read by FontData.
+//
+//   font_converter <in.fnt> <out.font>
+
+#include "FontData.h"
+
+#include <tinyxml2.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    template <typename T> T Narrow( const tinyxml2::XMLElement* element, const char* name )
+    {
+        return static_cast<T>( element->IntAttribute( name ) );
+    }
+
+    bool ReadFont( const char* path, FontDescription& font )
+    {
+        tinyxml2::XMLDocument document;
+        if ( document.LoadFile( path ) != tinyxml2::XML_SUCCESS )
+            return false;
+
+        const tinyxml2::XMLElement* root   = document.FirstChildElement( "font" );
+        const tinyxml2::XMLElement* common = root ? root->FirstChildElement( "common" ) : nullptr;
+        if ( !common )
+            return false;
+
+        if ( common->IntAttribute( "pages", 1 ) != 1 )
+            std::fprintf( stderr, "font_converter: %s has several pages; only page 0 is drawn\n", path );
+
+        font.lineHeight = Narrow<uint16_t>( common, "lineHeight" );
+        font.base       = Narrow<uint16_t>( common, "base" );
+        font.scaleW     = Narrow<uint16_t>( common, "scaleW" );
+        font.scaleH     = Narrow<uint16_t>( common, "scaleH" );
+
+        if ( const tinyxml2::XMLElement* chars = root->FirstChildElement( "chars" ) )
+        {
+            for ( const tinyxml2::XMLElement* c = chars->FirstChildElement( "char" ); c;
+                  c = c->NextSiblingElement( "char" ) )
+            {
+                FontGlyph glyph{};
+                glyph.codepoint = c->UnsignedAttribute( "id" );
+                glyph.x         = Narrow<uint16_t>( c, "x" );
+                glyph.y         = Narrow<uint16_t>( c, "y" );
+                glyph.width     = Narrow<uint16_t>( c, "width" );
+                glyph.height    = Narrow<uint16_t>( c, "height" );
+                glyph.xOffset   = Narrow<int16_t>( c, "xoffset" );
+                glyph.yOffset   = Narrow<int16_t>( c, "yoffset" );
+                glyph.xAdvance  = Narrow<int16_t>( c, "xadvance" );
+                glyph.page      = Narrow<uint16_t>( c, "page" );
+                font.glyphs.push_back( glyph );
+            }
+        }
+
+        if ( const tinyxml2::XMLElement* kernings = root->FirstChildElement( "kernings" ) )
+        {
+            for ( const tinyxml2::XMLElement* k = kernings->FirstChildElement( "kerning" ); k;
+                  k = k->NextSiblingElement( "kerning" ) )
+            {
+                font.kernings.push_back(
+                    { k->UnsignedAttribute( "first" ), k->UnsignedAttribute( "second" ), k->IntAttribute( "amount" ) } );
+            }
+        }
+        return font.lineHeight > 0 && font.scaleW > 0 && font.scaleH > 0;
+    }
+} // namespace
+
+int main( int argc, char** argv )
+{
+    if ( argc != 3 )
+    {
+        std::fprintf( stderr, "usage: font_converter <in.fnt> <out.font>\n" );
+        return 2;
+    }
+
+    FontDescription font;
+    if ( !ReadFont( argv[1], font ) )
+    {
+        std::fprintf( stderr, "font_converter: %s is not a BMFont XML file\n", argv[1] );
+        return 1;
+    }
+
+    const size_t glyphs                   = font.glyphs.size();
+    const size_t kernings                 = font.kernings.size();
+    const std::vector<unsigned char> file = FontData::Serialize( std::move( font ) );
+
+    std::ofstream output( argv[2], std::ios::binary | std::ios::trunc );
+    if ( !output.write( reinterpret_cast<const char*>( file.data() ), static_cast<std::streamsize>( file.size() ) ) )
+    {
+        std::fprintf( stderr, "font_converter: cannot write %s\n", argv[2] );
+        return 1;
+    }
+
+    std::printf( "%s: %zu glyphs, %zu kerning pairs, %zu bytes\n", argv[2], glyphs, kernings, file.size() );
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Lays out thousands of food-node style labels per simulated frame and reports the CPU cost.
+//
+//   glyph_layout_bench <font.font> [labels per frame] [frames]
+
+#include "GlyphLayout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 )
+    {
+        std::fprintf( stderr, "usage: glyph_layout_bench <font.font> [labels per frame] [frames]\n" );
+        return 2;
+    }
+
+    std::ifstream input( argv[1], std::ios::binary );
+    const std::vector<unsigned char> bytes( ( std::istreambuf_iterator<char>( input ) ),
+                                            std::istreambuf_iterator<char>() );
+    FontData font;
+    if ( !font.Load( bytes ) )
+    {
+        std::fprintf( stderr, "glyph_layout_bench: %s is not a converted font\n", argv[1] );
+        return 1;
+    }
+
+    const int labelCount = std::max( 1, argc >= 3 ? std::atoi( argv[2] ) : 5000 );
+    const int frames     = std::max( 1, argc >= 4 ? std::atoi( argv[3] ) : 200 );
+
+    // Same shape as the food-node labels: a word and an amount that changes every few frames
+    std::vector<std::string> labels;
+    for ( int i = 0; i < labelCount; i++ )
+        labels.push_back( ( i % 3 == 0 ? "Sugar " : "Food " ) + std::to_string( ( i * 37 ) % 1000 ) );
+
+    const GlyphLayout layout( font );
+    std::vector<GlyphInstance> instances;
+    std::vector<double> frameMs;
+    TextStyle style;
+    style.pixelHeight = 14.0f;
+    style.align       = TextAlign::Center;
+
+    for ( int frame = 0; frame < frames; frame++ )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        instances.clear();
+        for ( int i = 0; i < labelCount; i++ )
+            layout.Append( labels[i], Vector2D( i * 0.001f, frame * 0.001f ), style, instances );
+        frameMs.push_back( std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() );
+    }
+
+    std::sort( frameMs.begin(), frameMs.end() );
+    const double median = frameMs[frameMs.size() / 2];
+    const double p99    = frameMs[frameMs.size() * 99 / 100];
+    std::printf( "%d labels, %zu glyph instances (%zu bytes) per frame, %d frames\n", labelCount, instances.size(),
+                 instances.size() * sizeof( GlyphInstance ), frames );
+    std::printf( "median %.3f ms/frame, p99 %.3f ms/frame, %.1f ns/label, %.1f ns/glyph\n", median, p99,
+                 median * 1e6 / labelCount, median * 1e6 / static_cast<double>( instances.size() ) );
+    return 0;
+}
@@ -0,0 +1,144 @@
+// Throughput of SimulationPipeline at high ant counts: the same CPU simulation and "draw" run serially (step inline,
+// like the old paint handler) and pipelined (step on the worker, one frame ahead), and the frame rates are compared.
+// The present wait stands in for Present() blocking on vsync/GPU, which is when the worker gets the core to itself.
+//
+//   pipeline_bench [frames] [present wait ms] [ant count...]
+
+#include "SimulationPipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct BenchAnt
+    {
+        float x, y, vx, vy;
+    };
+
+    struct BenchInput
+    {
+        double time = 0.0; // running total, as in Game::FrameInput
+    };
+
+    struct BenchSnapshot
+    {
+        uint64_t sequence = 0;
+        std::vector<BenchAnt> ants;
+    };
+
+    // Stand-in for the game step: move and bounce every ant, then publish a copy of the colony
+    class BenchSimulation
+    {
+      public:
+        explicit BenchSimulation( const size_t count ) : ants_( count )
+        {
+            for ( size_t i = 0; i < count; i++ )
+            {
+                const float a = static_cast<float>( i ) * 0.618034f;
+                ants_[i]      = { std::cos( a ) * 0.5f, std::sin( a ) * 0.5f, std::sin( a * 3.0f ), std::cos( a * 5.0f ) };
+            }
+        }
+
+        void Step( const BenchInput& input, BenchSnapshot& out )
+        {
+            const auto dt = static_cast<float>( input.time - time_ );
+            time_         = input.time;
+            for ( BenchAnt& ant : ants_ )
+            {
+                ant.x += ant.vx * dt;
+                ant.y += ant.vy * dt;
+                if ( std::fabs( ant.x ) > 1.0f )
+                    ant.vx = -ant.vx;
+                if ( std::fabs( ant.y ) > 1.0f )
+                    ant.vy = -ant.vy;
+            }
+            out.ants     = ants_;
+            out.sequence = ++sequence_;
+        }
+
+      private:
+        std::vector<BenchAnt> ants_;
+        double time_       = 0.0;
+        uint64_t sequence_ = 0;
+    };
+
+    // Stand-in for the render thread's CPU side: project every ant into a vertex stream
+    float Draw( const BenchSnapshot& snapshot, std::vector<float>& vertices )
+    {
+        vertices.resize( snapshot.ants.size() * 2 );
+        float checksum = 0.0f;
+        for ( size_t i = 0; i < snapshot.ants.size(); i++ )
+        {
+            vertices[i * 2]     = snapshot.ants[i].x * 0.5f + 0.5f;
+            vertices[i * 2 + 1] = 0.5f - snapshot.ants[i].y * 0.5f;
+            checksum += vertices[i * 2];
+        }
+        return checksum;
+    }
+
+    struct BenchResult
+    {
+        double frameMs;
+        double freshFps; // frames that drew a snapshot not drawn before
+        SimulationPipelineStats stats;
+    };
+
+    BenchResult Run( const size_t ants, const int frames, const double presentMs, const bool threaded )
+    {
+        BenchSimulation simulation( ants );
+        SimulationPipeline<BenchInput, BenchSnapshot> pipeline(
+            [&simulation]( const BenchInput& input, BenchSnapshot& out ) { simulation.Step( input, out ); } );
+
+        std::vector<float> vertices;
+        BenchInput input;
+        pipeline.Start( input, threaded );
+
+        volatile float sink = 0.0f;
+        const auto start    = std::chrono::steady_clock::now();
+        for ( int frame = 0; frame < frames; frame++ )
+        {
+            input.time += 1.0 / 60.0;
+            sink = sink + Draw( pipeline.Advance( input ), vertices );
+            if ( presentMs > 0.0 )
+                std::this_thread::sleep_for( std::chrono::duration<double, std::milli>( presentMs ) );
+        }
+        const double totalMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        const SimulationPipelineStats stats = pipeline.Stats();
+        pipeline.Stop();
+        const auto fresh = static_cast<double>( frames - stats.reusedFrames );
+        return { totalMs / frames, fresh * 1000.0 / totalMs, stats };
+    }
+} // namespace
+
+int main( int argc, char** argv )
+{
+    const int frames = std::max( 1, argc >= 2 ? std::atoi( argv[1] ) : 300 );
+    const double presentMs = std::max( 0.0, argc >= 3 ? std::atof( argv[2] ) : 4.0 );
+    std::vector<size_t> counts;
+    for ( int i = 3; i < argc; i++ )
+        counts.push_back( static_cast<size_t>( std::max( 1, std::atoi( argv[i] ) ) ) );
+    if ( counts.empty() )
+        counts = { 10000, 100000, 1000000, 4000000 };
+
+    std::printf( "%d frames per run, %.1f ms present wait, %u hardware threads\n", frames, presentMs,
+                 std::thread::hardware_concurrency() );
+    std::printf( "%10s %12s %12s %12s %12s %9s\n", "ants", "serial fps", "piped fps", "piped fresh", "step ms",
+                 "speedup" );
+    for ( const size_t ants : counts )
+    {
+        const BenchResult serial    = Run( ants, frames, presentMs, false );
+        const BenchResult pipelined = Run( ants, frames, presentMs, true );
+        std::printf( "%10zu %12.1f %12.1f %12.1f %12.3f %8.2fx\n", ants, 1000.0 / serial.frameMs,
+                     1000.0 / pipelined.frameMs, pipelined.freshFps, pipelined.stats.lastStepMs,
+                     pipelined.freshFps * serial.frameMs / 1000.0 );
+    }
+    std::printf( "fresh: frames that showed a new snapshot; speedup compares fresh frames to serial frames\n" );
+    return 0;
+}
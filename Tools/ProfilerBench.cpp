@@ -0,0 +1,69 @@
+// Cost of a PROFILE_ZONE, disabled and enabled, on one thread and with several threads recording at once, then
+// the time to write what the rings hold as a Chrome trace.
+//
+//   profiler_bench [zones per thread] [threads] [trace.json]
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void Zones( const int count )
+    {
+        volatile uint64_t work = 0; // per thread, so the threads share nothing but the profiler
+        for ( int i = 0; i < count; i++ )
+        {
+            PROFILE_ZONE( "bench zone" );
+            work = work + 1;
+        }
+    }
+
+    double NanosecondsPerZone( const int count, const int threads )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for ( int t = 1; t < threads; t++ )
+            workers.emplace_back( [count] { Zones( count ); } );
+        Zones( count );
+        for ( std::thread& worker : workers )
+            worker.join();
+        // Per zone on one thread: the threads run side by side, so wall time over one thread's zones
+        return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() / count;
+    }
+} // namespace
+
+int main( int argc, char** argv )
+{
+    const int zones   = std::max( 1, argc >= 2 ? std::atoi( argv[1] ) : 2000000 );
+    const int threads = std::max( 1, argc >= 3 ? std::atoi( argv[2] ) : 4 );
+    const char* trace = argc >= 4 ? argv[3] : "profiler_bench_trace.json";
+
+    Profiler::SetThreadName( "bench main" ); // also allocates this thread's ring
+
+    const double disabled = NanosecondsPerZone( zones, 1 );
+    Profiler::SetEnabled( true );
+    const double enabled   = NanosecondsPerZone( zones, 1 );
+    const double contended = NanosecondsPerZone( zones, threads );
+    Profiler::SetEnabled( false );
+
+    const auto writeStart = std::chrono::steady_clock::now();
+    const bool written    = Profiler::WriteChromeTrace( trace );
+    const double writeMs =
+        std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - writeStart ).count();
+
+    const ProfilerStats stats = Profiler::Stats();
+    std::printf( "%d zones per run, %u hardware threads, %.0f ticks/us\n", zones, std::thread::hardware_concurrency(),
+                 stats.ticksPerMicro );
+    std::printf( "disabled:           %6.2f ns/zone\n", disabled );
+    std::printf( "enabled:            %6.2f ns/zone\n", enabled );
+    std::printf( "enabled, %d threads: %6.2f ns/zone (wall per zone on one thread)\n", threads, contended );
+    std::printf( "trace: %s, %llu zones from %d threads in %.1f ms\n", written ? trace : "write failed",
+                 static_cast<unsigned long long>( stats.zonesKept ), stats.threads, writeMs );
+    return written ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// Watches a headless run started with --spectate from another process: decodes every frame it is sent and prints,
+// once a second, what it sees (tick, ants and where they are, stage, score, food) and what that cost on the wire.
+// Joining late is fine; frames before the next keyframe are skipped.
+//
+//   spectator [port]
+
+#include "SpectatorCodec.h"
+#include "SpectatorSocket.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+int main( int argc, char** argv )
+{
+    const auto port = static_cast<uint16_t>( argc > 1 ? std::atoi( argv[1] ) : SpectatorPublisher::DefaultPort );
+
+    try
+    {
+        SpectatorSubscriber subscriber( port );
+        SpectatorDecoder decoder;
+        SpectatorWorld world;
+        std::vector<uint8_t> frame;
+
+        uint64_t frames = 0, bytes = 0, keyframes = 0, skipped = 0;
+        auto since      = std::chrono::steady_clock::now();
+        while ( subscriber.Receive( frame ) )
+        {
+            bool decoded = false;
+            try
+            {
+                decoded = decoder.Decode( frame, world );
+            }
+            catch ( const std::runtime_error& ex )
+            {
+                std::fprintf( stderr, "%s; waiting for a keyframe\n", ex.what() );
+            }
+            if ( !decoded )
+            {
+                skipped++;
+                continue;
+            }
+            frames++;
+            bytes += frame.size() + 4;
+            keyframes += SpectatorDecoder::IsKeyframe( frame ) ? 1 : 0;
+
+            const auto now     = std::chrono::steady_clock::now();
+            const double delta = std::chrono::duration<double>( now - since ).count();
+            if ( delta < 1.0 )
+                continue;
+
+            double x = 0.0, y = 0.0;
+            size_t nestward = 0;
+            for ( size_t i = 0; i < world.antX.size(); i++ )
+            {
+                x += SpectatorEncoder::Dequantize( world.antX[i] );
+                y += SpectatorEncoder::Dequantize( world.antY[i] );
+                nestward += world.antState[i] == 1 ? 1 : 0; // InstanceData::movementState 1: at or bound for the nest
+            }
+            const double ants = static_cast<double>( world.antX.size() );
+            std::printf( "tick %llu  ants %zu (centre %.3f, %.3f; %zu nestward)  stage %d  score %d  food %zu  |  "
+                         "%.1f frames/s  %.0f bytes/frame  %llu keyframes  %llu skipped\n",
+                         static_cast<unsigned long long>( world.tick ), world.antX.size(), ants > 0 ? x / ants : 0.0,
+                         ants > 0 ? y / ants : 0.0, nestward, world.score.stage, world.score.score, world.food.size(),
+                         frames / delta, frames ? static_cast<double>( bytes ) / frames : 0.0,
+                         static_cast<unsigned long long>( keyframes ), static_cast<unsigned long long>( skipped ) );
+            since  = now;
+            frames = bytes = keyframes = skipped = 0;
+        }
+        std::printf( "Publisher closed the stream\n" );
+    }
+    catch ( const std::exception& ex )
+    {
+        std::fprintf( stderr, "%s\n", ex.what() );
+        return 1;
+    }
+    return 0;
+}